@@ -22,6 +22,9 @@
 #include <unistd.h>
 #include <limits.h>
 
+#include <zlib.h>
+#include <bzlib.h>
+
 #include "libghw.h"
 
 // Exit the program with return value 1 and print calling line
@@ -61,24 +64,289 @@ calloc_unwrap (size_t nmemb, size_t size)
   return ret;
 }
 
-/* Reopen H through decompressor DECOMP.  */
+/* Size of the read buffer and of the compressed input buffer.  */
+#define GHW_BUF_SIZE (64 * 1024)
+
+enum ghw_stream_kind
+{
+  ghw_stream_raw,
+  ghw_stream_gzip,
+  ghw_stream_bzip2
+};
+
+/* All the reads go through a buffer, which is filled from STREAM either
+   directly or through an in-process decompressor.  */
+
+struct ghw_reader
+{
+  enum ghw_stream_kind kind;
+
+  /* Buffered data: BUF[POS..LEN) has not been read yet.  */
+  unsigned char buf[GHW_BUF_SIZE];
+  size_t pos;
+  size_t len;
+  /* Offset of BUF[0] in the uncompressed file.  */
+  int64_t offset;
+  /* Set when the end of the file has been reached.  */
+  int eof;
+
+  /* Compressed input and decompressor state.  */
+  unsigned char in[GHW_BUF_SIZE];
+  /* Number of compressed streams fully decoded (gzip and bzip2 files may
+     be concatenations of several streams).  */
+  int nbr_members;
+  union
+  {
+    z_stream z;
+    bz_stream bz;
+  } u;
+};
 
 static int
-ghw_openz (struct ghw_handler *h, const char *decomp, const char *filename)
+ghw_reader_start (struct ghw_reader *r)
 {
-  int plen = strlen (decomp) + 1 + strlen (filename) + 1;
-  char *p = malloc_unwrap (plen);
+  memset (&r->u, 0, sizeof (r->u));
+  r->pos = 0;
+  r->len = 0;
+  r->offset = 0;
+  r->eof = 0;
+  r->nbr_members = 0;
 
-  snprintf (p, plen, "%s %s", decomp, filename);
-  fclose (h->stream);
-  h->stream = popen (p, "r");
-  free (p);
+  switch (r->kind)
+    {
+    case ghw_stream_gzip:
+      /* 15 + 32: maximum window, gzip or zlib header detected.  */
+      return inflateInit2 (&r->u.z, 15 + 32) == Z_OK ? 0 : -1;
+    case ghw_stream_bzip2:
+      return BZ2_bzDecompressInit (&r->u.bz, 0, 0) == BZ_OK ? 0 : -1;
+    default:
+      return 0;
+    }
+}
 
-  if (h->stream == NULL)
+static void
+ghw_reader_stop (struct ghw_reader *r)
+{
+  switch (r->kind)
+    {
+    case ghw_stream_gzip:
+      inflateEnd (&r->u.z);
+      break;
+    case ghw_stream_bzip2:
+      BZ2_bzDecompressEnd (&r->u.bz);
+      break;
+    default:
+      break;
+    }
+}
+
+/* Decompress into DST (of SIZE bytes) from the gzip stream.
+   Return the number of bytes written, 0 at end of file or in case of
+   error.  */
+
+static size_t
+ghw_reader_inflate (struct ghw_handler *h, unsigned char *dst, size_t size)
+{
+  struct ghw_reader *r = h->reader;
+  z_stream *z = &r->u.z;
+
+  z->next_out = dst;
+  z->avail_out = size;
+  while (z->avail_out == size)
+    {
+      int res;
+
+      if (z->avail_in == 0)
+	{
+	  z->next_in = r->in;
+	  z->avail_in = fread (r->in, 1, sizeof (r->in), h->stream);
+	  if (z->avail_in == 0)
+	    {
+	      r->eof = feof (h->stream);
+	      break;
+	    }
+	}
+
+      res = inflate (z, Z_NO_FLUSH);
+      if (res == Z_STREAM_END)
+	{
+	  r->nbr_members++;
+	  inflateReset (z);
+	}
+      else if (res != Z_OK)
+	{
+	  /* Like gzip, ignore trailing garbage.  */
+	  r->eof = res == Z_DATA_ERROR && r->nbr_members > 0;
+	  break;
+	}
+    }
+  return size - z->avail_out;
+}
+
+/* Likewise for bzip2.  */
+
+static size_t
+ghw_reader_bunzip (struct ghw_handler *h, unsigned char *dst, size_t size)
+{
+  struct ghw_reader *r = h->reader;
+  bz_stream *bz = &r->u.bz;
+
+  bz->next_out = (char *) dst;
+  bz->avail_out = size;
+  while (bz->avail_out == size)
+    {
+      int res;
+
+      if (bz->avail_in == 0)
+	{
+	  bz->next_in = (char *) r->in;
+	  bz->avail_in = fread (r->in, 1, sizeof (r->in), h->stream);
+	  if (bz->avail_in == 0)
+	    {
+	      r->eof = feof (h->stream);
+	      break;
+	    }
+	}
+
+      res = BZ2_bzDecompress (bz);
+      if (res == BZ_STREAM_END)
+	{
+	  /* Restart the decompressor for the next stream, if any.  */
+	  r->nbr_members++;
+	  BZ2_bzDecompressEnd (bz);
+	  if (BZ2_bzDecompressInit (bz, 0, 0) != BZ_OK)
+	    break;
+	}
+      else if (res != BZ_OK)
+	{
+	  r->eof = res == BZ_DATA_ERROR_MAGIC && r->nbr_members > 0;
+	  break;
+	}
+    }
+  return size - bz->avail_out;
+}
+
+/* Refill the buffer, which must be empty.
+   Return the number of bytes now available.  */
+
+static size_t
+ghw_reader_fill (struct ghw_handler *h)
+{
+  struct ghw_reader *r = h->reader;
+
+  r->offset += r->len;
+  r->pos = 0;
+
+  switch (r->kind)
+    {
+    case ghw_stream_gzip:
+      r->len = ghw_reader_inflate (h, r->buf, sizeof (r->buf));
+      break;
+    case ghw_stream_bzip2:
+      r->len = ghw_reader_bunzip (h, r->buf, sizeof (r->buf));
+      break;
+    default:
+      r->len = fread (r->buf, 1, sizeof (r->buf), h->stream);
+      if (r->len == 0)
+	r->eof = feof (h->stream);
+      break;
+    }
+  return r->len;
+}
+
+static inline int
+ghw_getc (struct ghw_handler *h)
+{
+  struct ghw_reader *r = h->reader;
+
+  if (r->pos == r->len && ghw_reader_fill (h) == 0)
+    return EOF;
+  return r->buf[r->pos++];
+}
+
+/* Read exactly LEN bytes into PTR.  Return < 0 in case of error or at end
+   of file.  */
+
+static int
+ghw_read_bytes (struct ghw_handler *h, void *ptr, size_t len)
+{
+  struct ghw_reader *r = h->reader;
+  unsigned char *dst = ptr;
+
+  while (len > 0)
+    {
+      size_t n;
+
+      if (r->pos == r->len && ghw_reader_fill (h) == 0)
+	return -1;
+      n = r->len - r->pos;
+      if (n > len)
+	n = len;
+      memcpy (dst, r->buf + r->pos, n);
+      r->pos += n;
+      dst += n;
+      len -= n;
+    }
+  return 0;
+}
+
+/* True if the last failed read was due to the end of the file.  */
+
+static int
+ghw_eof (struct ghw_handler *h)
+{
+  return h->reader->eof;
+}
+
+int64_t
+ghw_tell (struct ghw_handler *h)
+{
+  return h->reader->offset + h->reader->pos;
+}
+
+int
+ghw_seek (struct ghw_handler *h, int64_t offset)
+{
+  struct ghw_reader *r = h->reader;
+
+  if (offset < 0)
     return -1;
 
-  h->stream_ispipe = 1;
+  /* Still in the buffer.  */
+  if (offset >= r->offset && offset <= r->offset + (int64_t) r->len)
+    {
+      r->pos = offset - r->offset;
+      return 0;
+    }
 
+  if (r->kind == ghw_stream_raw)
+    {
+      if (fseeko (h->stream, offset, SEEK_SET) != 0)
+	return -1;
+      r->offset = offset;
+      r->pos = 0;
+      r->len = 0;
+      r->eof = 0;
+      return 0;
+    }
+
+  /* A compressed file can only be decoded forward: restart from the
+     beginning to go backward.  */
+  if (offset < r->offset)
+    {
+      if (fseeko (h->stream, 0, SEEK_SET) != 0)
+	return -1;
+      ghw_reader_stop (r);
+      if (ghw_reader_start (r) < 0)
+	return -1;
+    }
+  while (offset > r->offset + (int64_t) r->len)
+    {
+      r->pos = r->len;
+      if (ghw_reader_fill (h) == 0)
+	return -1;
+    }
+  r->pos = offset - r->offset;
   return 0;
 }
 
@@ -94,32 +362,33 @@ ghw_open (struct ghw_handler *h, const char *filename)
     handler then this avoids segfault later on
    */
   h->no_null_sig_cache = NULL;
+  h->reader = NULL;
 
   h->stream = fopen (filename, "rb");
   if (h->stream == NULL)
     return -1;
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  h->reader = malloc_unwrap (sizeof (struct ghw_reader));
+  h->reader->kind = ghw_stream_raw;
+  ghw_reader_start (h->reader);
+
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     return -1;
 
-  /* Check compression layer.  */
+  /* Check compression layer, which is decoded in-process.  */
   if (!memcmp (hdr, "\x1f\x8b", 2))
-    {
-      if (ghw_openz (h, "gzip -cd", filename) < 0)
-	return -1;
-      if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
-	return -1;
-    }
+    h->reader->kind = ghw_stream_gzip;
   else if (!memcmp (hdr, "BZ", 2))
+    h->reader->kind = ghw_stream_bzip2;
+
+  if (h->reader->kind != ghw_stream_raw)
     {
-      if (ghw_openz (h, "bzip2 -cd", filename) < 0)
+      if (fseeko (h->stream, 0, SEEK_SET) != 0)
 	return -1;
-      if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+      if (ghw_reader_start (h->reader) < 0)
+	return -1;
+      if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
 	return -1;
-    }
-  else
-    {
-      h->stream_ispipe = 0;
     }
 
   /* Check magic.  */
@@ -213,7 +482,7 @@ ghw_read_byte (struct ghw_handler *h, unsigned char *res)
 {
   int v;
 
-  v = fgetc (h->stream);
+  v = ghw_getc (h);
   if (v == EOF)
     return -1;
   *res = v;
@@ -228,7 +497,7 @@ ghw_read_uleb128 (struct ghw_handler *h, uint32_t * res)
 
   while (1)
     {
-      int v = fgetc (h->stream);
+      int v = ghw_getc (h);
       if (v == EOF)
 	return -1;
       r |= (v & 0x7f) << off;
@@ -248,7 +517,7 @@ ghw_read_sleb128 (struct ghw_handler *h, int32_t * res)
 
   while (1)
     {
-      int v = fgetc (h->stream);
+      int v = ghw_getc (h);
       if (v == EOF)
 	return -1;
       r |= ((int32_t) (v & 0x7f)) << off;
@@ -273,7 +542,7 @@ ghw_read_lsleb128 (struct ghw_handler *h, int64_t * res)
 
   while (1)
     {
-      int v = fgetc (h->stream);
+      int v = ghw_getc (h);
       if (v == EOF)
 	return -1;
       r |= ((int64_t) (v & 0x7f)) << off;
@@ -293,7 +562,7 @@ int
 ghw_read_f64 (struct ghw_handler *h, double *res)
 {
   /* FIXME: handle byte order.  */
-  if (fread (res, sizeof (*res), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, res, sizeof (*res)) < 0)
     return -1;
   return 0;
 }
@@ -349,7 +618,7 @@ ghw_read_typeid (struct ghw_handler *h)
 union ghw_range *
 ghw_read_range (struct ghw_handler *h)
 {
-  int t = fgetc (h->stream);
+  int t = ghw_getc (h);
   if (t == EOF)
     ghw_error_exit();
   switch (t & 0x7f)
@@ -445,7 +714,7 @@ ghw_read_str (struct ghw_handler *h)
   char *p;
   int prev_len;
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     return -1;
 
   if (hdr[0] != 0 || hdr[1] != 0 || hdr[2] != 0 || hdr[3] != 0)
@@ -491,7 +760,7 @@ ghw_read_str (struct ghw_handler *h)
 
       while (1)
 	{
-	  c = fgetc (h->stream);
+	  c = ghw_getc (h);
 	  if (c == EOF)
 	    return -1;
 	  if ((c >= 0 && c <= 31) || (c >= 128 && c <= 159))
@@ -510,14 +779,14 @@ ghw_read_str (struct ghw_handler *h)
       sh = 5;
       while (c >= 128)
 	{
-	  c = fgetc (h->stream);
+	  c = ghw_getc (h);
 	  if (c == EOF)
 	    return -1;
 	  prev_len |= (c & 0x1f) << sh;
 	  sh += 5;
 	}
     }
-  if (fread (hdr, 4, 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, 4) < 0)
     return -1;
   if (memcmp (hdr, "EOS", 4) != 0)
     return -1;
@@ -746,7 +1015,7 @@ ghw_read_type (struct ghw_handler *h)
   unsigned char hdr[8];
   uint32_t i;
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     return -1;
 
   if (hdr[0] != 0 || hdr[1] != 0 || hdr[2] != 0 || hdr[3] != 0)
@@ -761,7 +1030,7 @@ ghw_read_type (struct ghw_handler *h)
     {
       int t;
 
-      t = fgetc (h->stream);
+      t = ghw_getc (h);
       if (t == EOF)
 	return -1;
       if (h->flag_verbose > 1)
@@ -1001,7 +1270,7 @@ ghw_read_type (struct ghw_handler *h)
 	  return -1;
 	}
     }
-  if (fgetc (h->stream) != 0)
+  if (ghw_getc (h) != 0)
     return -1;
   return 0;
 }
@@ -1011,7 +1280,7 @@ ghw_read_wk_types (struct ghw_handler *h)
 {
   char hdr[4];
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     return -1;
 
   if (hdr[0] != 0 || hdr[1] != 0 || hdr[2] != 0 || hdr[3] != 0)
@@ -1022,7 +1291,7 @@ ghw_read_wk_types (struct ghw_handler *h)
       int t;
       union ghw_type *tid;
 
-      t = fgetc (h->stream);
+      t = ghw_getc (h);
       if (t == EOF)
 	return -1;
       else if (t == 0)
@@ -1130,7 +1399,7 @@ ghw_read_value (struct ghw_handler *h,
     case ghdl_rtik_type_b2:
       {
 	int v;
-	v = fgetc (h->stream);
+	v = ghw_getc (h);
 	if (v == EOF)
 	  return -1;
 	val->b2 = v;
@@ -1139,7 +1408,7 @@ ghw_read_value (struct ghw_handler *h,
     case ghdl_rtik_type_e8:
       {
 	int v;
-	v = fgetc (h->stream);
+	v = ghw_getc (h);
 	if (v == EOF)
 	  return -1;
 	val->e8 = v;
@@ -1188,7 +1457,7 @@ ghw_read_hie (struct ghw_handler *h)
   struct ghw_hie *blk;
   struct ghw_hie **last;
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     return -1;
 
   if (hdr[0] != 0 || hdr[1] != 0 || hdr[2] != 0 || hdr[3] != 0)
@@ -1225,7 +1494,7 @@ ghw_read_hie (struct ghw_handler *h)
       struct ghw_hie *el;
       unsigned int str;
 
-      t = fgetc (h->stream);
+      t = ghw_getc (h);
       if (t == EOF)
 	return -1;
       if (t == 0)
@@ -1551,7 +1820,7 @@ ghw_read_base (struct ghw_handler *h)
 
   while (1)
     {
-      if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+      if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
 	return -1;
       if (memcmp (hdr, "STR", 4) == 0)
 	res = ghw_read_str (h);
@@ -1591,7 +1860,7 @@ ghw_read_snapshot (struct ghw_handler *h)
   unsigned i;
   struct ghw_sig *s;
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     return -1;
 
   if (hdr[0] != 0 || hdr[1] != 0 || hdr[2] != 0 || hdr[3] != 0)
@@ -1611,7 +1880,7 @@ ghw_read_snapshot (struct ghw_handler *h)
 	    return -1;
 	}
     }
-  if (fread (hdr, 4, 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, 4) < 0)
     return -1;
 
   if (memcmp (hdr, "ESN", 4))
@@ -1627,7 +1896,7 @@ ghw_read_cycle_start (struct ghw_handler *h)
 {
   unsigned char hdr[8];
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     return -1;
 
   h->snap_time = ghw_get_i64 (h, hdr);
@@ -1723,7 +1992,7 @@ ghw_read_cycle_end (struct ghw_handler *h)
 {
   char hdr[4];
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     return -1;
   if (memcmp (hdr, "ECY", 4))
     return -1;
@@ -1884,7 +2153,7 @@ ghw_read_directory (struct ghw_handler *h)
   int nbr_entries;
   int i;
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     return -1;
 
   nbr_entries = ghw_get_i32 (h, &hdr[4]);
@@ -1897,7 +2166,7 @@ ghw_read_directory (struct ghw_handler *h)
       unsigned char ent[8];
       int pos;
 
-      if (fread (ent, sizeof (ent), 1, h->stream) != 1)
+      if (ghw_read_bytes (h, ent, sizeof (ent)) < 0)
 	return -1;
 
       pos = ghw_get_i32 (h, &ent[4]);
@@ -1905,7 +2174,7 @@ ghw_read_directory (struct ghw_handler *h)
 	printf (" %s at %d\n", ent, pos);
     }
 
-  if (fread (hdr, 4, 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, 4) < 0)
     return -1;
   if (memcmp (hdr, "EOD", 4))
     return -1;
@@ -1918,7 +2187,7 @@ ghw_read_tailer (struct ghw_handler *h)
   unsigned char hdr[8];
   int pos;
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     return -1;
 
   pos = ghw_get_i32 (h, &hdr[4]);
@@ -1934,9 +2203,9 @@ ghw_read_sm_hdr (struct ghw_handler *h, int *list)
   unsigned char hdr[4];
   int res;
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     {
-      if (feof (h->stream))
+      if (ghw_eof (h))
 	return ghw_res_eof;
       else
 	return ghw_res_error;
@@ -2067,9 +2336,9 @@ ghw_read_dump (struct ghw_handler *h)
 
   while (1)
     {
-      if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+      if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
 	{
-	  if (feof (h->stream))
+	  if (ghw_eof (h))
 	    return 0;
 	  else
 	    return -1;
@@ -2121,9 +2390,9 @@ ghw_read_section (struct ghw_handler *h)
   unsigned char hdr[4];
   unsigned i;
 
-  if (fread (hdr, sizeof (hdr), 1, h->stream) != 1)
+  if (ghw_read_bytes (h, hdr, sizeof (hdr)) < 0)
     {
-      if (feof (h->stream))
+      if (ghw_eof (h))
 	return -2;
       else
 	return -1;
@@ -2141,13 +2410,16 @@ ghw_read_section (struct ghw_handler *h)
 void
 ghw_close (struct ghw_handler *h)
 {
-  if (h->stream)
+  if (h->reader)
     {
-      if (h->stream_ispipe)
-	pclose (h->stream);
-      else
-	fclose (h->stream);
+      ghw_reader_stop (h->reader);
+      free (h->reader);
+      h->reader = NULL;
+    }
 
+  if (h->stream)
+    {
+      fclose (h->stream);
       h->stream = NULL;
     }
 
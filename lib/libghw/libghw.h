@@ -350,11 +350,13 @@ struct ghw_hie
   } u;
 };
 
+struct ghw_reader;
+
 struct ghw_handler
 {
   FILE *stream;
-  /* True if STREAM was popen, else was fopen.  */
-  unsigned char stream_ispipe;
+  /* Buffered (and possibly decompressing) reader on top of STREAM.  */
+  struct ghw_reader *reader;
   /* True if words are big-endian.  */
   unsigned char word_be;
   unsigned char word_len;
@@ -404,6 +406,13 @@ struct ghw_handler
    Return < 0 in case of error. */
 int ghw_open (struct ghw_handler *h, const char *filename);
 
+/* Return the offset of the next byte to be read in the (uncompressed) file.  */
+int64_t ghw_tell (struct ghw_handler *h);
+
+/* Move to OFFSET (as returned by ghw_tell) in the (uncompressed) file.
+   Return < 0 in case of error.  */
+int ghw_seek (struct ghw_handler *h, int64_t offset);
+
 /* Return base type of T.  */
 union ghw_type *ghw_get_base_type (union ghw_type *t);
 
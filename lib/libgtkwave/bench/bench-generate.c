@@ -0,0 +1,777 @@
+#include <glib.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstapi.h>
+
+// Writes reproducible synthetic dump files for the benchmarks. The same
+// profile always produces the same value changes, independent of the format.
+
+typedef enum
+{
+    BENCH_VAR_BIT,
+    BENCH_VAR_VECTOR,
+    BENCH_VAR_REAL,
+    BENCH_VAR_STRING,
+} BenchVarKind;
+
+typedef struct
+{
+    const gchar *name;
+    const gchar *var_prefix;
+    BenchVarKind kind;
+    guint n_vars;
+    guint vars_per_scope;
+    guint width;
+    guint steps;
+    guint activity; // each var changes with a probability of 1/activity per step
+} BenchProfile;
+
+// clang-format off
+static const BenchProfile profiles[] = {
+    {"many-signals", "s",   BENCH_VAR_BIT,    20000, 100, 1,   2000,   64},
+    {"wide-buses",   "bus", BENCH_VAR_VECTOR, 256,   16,  512, 2000,   4},
+    {"dense-clocks", "clk", BENCH_VAR_BIT,    64,    64,  1,   200000, 1},
+    {"reals",        "r",   BENCH_VAR_REAL,   1000,  50,  64,  5000,   8},
+    {"strings",      "str", BENCH_VAR_STRING, 500,   50,  0,   5000,   8},
+};
+// clang-format on
+
+#define BENCH_SEED 0x67747776
+
+typedef struct
+{
+    const BenchProfile *profile;
+    GRand *rand;
+    guint steps;
+    gchar **values; // bit, vector and string values
+    gdouble *reals;
+    guint *changed; // vars changed in the current step, ascending
+    guint n_changed;
+} BenchState;
+
+static void bench_state_randomize(BenchState *state, guint var)
+{
+    const BenchProfile *profile = state->profile;
+
+    switch (profile->kind) {
+        case BENCH_VAR_BIT:
+            if (profile->activity == 1) {
+                state->values[var][0] = state->values[var][0] == '0' ? '1' : '0';
+            } else {
+                state->values[var][0] = g_rand_boolean(state->rand) ? '1' : '0';
+            }
+            break;
+
+        case BENCH_VAR_VECTOR: {
+            gchar *value = state->values[var];
+            for (guint i = 0; i < profile->width; i += 32) {
+                guint32 r = g_rand_int(state->rand);
+                for (guint j = 0; j < 32 && i + j < profile->width; j++) {
+                    value[i + j] = (r >> j) & 1 ? '1' : '0';
+                }
+            }
+            // occasionally add unknown and high impedance bits
+            if (g_rand_int_range(state->rand, 0, 16) == 0) {
+                value[g_rand_int_range(state->rand, 0, profile->width)] = 'x';
+                value[g_rand_int_range(state->rand, 0, profile->width)] = 'z';
+            }
+            break;
+        }
+
+        case BENCH_VAR_REAL:
+            state->reals[var] = g_rand_double_range(state->rand, -1000.0, 1000.0);
+            break;
+
+        case BENCH_VAR_STRING:
+            g_free(state->values[var]);
+            state->values[var] =
+                g_strdup_printf("state_%d", g_rand_int_range(state->rand, 0, 64));
+            break;
+
+        default:
+            g_assert_not_reached();
+    }
+}
+
+static BenchState *bench_state_new(const BenchProfile *profile, gdouble steps_scale)
+{
+    BenchState *state = g_new0(BenchState, 1);
+    state->profile = profile;
+    state->rand = g_rand_new_with_seed(BENCH_SEED);
+    state->steps = MAX(1, (guint)(profile->steps * steps_scale));
+    state->values = g_new0(gchar *, profile->n_vars);
+    state->reals = g_new0(gdouble, profile->n_vars);
+    state->changed = g_new(guint, profile->n_vars);
+
+    for (guint i = 0; i < profile->n_vars; i++) {
+        if (profile->kind == BENCH_VAR_BIT || profile->kind == BENCH_VAR_VECTOR) {
+            state->values[i] = g_strnfill(profile->width, '0');
+        }
+        if (profile->activity > 1) {
+            bench_state_randomize(state, i);
+        }
+    }
+
+    return state;
+}
+
+static void bench_state_free(BenchState *state)
+{
+    for (guint i = 0; i < state->profile->n_vars; i++) {
+        g_free(state->values[i]);
+    }
+    g_free(state->values);
+    g_free(state->reals);
+    g_free(state->changed);
+    g_rand_free(state->rand);
+    g_free(state);
+}
+
+static void bench_state_step(BenchState *state)
+{
+    const BenchProfile *profile = state->profile;
+
+    state->n_changed = 0;
+    for (guint i = 0; i < profile->n_vars; i++) {
+        if (profile->activity == 1 || g_rand_int_range(state->rand, 0, profile->activity) == 0) {
+            bench_state_randomize(state, i);
+            state->changed[state->n_changed++] = i;
+        }
+    }
+}
+
+static gchar *bench_var_name(const BenchProfile *profile, guint var)
+{
+    return g_strdup_printf("%s%u", profile->var_prefix, var);
+}
+
+static gchar *bench_scope_name(guint scope)
+{
+    return g_strdup_printf("u%u", scope);
+}
+
+static guint bench_n_scopes(const BenchProfile *profile)
+{
+    return (profile->n_vars + profile->vars_per_scope - 1) / profile->vars_per_scope;
+}
+
+/* VCD */
+
+static void vcd_make_id(gchar *buf, guint value)
+{
+    gchar *p = buf;
+
+    do {
+        *p++ = '!' + value % 94;
+        value /= 94;
+    } while (value > 0);
+    *p = '\0';
+}
+
+static void vcd_write_value(FILE *f, BenchState *state, guint var, const gchar *id)
+{
+    switch (state->profile->kind) {
+        case BENCH_VAR_BIT:
+            fprintf(f, "%c%s\n", state->values[var][0], id);
+            break;
+
+        case BENCH_VAR_VECTOR:
+            fprintf(f, "b%s %s\n", state->values[var], id);
+            break;
+
+        case BENCH_VAR_REAL:
+            fprintf(f, "r%.16g %s\n", state->reals[var], id);
+            break;
+
+        case BENCH_VAR_STRING:
+            fprintf(f, "s%s %s\n", state->values[var], id);
+            break;
+
+        default:
+            g_assert_not_reached();
+    }
+}
+
+static gboolean write_vcd(BenchState *state, const gchar *filename, GError **error)
+{
+    const BenchProfile *profile = state->profile;
+
+    FILE *f = fopen(filename, "wb");
+    if (f == NULL) {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_FAILED, "Couldn't open %s", filename);
+        return FALSE;
+    }
+
+    gchar(*ids)[8] = g_malloc_n(profile->n_vars, sizeof(*ids));
+    for (guint i = 0; i < profile->n_vars; i++) {
+        vcd_make_id(ids[i], i);
+    }
+
+    const gchar *type = "wire";
+    if (profile->kind == BENCH_VAR_REAL) {
+        type = "real";
+    } else if (profile->kind == BENCH_VAR_STRING) {
+        type = "string";
+    }
+
+    fprintf(f, "$version bench-generate %s $end\n", profile->name);
+    fprintf(f, "$timescale 1ns $end\n");
+    fprintf(f, "$scope module top $end\n");
+    for (guint i = 0; i < profile->n_vars; i++) {
+        if (i % profile->vars_per_scope == 0) {
+            gchar *scope = bench_scope_name(i / profile->vars_per_scope);
+            fprintf(f, "$scope module %s $end\n", scope);
+            g_free(scope);
+        }
+
+        gchar *name = bench_var_name(profile, i);
+        if (profile->kind == BENCH_VAR_VECTOR) {
+            fprintf(f,
+                    "$var %s %u %s %s [%u:0] $end\n",
+                    type,
+                    profile->width,
+                    ids[i],
+                    name,
+                    profile->width - 1);
+        } else {
+            fprintf(f, "$var %s %u %s %s $end\n", type, MAX(profile->width, 1), ids[i], name);
+        }
+        g_free(name);
+
+        if ((i + 1) % profile->vars_per_scope == 0 || i + 1 == profile->n_vars) {
+            fprintf(f, "$upscope $end\n");
+        }
+    }
+    fprintf(f, "$upscope $end\n");
+    fprintf(f, "$enddefinitions $end\n");
+
+    fprintf(f, "#0\n$dumpvars\n");
+    for (guint i = 0; i < profile->n_vars; i++) {
+        vcd_write_value(f, state, i, ids[i]);
+    }
+    fprintf(f, "$end\n");
+
+    for (guint step = 1; step <= state->steps; step++) {
+        bench_state_step(state);
+
+        fprintf(f, "#%u\n", step);
+        for (guint i = 0; i < state->n_changed; i++) {
+            guint var = state->changed[i];
+            vcd_write_value(f, state, var, ids[var]);
+        }
+    }
+
+    g_free(ids);
+
+    if (fclose(f) != 0) {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_FAILED, "Couldn't write %s", filename);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* FST */
+
+static void fst_write_value(void *ctx, BenchState *state, guint var, fstHandle handle)
+{
+    switch (state->profile->kind) {
+        case BENCH_VAR_BIT:
+        case BENCH_VAR_VECTOR:
+            fstWriterEmitValueChange(ctx, handle, state->values[var]);
+            break;
+
+        case BENCH_VAR_REAL:
+            fstWriterEmitValueChange(ctx, handle, &state->reals[var]);
+            break;
+
+        case BENCH_VAR_STRING:
+            fstWriterEmitVariableLengthValueChange(ctx,
+                                                   handle,
+                                                   state->values[var],
+                                                   strlen(state->values[var]));
+            break;
+
+        default:
+            g_assert_not_reached();
+    }
+}
+
+static gboolean write_fst(BenchState *state, const gchar *filename, GError **error)
+{
+    const BenchProfile *profile = state->profile;
+
+    void *ctx = fstWriterCreate(filename, 1);
+    if (ctx == NULL) {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_FAILED, "Couldn't open %s", filename);
+        return FALSE;
+    }
+
+    fstWriterSetVersion(ctx, "bench-generate");
+    fstWriterSetTimescale(ctx, -9);
+
+    enum fstVarType type = FST_VT_VCD_WIRE;
+    guint32 len = profile->width;
+    if (profile->kind == BENCH_VAR_REAL) {
+        type = FST_VT_VCD_REAL;
+    } else if (profile->kind == BENCH_VAR_STRING) {
+        type = FST_VT_GEN_STRING;
+    }
+
+    fstHandle *handles = g_new(fstHandle, profile->n_vars);
+
+    fstWriterSetScope(ctx, FST_ST_VCD_MODULE, "top", NULL);
+    for (guint i = 0; i < profile->n_vars; i++) {
+        if (i % profile->vars_per_scope == 0) {
+            gchar *scope = bench_scope_name(i / profile->vars_per_scope);
+            fstWriterSetScope(ctx, FST_ST_VCD_MODULE, scope, NULL);
+            g_free(scope);
+        }
+
+        gchar *name = bench_var_name(profile, i);
+        if (profile->kind == BENCH_VAR_VECTOR) {
+            gchar *full_name = g_strdup_printf("%s [%u:0]", name, profile->width - 1);
+            handles[i] = fstWriterCreateVar(ctx, type, FST_VD_IMPLICIT, len, full_name, 0);
+            g_free(full_name);
+        } else {
+            handles[i] = fstWriterCreateVar(ctx, type, FST_VD_IMPLICIT, len, name, 0);
+        }
+        g_free(name);
+
+        if ((i + 1) % profile->vars_per_scope == 0 || i + 1 == profile->n_vars) {
+            fstWriterSetUpscope(ctx);
+        }
+    }
+    fstWriterSetUpscope(ctx);
+
+    fstWriterEmitTimeChange(ctx, 0);
+    for (guint i = 0; i < profile->n_vars; i++) {
+        fst_write_value(ctx, state, i, handles[i]);
+    }
+
+    for (guint step = 1; step <= state->steps; step++) {
+        bench_state_step(state);
+
+        fstWriterEmitTimeChange(ctx, step);
+        for (guint i = 0; i < state->n_changed; i++) {
+            guint var = state->changed[i];
+            fst_write_value(ctx, state, var, handles[var]);
+        }
+    }
+
+    fstWriterClose(ctx);
+    g_free(handles);
+
+    return TRUE;
+}
+
+/* GHW */
+
+enum
+{
+    GHW_STR_STD_ULOGIC = 1,
+    GHW_STR_LITERALS,
+    GHW_STR_INTEGER = GHW_STR_LITERALS + 9,
+    GHW_STR_STD_ULOGIC_VECTOR,
+    GHW_STR_REAL,
+    GHW_STR_TOP,
+    GHW_STR_FIRST_SCOPE,
+};
+
+enum
+{
+    GHW_TYPE_STD_ULOGIC = 1,
+    GHW_TYPE_INTEGER,
+    GHW_TYPE_STD_ULOGIC_VECTOR,
+    GHW_TYPE_REAL_BASE,
+    GHW_TYPE_REAL,
+    GHW_TYPE_VECTOR_SUBTYPE,
+    GHW_N_TYPES = GHW_TYPE_VECTOR_SUBTYPE,
+};
+
+// type kinds, hierarchy kinds and well known types from libghw.h
+#define GHW_RTIK_TYPE_E8 23
+#define GHW_RTIK_TYPE_I32 25
+#define GHW_RTIK_TYPE_F64 27
+#define GHW_RTIK_TYPE_ARRAY 31
+#define GHW_RTIK_SUBTYPE_SCALAR 34
+#define GHW_RTIK_SUBTYPE_ARRAY 35
+#define GHW_HIE_INSTANCE 6
+#define GHW_HIE_EOS 15
+#define GHW_HIE_SIGNAL 16
+#define GHW_WKT_STD_ULOGIC 3
+
+static const gchar *ghw_std_ulogic_literals[] =
+    {"'U'", "'X'", "'0'", "'1'", "'Z'", "'W'", "'L'", "'H'", "'-'"};
+
+static void ghw_put_uleb128(GString *out, guint32 value)
+{
+    do {
+        guchar b = value & 0x7f;
+        value >>= 7;
+        if (value != 0) {
+            b |= 0x80;
+        }
+        g_string_append_c(out, b);
+    } while (value != 0);
+}
+
+static void ghw_put_sleb128(GString *out, gint64 value)
+{
+    while (TRUE) {
+        guchar b = value & 0x7f;
+        value >>= 7;
+        if ((value == 0 && !(b & 0x40)) || (value == -1 && (b & 0x40))) {
+            g_string_append_c(out, b);
+            break;
+        }
+        g_string_append_c(out, b | 0x80);
+    }
+}
+
+static void ghw_put_i32(GString *out, gint32 value)
+{
+    guint32 v = value;
+
+    for (gint i = 0; i < 4; i++) {
+        g_string_append_c(out, (v >> (8 * i)) & 0xff);
+    }
+}
+
+static void ghw_put_i64(GString *out, gint64 value)
+{
+    guint64 v = value;
+
+    for (gint i = 0; i < 8; i++) {
+        g_string_append_c(out, (v >> (8 * i)) & 0xff);
+    }
+}
+
+static void ghw_put_f64(GString *out, gdouble value)
+{
+    // libghw reads doubles in host byte order
+    g_string_append_len(out, (const gchar *)&value, sizeof(value));
+}
+
+static void ghw_put_section(GString *out, const gchar *name)
+{
+    g_string_append_len(out, name, 4);
+}
+
+static guchar ghw_std_ulogic_value(gchar c)
+{
+    switch (c) {
+        case '0':
+            return 2;
+        case '1':
+            return 3;
+        case 'z':
+            return 4;
+        default:
+            return 1;
+    }
+}
+
+static guint ghw_elements_per_var(const BenchProfile *profile)
+{
+    return profile->kind == BENCH_VAR_VECTOR ? profile->width : 1;
+}
+
+static void ghw_put_element(GString *out, BenchState *state, guint var, guint bit)
+{
+    if (state->profile->kind == BENCH_VAR_REAL) {
+        ghw_put_f64(out, state->reals[var]);
+    } else {
+        g_string_append_c(out, ghw_std_ulogic_value(state->values[var][bit]));
+    }
+}
+
+static gboolean ghw_flush(FILE *f, GString *out)
+{
+    gboolean ok = fwrite(out->str, 1, out->len, f) == out->len;
+
+    g_string_truncate(out, 0);
+
+    return ok;
+}
+
+static gboolean write_ghw(BenchState *state, const gchar *filename, GError **error)
+{
+    const BenchProfile *profile = state->profile;
+
+    if (profile->kind == BENCH_VAR_STRING) {
+        g_set_error(error,
+                    G_FILE_ERROR,
+                    G_FILE_ERROR_INVAL,
+                    "GHW files don't support the %s profile",
+                    profile->name);
+        return FALSE;
+    }
+
+    FILE *f = fopen(filename, "wb");
+    if (f == NULL) {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_FAILED, "Couldn't open %s", filename);
+        return FALSE;
+    }
+
+    guint n_scopes = bench_n_scopes(profile);
+    guint per_var = ghw_elements_per_var(profile);
+    guint n_elements = profile->n_vars * per_var;
+    guint first_var_str = GHW_STR_FIRST_SCOPE + n_scopes;
+
+    GString *out = g_string_sized_new(1024 * 1024);
+
+    // header: magic, version 1, little endian, word and offset length
+    g_string_append_len(out, "GHDLwave\n\x10\x00\x01\x01\x04\x08\x00", 16);
+
+    GPtrArray *strings = g_ptr_array_new_with_free_func(g_free);
+    g_ptr_array_add(strings, g_strdup("std_ulogic"));
+    for (guint i = 0; i < G_N_ELEMENTS(ghw_std_ulogic_literals); i++) {
+        g_ptr_array_add(strings, g_strdup(ghw_std_ulogic_literals[i]));
+    }
+    g_ptr_array_add(strings, g_strdup("integer"));
+    g_ptr_array_add(strings, g_strdup("std_ulogic_vector"));
+    g_ptr_array_add(strings, g_strdup("real"));
+    g_ptr_array_add(strings, g_strdup("top"));
+    for (guint i = 0; i < n_scopes; i++) {
+        g_ptr_array_add(strings, bench_scope_name(i));
+    }
+    for (guint i = 0; i < profile->n_vars; i++) {
+        g_ptr_array_add(strings, bench_var_name(profile, i));
+    }
+
+    gsize str_size = 0;
+    for (guint i = 0; i < strings->len; i++) {
+        str_size += strlen(g_ptr_array_index(strings, i));
+    }
+
+    ghw_put_section(out, "STR");
+    ghw_put_i32(out, 0);
+    ghw_put_i32(out, strings->len);
+    ghw_put_i32(out, str_size);
+    for (guint i = 0; i < strings->len; i++) {
+        // strings are stored without a shared prefix
+        g_string_append(out, g_ptr_array_index(strings, i));
+        g_string_append_c(out, 0);
+    }
+    ghw_put_section(out, "EOS");
+    g_ptr_array_free(strings, TRUE);
+
+    ghw_put_section(out, "TYP");
+    ghw_put_i32(out, 0);
+    ghw_put_i32(out, GHW_N_TYPES);
+    g_string_append_c(out, GHW_RTIK_TYPE_E8);
+    ghw_put_uleb128(out, GHW_STR_STD_ULOGIC);
+    ghw_put_uleb128(out, G_N_ELEMENTS(ghw_std_ulogic_literals));
+    for (guint i = 0; i < G_N_ELEMENTS(ghw_std_ulogic_literals); i++) {
+        ghw_put_uleb128(out, GHW_STR_LITERALS + i);
+    }
+    g_string_append_c(out, GHW_RTIK_TYPE_I32);
+    ghw_put_uleb128(out, GHW_STR_INTEGER);
+    g_string_append_c(out, GHW_RTIK_TYPE_ARRAY);
+    ghw_put_uleb128(out, GHW_STR_STD_ULOGIC_VECTOR);
+    ghw_put_uleb128(out, GHW_TYPE_STD_ULOGIC);
+    ghw_put_uleb128(out, 1);
+    ghw_put_uleb128(out, GHW_TYPE_INTEGER);
+    g_string_append_c(out, GHW_RTIK_TYPE_F64);
+    ghw_put_uleb128(out, GHW_STR_REAL);
+    g_string_append_c(out, GHW_RTIK_SUBTYPE_SCALAR);
+    ghw_put_uleb128(out, GHW_STR_REAL);
+    ghw_put_uleb128(out, GHW_TYPE_REAL_BASE);
+    g_string_append_c(out, GHW_RTIK_TYPE_F64);
+    ghw_put_f64(out, -DBL_MAX);
+    ghw_put_f64(out, DBL_MAX);
+    g_string_append_c(out, GHW_RTIK_SUBTYPE_ARRAY);
+    ghw_put_uleb128(out, 0);
+    ghw_put_uleb128(out, GHW_TYPE_STD_ULOGIC_VECTOR);
+    g_string_append_c(out, GHW_RTIK_TYPE_I32 | 0x80); // downto
+    ghw_put_sleb128(out, (gint64)MAX(profile->width, 1) - 1);
+    ghw_put_sleb128(out, 0);
+    g_string_append_c(out, 0);
+
+    ghw_put_section(out, "WKT");
+    ghw_put_i32(out, 0);
+    g_string_append_c(out, GHW_WKT_STD_ULOGIC);
+    ghw_put_uleb128(out, GHW_TYPE_STD_ULOGIC);
+    g_string_append_c(out, 0);
+
+    guint32 sig_type = GHW_TYPE_STD_ULOGIC;
+    if (profile->kind == BENCH_VAR_VECTOR) {
+        sig_type = GHW_TYPE_VECTOR_SUBTYPE;
+    } else if (profile->kind == BENCH_VAR_REAL) {
+        sig_type = GHW_TYPE_REAL;
+    }
+
+    ghw_put_section(out, "HIE");
+    ghw_put_i32(out, 0);
+    ghw_put_i32(out, n_scopes + 1);
+    ghw_put_i32(out, profile->n_vars);
+    ghw_put_i32(out, n_elements);
+    g_string_append_c(out, GHW_HIE_INSTANCE);
+    ghw_put_uleb128(out, GHW_STR_TOP);
+    for (guint i = 0; i < profile->n_vars; i++) {
+        if (i % profile->vars_per_scope == 0) {
+            g_string_append_c(out, GHW_HIE_INSTANCE);
+            ghw_put_uleb128(out, GHW_STR_FIRST_SCOPE + i / profile->vars_per_scope);
+        }
+
+        g_string_append_c(out, GHW_HIE_SIGNAL);
+        ghw_put_uleb128(out, first_var_str + i);
+        ghw_put_uleb128(out, sig_type);
+        for (guint j = 0; j < per_var; j++) {
+            // signal elements are numbered from 1
+            ghw_put_uleb128(out, i * per_var + j + 1);
+        }
+
+        if ((i + 1) % profile->vars_per_scope == 0 || i + 1 == profile->n_vars) {
+            g_string_append_c(out, GHW_HIE_EOS);
+        }
+    }
+    g_string_append_c(out, GHW_HIE_EOS);
+    g_string_append_c(out, 0);
+    ghw_put_section(out, "EOH");
+
+    ghw_put_section(out, "SNP");
+    ghw_put_i32(out, 0);
+    ghw_put_i64(out, 0);
+    for (guint i = 0; i < profile->n_vars; i++) {
+        for (guint j = 0; j < per_var; j++) {
+            ghw_put_element(out, state, i, j);
+        }
+    }
+    ghw_put_section(out, "ESN");
+
+    // the previous values are needed to only write the bits that changed
+    gchar *previous = g_new(gchar, n_elements);
+    if (profile->kind != BENCH_VAR_REAL) {
+        for (guint i = 0; i < profile->n_vars; i++) {
+            memcpy(previous + i * per_var, state->values[i], per_var);
+        }
+    }
+
+    gboolean ok = ghw_flush(f, out);
+
+    // times are stored in femtoseconds
+    const gint64 step_time = 1000000;
+
+    for (guint step = 1; step <= state->steps && ok; step++) {
+        bench_state_step(state);
+
+        if (step == 1) {
+            ghw_put_section(out, "CYC");
+            ghw_put_i64(out, step_time);
+        } else {
+            ghw_put_sleb128(out, step_time);
+        }
+
+        guint last_element = 0;
+        for (guint i = 0; i < state->n_changed; i++) {
+            guint var = state->changed[i];
+
+            for (guint j = 0; j < per_var; j++) {
+                guint element = var * per_var + j;
+
+                if (profile->kind != BENCH_VAR_REAL) {
+                    if (previous[element] == state->values[var][j]) {
+                        continue;
+                    }
+                    previous[element] = state->values[var][j];
+                }
+
+                ghw_put_uleb128(out, element + 1 - last_element);
+                ghw_put_element(out, state, var, j);
+                last_element = element + 1;
+            }
+        }
+        ghw_put_uleb128(out, 0);
+
+        if (out->len >= 1024 * 1024) {
+            ok = ghw_flush(f, out);
+        }
+    }
+
+    if (state->steps > 0) {
+        ghw_put_sleb128(out, -1);
+        ghw_put_section(out, "ECY");
+    }
+
+    ok = ok && ghw_flush(f, out);
+    ok = fclose(f) == 0 && ok;
+
+    g_free(previous);
+    g_string_free(out, TRUE);
+
+    if (!ok) {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_FAILED, "Couldn't write %s", filename);
+    }
+
+    return ok;
+}
+
+static gdouble scale = 1.0;
+
+static GOptionEntry entries[] = {
+    {"scale", 's', 0, G_OPTION_ARG_DOUBLE, &scale, "Scale the number of time steps", "FACTOR"},
+    G_OPTION_ENTRY_NULL,
+};
+
+int main(int argc, char **argv)
+{
+    GError *error = NULL;
+    GOptionContext *context = g_option_context_new("PROFILE OUTPUT_FILE");
+    g_option_context_set_summary(context,
+                                 "Writes a synthetic VCD, FST or GHW file. The format is "
+                                 "selected by the file extension.\n\n"
+                                 "Profiles: many-signals, wide-buses, dense-clocks, reals, "
+                                 "strings");
+    g_option_context_add_main_entries(context, entries, NULL);
+
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        g_printerr("%s\n", error->message);
+        exit(EXIT_FAILURE);
+    }
+    g_option_context_free(context);
+
+    if (argc != 3 || scale <= 0.0) {
+        g_printerr("USAGE: %s [--scale FACTOR] PROFILE OUTPUT_FILE\n", g_get_prgname());
+        exit(EXIT_FAILURE);
+    }
+
+    const BenchProfile *profile = NULL;
+    for (guint i = 0; i < G_N_ELEMENTS(profiles); i++) {
+        if (g_strcmp0(profiles[i].name, argv[1]) == 0) {
+            profile = &profiles[i];
+        }
+    }
+    if (profile == NULL) {
+        g_printerr("Unknown profile: %s\n", argv[1]);
+        exit(EXIT_FAILURE);
+    }
+
+    const gchar *filename = argv[2];
+    BenchState *state = bench_state_new(profile, scale);
+    gboolean ok;
+
+    if (g_str_has_suffix(filename, ".vcd")) {
+        ok = write_vcd(state, filename, &error);
+    } else if (g_str_has_suffix(filename, ".fst")) {
+        ok = write_fst(state, filename, &error);
+    } else if (g_str_has_suffix(filename, ".ghw")) {
+        ok = write_ghw(state, filename, &error);
+    } else {
+        g_set_error(&error, G_FILE_ERROR, G_FILE_ERROR_INVAL, "Unknown file type: %s", filename);
+        ok = FALSE;
+    }
+
+    bench_state_free(state);
+
+    if (!ok) {
+        g_printerr("%s\n", error->message);
+        g_error_free(error);
+        exit(EXIT_FAILURE);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+#include <gtkwave.h>
+#include <glib/gstdio.h>
+#include "bench-util.h"
+
+static gint iterations = 1;
+
+static GOptionEntry entries[] = {
+    {"iterations", 'i', 0, G_OPTION_ARG_INT, &iterations, "Number of iterations", "N"},
+    G_OPTION_ENTRY_NULL,
+};
+
+static GwLoader *create_loader(const gchar *filename)
+{
+    if (g_str_has_suffix(filename, ".fst")) {
+        return gw_fst_loader_new();
+    } else if (g_str_has_suffix(filename, ".vcd")) {
+        return gw_vcd_loader_new();
+    } else if (g_str_has_suffix(filename, ".ghw")) {
+        return gw_ghw_loader_new();
+    } else if (g_str_has_suffix(filename, ".lxt2") || g_str_has_suffix(filename, ".lx2")) {
+        return gw_lxt2_loader_new();
+    } else if (g_str_has_suffix(filename, ".vzt")) {
+        return gw_vzt_loader_new();
+    }
+
+    g_error("Unknown filetype: %s", filename);
+}
+
+static guint64 count_value_changes(GwDumpFile *file)
+{
+    GwFacs *facs = gw_dump_file_get_facs(file);
+    guint64 count = 0;
+
+    for (guint i = 0; i < gw_facs_get_length(facs); i++) {
+        GwNode *node = gw_facs_get(facs, i)->n;
+
+        for (GwHistEnt *iter = node->head.next; iter != NULL; iter = iter->next) {
+            if (iter->time >= 0 && iter->time < GW_TIME_MAX - 1) {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    GError *error = NULL;
+    GOptionContext *context = g_option_context_new("DUMP_FILE");
+    g_option_context_set_summary(context,
+                                 "Measures loading and importing a dump file and prints the "
+                                 "results as JSON lines.");
+    g_option_context_add_main_entries(context, entries, NULL);
+
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        g_printerr("%s\n", error->message);
+        exit(EXIT_FAILURE);
+    }
+    g_option_context_free(context);
+
+    if (argc != 2 || iterations < 1) {
+        g_printerr("USAGE: %s [--iterations N] DUMP_FILE\n", g_get_prgname());
+        exit(EXIT_FAILURE);
+    }
+
+    const gchar *filename = argv[1];
+    gchar *basename = g_path_get_basename(filename);
+
+    GStatBuf st;
+    if (g_stat(filename, &st) != 0) {
+        g_error("Couldn't stat %s", filename);
+    }
+
+    BenchResult load = {
+        .name = "gw_loader_load",
+        .file = basename,
+        .iterations = iterations,
+        .seconds_min = G_MAXDOUBLE,
+        .bytes = st.st_size,
+    };
+    BenchResult import = {
+        .name = "gw_dump_file_import_all",
+        .file = basename,
+        .iterations = iterations,
+        .seconds_min = G_MAXDOUBLE,
+    };
+
+    GTimer *timer = g_timer_new();
+
+    for (gint i = 0; i < iterations; i++) {
+        GwLoader *loader = create_loader(filename);
+
+        g_timer_start(timer);
+        GwDumpFile *file = gw_loader_load(loader, filename, &error);
+        gdouble load_seconds = g_timer_elapsed(timer, NULL);
+
+        g_object_unref(loader);
+        if (file == NULL) {
+            g_error("Couldn't load dumpfile: %s", error->message);
+        }
+
+        g_timer_start(timer);
+        if (!gw_dump_file_import_all(file, &error)) {
+            g_error("Couldn't import traces: %s", error->message);
+        }
+        gdouble import_seconds = g_timer_elapsed(timer, NULL);
+
+        load.seconds += load_seconds;
+        load.seconds_min = MIN(load.seconds_min, load_seconds);
+        load.items = gw_facs_get_length(gw_dump_file_get_facs(file));
+
+        import.seconds += import_seconds;
+        import.seconds_min = MIN(import.seconds_min, import_seconds);
+        import.items = count_value_changes(file);
+
+        g_object_unref(file);
+    }
+
+    load.seconds /= iterations;
+    import.seconds /= iterations;
+
+    bench_report(&load);
+    bench_report(&import);
+
+    g_timer_destroy(timer);
+    g_free(basename);
+
+    return EXIT_SUCCESS;
+}
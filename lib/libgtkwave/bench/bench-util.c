@@ -0,0 +1,62 @@
+#include "bench-util.h"
+#include <stdio.h>
+
+static void append_json_string(GString *str, const gchar *value)
+{
+    g_string_append_c(str, '"');
+    for (const gchar *p = value; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') {
+            g_string_append_c(str, '\\');
+            g_string_append_c(str, *p);
+        } else if ((guchar)*p < 0x20) {
+            g_string_append_printf(str, "\\u%04x", (guchar)*p);
+        } else {
+            g_string_append_c(str, *p);
+        }
+    }
+    g_string_append_c(str, '"');
+}
+
+static void append_json_double(GString *str, gdouble value)
+{
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+    g_string_append(str, g_ascii_formatd(buf, sizeof(buf), "%.6f", value));
+}
+
+void bench_report(const BenchResult *result)
+{
+    GString *str = g_string_new("{\"name\": ");
+
+    append_json_string(str, result->name);
+    if (result->file != NULL) {
+        g_string_append(str, ", \"file\": ");
+        append_json_string(str, result->file);
+    }
+
+    g_string_append_printf(str, ", \"iterations\": %u, \"seconds\": ", result->iterations);
+    append_json_double(str, result->seconds);
+    g_string_append(str, ", \"seconds_min\": ");
+    append_json_double(str, result->seconds_min);
+
+    g_string_append_printf(str, ", \"items\": %" G_GUINT64_FORMAT, result->items);
+    if (result->seconds_min > 0.0) {
+        g_string_append(str, ", \"items_per_second\": ");
+        append_json_double(str, result->items / result->seconds_min);
+    }
+
+    if (result->bytes > 0) {
+        g_string_append_printf(str, ", \"bytes\": %" G_GUINT64_FORMAT, result->bytes);
+        if (result->seconds_min > 0.0) {
+            g_string_append(str, ", \"bytes_per_second\": ");
+            append_json_double(str, result->bytes / result->seconds_min);
+        }
+    }
+
+    g_string_append(str, "}\n");
+
+    fputs(str->str, stdout);
+    fflush(stdout);
+
+    g_string_free(str, TRUE);
+}
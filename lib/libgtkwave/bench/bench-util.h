@@ -0,0 +1,19 @@
+#pragma once
+
+#include <glib.h>
+
+// Results are printed as one JSON object per line to allow tracking
+// regressions across builds.
+
+typedef struct
+{
+    const gchar *name;
+    const gchar *file;
+    guint iterations;
+    gdouble seconds; // mean time per iteration
+    gdouble seconds_min;
+    guint64 items; // items processed per iteration
+    guint64 bytes; // bytes processed per iteration
+} BenchResult;
+
+void bench_report(const BenchResult *result);
@@ -4,6 +4,7 @@
 #include "gw-enums.h"
 #include "gw-bit.h"
 #include "gw-time.h"
+#include "gw-stats.h"
 #include "gw-time-range.h"
 #include "gw-named-markers.h"
 #include "gw-marker.h"
@@ -19,6 +20,8 @@
 #include "gw-fac.h"
 #include "gw-bits.h"
 #include "gw-bit-vector.h"
+#include "gw-edge-index.h"
+#include "gw-analog-envelope.h"
 #include "gw-trace.h"
 #include "gw-stems.h"
 #include "gw-var-enums.h"
@@ -27,6 +30,8 @@
 #include "gw-blackout-regions.h"
 #include "gw-symbol.h"
 #include "gw-string-table.h"
+#include "gw-symbol-index.h"
+#include "gw-symbol-search.h"
 #include "gw-enum-filter.h"
 #include "gw-enum-filter-list.h"
 #include "gw-dump-file.h"
@@ -40,4 +45,8 @@
 #include "gw-vcd-file.h"
 #include "gw-vcd-loader.h"
 #include "gw-fst-file.h"
-#include "gw-fst-loader.h"
\ No newline at end of file
+#include "gw-fst-loader.h"
+#include "gw-lxt2-file.h"
+#include "gw-lxt2-loader.h"
+#include "gw-vzt-file.h"
+#include "gw-vzt-loader.h"
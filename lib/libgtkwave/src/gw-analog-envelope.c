@@ -0,0 +1,201 @@
+#include <math.h>
+#include "gw-analog-envelope.h"
+
+// The samples are summarized in a hierarchy of blocks, where every level stores the range of
+// BLOCK_SIZE consecutive entries of the level below. A range query only visits the blocks at
+// the boundaries of the queried range, which makes the min/max of a pixel column independent
+// of the number of samples in it.
+//
+// The samples themselves aren't copied. They stay in the history of the trace and are read
+// through the value function while the levels are built and at the boundaries of a query.
+#define BLOCK_SIZE 16
+
+struct _GwAnalogEnvelope
+{
+    guint length;
+    GwAnalogEnvelopeValueFunc value_func;
+    gpointer user_data;
+
+    // Arrays of GwAnalogRange, level 0 summarizes BLOCK_SIZE samples.
+    GPtrArray *levels;
+    gboolean levels_valid;
+};
+
+/**
+ * gw_analog_envelope_new:
+ * @length: The number of samples.
+ * @value_func: Function that returns the value of a sample.
+ * @user_data: Data passed to @value_func.
+ *
+ * Creates an envelope over @length samples in time order. @value_func must keep returning the
+ * same values for as long as the envelope is used.
+ *
+ * Returns: (transfer full): The envelope.
+ */
+GwAnalogEnvelope *gw_analog_envelope_new(guint length,
+                                         GwAnalogEnvelopeValueFunc value_func,
+                                         gpointer user_data)
+{
+    g_return_val_if_fail(value_func != NULL, NULL);
+
+    GwAnalogEnvelope *self = g_new0(GwAnalogEnvelope, 1);
+
+    self->length = length;
+    self->value_func = value_func;
+    self->user_data = user_data;
+    self->levels = g_ptr_array_new_with_free_func((GDestroyNotify)g_array_unref);
+
+    return self;
+}
+
+void gw_analog_envelope_free(GwAnalogEnvelope *self)
+{
+    g_return_if_fail(self != NULL);
+
+    g_ptr_array_free(self->levels, TRUE);
+    g_free(self);
+}
+
+guint gw_analog_envelope_get_length(GwAnalogEnvelope *self)
+{
+    g_return_val_if_fail(self != NULL, 0);
+
+    return self->length;
+}
+
+/**
+ * gw_analog_envelope_get_memory_size:
+ * @self: A #GwAnalogEnvelope.
+ *
+ * Returns: The number of bytes held by the summary levels.
+ */
+gsize gw_analog_envelope_get_memory_size(GwAnalogEnvelope *self)
+{
+    g_return_val_if_fail(self != NULL, 0);
+
+    gsize size = sizeof(GwAnalogEnvelope);
+    for (guint i = 0; i < self->levels->len; i++) {
+        GArray *level = g_ptr_array_index(self->levels, i);
+        size += level->len * sizeof(GwAnalogRange);
+    }
+
+    return size;
+}
+
+static void range_add_value(GwAnalogRange *range, gdouble value)
+{
+    if (isnan(value)) {
+        range->flags |= GW_ANALOG_RANGE_NAN;
+    } else if (isinf(value)) {
+        range->flags |= value > 0 ? GW_ANALOG_RANGE_POSITIVE_INFINITY
+                                  : GW_ANALOG_RANGE_NEGATIVE_INFINITY;
+    } else if (!(range->flags & GW_ANALOG_RANGE_FINITE)) {
+        range->min = range->max = value;
+        range->flags |= GW_ANALOG_RANGE_FINITE;
+    } else {
+        range->min = MIN(range->min, value);
+        range->max = MAX(range->max, value);
+    }
+}
+
+static void range_add_range(GwAnalogRange *range, const GwAnalogRange *other)
+{
+    if (other->flags & GW_ANALOG_RANGE_FINITE) {
+        if (range->flags & GW_ANALOG_RANGE_FINITE) {
+            range->min = MIN(range->min, other->min);
+            range->max = MAX(range->max, other->max);
+        } else {
+            range->min = other->min;
+            range->max = other->max;
+        }
+    }
+    range->flags |= other->flags;
+}
+
+static void build_levels(GwAnalogEnvelope *self)
+{
+    g_ptr_array_set_size(self->levels, 0);
+
+    guint n = self->length;
+
+    GArray *level = NULL;
+    while (n > BLOCK_SIZE) {
+        guint n_blocks = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        GArray *next = g_array_sized_new(FALSE, TRUE, sizeof(GwAnalogRange), n_blocks);
+        g_array_set_size(next, n_blocks);
+
+        GwAnalogRange *blocks = (GwAnalogRange *)next->data;
+        for (guint i = 0; i < n; i++) {
+            if (level == NULL) {
+                range_add_value(&blocks[i / BLOCK_SIZE], self->value_func(i, self->user_data));
+            } else {
+                range_add_range(&blocks[i / BLOCK_SIZE], &g_array_index(level, GwAnalogRange, i));
+            }
+        }
+
+        g_ptr_array_add(self->levels, next);
+        level = next;
+        n = n_blocks;
+    }
+
+    self->levels_valid = TRUE;
+}
+
+/**
+ * gw_analog_envelope_get_range:
+ * @self: A #GwAnalogEnvelope.
+ * @start: The index of the first sample.
+ * @end: The index after the last sample.
+ * @range: (out): Location for the range.
+ *
+ * Determines the minimum and maximum of the finite values of the samples from @start up to
+ * but not including @end and which non-finite values occur in between. @end is clamped to
+ * the number of samples.
+ */
+void gw_analog_envelope_get_range(GwAnalogEnvelope *self,
+                                  guint start,
+                                  guint end,
+                                  GwAnalogRange *range)
+{
+    g_return_if_fail(self != NULL);
+    g_return_if_fail(range != NULL);
+
+    range->min = 0.0;
+    range->max = 0.0;
+    range->flags = 0;
+
+    end = MIN(end, self->length);
+    if (start >= end) {
+        return;
+    }
+
+    if (!self->levels_valid) {
+        build_levels(self);
+    }
+
+    guint i = start;
+
+    // Level 0 is the samples, level n is stored in levels[n - 1].
+    guint level = 0;
+    guint size = 1;
+
+    while (i < end) {
+        while (level < self->levels->len && i % (size * BLOCK_SIZE) == 0 &&
+               i + size * BLOCK_SIZE <= end) {
+            size *= BLOCK_SIZE;
+            level++;
+        }
+        while (i + size > end) {
+            size /= BLOCK_SIZE;
+            level--;
+        }
+
+        if (level == 0) {
+            range_add_value(range, self->value_func(i, self->user_data));
+        } else {
+            GArray *blocks = g_ptr_array_index(self->levels, level - 1);
+            range_add_range(range, &g_array_index(blocks, GwAnalogRange, i / size));
+        }
+        i += size;
+    }
+}
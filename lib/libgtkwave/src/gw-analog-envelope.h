@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glib.h>
+#include "gw-types.h"
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+    GW_ANALOG_RANGE_FINITE = 1 << 0,
+    GW_ANALOG_RANGE_NAN = 1 << 1,
+    GW_ANALOG_RANGE_POSITIVE_INFINITY = 1 << 2,
+    GW_ANALOG_RANGE_NEGATIVE_INFINITY = 1 << 3,
+} GwAnalogRangeFlags;
+
+typedef struct
+{
+    gdouble min; // smallest finite value
+    gdouble max; // largest finite value
+    GwAnalogRangeFlags flags;
+} GwAnalogRange;
+
+// Returns the value of the sample at index.
+typedef gdouble (*GwAnalogEnvelopeValueFunc)(guint index, gpointer user_data);
+
+GwAnalogEnvelope *gw_analog_envelope_new(guint length,
+                                         GwAnalogEnvelopeValueFunc value_func,
+                                         gpointer user_data);
+void gw_analog_envelope_free(GwAnalogEnvelope *self);
+
+guint gw_analog_envelope_get_length(GwAnalogEnvelope *self);
+gsize gw_analog_envelope_get_memory_size(GwAnalogEnvelope *self);
+void gw_analog_envelope_get_range(GwAnalogEnvelope *self,
+                                  guint start,
+                                  guint end,
+                                  GwAnalogRange *range);
+
+G_END_DECLS
@@ -17,6 +17,7 @@ struct _GwBitVector
     int nbits; /* number of bits in this vector         */
     int numregions; /* number of regions that follow         */
     GwBits *bits; /* pointer to Bits structs for save file */
+    GwEdgeIndex *edge_index; /* built on demand by edge searches */
     GwVectorEnt *vectors[]; /* C99 pointers to the vectors           */
 };
 
@@ -1,5 +1,6 @@
 #include "gw-dump-file.h"
 #include "gw-enums.h"
+#include "gw-stats.h"
 #include "gw-string-table.h"
 
 // clang-format off
@@ -25,6 +26,8 @@ typedef struct
     gboolean has_supplemental_vartypes;
     gboolean has_escaped_names;
     gboolean uses_vhdl_component_format;
+
+    GwSymbolIndex *symbol_index;
 } GwDumpFilePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(GwDumpFile, gw_dump_file, G_TYPE_OBJECT)
@@ -61,6 +64,7 @@ static void gw_dump_file_dispose(GObject *object)
     g_clear_object(&priv->component_names);
     g_clear_object(&priv->enum_filters);
     g_clear_object(&priv->time_range);
+    g_clear_object(&priv->symbol_index);
 
     G_OBJECT_CLASS(gw_dump_file_parent_class)->dispose(object);
 }
@@ -400,7 +404,11 @@ gboolean gw_dump_file_import_traces(GwDumpFile *self, GwNode **nodes, GError **e
         return TRUE;
     }
 
-    return GW_DUMP_FILE_GET_CLASS(self)->import_traces(self, nodes, error);
+    gint64 stats_begin = gw_stats_timer_begin();
+    gboolean ret = GW_DUMP_FILE_GET_CLASS(self)->import_traces(self, nodes, error);
+    gw_stats_timer_end(GW_STATS_TIMER_IMPORT, stats_begin);
+
+    return ret;
 }
 
 /**
@@ -431,8 +439,10 @@ gboolean gw_dump_file_import_all(GwDumpFile *self, GError **error)
     }
     g_ptr_array_add(nodes, NULL);
 
+    gint64 stats_begin = gw_stats_timer_begin();
     gboolean ret =
         GW_DUMP_FILE_GET_CLASS(self)->import_traces(self, (GwNode **)nodes->pdata, error);
+    gw_stats_timer_end(GW_STATS_TIMER_IMPORT, stats_begin);
 
     g_ptr_array_free(nodes, TRUE);
 
@@ -836,6 +846,112 @@ GwSymbol *gw_dump_file_lookup_symbol(GwDumpFile *self, const gchar *name)
     return symfind_2(self, name2);
 }
 
+/**
+ * gw_dump_file_lookup_symbols:
+ * @self: A #GwDumpFile.
+ * @names: (array length=n_names): The symbol names to look up.
+ * @n_names: The number of names.
+ * @symbols: (out caller-allocates) (array length=n_names): Return location for the symbols.
+ *
+ * Looks up several symbols in one batch, with the same rules as
+ * gw_dump_file_lookup_symbol(). Names without a symbol are set to %NULL in
+ * @symbols.
+ */
+void gw_dump_file_lookup_symbols(GwDumpFile *self,
+                                 const gchar *const *names,
+                                 guint n_names,
+                                 GwSymbol **symbols)
+{
+    g_return_if_fail(GW_IS_DUMP_FILE(self));
+    g_return_if_fail(n_names == 0 || (names != NULL && symbols != NULL));
+
+    if (gw_dump_file_has_escaped_names(self)) {
+        for (guint i = 0; i < n_names; i++) {
+            symbols[i] = gw_dump_file_lookup_symbol(self, names[i]);
+        }
+        return;
+    }
+
+    GwFacs *facs = gw_dump_file_get_facs(self);
+    gw_facs_lookup_many(facs, names, n_names, symbols);
+
+    // Retry the names which weren't found with a bit index (bluespec vs modelsim).
+    GPtrArray *retry_names = g_ptr_array_new_with_free_func(g_free);
+    GArray *retry_indices = g_array_new(FALSE, FALSE, sizeof(guint));
+    for (guint i = 0; i < n_names; i++) {
+        if (symbols[i] == NULL && !g_str_has_suffix(names[i], "]")) {
+            g_ptr_array_add(retry_names, g_strconcat(names[i], "[0]", NULL));
+            g_array_append_val(retry_indices, i);
+        }
+    }
+
+    if (retry_names->len > 0) {
+        GwSymbol **retry_symbols = g_new(GwSymbol *, retry_names->len);
+        gw_facs_lookup_many(facs,
+                            (const gchar *const *)retry_names->pdata,
+                            retry_names->len,
+                            retry_symbols);
+        for (guint i = 0; i < retry_names->len; i++) {
+            symbols[g_array_index(retry_indices, guint, i)] = retry_symbols[i];
+        }
+        g_free(retry_symbols);
+    }
+
+    g_array_free(retry_indices, TRUE);
+    g_ptr_array_free(retry_names, TRUE);
+}
+
+/**
+ * gw_dump_file_get_symbol_index:
+ * @self: A #GwDumpFile.
+ *
+ * Returns the index of the symbol names, which is built on the first call.
+ *
+ * Returns: (transfer none): The symbol index.
+ */
+GwSymbolIndex *gw_dump_file_get_symbol_index(GwDumpFile *self)
+{
+    g_return_val_if_fail(GW_IS_DUMP_FILE(self), NULL);
+
+    GwDumpFilePrivate *priv = gw_dump_file_get_instance_private(self);
+
+    if (priv->symbol_index == NULL) {
+        gint64 stats_begin = gw_stats_timer_begin();
+
+        priv->symbol_index = gw_symbol_index_new(priv->facs);
+
+        gw_stats_timer_end(GW_STATS_TIMER_SEARCH, stats_begin);
+    }
+
+    return priv->symbol_index;
+}
+
+/**
+ * gw_dump_file_search_symbols:
+ * @self: A #GwDumpFile.
+ * @pattern: The regular expression to search.
+ * @error: Return location for a #GError or %NULL.
+ *
+ * Starts an incremental search for all symbols that match the given regular
+ * expression. The search is restricted to the candidates found in the symbol
+ * index.
+ *
+ * Returns: (transfer full): A #GwSymbolSearch or %NULL in case of an error.
+ */
+GwSymbolSearch *gw_dump_file_search_symbols(GwDumpFile *self,
+                                            const gchar *pattern,
+                                            GError **error)
+{
+    g_return_val_if_fail(GW_IS_DUMP_FILE(self), NULL);
+    g_return_val_if_fail(pattern != NULL, NULL);
+    g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+    return gw_symbol_search_new(gw_dump_file_get_facs(self),
+                                gw_dump_file_get_symbol_index(self),
+                                pattern,
+                                error);
+}
+
 /**
  * gw_dump_file_find_symbols:
  * @self: A #GwDumpFile.
@@ -853,25 +969,162 @@ GPtrArray *gw_dump_file_find_symbols(GwDumpFile *self, const gchar *pattern, GEr
     g_return_val_if_fail(pattern != NULL, NULL);
     g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
-    GRegex *regex = g_regex_new(pattern, G_REGEX_CASELESS, 0, error);
-    if (regex == NULL) {
+    GwSymbolSearch *search = gw_dump_file_search_symbols(self, pattern, error);
+    if (search == NULL) {
         return NULL;
     }
 
     GPtrArray *symbols = g_ptr_array_new();
 
+    while (gw_symbol_search_step(search, G_MAXUINT, symbols)) {
+    }
+
+    g_object_unref(search);
+
+    return symbols;
+}
+
+/**
+ * gw_dump_file_get_node_memory_usage:
+ * @self: A #GwDumpFile.
+ * @node: A node of @self.
+ * @usage: (out): The memory usage.
+ *
+ * Returns the memory used by the trace of @node, including value change data
+ * which hasn't been imported yet.
+ */
+void gw_dump_file_get_node_memory_usage(GwDumpFile *self, GwNode *node, GwMemoryUsage *usage)
+{
+    g_return_if_fail(GW_IS_DUMP_FILE(self));
+    g_return_if_fail(node != NULL);
+    g_return_if_fail(usage != NULL);
+
+    gw_node_get_memory_usage(node, usage);
+
+    GwDumpFileClass *klass = GW_DUMP_FILE_GET_CLASS(self);
+    if (klass->get_pending_bytes != NULL) {
+        usage->pending = klass->get_pending_bytes(self, node);
+    }
+}
+
+static void add_node_memory_usage(GwDumpFile *self,
+                                  GwNode *node,
+                                  GHashTable *seen,
+                                  GwMemoryUsage *usage)
+{
+    if (!g_hash_table_add(seen, node)) {
+        return;
+    }
+
+    GwMemoryUsage node_usage;
+    gw_dump_file_get_node_memory_usage(self, node, &node_usage);
+
+    // Alias nodes share the history of the node they alias, which must only
+    // be counted once.
+    if (node->head.next != NULL && !g_hash_table_add(seen, node->head.next)) {
+        node_usage.transitions = 0;
+        node_usage.hist_ents = 0;
+        node_usage.vectors = 0;
+        node_usage.strings = 0;
+    }
+
+    gw_memory_usage_add(usage, &node_usage);
+}
+
+static void add_scope_memory_usage(GwDumpFile *self,
+                                   GwTreeNode *scope,
+                                   GHashTable *seen,
+                                   GwMemoryUsage *usage)
+{
     GwFacs *facs = gw_dump_file_get_facs(self);
-    guint facs_count = gw_facs_get_length(facs);
 
-    for (guint i = 0; i < facs_count; i++) {
-        GwSymbol *fac = gw_facs_get(facs, i);
+    if (scope->t_which >= 0 && (guint)scope->t_which < gw_facs_get_length(facs)) {
+        GwSymbol *symbol = gw_facs_get(facs, scope->t_which);
+        add_node_memory_usage(self, symbol->n, seen, usage);
+    }
 
-        if (g_regex_match(regex, fac->name, 0, NULL)) {
-            g_ptr_array_add(symbols, fac);
-        }
+    for (GwTreeNode *child = scope->child; child != NULL; child = child->next) {
+        add_scope_memory_usage(self, child, seen, usage);
     }
+}
 
-    g_regex_unref(regex);
+/**
+ * gw_dump_file_get_scope_memory_usage:
+ * @self: A #GwDumpFile.
+ * @scope: A node of the tree of @self.
+ * @usage: (out): The memory usage.
+ *
+ * Returns the memory used by the traces of all signals in the hierarchy below
+ * @scope, including @scope itself if it is a signal. Histories shared by alias
+ * nodes are only counted once.
+ */
+void gw_dump_file_get_scope_memory_usage(GwDumpFile *self,
+                                         GwTreeNode *scope,
+                                         GwMemoryUsage *usage)
+{
+    g_return_if_fail(GW_IS_DUMP_FILE(self));
+    g_return_if_fail(scope != NULL);
+    g_return_if_fail(usage != NULL);
 
-    return symbols;
+    memset(usage, 0, sizeof(*usage));
+
+    GHashTable *seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+    add_scope_memory_usage(self, scope, seen, usage);
+    g_hash_table_destroy(seen);
+}
+
+/**
+ * gw_dump_file_get_memory_usage:
+ * @self: A #GwDumpFile.
+ * @usage: (out): The memory usage.
+ *
+ * Returns the memory used by the traces of all signals in @self. Histories
+ * shared by alias nodes are only counted once.
+ */
+void gw_dump_file_get_memory_usage(GwDumpFile *self, GwMemoryUsage *usage)
+{
+    g_return_if_fail(GW_IS_DUMP_FILE(self));
+    g_return_if_fail(usage != NULL);
+
+    memset(usage, 0, sizeof(*usage));
+
+    GwFacs *facs = gw_dump_file_get_facs(self);
+    GHashTable *seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    for (guint i = 0; i < gw_facs_get_length(facs); i++) {
+        GwSymbol *symbol = gw_facs_get(facs, i);
+        add_node_memory_usage(self, symbol->n, seen, usage);
+    }
+
+    g_hash_table_destroy(seen);
+}
+
+/**
+ * gw_dump_file_get_hist_ent_block_usage:
+ * @self: A #GwDumpFile.
+ * @usage: (out): The block usage.
+ *
+ * Returns how well the history entry blocks of @self are used. Dump files
+ * which don't allocate history entries from a factory report zero for
+ * @allocated and @used.
+ */
+void gw_dump_file_get_hist_ent_block_usage(GwDumpFile *self, GwHistEntBlockUsage *usage)
+{
+    g_return_if_fail(GW_IS_DUMP_FILE(self));
+    g_return_if_fail(usage != NULL);
+
+    memset(usage, 0, sizeof(*usage));
+
+    GwDumpFileClass *klass = GW_DUMP_FILE_GET_CLASS(self);
+    GwHistEntFactory *factory =
+        klass->get_hist_ent_factory != NULL ? klass->get_hist_ent_factory(self) : NULL;
+
+    if (factory != NULL) {
+        usage->allocated = gw_hist_ent_factory_get_allocated_bytes(factory);
+        usage->used = gw_hist_ent_factory_get_used_bytes(factory);
+    }
+
+    GwMemoryUsage memory_usage;
+    gw_dump_file_get_memory_usage(self, &memory_usage);
+    usage->live = memory_usage.hist_ents;
 }
@@ -7,8 +7,11 @@
 #include "gw-time.h"
 #include "gw-time-range.h"
 #include "gw-facs.h"
+#include "gw-hist-ent-factory.h"
 #include "gw-enum-filter-list.h"
 #include "gw-string-table.h"
+#include "gw-symbol-index.h"
+#include "gw-symbol-search.h"
 
 G_BEGIN_DECLS
 
@@ -31,8 +34,26 @@ struct _GwDumpFileClass
 
     gboolean (*import_traces)(GwDumpFile *self, GwNode **nodes, GError **error);
     guint (*get_enum_filter_for_node)(GwDumpFile *self, GwNode *node);
+    GwHistEntFactory *(*get_hist_ent_factory)(GwDumpFile *self);
+    gsize (*get_pending_bytes)(GwDumpFile *self, GwNode *node);
 };
 
+/**
+ * GwHistEntBlockUsage:
+ * @allocated: Bytes in the blocks of the history entry factory.
+ * @used: Bytes in entries handed out by the factory.
+ * @live: Bytes in entries reachable from the node histories.
+ *
+ * Fragmentation of the history entry blocks. The difference between
+ * @allocated and @live is memory that can only be reclaimed by compaction.
+ */
+typedef struct
+{
+    gsize allocated;
+    gsize used;
+    gsize live;
+} GwHistEntBlockUsage;
+
 gboolean gw_dump_file_import_traces(GwDumpFile *self, GwNode **nodes, GError **error);
 gboolean gw_dump_file_import_all(GwDumpFile *self, GError **error);
 
@@ -56,6 +77,21 @@ gboolean gw_dump_file_has_escaped_names(GwDumpFile *self);
 gboolean gw_dump_file_get_uses_vhdl_component_format(GwDumpFile *self);
 
 GwSymbol *gw_dump_file_lookup_symbol(GwDumpFile *self, const gchar *name);
+void gw_dump_file_lookup_symbols(GwDumpFile *self,
+                                 const gchar *const *names,
+                                 guint n_names,
+                                 GwSymbol **symbols);
 GPtrArray *gw_dump_file_find_symbols(GwDumpFile *self, const gchar *pattern, GError **error);
+GwSymbolIndex *gw_dump_file_get_symbol_index(GwDumpFile *self);
+GwSymbolSearch *gw_dump_file_search_symbols(GwDumpFile *self,
+                                            const gchar *pattern,
+                                            GError **error);
+
+void gw_dump_file_get_node_memory_usage(GwDumpFile *self, GwNode *node, GwMemoryUsage *usage);
+void gw_dump_file_get_scope_memory_usage(GwDumpFile *self,
+                                         GwTreeNode *scope,
+                                         GwMemoryUsage *usage);
+void gw_dump_file_get_memory_usage(GwDumpFile *self, GwMemoryUsage *usage);
+void gw_dump_file_get_hist_ent_block_usage(GwDumpFile *self, GwHistEntBlockUsage *usage);
 
 G_END_DECLS
\ No newline at end of file
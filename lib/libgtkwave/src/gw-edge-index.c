@@ -0,0 +1,258 @@
+#include "gw-edge-index.h"
+#include "gw-bit.h"
+#include "gw-bit-vector.h"
+#include "gw-hist-ent.h"
+#include "gw-node.h"
+#include "gw-vector-ent.h"
+
+// Every n-th time of an edge list is copied into a small summary array, which is searched first
+// to narrow down the block in the full list. This keeps lookups in long lists cache friendly.
+#define SUMMARY_STRIDE 64
+
+typedef struct
+{
+    GArray *times;
+    GArray *summary;
+} EdgeList;
+
+struct _GwEdgeIndex
+{
+    EdgeList lists[GW_EDGE_TYPE_FALLING + 1];
+};
+
+static GwEdgeIndex *gw_edge_index_new(void)
+{
+    GwEdgeIndex *self = g_new0(GwEdgeIndex, 1);
+
+    for (guint i = 0; i < G_N_ELEMENTS(self->lists); i++) {
+        self->lists[i].times = g_array_new(FALSE, FALSE, sizeof(GwTime));
+        self->lists[i].summary = g_array_new(FALSE, FALSE, sizeof(GwTime));
+    }
+
+    return self;
+}
+
+static void gw_edge_index_append(GwEdgeIndex *self, GwEdgeType type, GwTime time)
+{
+    EdgeList *list = &self->lists[type];
+
+    if (list->times->len % SUMMARY_STRIDE == 0) {
+        g_array_append_val(list->summary, time);
+    }
+    g_array_append_val(list->times, time);
+}
+
+static gboolean is_edge_time(GwTime time)
+{
+    // Skip the sentinel entries at the start and end of the history.
+    return time >= 0 && time < GW_TIME_MAX - 1;
+}
+
+static gboolean is_high(GwBit bit)
+{
+    return bit == GW_BIT_1 || bit == GW_BIT_H;
+}
+
+static gboolean is_low(GwBit bit)
+{
+    return bit == GW_BIT_0 || bit == GW_BIT_L;
+}
+
+/**
+ * gw_edge_index_new_for_node:
+ * @node: A #GwNode.
+ *
+ * Creates an index of the transitions of @node. Rising and falling edges are only
+ * indexed for single bit nodes.
+ *
+ * Returns: (transfer full): The edge index.
+ */
+GwEdgeIndex *gw_edge_index_new_for_node(GwNode *node)
+{
+    g_return_val_if_fail(node != NULL, NULL);
+
+    GwEdgeIndex *self = gw_edge_index_new();
+    gboolean is_scalar = !node->extvals;
+    GwBit previous = GW_BIT_X;
+
+    for (GwHistEnt *h = &node->head; h != NULL; h = h->next) {
+        // Only the last of multiple entries at the same time is visible.
+        if (h->next != NULL && h->next->time == h->time) {
+            continue;
+        }
+
+        GwBit value = is_scalar ? (h->v.h_val & GW_BIT_MASK) : GW_BIT_X;
+
+        if (is_edge_time(h->time)) {
+            gw_edge_index_append(self, GW_EDGE_TYPE_ANY, h->time);
+
+            if (is_scalar && is_high(value) && !is_high(previous)) {
+                gw_edge_index_append(self, GW_EDGE_TYPE_RISING, h->time);
+            } else if (is_scalar && is_low(value) && !is_low(previous)) {
+                gw_edge_index_append(self, GW_EDGE_TYPE_FALLING, h->time);
+            }
+        }
+
+        previous = value;
+    }
+
+    return self;
+}
+
+/**
+ * gw_edge_index_new_for_vector:
+ * @vector: A #GwBitVector.
+ *
+ * Creates an index of the value changes of @vector. Vectors have no rising or falling
+ * edges.
+ *
+ * Returns: (transfer full): The edge index.
+ */
+GwEdgeIndex *gw_edge_index_new_for_vector(GwBitVector *vector)
+{
+    g_return_val_if_fail(vector != NULL, NULL);
+
+    GwEdgeIndex *self = gw_edge_index_new();
+
+    for (gint i = 0; i < vector->numregions; i++) {
+        GwVectorEnt *v = vector->vectors[i];
+
+        if (v->next != NULL && v->next->time == v->time) {
+            continue;
+        }
+
+        if (is_edge_time(v->time)) {
+            gw_edge_index_append(self, GW_EDGE_TYPE_ANY, v->time);
+        }
+    }
+
+    return self;
+}
+
+void gw_edge_index_free(GwEdgeIndex *self)
+{
+    g_return_if_fail(self != NULL);
+
+    for (guint i = 0; i < G_N_ELEMENTS(self->lists); i++) {
+        g_array_free(self->lists[i].times, TRUE);
+        g_array_free(self->lists[i].summary, TRUE);
+    }
+    g_free(self);
+}
+
+// Returns the index of the first time in the sorted array that is larger than time.
+static guint upper_bound(const GwTime *times, guint lo, guint hi, GwTime time)
+{
+    while (lo < hi) {
+        guint mid = lo + (hi - lo) / 2;
+
+        if (times[mid] <= time) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+// Returns the number of edges at or before time.
+static guint edge_list_rank(EdgeList *list, GwTime time)
+{
+    const GwTime *summary = (const GwTime *)list->summary->data;
+    guint block = upper_bound(summary, 0, list->summary->len, time);
+
+    if (block == 0) {
+        return 0;
+    }
+
+    guint lo = (block - 1) * SUMMARY_STRIDE;
+    guint hi = MIN(lo + SUMMARY_STRIDE, list->times->len);
+
+    return upper_bound((const GwTime *)list->times->data, lo, hi, time);
+}
+
+/**
+ * gw_edge_index_find_next:
+ * @self: A #GwEdgeIndex.
+ * @type: The edge type.
+ * @time: The start time.
+ * @next: (out): Location for the edge time.
+ *
+ * Finds the first edge of the given type after @time.
+ *
+ * Returns: %TRUE if an edge was found.
+ */
+gboolean gw_edge_index_find_next(GwEdgeIndex *self, GwEdgeType type, GwTime time, GwTime *next)
+{
+    g_return_val_if_fail(self != NULL, FALSE);
+    g_return_val_if_fail(type <= GW_EDGE_TYPE_FALLING, FALSE);
+    g_return_val_if_fail(next != NULL, FALSE);
+
+    EdgeList *list = &self->lists[type];
+    guint rank = edge_list_rank(list, time);
+
+    if (rank >= list->times->len) {
+        return FALSE;
+    }
+
+    *next = g_array_index(list->times, GwTime, rank);
+    return TRUE;
+}
+
+/**
+ * gw_edge_index_find_previous:
+ * @self: A #GwEdgeIndex.
+ * @type: The edge type.
+ * @time: The start time.
+ * @previous: (out): Location for the edge time.
+ *
+ * Finds the last edge of the given type before @time.
+ *
+ * Returns: %TRUE if an edge was found.
+ */
+gboolean gw_edge_index_find_previous(GwEdgeIndex *self,
+                                     GwEdgeType type,
+                                     GwTime time,
+                                     GwTime *previous)
+{
+    g_return_val_if_fail(self != NULL, FALSE);
+    g_return_val_if_fail(type <= GW_EDGE_TYPE_FALLING, FALSE);
+    g_return_val_if_fail(previous != NULL, FALSE);
+
+    EdgeList *list = &self->lists[type];
+    guint rank = time > G_MININT64 ? edge_list_rank(list, time - 1) : 0;
+
+    if (rank == 0) {
+        return FALSE;
+    }
+
+    *previous = g_array_index(list->times, GwTime, rank - 1);
+    return TRUE;
+}
+
+/**
+ * gw_edge_index_count:
+ * @self: A #GwEdgeIndex.
+ * @type: The edge type.
+ * @start: The start time.
+ * @end: The end time.
+ *
+ * Counts the edges of the given type between @start and @end, including both ends.
+ *
+ * Returns: The number of edges.
+ */
+gsize gw_edge_index_count(GwEdgeIndex *self, GwEdgeType type, GwTime start, GwTime end)
+{
+    g_return_val_if_fail(self != NULL, 0);
+    g_return_val_if_fail(type <= GW_EDGE_TYPE_FALLING, 0);
+
+    if (start > end) {
+        return 0;
+    }
+
+    EdgeList *list = &self->lists[type];
+    guint before = start > G_MININT64 ? edge_list_rank(list, start - 1) : 0;
+
+    return edge_list_rank(list, end) - before;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glib.h>
+#include "gw-types.h"
+#include "gw-time.h"
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+    GW_EDGE_TYPE_ANY,
+    GW_EDGE_TYPE_RISING,
+    GW_EDGE_TYPE_FALLING,
+} GwEdgeType;
+
+GwEdgeIndex *gw_edge_index_new_for_node(GwNode *node);
+GwEdgeIndex *gw_edge_index_new_for_vector(GwBitVector *vector);
+void gw_edge_index_free(GwEdgeIndex *self);
+
+gboolean gw_edge_index_find_next(GwEdgeIndex *self, GwEdgeType type, GwTime time, GwTime *next);
+gboolean gw_edge_index_find_previous(GwEdgeIndex *self,
+                                     GwEdgeType type,
+                                     GwTime time,
+                                     GwTime *previous);
+gsize gw_edge_index_count(GwEdgeIndex *self, GwEdgeType type, GwTime start, GwTime end);
+
+G_END_DECLS
@@ -1,5 +1,11 @@
 #include "gw-facs.h"
+#include "gw-stats.h"
 #include "gw-util.h"
+#include <string.h>
+
+// Facs are only sorted on multiple threads if there are enough to make up
+// for the overhead of the merge passes.
+#define GW_FACS_PARALLEL_SORT_MIN 65536
 
 struct _GwFacs
 {
@@ -160,6 +166,8 @@ void gw_facs_order_from_tree(GwFacs *self, GwTree *tree)
 
     // TODO: check for empty
 
+    gint64 stats_begin = gw_stats_timer_begin();
+
     GwFacs *sorted_facs = gw_facs_new(gw_facs_get_length(self));
     gint pos = gw_facs_get_length(self) - 1;
 
@@ -170,23 +178,144 @@ void gw_facs_order_from_tree(GwFacs *self, GwTree *tree)
     self->facs = g_steal_pointer(&sorted_facs->facs);
 
     g_object_unref(sorted_facs);
+
+    gw_stats_timer_end(GW_STATS_TIMER_SORT_FACS, stats_begin);
 }
 
-static int sigcmp(const void *v1, const void *v2)
+typedef GwSymbol *SortEntry;
+
+static gint compare_sort_entries(gconstpointer a, gconstpointer b, gpointer user_data)
 {
-    GwSymbol *a1 = *((GwSymbol **)v1);
-    GwSymbol *a2 = *((GwSymbol **)v2);
-    return gw_signal_name_compare(a1->name, a2->name);
+    const SortEntry *e1 = a;
+    const SortEntry *e2 = b;
+    (void)user_data;
+
+    return gw_signal_name_compare((*e1)->name, (*e2)->name);
+}
+
+typedef struct
+{
+    SortEntry *entries;
+    guint len;
+} SortChunk;
+
+typedef struct
+{
+    const SortEntry *src;
+    SortEntry *dst;
+    guint start;
+    guint mid;
+    guint end;
+} MergeTask;
+
+static void sort_chunk(gpointer data, gpointer user_data)
+{
+    SortChunk *chunk = data;
+    (void)user_data;
+
+    g_qsort_with_data(chunk->entries, chunk->len, sizeof(SortEntry), compare_sort_entries, NULL);
+}
+
+static void merge_chunks(gpointer data, gpointer user_data)
+{
+    MergeTask *task = data;
+    (void)user_data;
+
+    guint i = task->start;
+    guint j = task->mid;
+    guint k = task->start;
+
+    // Taking equal entries from the left run keeps the merge stable.
+    while (i < task->mid && j < task->end) {
+        if (compare_sort_entries(&task->src[j], &task->src[i], NULL) < 0) {
+            task->dst[k++] = task->src[j++];
+        } else {
+            task->dst[k++] = task->src[i++];
+        }
+    }
+    while (i < task->mid) {
+        task->dst[k++] = task->src[i++];
+    }
+    while (j < task->end) {
+        task->dst[k++] = task->src[j++];
+    }
+}
+
+/*
+ * Sorts chunks of the entries on separate threads and merges the sorted runs
+ * pairwise, with the merges of each pass also running in parallel.
+ */
+static void sort_entries_parallel(SortEntry *entries, guint len, guint n_chunks)
+{
+    guint *bounds = g_new(guint, n_chunks + 1);
+    for (guint i = 0; i <= n_chunks; i++) {
+        bounds[i] = (guint)((guint64)len * i / n_chunks);
+    }
+
+    SortChunk *chunks = g_new(SortChunk, n_chunks);
+    for (guint i = 0; i < n_chunks; i++) {
+        chunks[i].entries = entries + bounds[i];
+        chunks[i].len = bounds[i + 1] - bounds[i];
+    }
+    gw_run_parallel(sort_chunk, chunks, sizeof(SortChunk), n_chunks, NULL);
+    g_free(chunks);
+
+    SortEntry *src = entries;
+    SortEntry *dst = g_new(SortEntry, len);
+    MergeTask *tasks = g_new(MergeTask, n_chunks);
+
+    for (guint width = 1; width < n_chunks; width *= 2) {
+        guint n_tasks = 0;
+
+        for (guint i = 0; i < n_chunks; i += 2 * width) {
+            MergeTask *task = &tasks[n_tasks++];
+            task->src = src;
+            task->dst = dst;
+            task->start = bounds[i];
+            task->mid = bounds[MIN(i + width, n_chunks)];
+            task->end = bounds[MIN(i + 2 * width, n_chunks)];
+        }
+        gw_run_parallel(merge_chunks, tasks, sizeof(MergeTask), n_tasks, NULL);
+
+        SortEntry *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != entries) {
+        memcpy(entries, src, len * sizeof(SortEntry));
+        dst = src;
+    }
+
+    g_free(tasks);
+    g_free(dst);
+    g_free(bounds);
 }
 
 void gw_facs_sort(GwFacs *self)
 {
     g_return_if_fail(GW_IS_FACS(self));
 
-    // TODO: Check which sorting algorithm is used by Glib. The original code
-    // used a custom heapsort for some platforms, because quicksort can be very
-    // slow if the facs are already sorted.
-    g_ptr_array_sort(self->facs, sigcmp);
+    guint len = self->facs->len;
+    if (len < 2) {
+        return;
+    }
+
+    gint64 stats_begin = gw_stats_timer_begin();
+
+    SortEntry *entries = (SortEntry *)self->facs->pdata;
+
+    guint n_threads = gw_get_thread_count();
+
+    if (n_threads > 1 && len >= GW_FACS_PARALLEL_SORT_MIN) {
+        sort_entries_parallel(entries, len, n_threads);
+    } else {
+        // g_qsort_with_data() is a merge sort, which unlike the quicksort that
+        // was used originally isn't slowed down by already sorted facs.
+        g_qsort_with_data(entries, len, sizeof(SortEntry), compare_sort_entries, NULL);
+    }
+
+    gw_stats_timer_end(GW_STATS_TIMER_SORT_FACS, stats_begin);
 }
 
 static int compar_facs(const void *key, const void *v2)
@@ -214,3 +343,74 @@ GwSymbol *gw_facs_lookup(GwFacs *self, const gchar *name)
 
     return symbol != NULL ? *symbol : NULL;
 }
+
+static gint compare_lookup_names(gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    const gchar *const *names = user_data;
+
+    return gw_signal_name_compare(names[*(const guint *)a], names[*(const guint *)b]);
+}
+
+// Returns the index of the first fac which isn't sorted before name, searching
+// from start with exponentially growing steps.
+static guint gallop_lower_bound(GwSymbol **facs, guint start, guint len, const gchar *name)
+{
+    guint lo = start;
+    guint step = 1;
+    while (lo + step <= len && gw_signal_name_compare(facs[lo + step - 1]->name, name) < 0) {
+        lo += step;
+        step *= 2;
+    }
+
+    guint hi = MIN(lo + step - 1, len);
+    while (lo < hi) {
+        guint mid = lo + (hi - lo) / 2;
+        if (gw_signal_name_compare(facs[mid]->name, name) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/**
+ * gw_facs_lookup_many:
+ * @self: A #GwFacs.
+ * @names: (array length=n_names): The names to look up.
+ * @n_names: The number of names.
+ * @symbols: (out caller-allocates) (array length=n_names): Return location for the symbols.
+ *
+ * Looks up several names at once. The names are sorted and resolved in a
+ * single forward pass over the facs, which is faster than separate lookups
+ * for large batches. Names which don't exist are set to %NULL in @symbols.
+ */
+void gw_facs_lookup_many(GwFacs *self, const gchar *const *names, guint n_names, GwSymbol **symbols)
+{
+    g_return_if_fail(GW_IS_FACS(self));
+    g_return_if_fail(n_names == 0 || (names != NULL && symbols != NULL));
+
+    guint *order = g_new(guint, n_names);
+    for (guint i = 0; i < n_names; i++) {
+        order[i] = i;
+    }
+    g_qsort_with_data(order, n_names, sizeof(guint), compare_lookup_names, (gpointer)names);
+
+    GwSymbol **facs = (GwSymbol **)self->facs->pdata;
+    guint len = self->facs->len;
+    guint pos = 0;
+
+    for (guint i = 0; i < n_names; i++) {
+        const gchar *name = names[order[i]];
+
+        pos = gallop_lower_bound(facs, pos, len, name);
+        if (pos < len && gw_signal_name_compare(facs[pos]->name, name) == 0) {
+            symbols[order[i]] = facs[pos];
+        } else {
+            symbols[order[i]] = NULL;
+        }
+    }
+
+    g_free(order);
+}
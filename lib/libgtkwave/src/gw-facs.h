@@ -22,5 +22,9 @@ void gw_facs_order_from_tree(GwFacs *self, GwTree *tree);
 void gw_facs_sort(GwFacs *self);
 
 GwSymbol *gw_facs_lookup(GwFacs *self, const gchar *name);
+void gw_facs_lookup_many(GwFacs *self,
+                         const gchar *const *names,
+                         guint n_names,
+                         GwSymbol **symbols);
 
 G_END_DECLS
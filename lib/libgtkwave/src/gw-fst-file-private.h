@@ -3,23 +3,7 @@
 #include <gtkwave.h>
 #include <fstapi.h>
 #include <jrb.h>
-
-#ifdef WAVE_USE_STRUCT_PACKING
-#pragma pack(push)
-#pragma pack(1)
-#endif
-
-typedef struct
-{
-    GwHistEnt *histent_head;
-    GwHistEnt *histent_curr;
-    int numtrans;
-    GwNode *np;
-} GwLx2Entry;
-
-#ifdef WAVE_USE_STRUCT_PACKING
-#pragma pack(pop)
-#endif
+#include "gw-lx2.h"
 
 struct _GwFstFile
 {
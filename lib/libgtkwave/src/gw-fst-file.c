@@ -59,6 +59,11 @@ static guint gw_fst_file_get_enum_filter_for_node(GwDumpFile *dump_file, GwNode
     return enum_nptr != NULL ? enum_nptr->val.ui : 0;
 }
 
+static GwHistEntFactory *gw_fst_file_get_hist_ent_factory(GwDumpFile *dump_file)
+{
+    return GW_FST_FILE(dump_file)->hist_ent_factory;
+}
+
 static void gw_fst_file_class_init(GwFstFileClass *klass)
 {
     GObjectClass *object_class = G_OBJECT_CLASS(klass);
@@ -69,6 +74,7 @@ static void gw_fst_file_class_init(GwFstFileClass *klass)
 
     dump_file_class->import_traces = gw_fst_file_import_traces;
     dump_file_class->get_enum_filter_for_node = gw_fst_file_get_enum_filter_for_node;
+    dump_file_class->get_hist_ent_factory = gw_fst_file_get_hist_ent_factory;
 }
 
 static void gw_fst_file_init(GwFstFile *self)
@@ -1,6 +1,7 @@
 #include "gw-fst-loader.h"
 #include "gw-fst-file.h"
 #include "gw-fst-file-private.h"
+#include "gw-stats.h"
 #include "gw-util.h"
 #include <fstapi.h>
 
@@ -963,9 +964,12 @@ static GwDumpFile *gw_fst_loader_load(GwLoader *loader, const char *fname, GErro
 
     fprintf(stderr, FST_RDLOAD "Sorting facility hierarchy tree.\n");
 
+    gint64 stats_begin = gw_stats_timer_begin();
     GwTreeNode *root = gw_tree_builder_build(self->tree_builder);
     GwTree *tree = gw_tree_new(root);
     gw_tree_graft(tree, self->terminals_chain);
+    gw_stats_timer_end(GW_STATS_TIMER_BUILD_TREE, stats_begin);
+
     gw_tree_sort(tree);
 
     // TODO: update splash
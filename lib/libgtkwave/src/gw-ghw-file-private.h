@@ -1,9 +1,28 @@
 #pragma once
 
+#include <libghw.h>
+
+typedef struct
+{
+    struct ghw_handler *h;
+    GwNode **nxp; /* node of each GHW signal */
+    GwHistEntFactory *hist_ent_factory;
+    GwTime max_time;
+    int num_glitches;
+    int num_glitch_regions;
+    gboolean warned;
+} GwGhwHistory;
+
+void gw_ghw_history_read(GwGhwHistory *history, const guint8 *wanted);
+
 struct _GwGhwFile
 {
     GwDumpFile parent_instance;
 
     GwHistEntFactory *hist_ent_factory;
-};
 
+    /* only set up if the traces are imported on demand */
+    GwGhwHistory history;
+    gint64 traces_offset; /* start of the snapshot and cycle sections */
+    GwFac *mvlfacs; /* one per GHW signal, mv.mvlfac of nodes not imported yet */
+};
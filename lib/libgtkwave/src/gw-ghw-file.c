@@ -5,6 +5,80 @@
 
 G_DEFINE_TYPE(GwGhwFile, gw_ghw_file, GW_TYPE_DUMP_FILE)
 
+static gboolean gw_ghw_file_import_traces(GwDumpFile *dump_file, GwNode **nodes, GError **error)
+{
+    GwGhwFile *self = GW_GHW_FILE(dump_file);
+    GwGhwHistory *history = &self->history;
+    guint8 *wanted = NULL;
+
+    if (self->mvlfacs == NULL) {
+        return TRUE; /* file without signals */
+    }
+
+    for (GwNode **iter = nodes; *iter != NULL; iter++) {
+        GwNode *node = *iter;
+
+        if (node->mv.mvlfac != NULL) {
+            gsize sig = node->mv.mvlfac - self->mvlfacs;
+
+            if (history->nxp[sig]->mv.mvlfac != NULL) {
+                if (wanted == NULL) {
+                    wanted = g_new0(guint8, history->h->nbr_sigs + 1);
+                }
+                wanted[sig] = 1;
+            }
+        }
+    }
+
+    /* all requested signals are read in a single pass over the cycles */
+    if (wanted != NULL) {
+        if (ghw_seek(history->h, self->traces_offset) < 0) {
+            g_set_error(error,
+                        GW_DUMP_FILE_ERROR,
+                        GW_DUMP_FILE_ERROR_UNKNOWN,
+                        "Failed to seek in GHW file");
+            g_free(wanted);
+            return FALSE;
+        }
+
+        /* glitches are only seen once the value changes of a signal are read */
+        history->num_glitches = 0;
+        history->num_glitch_regions = 0;
+        gw_ghw_history_read(history, wanted);
+        if (history->num_glitches) {
+            fprintf(stderr,
+                    "Warning: encountered %d glitch%s across %d glitch region%s.\n",
+                    history->num_glitches,
+                    (history->num_glitches != 1) ? "es" : "",
+                    history->num_glitch_regions,
+                    (history->num_glitch_regions != 1) ? "s" : "");
+        }
+
+        for (guint32 i = 0; i < history->h->nbr_sigs; i++) {
+            if (wanted[i]) {
+                history->nxp[i]->mv.mvlfac = NULL;
+            }
+        }
+
+        g_free(wanted);
+    }
+
+    /* aliases are copies of the node of their signal and share its history */
+    for (GwNode **iter = nodes; *iter != NULL; iter++) {
+        GwNode *node = *iter;
+
+        if (node->mv.mvlfac != NULL) {
+            GwNode *n = history->nxp[node->mv.mvlfac - self->mvlfacs];
+
+            node->head = n->head;
+            node->curr = n->curr;
+            node->mv.mvlfac = NULL;
+        }
+    }
+
+    return TRUE;
+}
+
 static void gw_ghw_file_dispose(GObject *object)
 {
     GwGhwFile *self = GW_GHW_FILE(object);
@@ -14,14 +88,326 @@ static void gw_ghw_file_dispose(GObject *object)
     G_OBJECT_CLASS(gw_ghw_file_parent_class)->dispose(object);
 }
 
+static void gw_ghw_file_finalize(GObject *object)
+{
+    GwGhwFile *self = GW_GHW_FILE(object);
+
+    if (self->history.h != NULL) {
+        ghw_close(self->history.h);
+        g_free(self->history.h);
+    }
+    g_free(self->history.nxp);
+    g_free(self->mvlfacs);
+
+    G_OBJECT_CLASS(gw_ghw_file_parent_class)->finalize(object);
+}
+
+static GwHistEntFactory *gw_ghw_file_get_hist_ent_factory(GwDumpFile *dump_file)
+{
+    return GW_GHW_FILE(dump_file)->hist_ent_factory;
+}
+
 static void gw_ghw_file_class_init(GwGhwFileClass *klass)
 {
     GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    GwDumpFileClass *dump_file_class = GW_DUMP_FILE_CLASS(klass);
 
     object_class->dispose = gw_ghw_file_dispose;
+    object_class->finalize = gw_ghw_file_finalize;
+
+    dump_file_class->import_traces = gw_ghw_file_import_traces;
+    dump_file_class->get_hist_ent_factory = gw_ghw_file_get_hist_ent_factory;
 }
 
 static void gw_ghw_file_init(GwGhwFile *self)
 {
     (void)self;
 }
+
+static void add_history(GwGhwHistory *self, GwNode *n, int sig_num)
+{
+    GwHistEnt *he;
+    struct ghw_sig *sig = &self->h->sigs[sig_num];
+    union ghw_type *sig_type = sig->type;
+    int flags;
+    int is_vector = 0;
+    int is_double = 0;
+
+    if (sig_type == NULL) {
+        return;
+    }
+
+    switch (sig_type->kind) {
+        case ghdl_rtik_type_i32:
+        case ghdl_rtik_type_i64:
+        case ghdl_rtik_type_p32:
+        case ghdl_rtik_type_p64:
+            flags = 0;
+            break;
+
+        case ghdl_rtik_type_b2:
+            if (sig_type->en.wkt == ghw_wkt_bit) {
+                flags = 0;
+                break;
+            }
+            /* FALLTHROUGH */
+
+        case ghdl_rtik_type_e8:
+            if (sig_type->en.wkt == ghw_wkt_std_ulogic) {
+                flags = 0;
+                break;
+            }
+            /* FALLTHROUGH */
+
+        case ghdl_rtik_type_e32:
+            flags = GW_HIST_ENT_FLAG_STRING | GW_HIST_ENT_FLAG_REAL;
+            if (GW_HIST_ENT_FLAG_STRING == 0) {
+                if (!self->warned) {
+                    fprintf(stderr, "warning: do not compile with STRICT_VCD\n");
+                    self->warned = TRUE;
+                }
+                return;
+            }
+            break;
+
+        case ghdl_rtik_type_f64:
+            flags = GW_HIST_ENT_FLAG_REAL;
+            break;
+
+        default:
+            fprintf(stderr, "ghw:add_history: unhandled kind %d\n", sig->type->kind);
+            return;
+    }
+
+    if (!n->curr) {
+        he = gw_hist_ent_factory_alloc(self->hist_ent_factory);
+        he->flags = flags;
+        he->time = -1;
+        he->v.h_vector = NULL;
+
+        n->head.next = he;
+        n->curr = he;
+        n->head.time = -2;
+    }
+
+    he = gw_hist_ent_factory_alloc(self->hist_ent_factory);
+    he->flags = flags;
+    he->time = self->h->snap_time;
+
+    switch (sig_type->kind) {
+        case ghdl_rtik_type_b2:
+            if (sig_type->en.wkt == ghw_wkt_bit)
+                he->v.h_val = sig->val->b2 == 0 ? GW_BIT_0 : GW_BIT_1;
+            else {
+                if (sig->val->b2 >= sig->type->en.nbr)
+                    ghw_error_exit();
+                he->v.h_vector = (char *)sig->type->en.lits[sig->val->b2];
+                is_vector = 1;
+            }
+            break;
+
+        case ghdl_rtik_type_e8: {
+            unsigned char val_e8 = sig->val->e8;
+            if (sig_type->en.wkt == ghw_wkt_std_ulogic) {
+                /* Res: 0->0, 1->X, 2->Z, 3->1 */
+                static const char map_su2vlg[9] = {/* U */ GW_BIT_U,
+                                                   /* X */ GW_BIT_X,
+                                                   /* 0 */ GW_BIT_0,
+                                                   /* 1 */ GW_BIT_1,
+                                                   /* Z */ GW_BIT_Z,
+                                                   /* W */ GW_BIT_W,
+                                                   /* L */ GW_BIT_L,
+                                                   /* H */ GW_BIT_H,
+                                                   /* - */ GW_BIT_DASH};
+                if (val_e8 >= sizeof(map_su2vlg) / sizeof(map_su2vlg[0]))
+                    ghw_error_exit();
+                he->v.h_val = map_su2vlg[val_e8];
+            } else {
+                if (val_e8 >= sig_type->en.nbr)
+                    ghw_error_exit();
+                he->v.h_vector = (char *)sig_type->en.lits[val_e8];
+                is_vector = 1;
+            }
+            break;
+        }
+
+        case ghdl_rtik_type_f64: {
+            he->v.h_double = sig->val->f64;
+            is_double = 1;
+        } break;
+
+        case ghdl_rtik_type_i32:
+        case ghdl_rtik_type_p32: {
+            he->v.h_vector = g_malloc(32);
+            for (gint i = 0; i < 32; i++) {
+                he->v.h_vector[31 - i] = ((sig->val->i32 >> i) & 1) ? GW_BIT_1 : GW_BIT_0;
+            }
+
+            is_vector = 1;
+            break;
+        }
+
+        case ghdl_rtik_type_i64:
+        case ghdl_rtik_type_p64: {
+            he->v.h_vector = g_malloc(64);
+            for (gint i = 0; i < 64; i++) {
+                he->v.h_vector[63 - i] = ((sig->val->i64 >> i) & 1) ? GW_BIT_1 : GW_BIT_0;
+            }
+
+            is_vector = 1;
+            break;
+        }
+
+        default:
+            abort();
+    }
+
+    /* deglitch */
+    if (n->curr->time == he->time) {
+        int gl_add = 0;
+
+        if (n->curr->time) /* filter out time zero glitches */
+        {
+            gl_add = 1;
+        }
+
+        self->num_glitches += gl_add;
+
+        if (!(n->curr->flags & GW_HIST_ENT_FLAG_GLITCH)) {
+            if (gl_add) {
+                n->curr->flags |= GW_HIST_ENT_FLAG_GLITCH; /* set the glitch flag */
+                self->num_glitch_regions++;
+            }
+        }
+
+        if (is_double) {
+            n->curr->v.h_double = he->v.h_double;
+        } else if (is_vector) {
+            if (n->curr->v.h_vector && sig_type->kind != ghdl_rtik_type_b2 &&
+                sig_type->kind != ghdl_rtik_type_e8)
+                g_free(n->curr->v.h_vector);
+            n->curr->v.h_vector = he->v.h_vector;
+            /* can't free up this "he" because of block allocation so assume it's dead */
+        } else {
+            n->curr->v.h_val = he->v.h_val;
+        }
+        return;
+    } else /* look for duplicate dumps of same value at adjacent times */
+    {
+        if (!is_vector & !is_double) {
+            if (n->curr->v.h_val == he->v.h_val) {
+                return;
+                /* can't free up this "he" because of block allocation so assume it's dead */
+            }
+        }
+    }
+
+    n->curr->next = he;
+    n->curr = he;
+}
+
+static void add_tail(GwGhwHistory *self, const guint8 *wanted)
+{
+    unsigned int i;
+    GwTime j;
+
+    for (j = 1; j >= 0; j--) /* add two endcaps */
+        for (i = 0; i < self->h->nbr_sigs; i++) {
+            struct ghw_sig *sig = &self->h->sigs[i];
+            GwNode *n = self->nxp[i];
+            GwHistEnt *he;
+
+            if (sig->type == NULL || n == NULL || !n->curr || (wanted && !wanted[i]))
+                continue;
+
+            /* Copy the last one.  */
+            he = gw_hist_ent_factory_alloc(self->hist_ent_factory);
+            *he = *n->curr;
+            he->time = GW_TIME_MAX - j;
+            he->next = NULL;
+
+            /* Append.  */
+            n->curr->next = he;
+            n->curr = he;
+        }
+}
+
+static void read_traces(GwGhwHistory *self, const guint8 *wanted)
+{
+    int *list;
+    unsigned int i;
+    enum ghw_res res;
+
+    struct ghw_handler *h = self->h;
+
+    list = g_malloc((h->nbr_sigs + 1) * sizeof(int));
+
+    while (1) {
+        res = ghw_read_sm_hdr(h, list);
+        switch (res) {
+            case ghw_res_error:
+            case ghw_res_eof:
+                g_free(list);
+                return;
+            case ghw_res_ok:
+            case ghw_res_other:
+                break;
+            case ghw_res_snapshot:
+                if (h->snap_time > self->max_time) {
+                    self->max_time = h->snap_time;
+                }
+                /* printf ("Time is "GHWPRI64"\n", h->snap_time); */
+
+                for (i = 0; i < h->nbr_sigs; i++) {
+                    if (!wanted || wanted[i])
+                        add_history(self, self->nxp[i], i);
+                }
+                break;
+            case ghw_res_cycle:
+                while (1) {
+                    int sig;
+
+                    /* printf ("Time is "GHWPRI64"\n", h->snap_time); */
+                    if (h->snap_time < GW_TIME_CONSTANT(9223372036854775807)) {
+                        if (h->snap_time > self->max_time) {
+                            self->max_time = h->snap_time;
+                        }
+
+                        for (i = 0; (sig = list[i]) != 0; i++) {
+                            size_t nxp_idx = (size_t)sig;
+                            if (nxp_idx > self->h->nbr_sigs)
+                                ghw_error_exit();
+                            if (!wanted || wanted[nxp_idx])
+                                add_history(self, self->nxp[nxp_idx], sig);
+                        }
+                    }
+                    res = ghw_read_cycle_next(h);
+                    if (res != 1)
+                        break;
+                    res = ghw_read_cycle_cont(h, list);
+                    if (res < 0)
+                        break;
+                }
+                if (res < 0)
+                    break;
+                res = ghw_read_cycle_end(h);
+                if (res < 0)
+                    break;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/*
+ * reads the snapshot and cycle sections from the current position of the
+ * stream to the end and adds the value changes of the signals flagged in
+ * wanted (all signals if wanted is NULL) to their nodes.  with no signal
+ * flagged this only determines the end time.
+ */
+void gw_ghw_history_read(GwGhwHistory *self, const guint8 *wanted)
+{
+    read_traces(self, wanted);
+    add_tail(self, wanted);
+}
@@ -20,19 +20,15 @@ struct _GwGhwLoader
     struct ghw_tree_node *gwt;
     struct ghw_tree_node *gwt_corr;
     int nbr_sig_ref;
-    int num_glitches;
-    int num_glitch_regions;
     char *asbuf;
     char *fac_name;
     int fac_name_len;
     int fac_name_max;
-    gboolean warned;
 
     GSList *sym_chain;
 
     GwFacs *facs;
     GwTreeNode *treeroot;
-    GwTime max_time;
 
     GwHistEntFactory *hist_ent_factory;
 };
@@ -878,286 +874,13 @@ static void set_fac_name(GwGhwLoader *self)
     set_fac_name_1(self, self->treeroot);
 }
 
-static void add_history(GwGhwLoader *self, GwNode *n, int sig_num)
-{
-    GwHistEnt *he;
-    struct ghw_sig *sig = &self->h->sigs[sig_num];
-    union ghw_type *sig_type = sig->type;
-    int flags;
-    int is_vector = 0;
-    int is_double = 0;
-
-    if (sig_type == NULL) {
-        return;
-    }
-
-    switch (sig_type->kind) {
-        case ghdl_rtik_type_i32:
-        case ghdl_rtik_type_i64:
-        case ghdl_rtik_type_p32:
-        case ghdl_rtik_type_p64:
-            flags = 0;
-            break;
-
-        case ghdl_rtik_type_b2:
-            if (sig_type->en.wkt == ghw_wkt_bit) {
-                flags = 0;
-                break;
-            }
-            /* FALLTHROUGH */
-
-        case ghdl_rtik_type_e8:
-            if (sig_type->en.wkt == ghw_wkt_std_ulogic) {
-                flags = 0;
-                break;
-            }
-            /* FALLTHROUGH */
-
-        case ghdl_rtik_type_e32:
-            flags = GW_HIST_ENT_FLAG_STRING | GW_HIST_ENT_FLAG_REAL;
-            if (GW_HIST_ENT_FLAG_STRING == 0) {
-                if (!self->warned) {
-                    fprintf(stderr, "warning: do not compile with STRICT_VCD\n");
-                    self->warned = TRUE;
-                }
-                return;
-            }
-            break;
-
-        case ghdl_rtik_type_f64:
-            flags = GW_HIST_ENT_FLAG_REAL;
-            break;
-
-        default:
-            fprintf(stderr, "ghw:add_history: unhandled kind %d\n", sig->type->kind);
-            return;
-    }
-
-    if (!n->curr) {
-        he = gw_hist_ent_factory_alloc(self->hist_ent_factory);
-        he->flags = flags;
-        he->time = -1;
-        he->v.h_vector = NULL;
-
-        n->head.next = he;
-        n->curr = he;
-        n->head.time = -2;
-    }
-
-    he = gw_hist_ent_factory_alloc(self->hist_ent_factory);
-    he->flags = flags;
-    he->time = self->h->snap_time;
-
-    switch (sig_type->kind) {
-        case ghdl_rtik_type_b2:
-            if (sig_type->en.wkt == ghw_wkt_bit)
-                he->v.h_val = sig->val->b2 == 0 ? GW_BIT_0 : GW_BIT_1;
-            else {
-                if (sig->val->b2 >= sig->type->en.nbr)
-                    ghw_error_exit();
-                he->v.h_vector = (char *)sig->type->en.lits[sig->val->b2];
-                is_vector = 1;
-            }
-            break;
-
-        case ghdl_rtik_type_e8: {
-            unsigned char val_e8 = sig->val->e8;
-            if (sig_type->en.wkt == ghw_wkt_std_ulogic) {
-                /* Res: 0->0, 1->X, 2->Z, 3->1 */
-                static const char map_su2vlg[9] = {/* U */ GW_BIT_U,
-                                                   /* X */ GW_BIT_X,
-                                                   /* 0 */ GW_BIT_0,
-                                                   /* 1 */ GW_BIT_1,
-                                                   /* Z */ GW_BIT_Z,
-                                                   /* W */ GW_BIT_W,
-                                                   /* L */ GW_BIT_L,
-                                                   /* H */ GW_BIT_H,
-                                                   /* - */ GW_BIT_DASH};
-                if (val_e8 >= sizeof(map_su2vlg) / sizeof(map_su2vlg[0]))
-                    ghw_error_exit();
-                he->v.h_val = map_su2vlg[val_e8];
-            } else {
-                if (val_e8 >= sig_type->en.nbr)
-                    ghw_error_exit();
-                he->v.h_vector = (char *)sig_type->en.lits[val_e8];
-                is_vector = 1;
-            }
-            break;
-        }
-
-        case ghdl_rtik_type_f64: {
-            he->v.h_double = sig->val->f64;
-            is_double = 1;
-        } break;
-
-        case ghdl_rtik_type_i32:
-        case ghdl_rtik_type_p32: {
-            he->v.h_vector = g_malloc(32);
-            for (gint i = 0; i < 32; i++) {
-                he->v.h_vector[31 - i] = ((sig->val->i32 >> i) & 1) ? GW_BIT_1 : GW_BIT_0;
-            }
-
-            is_vector = 1;
-            break;
-        }
-
-        case ghdl_rtik_type_i64:
-        case ghdl_rtik_type_p64: {
-            he->v.h_vector = g_malloc(64);
-            for (gint i = 0; i < 64; i++) {
-                he->v.h_vector[63 - i] = ((sig->val->i64 >> i) & 1) ? GW_BIT_1 : GW_BIT_0;
-            }
-
-            is_vector = 1;
-            break;
-        }
-
-        default:
-            abort();
-    }
-
-    /* deglitch */
-    if (n->curr->time == he->time) {
-        int gl_add = 0;
-
-        if (n->curr->time) /* filter out time zero glitches */
-        {
-            gl_add = 1;
-        }
-
-        self->num_glitches += gl_add;
-
-        if (!(n->curr->flags & GW_HIST_ENT_FLAG_GLITCH)) {
-            if (gl_add) {
-                n->curr->flags |= GW_HIST_ENT_FLAG_GLITCH; /* set the glitch flag */
-                self->num_glitch_regions++;
-            }
-        }
-
-        if (is_double) {
-            n->curr->v.h_double = he->v.h_double;
-        } else if (is_vector) {
-            if (n->curr->v.h_vector && sig_type->kind != ghdl_rtik_type_b2 &&
-                sig_type->kind != ghdl_rtik_type_e8)
-                g_free(n->curr->v.h_vector);
-            n->curr->v.h_vector = he->v.h_vector;
-            /* can't free up this "he" because of block allocation so assume it's dead */
-        } else {
-            n->curr->v.h_val = he->v.h_val;
-        }
-        return;
-    } else /* look for duplicate dumps of same value at adjacent times */
-    {
-        if (!is_vector & !is_double) {
-            if (n->curr->v.h_val == he->v.h_val) {
-                return;
-                /* can't free up this "he" because of block allocation so assume it's dead */
-            }
-        }
-    }
-
-    n->curr->next = he;
-    n->curr = he;
-}
-
-static void add_tail(GwGhwLoader *self)
-{
-    unsigned int i;
-    GwTime j;
-
-    for (j = 1; j >= 0; j--) /* add two endcaps */
-        for (i = 0; i < self->h->nbr_sigs; i++) {
-            struct ghw_sig *sig = &self->h->sigs[i];
-            GwNode *n = self->nxp[i];
-            GwHistEnt *he;
-
-            if (sig->type == NULL || n == NULL || !n->curr)
-                continue;
-
-            /* Copy the last one.  */
-            he = gw_hist_ent_factory_alloc(self->hist_ent_factory);
-            *he = *n->curr;
-            he->time = GW_TIME_MAX - j;
-            he->next = NULL;
-
-            /* Append.  */
-            n->curr->next = he;
-            n->curr = he;
-        }
-}
-
-static void read_traces(GwGhwLoader *self)
-{
-    int *list;
-    unsigned int i;
-    enum ghw_res res;
-
-    list = g_malloc((gw_facs_get_length(self->facs) + 1) * sizeof(int));
-
-    struct ghw_handler *h = self->h;
-
-    while (1) {
-        res = ghw_read_sm_hdr(h, list);
-        switch (res) {
-            case ghw_res_error:
-            case ghw_res_eof:
-                g_free(list);
-                return;
-            case ghw_res_ok:
-            case ghw_res_other:
-                break;
-            case ghw_res_snapshot:
-                if (h->snap_time > self->max_time) {
-                    self->max_time = h->snap_time;
-                }
-                /* printf ("Time is "GHWPRI64"\n", h->snap_time); */
-
-                for (i = 0; i < h->nbr_sigs; i++)
-                    add_history(self, self->nxp[i], i);
-                break;
-            case ghw_res_cycle:
-                while (1) {
-                    int sig;
-
-                    /* printf ("Time is "GHWPRI64"\n", h->snap_time); */
-                    if (h->snap_time < GW_TIME_CONSTANT(9223372036854775807)) {
-                        if (h->snap_time > self->max_time) {
-                            self->max_time = h->snap_time;
-                        }
-
-                        for (i = 0; (sig = list[i]) != 0; i++) {
-                            size_t nxp_idx = (size_t)sig;
-                            if (nxp_idx > self->h->nbr_sigs)
-                                ghw_error_exit();
-                            add_history(self, self->nxp[nxp_idx], sig);
-                        }
-                    }
-                    res = ghw_read_cycle_next(h);
-                    if (res != 1)
-                        break;
-                    res = ghw_read_cycle_cont(h, list);
-                    if (res < 0)
-                        break;
-                }
-                if (res < 0)
-                    break;
-                res = ghw_read_cycle_end(h);
-                if (res < 0)
-                    break;
-                break;
-            default:
-                break;
-        }
-    }
-}
-
 /*******************************************************************************/
 
 GwDumpFile *gw_ghw_loader_load(GwLoader *loader, const gchar *fname, GError **error)
 {
     GwGhwLoader *self = GW_GHW_LOADER(loader);
 
-    struct ghw_handler handle = {0};
+    struct ghw_handler *handle = g_new0(struct ghw_handler, 1);
     unsigned int ui;
     int rc;
 
@@ -1166,45 +889,70 @@ GwDumpFile *gw_ghw_loader_load(GwLoader *loader, const gchar *fname, GError **er
     //     GLOBALS->hier_delimeter = '.';
     // }
 
-    handle.flag_verbose = 0;
-    if ((rc = ghw_open(&handle, fname)) < 0) {
+    handle->flag_verbose = 0;
+    if ((rc = ghw_open(handle, fname)) < 0) {
         g_set_error(error,
                     GW_DUMP_FILE_ERROR,
                     GW_DUMP_FILE_ERROR_UNKNOWN,
                     "Failed to open GHW file (error code %d)",
                     rc);
+        ghw_close(handle);
+        g_free(handle);
         return NULL;
     }
 
-    if (ghw_read_base(&handle) < 0) {
+    if (ghw_read_base(handle) < 0) {
         fprintf(stderr, "Error in ghw file '%s'.\n", fname);
+        ghw_close(handle);
+        g_free(handle);
         return NULL; /* look at return code in caller for success status... */
     }
 
-    if (handle.hie == NULL) {
+    if (handle->hie == NULL) {
         fprintf(stderr, "Error in ghw file '%s': No HIE.\n", fname);
+        ghw_close(handle);
+        g_free(handle);
         return NULL; /* look at return code in caller for success status... */
     }
 
-    self->h = &handle;
+    self->h = handle;
     self->asbuf = g_malloc(4097);
 
-    self->nxp = g_new0(GwNode *, handle.nbr_sigs);
-    for (ui = 0; ui < handle.nbr_sigs; ui++) {
+    self->nxp = g_new0(GwNode *, handle->nbr_sigs);
+    for (ui = 0; ui < handle->nbr_sigs; ui++) {
         self->nxp[ui] = g_new0(GwNode, 1);
     }
 
-    self->treeroot = build_hierarchy(self, handle.hie);
+    self->treeroot = build_hierarchy(self, handle->hie);
     /* GHW does not contains a 'top' name.
        FIXME: should use basename of the file.  */
 
     create_facs(self);
-    read_traces(self);
-    add_tail(self);
+
+    GwGhwHistory history = {
+        .h = handle,
+        .nxp = self->nxp,
+        .hist_ent_factory = self->hist_ent_factory,
+    };
+
+    /* the file is only scanned for its end time here, the value changes of a
+       signal are read when it is imported */
+    gint64 traces_offset = ghw_tell(handle);
+    guint8 *none = g_new0(guint8, handle->nbr_sigs + 1);
+    gw_ghw_history_read(&history, none);
+    g_free(none);
+
+    GwFac *mvlfacs = g_new0(GwFac, handle->nbr_sigs);
+    for (ui = 0; ui < handle->nbr_sigs; ui++) {
+        mvlfacs[ui].working_node = self->nxp[ui];
+        if (handle->sigs[ui].type != NULL) {
+            self->nxp[ui]->mv.mvlfac = &mvlfacs[ui];
+        }
+    }
 
     set_fac_name(self);
 
-    g_clear_pointer(&self->nxp, g_free);
+    self->nxp = NULL; /* owned by the dump file from now on */
 
     /* fix up names on aliased nodes via cloning... */
     for (guint i = 0; i < gw_facs_get_length(self->facs); i++) {
@@ -1232,7 +980,7 @@ GwDumpFile *gw_ghw_loader_load(GwLoader *loader, const gchar *fname, GError **er
         self->treeroot = t;
     }
 
-    ghw_close(&handle);
+    self->h = NULL;
 
     rechain_facs(self); /* vectorize bitblasted nets */
     ghw_sortfacs(self); /* sort nets as ghw is unsorted ... also fix hier tree (it should really be
@@ -1246,17 +994,10 @@ GwDumpFile *gw_ghw_loader_load(GwLoader *loader, const gchar *fname, GError **er
     fprintf(stderr,
             "[%" GW_TIME_FORMAT "] start time.\n[%" GW_TIME_FORMAT "] end time.\n",
             GW_TIME_CONSTANT(0),
-            self->max_time);
-    if (self->num_glitches)
-        fprintf(stderr,
-                "Warning: encountered %d glitch%s across %d glitch region%s.\n",
-                self->num_glitches,
-                (self->num_glitches != 1) ? "es" : "",
-                self->num_glitch_regions,
-                (self->num_glitch_regions != 1) ? "s" : "");
+            history.max_time);
 
     GwTree *tree = gw_tree_new(g_steal_pointer(&self->treeroot));
-    GwTimeRange *time_range = gw_time_range_new(0, self->max_time);
+    GwTimeRange *time_range = gw_time_range_new(0, history.max_time);
 
     // clang-format off
     GwGhwFile *dump_file = g_object_new(GW_TYPE_GHW_FILE,
@@ -1268,6 +1009,9 @@ GwDumpFile *gw_ghw_loader_load(GwLoader *loader, const gchar *fname, GError **er
     // clang-format on
 
     dump_file->hist_ent_factory = g_steal_pointer(&self->hist_ent_factory);
+    dump_file->history = history;
+    dump_file->traces_offset = traces_offset;
+    dump_file->mvlfacs = mvlfacs;
 
     g_object_unref(tree);
     g_object_unref(time_range);
@@ -1,4 +1,5 @@
 #include "gw-hist-ent-factory.h"
+#include "gw-stats.h"
 
 #define BLOCK_SIZE (64 * 1024)
 #define HIST_ENTS_PER_BLOCK (BLOCK_SIZE / sizeof(GwHistEnt))
@@ -18,6 +19,7 @@ static void gw_hist_ent_factory_finalize(GObject *object)
 {
     GwHistEntFactory *self = GW_HIST_ENT_FACTORY(object);
 
+    gw_stats_counter_add(GW_STATS_COUNTER_HIST_ENTS, -(gint64)self->blocks->len * BLOCK_SIZE);
     g_ptr_array_free(self->blocks, TRUE);
 
     G_OBJECT_CLASS(gw_hist_ent_factory_parent_class)->finalize(object);
@@ -46,6 +48,7 @@ GwHistEnt *gw_hist_ent_factory_alloc(GwHistEntFactory *self)
 
     if (self->next_index == HIST_ENTS_PER_BLOCK || self->blocks->len == 0) {
         self->current_block = g_malloc0(BLOCK_SIZE);
+        gw_stats_counter_add(GW_STATS_COUNTER_HIST_ENTS, BLOCK_SIZE);
 
         g_ptr_array_add(self->blocks, self->current_block);
         self->next_index = 0;
@@ -56,4 +59,37 @@ GwHistEnt *gw_hist_ent_factory_alloc(GwHistEntFactory *self)
     self->next_index++;
 
     return h;
-}
\ No newline at end of file
+}
+
+/**
+ * gw_hist_ent_factory_get_allocated_bytes:
+ * @self: A #GwHistEntFactory.
+ *
+ * Returns: The number of bytes in all allocated blocks.
+ */
+gsize gw_hist_ent_factory_get_allocated_bytes(GwHistEntFactory *self)
+{
+    g_return_val_if_fail(GW_IS_HIST_ENT_FACTORY(self), 0);
+
+    return self->blocks->len * BLOCK_SIZE;
+}
+
+/**
+ * gw_hist_ent_factory_get_used_bytes:
+ * @self: A #GwHistEntFactory.
+ *
+ * Returns: The number of bytes in history entries returned by
+ *          gw_hist_ent_factory_alloc().
+ */
+gsize gw_hist_ent_factory_get_used_bytes(GwHistEntFactory *self)
+{
+    g_return_val_if_fail(GW_IS_HIST_ENT_FACTORY(self), 0);
+
+    if (self->blocks->len == 0) {
+        return 0;
+    }
+
+    gsize count = (self->blocks->len - 1) * HIST_ENTS_PER_BLOCK + self->next_index;
+
+    return count * sizeof(GwHistEnt);
+}
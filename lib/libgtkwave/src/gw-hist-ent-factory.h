@@ -12,4 +12,7 @@ GwHistEntFactory *gw_hist_ent_factory_new(void);
 
 GwHistEnt *gw_hist_ent_factory_alloc(GwHistEntFactory *self);
 
+gsize gw_hist_ent_factory_get_allocated_bytes(GwHistEntFactory *self);
+gsize gw_hist_ent_factory_get_used_bytes(GwHistEntFactory *self);
+
 G_END_DECLS
@@ -1,4 +1,5 @@
 #include "gw-loader.h"
+#include "gw-stats.h"
 
 typedef struct
 {
@@ -24,6 +25,14 @@ enum
 
 static GParamSpec *properties[N_PROPERTIES];
 
+enum
+{
+    PROGRESS,
+    N_SIGNALS,
+};
+
+static guint signals[N_SIGNALS];
+
 static void gw_loader_set_property(GObject *object,
                                    guint property_id,
                                    const GValue *value,
@@ -123,6 +132,26 @@ static void gw_loader_class_init(GwLoaderClass *klass)
                            G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
     g_object_class_install_properties(object_class, N_PROPERTIES, properties);
+
+    /**
+     * GwLoader::progress:
+     * @loader: The #GwLoader.
+     * @current: The number of bytes that have been processed.
+     * @total: The total number of bytes or %0 if the size is unknown.
+     *
+     * The "progress" signal is emitted periodically while a dump file is loaded.
+     */
+    signals[PROGRESS] = g_signal_new("progress",
+                                     GW_TYPE_LOADER,
+                                     G_SIGNAL_RUN_LAST,
+                                     0,
+                                     NULL,
+                                     NULL,
+                                     NULL,
+                                     G_TYPE_NONE,
+                                     2,
+                                     G_TYPE_UINT64,
+                                     G_TYPE_UINT64);
 }
 
 static void gw_loader_init(GwLoader *self)
@@ -154,7 +183,10 @@ GwDumpFile *gw_loader_load(GwLoader *self, const gchar *path, GError **error)
     g_return_val_if_fail(!priv->already_used, NULL);
 
     g_return_val_if_fail(GW_LOADER_GET_CLASS(self)->load != NULL, NULL);
+
+    gint64 stats_begin = gw_stats_timer_begin();
     GwDumpFile *file = GW_LOADER_GET_CLASS(self)->load(self, path, error);
+    gw_stats_timer_end(GW_STATS_TIMER_LOAD, stats_begin);
 
     priv->already_used = TRUE;
 
@@ -254,3 +286,19 @@ gchar gw_loader_get_hierarchy_delimiter(GwLoader *self)
 
     return priv->hierarchy_delimiter;
 }
+
+/**
+ * gw_loader_emit_progress:
+ * @self: A #GwLoader.
+ * @current: The number of bytes that have been processed.
+ * @total: The total number of bytes or %0 if the size is unknown.
+ *
+ * Emits the #GwLoader::progress signal. This function is intended to be used
+ * by #GwLoader subclasses.
+ */
+void gw_loader_emit_progress(GwLoader *self, guint64 current, guint64 total)
+{
+    g_return_if_fail(GW_IS_LOADER(self));
+
+    g_signal_emit(self, signals[PROGRESS], 0, current, total);
+}
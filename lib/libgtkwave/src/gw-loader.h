@@ -26,4 +26,6 @@ gboolean gw_loader_is_autocoalesce(GwLoader *self);
 void gw_loader_set_hierarchy_delimiter(GwLoader *self, gchar delimiter);
 gchar gw_loader_get_hierarchy_delimiter(GwLoader *self);
 
+void gw_loader_emit_progress(GwLoader *self, guint64 current, guint64 total);
+
 G_END_DECLS
@@ -0,0 +1,468 @@
+#include "gw-lx2.h"
+#include <stdio.h>
+
+// Fac flags as stored by the LXT2 and VZT writers. The low bits are the same
+// as GwFacFlags.
+#define LX2_SYM_F_IN (1 << 12)
+#define LX2_SYM_F_OUT (1 << 13)
+#define LX2_SYM_F_INOUT (1 << 14)
+
+#define LX2_FAC_FLAGS_MASK \
+    (GW_FAC_FLAG_INTEGER | GW_FAC_FLAG_DOUBLE | GW_FAC_FLAG_STRING | GW_FAC_FLAG_ALIAS)
+
+struct _GwLx2Builder
+{
+    GwTreeBuilder *tree_builder;
+    gchar delimiter[2];
+    GPtrArray *scope;
+
+    GwFacs *facs;
+    GwSymbol *symbols;
+    GwNode *nodes;
+    GwFac *mvlfacs;
+
+    GwTreeNode *terminals_chain;
+};
+
+/*
+ * returns the fac that holds the value changes of node, which differs from
+ * the node's own fac for aliases
+ */
+static guint32 gw_lx2_history_get_root(GwLx2History *self, GwNode *node)
+{
+    GwFac *f = node->mv.mvlfac;
+    guint32 facidx = f - self->mvlfacs;
+
+    if (f->flags & GW_FAC_FLAG_ALIAS) {
+        facidx = f->node_alias;
+    }
+
+    return facidx;
+}
+
+static gboolean gw_lx2_history_needs_import(GwLx2History *self, GwNode *node, guint32 *facidx)
+{
+    if (node->mv.mvlfac == NULL) {
+        return FALSE; /* already imported */
+    }
+
+    guint32 root = gw_lx2_history_get_root(self, node);
+    GwNode *np = self->mvlfacs[root].working_node;
+
+    if (np->mv.mvlfac == NULL) {
+        return FALSE; /* alias of an imported signal */
+    }
+
+    self->table[root].np = np;
+    *facidx = root;
+
+    return TRUE;
+}
+
+void gw_lx2_history_add_value(GwLx2History *self, guint32 facidx, guint64 time, const gchar *value)
+{
+    GwLx2Entry *l2e = &self->table[facidx];
+    GwFac *f = &self->mvlfacs[facidx];
+    GwHistEnt *htemp;
+
+    if (!(f->flags & (GW_FAC_FLAG_DOUBLE | GW_FAC_FLAG_STRING))) {
+        if (f->len > 1) {
+            char *h_vector = g_malloc(f->len);
+            for (gint i = 0; i < f->len; i++) {
+                h_vector[i] = gw_bit_from_char(value[i]);
+            }
+
+            if (l2e->histent_curr != NULL && !self->preserve_glitches &&
+                memcmp(l2e->histent_curr->v.h_vector, h_vector, f->len) == 0) {
+                g_free(h_vector);
+                return; /* remove duplicate values */
+            }
+
+            htemp = gw_hist_ent_factory_alloc(self->hist_ent_factory);
+            htemp->v.h_vector = h_vector;
+        } else {
+            GwBit h_val = gw_bit_from_char(*value);
+
+            if (l2e->histent_curr != NULL && !self->preserve_glitches &&
+                l2e->histent_curr->v.h_val == h_val) {
+                return; /* remove duplicate values */
+            }
+
+            htemp = gw_hist_ent_factory_alloc(self->hist_ent_factory);
+            htemp->v.h_val = h_val;
+        }
+    } else if (f->flags & GW_FAC_FLAG_DOUBLE) {
+        gdouble d = g_ascii_strtod(value, NULL);
+
+        if (l2e->histent_curr != NULL && !self->preserve_glitches &&
+            !self->preserve_glitches_real && l2e->histent_curr->v.h_double == d) {
+            return; /* remove duplicate values */
+        }
+
+        htemp = gw_hist_ent_factory_alloc(self->hist_ent_factory);
+        htemp->v.h_double = d;
+        htemp->flags = GW_HIST_ENT_FLAG_REAL;
+    } else /* string */
+    {
+        if (l2e->histent_curr != NULL && !self->preserve_glitches &&
+            strcmp(l2e->histent_curr->v.h_vector, value) == 0) {
+            return; /* remove duplicate values */
+        }
+
+        htemp = gw_hist_ent_factory_alloc(self->hist_ent_factory);
+        htemp->v.h_vector = g_strdup(value);
+        htemp->flags = GW_HIST_ENT_FLAG_REAL | GW_HIST_ENT_FLAG_STRING;
+    }
+
+    htemp->time = time * self->time_scale;
+
+    if (l2e->histent_curr != NULL) {
+        l2e->histent_curr->next = htemp;
+        l2e->histent_curr = htemp;
+    } else {
+        l2e->histent_head = l2e->histent_curr = htemp;
+    }
+
+    l2e->numtrans++;
+}
+
+/*
+ * adds the sentinels around the value changes collected for facidx and
+ * attaches them to the node flagged by gw_lx2_history_needs_import()
+ */
+static void gw_lx2_history_finish(GwLx2History *self, guint32 facidx)
+{
+    GwLx2Entry *l2e = &self->table[facidx];
+    GwFac *f = &self->mvlfacs[facidx];
+    GwNode *np = l2e->np;
+    int len = f->len;
+    GwHistEnt *htemp;
+    GwHistEnt *htempx;
+    GwHistEnt *histent_tail;
+
+    histent_tail = htemp = gw_hist_ent_factory_alloc(self->hist_ent_factory);
+    if (len > 1) {
+        htemp->v.h_vector = g_malloc(len);
+        for (gint i = 0; i < len; i++) {
+            if (f->flags & GW_FAC_FLAG_STRING) {
+                htemp->v.h_vector[i] = 0;
+                htemp->flags = GW_HIST_ENT_FLAG_REAL | GW_HIST_ENT_FLAG_STRING;
+            } else {
+                htemp->v.h_vector[i] = GW_BIT_Z;
+            }
+        }
+    } else {
+        htemp->v.h_val = GW_BIT_Z; /* z */
+    }
+    htemp->time = GW_TIME_MAX;
+
+    htemp = gw_hist_ent_factory_alloc(self->hist_ent_factory);
+    if (len > 1) {
+        if (!(f->flags & GW_FAC_FLAG_DOUBLE)) {
+            if (!(f->flags & GW_FAC_FLAG_STRING)) {
+                htemp->v.h_vector = g_malloc(len);
+                for (gint i = 0; i < len; i++) {
+                    htemp->v.h_vector[i] = GW_BIT_X;
+                }
+            } else {
+                htemp->v.h_vector = g_strdup("UNDEF");
+                htemp->flags = GW_HIST_ENT_FLAG_REAL | GW_HIST_ENT_FLAG_STRING;
+            }
+        } else {
+            htemp->v.h_double = strtod("NaN", NULL);
+            htemp->flags = GW_HIST_ENT_FLAG_REAL;
+        }
+    } else {
+        htemp->v.h_val = GW_BIT_X; /* x */
+    }
+    htempx = htemp;
+    htemp->time = GW_TIME_MAX - 1;
+    htemp->next = histent_tail;
+
+    if (l2e->histent_curr != NULL) {
+        l2e->histent_curr->next = htemp;
+        htemp = l2e->histent_head;
+    }
+
+    if (!(f->flags & (GW_FAC_FLAG_DOUBLE | GW_FAC_FLAG_STRING))) {
+        if (len > 1) {
+            np->head.v.h_vector = g_malloc(len);
+            for (gint i = 0; i < len; i++) {
+                np->head.v.h_vector[i] = GW_BIT_X;
+            }
+        } else {
+            np->head.v.h_val = GW_BIT_X; /* x */
+        }
+    } else {
+        np->head.flags = GW_HIST_ENT_FLAG_REAL;
+        if (f->flags & GW_FAC_FLAG_STRING) {
+            np->head.flags |= GW_HIST_ENT_FLAG_STRING;
+        }
+    }
+
+    GwHistEnt *htemp2 = gw_hist_ent_factory_alloc(self->hist_ent_factory);
+    htemp2->time = -1;
+    if (len > 1) {
+        htemp2->v.h_vector = htempx->v.h_vector;
+        htemp2->flags = htempx->flags;
+    } else {
+        htemp2->v.h_val = htempx->v.h_val;
+    }
+    htemp2->next = htemp;
+    htemp = htemp2;
+    l2e->numtrans++;
+
+    np->head.time = -2;
+    np->head.next = htemp;
+    np->numhist = l2e->numtrans + 2 /*endcap*/ + 1 /*frontcap*/;
+
+    memset(l2e, 0, sizeof(GwLx2Entry)); /* zero it out */
+
+    np->curr = histent_tail;
+    np->mv.mvlfac = NULL; /* it's imported and cached so we can forget it's an mvlfac now */
+}
+
+/*
+ * aliases are separate nodes that share the history of their root fac
+ */
+static void gw_lx2_history_resolve_alias(GwLx2History *self, GwNode *node)
+{
+    if (node->mv.mvlfac == NULL) {
+        return;
+    }
+
+    GwNode *np = self->mvlfacs[gw_lx2_history_get_root(self, node)].working_node;
+    if (np == node || np->mv.mvlfac != NULL) {
+        return;
+    }
+
+    node->head = np->head;
+    node->curr = np->curr;
+    node->harray = np->harray;
+    node->numhist = np->numhist;
+    node->mv.mvlfac = NULL;
+}
+
+void gw_lx2_history_import(GwLx2History *self,
+                           const GwLx2ReaderFuncs *funcs,
+                           gpointer reader,
+                           GwNode **nodes)
+{
+    guint cnt = 0;
+
+    for (GwNode **iter = nodes; *iter != NULL; iter++) {
+        guint32 facidx;
+
+        if (gw_lx2_history_needs_import(self, *iter, &facidx) &&
+            !funcs->get_process_mask(reader, facidx)) {
+            funcs->set_process_mask(reader, facidx);
+            cnt++;
+        }
+    }
+
+    /* all flagged traces are extracted in a single pass over the blocks */
+    if (cnt > 0) {
+        if (cnt > 100) {
+            fprintf(stderr, "%sExtracting %u traces\n", funcs->log_prefix, cnt);
+        }
+
+        funcs->iter_blocks(reader, self);
+
+        for (guint32 i = 0; i < self->numfacs; i++) {
+            if (funcs->get_process_mask(reader, i)) {
+                gw_lx2_history_finish(self, i);
+                funcs->clr_process_mask(reader, i);
+            }
+        }
+    }
+
+    for (GwNode **iter = nodes; *iter != NULL; iter++) {
+        gw_lx2_history_resolve_alias(self, *iter);
+    }
+}
+
+void gw_lx2_history_clear(GwLx2History *self)
+{
+    g_clear_object(&self->hist_ent_factory);
+    g_clear_pointer(&self->mvlfacs, g_free);
+    g_clear_pointer(&self->table, g_free);
+}
+
+GwLx2Builder *gw_lx2_builder_new(guint32 numfacs, gchar hierarchy_delimiter)
+{
+    GwLx2Builder *self = g_new0(GwLx2Builder, 1);
+
+    self->tree_builder = gw_tree_builder_new(hierarchy_delimiter);
+    self->delimiter[0] = hierarchy_delimiter;
+    self->scope = g_ptr_array_new_with_free_func(g_free);
+
+    self->facs = gw_facs_new(numfacs);
+    self->symbols = g_new0(GwSymbol, numfacs);
+    self->nodes = g_new0(GwNode, numfacs);
+    self->mvlfacs = g_new0(GwFac, numfacs);
+
+    return self;
+}
+
+/*
+ * moves the tree builder into the scope given by the first count components
+ * of path, the facs are sorted by name so most of them share the scope of
+ * the previous one
+ */
+static void gw_lx2_builder_enter_scope(GwLx2Builder *self, gchar **path, guint count)
+{
+    guint common = 0;
+    while (common < self->scope->len && common < count &&
+           strcmp(g_ptr_array_index(self->scope, common), path[common]) == 0) {
+        common++;
+    }
+
+    while (self->scope->len > common) {
+        gw_tree_builder_pop_scope(self->tree_builder);
+        g_ptr_array_set_size(self->scope, self->scope->len - 1);
+    }
+
+    for (guint i = common; i < count; i++) {
+        GwTreeNode *scope =
+            gw_tree_builder_push_scope(self->tree_builder, GW_TREE_KIND_UNKNOWN, path[i]);
+        scope->t_which = -1;
+        g_ptr_array_add(self->scope, g_strdup(path[i]));
+    }
+}
+
+void gw_lx2_builder_add_fac(GwLx2Builder *self,
+                            guint32 facidx,
+                            const gchar *name,
+                            gint msb,
+                            gint lsb,
+                            guint32 flags,
+                            guint32 len,
+                            guint32 alias_root)
+{
+    GwFac *f = &self->mvlfacs[facidx];
+    GwNode *n = &self->nodes[facidx];
+    GwSymbol *s = &self->symbols[facidx];
+
+    gchar **path = g_strsplit(name, self->delimiter, -1);
+    guint scope_len = g_strv_length(path);
+    const gchar *leaf = name;
+    if (scope_len > 0) {
+        scope_len--;
+        leaf = path[scope_len];
+    }
+    for (guint i = 0; i < scope_len; i++) {
+        if (path[i][0] == '\0') {
+            // keep malformed names in the top level
+            scope_len = 0;
+            leaf = name;
+            break;
+        }
+    }
+    gw_lx2_builder_enter_scope(self, path, scope_len);
+
+    f->flags = flags & LX2_FAC_FLAGS_MASK;
+    f->len = len;
+    f->node_alias = alias_root;
+    f->working_node = n;
+
+    n->msi = msb;
+    n->lsi = lsb;
+
+    if (f->flags & GW_FAC_FLAG_STRING) {
+        f->len = 2;
+        n->msi = n->lsi = -1;
+        n->vartype = GW_VAR_TYPE_GEN_STRING;
+    } else if (f->flags & GW_FAC_FLAG_DOUBLE) {
+        f->len = 64;
+        n->msi = 63;
+        n->lsi = 0;
+        n->vartype = GW_VAR_TYPE_VCD_REAL;
+    } else if (f->flags & GW_FAC_FLAG_INTEGER) {
+        if (f->len == 0) {
+            f->len = 32;
+        }
+        n->msi = f->len - 1;
+        n->lsi = 0;
+        n->vartype = GW_VAR_TYPE_VCD_INTEGER;
+    } else {
+        if (f->len == 0) {
+            f->len = 1;
+        }
+        n->vartype = GW_VAR_TYPE_UNSPECIFIED_DEFAULT;
+    }
+
+    if ((flags & LX2_SYM_F_INOUT) == LX2_SYM_F_INOUT) {
+        n->vardir = GW_VAR_DIR_INOUT;
+    } else if (flags & LX2_SYM_F_IN) {
+        n->vardir = GW_VAR_DIR_IN;
+    } else if (flags & LX2_SYM_F_OUT) {
+        n->vardir = GW_VAR_DIR_OUT;
+    } else {
+        n->vardir = GW_VAR_DIR_IMPLICIT;
+    }
+
+    if (f->len > 1 && !(f->flags & (GW_FAC_FLAG_INTEGER | GW_FAC_FLAG_DOUBLE |
+                                     GW_FAC_FLAG_STRING))) {
+        s->name = gw_tree_builder_get_symbol_name_with_two_indices(self->tree_builder,
+                                                                   leaf,
+                                                                   n->msi,
+                                                                   n->lsi);
+    } else {
+        s->name = gw_tree_builder_get_symbol_name(self->tree_builder, leaf);
+    }
+
+    if (f->len > 1 || (f->flags & (GW_FAC_FLAG_DOUBLE | GW_FAC_FLAG_STRING))) {
+        n->extvals = 1;
+    }
+
+    n->nname = s->name;
+    n->mv.mvlfac = f;
+    n->head.time = -1; // mark 1st node as negative time
+    n->head.v.h_val = GW_BIT_X;
+    s->n = n;
+
+    // Get the node name by stripping off the prefix.
+    const gchar *name_prefix = gw_tree_builder_get_name_prefix(self->tree_builder);
+    const gchar *node_name = s->name;
+    if (name_prefix != NULL) {
+        node_name += strlen(name_prefix) + 1;
+    }
+
+    GwTreeNode *t = gw_tree_node_new(GW_TREE_KIND_UNKNOWN, node_name);
+    t->t_which = facidx;
+    t->child = gw_tree_builder_get_current_scope(self->tree_builder);
+    t->next = self->terminals_chain;
+    self->terminals_chain = t;
+
+    gw_facs_set(self->facs, facidx, s);
+
+    g_strfreev(path);
+}
+
+/*
+ * builds the sorted hierarchy and facs and frees the builder, the symbols
+ * and nodes are referenced by the facs and live as long as the dump file
+ */
+void gw_lx2_builder_finish(GwLx2Builder *self, GwFacs **facs, GwTree **tree, GwFac **mvlfacs)
+{
+    gint64 stats_begin = gw_stats_timer_begin();
+
+    GwTreeNode *root = gw_tree_builder_build(self->tree_builder);
+    *tree = gw_tree_new(root);
+    if (self->terminals_chain != NULL) {
+        gw_tree_graft(*tree, self->terminals_chain);
+    }
+
+    gw_stats_timer_end(GW_STATS_TIMER_BUILD_TREE, stats_begin);
+
+    gw_tree_sort(*tree);
+
+    gw_facs_order_from_tree(self->facs, *tree);
+
+    *facs = self->facs;
+    *mvlfacs = self->mvlfacs;
+
+    g_object_unref(self->tree_builder);
+    g_ptr_array_free(self->scope, TRUE);
+    g_free(self);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <gtkwave.h>
+
+// Helpers shared by the LXT2 and VZT loaders. Both reader libraries expose
+// the same fac geometry and value change callbacks, only their prefixes differ.
+
+#ifdef WAVE_USE_STRUCT_PACKING
+#pragma pack(push)
+#pragma pack(1)
+#endif
+
+typedef struct
+{
+    GwHistEnt *histent_head;
+    GwHistEnt *histent_curr;
+    int numtrans;
+    GwNode *np;
+} GwLx2Entry;
+
+#ifdef WAVE_USE_STRUCT_PACKING
+#pragma pack(pop)
+#endif
+
+typedef struct
+{
+    GwHistEntFactory *hist_ent_factory;
+    GwFac *mvlfacs;
+    GwLx2Entry *table;
+    guint32 numfacs;
+    GwTime time_scale;
+    gboolean preserve_glitches;
+    gboolean preserve_glitches_real;
+} GwLx2History;
+
+// The parts of a reader library used to import traces. iter_blocks has to
+// pass each value change to gw_lx2_history_add_value().
+typedef struct
+{
+    const gchar *log_prefix;
+    gboolean (*get_process_mask)(gpointer reader, guint32 facidx);
+    void (*set_process_mask)(gpointer reader, guint32 facidx);
+    void (*clr_process_mask)(gpointer reader, guint32 facidx);
+    void (*iter_blocks)(gpointer reader, GwLx2History *history);
+} GwLx2ReaderFuncs;
+
+void gw_lx2_history_import(GwLx2History *self,
+                           const GwLx2ReaderFuncs *funcs,
+                           gpointer reader,
+                           GwNode **nodes);
+void gw_lx2_history_add_value(GwLx2History *self,
+                              guint32 facidx,
+                              guint64 time,
+                              const gchar *value);
+void gw_lx2_history_clear(GwLx2History *self);
+
+typedef struct _GwLx2Builder GwLx2Builder;
+
+GwLx2Builder *gw_lx2_builder_new(guint32 numfacs, gchar hierarchy_delimiter);
+void gw_lx2_builder_add_fac(GwLx2Builder *self,
+                            guint32 facidx,
+                            const gchar *name,
+                            gint msb,
+                            gint lsb,
+                            guint32 flags,
+                            guint32 len,
+                            guint32 alias_root);
+void gw_lx2_builder_finish(GwLx2Builder *self, GwFacs **facs, GwTree **tree, GwFac **mvlfacs);
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <gtkwave.h>
+#include <lxt2_read.h>
+#include "gw-lx2.h"
+
+#define LXT2_RDLOAD "LXTLOAD | "
+
+struct _GwLxt2File
+{
+    GwDumpFile parent_instance;
+
+    struct lxt2_rd_trace *lt;
+
+    GwLx2History history;
+};
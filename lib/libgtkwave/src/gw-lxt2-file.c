@@ -0,0 +1,83 @@
+#include "gw-lxt2-file.h"
+#include "gw-lxt2-file-private.h"
+
+G_DEFINE_TYPE(GwLxt2File, gw_lxt2_file, GW_TYPE_DUMP_FILE)
+
+static void lxt2_callback(struct lxt2_rd_trace **lt,
+                          lxtint64_t *time,
+                          lxtint32_t *facidx,
+                          char **value)
+{
+    GwLx2History *history = lxt2_rd_get_user_callback_data_pointer(*lt);
+
+    gw_lx2_history_add_value(history, *facidx, *time, *value);
+}
+
+static gboolean lxt2_get_process_mask(gpointer lt, guint32 facidx)
+{
+    return lxt2_rd_get_fac_process_mask(lt, facidx);
+}
+
+static void lxt2_set_process_mask(gpointer lt, guint32 facidx)
+{
+    lxt2_rd_set_fac_process_mask(lt, facidx);
+}
+
+static void lxt2_clr_process_mask(gpointer lt, guint32 facidx)
+{
+    lxt2_rd_clr_fac_process_mask(lt, facidx);
+}
+
+static void lxt2_iter_blocks(gpointer lt, GwLx2History *history)
+{
+    lxt2_rd_iter_blocks(lt, lxt2_callback, history);
+}
+
+static const GwLx2ReaderFuncs lxt2_reader_funcs = {
+    .log_prefix = LXT2_RDLOAD,
+    .get_process_mask = lxt2_get_process_mask,
+    .set_process_mask = lxt2_set_process_mask,
+    .clr_process_mask = lxt2_clr_process_mask,
+    .iter_blocks = lxt2_iter_blocks,
+};
+
+static gboolean gw_lxt2_file_import_traces(GwDumpFile *dump_file, GwNode **nodes, GError **error)
+{
+    GwLxt2File *self = GW_LXT2_FILE(dump_file);
+    (void)error;
+
+    gw_lx2_history_import(&self->history, &lxt2_reader_funcs, self->lt, nodes);
+
+    return TRUE;
+}
+
+static void gw_lxt2_file_finalize(GObject *object)
+{
+    GwLxt2File *self = GW_LXT2_FILE(object);
+
+    g_clear_pointer(&self->lt, lxt2_rd_close);
+    gw_lx2_history_clear(&self->history);
+
+    G_OBJECT_CLASS(gw_lxt2_file_parent_class)->finalize(object);
+}
+
+static GwHistEntFactory *gw_lxt2_file_get_hist_ent_factory(GwDumpFile *dump_file)
+{
+    return GW_LXT2_FILE(dump_file)->history.hist_ent_factory;
+}
+
+static void gw_lxt2_file_class_init(GwLxt2FileClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    GwDumpFileClass *dump_file_class = GW_DUMP_FILE_CLASS(klass);
+
+    object_class->finalize = gw_lxt2_file_finalize;
+
+    dump_file_class->import_traces = gw_lxt2_file_import_traces;
+    dump_file_class->get_hist_ent_factory = gw_lxt2_file_get_hist_ent_factory;
+}
+
+static void gw_lxt2_file_init(GwLxt2File *self)
+{
+    (void)self;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <gtkwave.h>
+
+G_BEGIN_DECLS
+
+#define GW_TYPE_LXT2_FILE (gw_lxt2_file_get_type())
+G_DECLARE_FINAL_TYPE(GwLxt2File, gw_lxt2_file, GW, LXT2_FILE, GwDumpFile)
+
+G_END_DECLS
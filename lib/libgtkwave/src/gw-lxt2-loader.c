@@ -0,0 +1,106 @@
+#include "gw-lxt2-loader.h"
+#include "gw-lxt2-file.h"
+#include "gw-lxt2-file-private.h"
+
+struct _GwLxt2Loader
+{
+    GwLoader parent_instance;
+};
+
+G_DEFINE_TYPE(GwLxt2Loader, gw_lxt2_loader, GW_TYPE_LOADER)
+
+static GwDumpFile *gw_lxt2_loader_load(GwLoader *loader, const char *fname, GError **error)
+{
+    struct lxt2_rd_trace *lt = lxt2_rd_init(fname);
+    if (lt == NULL) {
+        g_set_error(error,
+                    GW_DUMP_FILE_ERROR,
+                    GW_DUMP_FILE_ERROR_UNKNOWN,
+                    "Failed to open LXT2 file");
+        return NULL;
+    }
+
+    /* only the blocks of the traces being imported are kept in memory */
+    lxt2_rd_set_max_block_mem_usage(lt, 0);
+
+    GwTimeScaleAndDimension *scale =
+        gw_time_scale_and_dimension_from_exponent(lxt2_rd_get_timescale(lt));
+
+    guint32 numfacs = lxt2_rd_get_num_facs(lt);
+    GwLx2Builder *builder = gw_lx2_builder_new(numfacs, gw_loader_get_hierarchy_delimiter(loader));
+
+    fprintf(stderr, LXT2_RDLOAD "Processing %u facs.\n", numfacs);
+
+    for (guint32 i = 0; i < numfacs; i++) {
+        guint32 flags = lxt2_rd_get_fac_flags(lt, i);
+        guint32 root = i;
+
+        /* aliases use the geometry of the fac holding their value changes */
+        if (flags & LXT2_RD_SYM_F_ALIAS) {
+            root = lxt2_rd_get_alias_root(lt, i);
+            flags = lxt2_rd_get_fac_flags(lt, root) | LXT2_RD_SYM_F_ALIAS;
+        }
+
+        gw_lx2_builder_add_fac(builder,
+                               i,
+                               lxt2_rd_get_facname(lt, i),
+                               lxt2_rd_get_fac_msb(lt, i),
+                               lxt2_rd_get_fac_lsb(lt, i),
+                               flags,
+                               lxt2_rd_get_fac_len(lt, root),
+                               root);
+    }
+
+    GwFacs *facs = NULL;
+    GwTree *tree = NULL;
+    GwFac *mvlfacs = NULL;
+    gw_lx2_builder_finish(builder, &facs, &tree, &mvlfacs);
+
+    GwTimeRange *time_range =
+        gw_time_range_new(lxt2_rd_get_start_time(lt) * scale->scale,
+                          lxt2_rd_get_end_time(lt) * scale->scale);
+    GwTime global_time_offset = lxt2_rd_get_timezero(lt) * scale->scale;
+
+    // clang-format off
+    GwLxt2File *dump_file = g_object_new(GW_TYPE_LXT2_FILE,
+                                         "tree", tree,
+                                         "facs", facs,
+                                         "time-dimension", scale->dimension,
+                                         "time-range", time_range,
+                                         "global-time-offset", global_time_offset,
+                                         NULL);
+    // clang-format on
+
+    dump_file->lt = lt;
+    dump_file->history.hist_ent_factory = gw_hist_ent_factory_new();
+    dump_file->history.mvlfacs = mvlfacs;
+    dump_file->history.table = g_new0(GwLx2Entry, numfacs);
+    dump_file->history.numfacs = numfacs;
+    dump_file->history.time_scale = scale->scale;
+    dump_file->history.preserve_glitches = gw_loader_is_preserve_glitches(loader);
+    dump_file->history.preserve_glitches_real = gw_loader_is_preserve_glitches_real(loader);
+
+    g_free(scale);
+    g_object_unref(facs);
+    g_object_unref(tree);
+    g_object_unref(time_range);
+
+    return GW_DUMP_FILE(dump_file);
+}
+
+static void gw_lxt2_loader_class_init(GwLxt2LoaderClass *klass)
+{
+    GwLoaderClass *loader_class = GW_LOADER_CLASS(klass);
+
+    loader_class->load = gw_lxt2_loader_load;
+}
+
+static void gw_lxt2_loader_init(GwLxt2Loader *self)
+{
+    (void)self;
+}
+
+GwLoader *gw_lxt2_loader_new(void)
+{
+    return g_object_new(GW_TYPE_LXT2_LOADER, NULL);
+}
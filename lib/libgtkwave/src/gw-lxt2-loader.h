@@ -0,0 +1,13 @@
+#pragma once
+
+#include <glib-object.h>
+#include "gw-loader.h"
+
+G_BEGIN_DECLS
+
+#define GW_TYPE_LXT2_LOADER (gw_lxt2_loader_get_type())
+G_DECLARE_FINAL_TYPE(GwLxt2Loader, gw_lxt2_loader, GW, LXT2_LOADER, GwLoader)
+
+GwLoader *gw_lxt2_loader_new(void);
+
+G_END_DECLS
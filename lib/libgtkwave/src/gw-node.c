@@ -240,3 +240,82 @@ GwExpandInfo *gw_node_expand(GwNode *self)
 
     return rc;
 }
+
+/**
+ * gw_memory_usage_add:
+ * @self: A #GwMemoryUsage.
+ * @other: The usage to add to @self.
+ */
+void gw_memory_usage_add(GwMemoryUsage *self, const GwMemoryUsage *other)
+{
+    g_return_if_fail(self != NULL);
+    g_return_if_fail(other != NULL);
+
+    self->transitions += other->transitions;
+    self->hist_ents += other->hist_ents;
+    self->harray += other->harray;
+    self->vectors += other->vectors;
+    self->strings += other->strings;
+    self->pending += other->pending;
+}
+
+gsize gw_memory_usage_get_total(const GwMemoryUsage *self)
+{
+    g_return_val_if_fail(self != NULL, 0);
+
+    return self->hist_ents + self->harray + self->vectors + self->strings + self->pending;
+}
+
+/**
+ * gw_node_get_memory_usage:
+ * @self: A #GwNode.
+ * @usage: (out): The memory usage.
+ *
+ * Walks the transition history of @self and sums up the memory it references.
+ * Value buffers which are shared by several entries of the history are only
+ * counted once, buffers shared between nodes are counted for every node.
+ * The pending field is left at zero, because only the dump file knows how
+ * not yet imported data is stored (see gw_dump_file_get_node_memory_usage()).
+ */
+void gw_node_get_memory_usage(GwNode *self, GwMemoryUsage *usage)
+{
+    g_return_if_fail(self != NULL);
+    g_return_if_fail(usage != NULL);
+
+    memset(usage, 0, sizeof(*usage));
+
+    if (self->harray != NULL) {
+        usage->harray = self->numhist * sizeof(GwHistEnt *);
+    }
+
+    gsize vector_size = self->extvals ? ABS(self->msi - self->lsi) + 1 : 0;
+    GHashTable *seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    for (GwHistEnt *h = &self->head; h != NULL; h = h->next) {
+        usage->transitions++;
+        if (h != &self->head) {
+            usage->hist_ents += sizeof(GwHistEnt);
+        }
+
+        gboolean is_string = (h->flags & GW_HIST_ENT_FLAG_STRING) != 0;
+        gboolean is_real = (h->flags & GW_HIST_ENT_FLAG_REAL) != 0;
+
+        if (is_real && !is_string) {
+            continue; // stored inline
+        }
+        if (!is_string && vector_size == 0) {
+            continue; // scalar
+        }
+        if (h->v.h_vector == NULL || !g_hash_table_add(seen, h->v.h_vector)) {
+            continue;
+        }
+
+        if (is_string) {
+            usage->strings += strlen(h->v.h_vector) + 1;
+        } else {
+            usage->vectors += vector_size;
+        }
+    }
+
+    g_hash_table_destroy(seen);
+}
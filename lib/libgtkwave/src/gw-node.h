@@ -44,6 +44,7 @@ struct _GwNode
 
     GwHistEnt **harray; /* fill this in when we make a trace.. contains  */
     /*  a ptr to an array of histents for bsearching */
+    GwEdgeIndex *edge_index; /* built on demand by edge searches */
     union
     {
         GwFac *mvlfac; /* for use with mvlsim aets */
@@ -70,3 +71,29 @@ struct _GwNode
 #endif
 
 GwExpandInfo *gw_node_expand(GwNode *self);
+
+/**
+ * GwMemoryUsage:
+ * @transitions: Number of history entries, including the embedded head.
+ * @hist_ents: Bytes in history entries allocated outside of the node.
+ * @harray: Bytes in the history lookup array.
+ * @vectors: Bytes in vector values.
+ * @strings: Bytes in string and enum values.
+ * @pending: Bytes in not yet imported value change data.
+ *
+ * Memory used by the traces of one or more nodes.
+ */
+typedef struct
+{
+    guint64 transitions;
+    gsize hist_ents;
+    gsize harray;
+    gsize vectors;
+    gsize strings;
+    gsize pending;
+} GwMemoryUsage;
+
+void gw_memory_usage_add(GwMemoryUsage *self, const GwMemoryUsage *other);
+gsize gw_memory_usage_get_total(const GwMemoryUsage *self);
+
+void gw_node_get_memory_usage(GwNode *self, GwMemoryUsage *usage);
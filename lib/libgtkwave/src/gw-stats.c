@@ -0,0 +1,281 @@
+#include "gw-stats.h"
+#include <string.h>
+#include <time.h>
+
+/*
+ * Process wide timers and counters. Instrumentation is disabled by default
+ * and the disabled case only costs an atomic load per call, so the hooks can
+ * stay in hot paths. Counters are only updated while enabled, which means
+ * instrumentation should be enabled before any dump file is loaded.
+ */
+
+static const gchar *TIMER_NAMES[GW_STATS_N_TIMERS] = {
+    [GW_STATS_TIMER_LOAD] = "load",
+    [GW_STATS_TIMER_IMPORT] = "import",
+    [GW_STATS_TIMER_VLIST_COMPRESS] = "vlist-compress",
+    [GW_STATS_TIMER_RENDER] = "render",
+    [GW_STATS_TIMER_SEARCH] = "search",
+    [GW_STATS_TIMER_FILTER] = "filter",
+    [GW_STATS_TIMER_SORT_FACS] = "sort-facs",
+    [GW_STATS_TIMER_BUILD_TREE] = "build-tree",
+    [GW_STATS_TIMER_SORT_TREE] = "sort-tree",
+};
+
+static const gchar *COUNTER_NAMES[GW_STATS_N_COUNTERS] = {
+    [GW_STATS_COUNTER_HIST_ENTS] = "hist-ents",
+    [GW_STATS_COUNTER_VLISTS] = "vlists",
+    [GW_STATS_COUNTER_STRINGS] = "strings",
+    [GW_STATS_COUNTER_SURFACES] = "surfaces",
+};
+
+static gint stats_enabled;
+static GMutex stats_mutex;
+static GwStatsTimerValue stats_timers[GW_STATS_N_TIMERS];
+static GwStatsCounterValue stats_counters[GW_STATS_N_COUNTERS];
+static GwStatsDrawCost stats_draw_cost;
+
+static gint64 gw_stats_get_time_ns(void)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+        return (gint64)ts.tv_sec * G_GINT64_CONSTANT(1000000000) + ts.tv_nsec;
+    }
+#endif
+    return g_get_monotonic_time() * 1000;
+}
+
+/**
+ * gw_stats_set_enabled:
+ * @enabled: %TRUE to enable instrumentation.
+ *
+ * Enables or disables the collection of timers and counters.
+ */
+void gw_stats_set_enabled(gboolean enabled)
+{
+    g_atomic_int_set(&stats_enabled, !!enabled);
+}
+
+gboolean gw_stats_is_enabled(void)
+{
+    return g_atomic_int_get(&stats_enabled);
+}
+
+/**
+ * gw_stats_reset:
+ *
+ * Clears all timers and the draw cost and resets the counter peaks to the current values.
+ */
+void gw_stats_reset(void)
+{
+    g_mutex_lock(&stats_mutex);
+
+    memset(stats_timers, 0, sizeof(stats_timers));
+    memset(&stats_draw_cost, 0, sizeof(stats_draw_cost));
+    for (gint i = 0; i < GW_STATS_N_COUNTERS; i++) {
+        stats_counters[i].peak = stats_counters[i].value;
+    }
+
+    g_mutex_unlock(&stats_mutex);
+}
+
+/**
+ * gw_stats_timer_begin:
+ *
+ * Starts a scoped timer, which must be ended with gw_stats_timer_end().
+ *
+ * Returns: The start time or 0 if instrumentation is disabled.
+ */
+gint64 gw_stats_timer_begin(void)
+{
+    if (!g_atomic_int_get(&stats_enabled)) {
+        return 0;
+    }
+
+    return gw_stats_get_time_ns();
+}
+
+/**
+ * gw_stats_timer_end:
+ * @timer: The timer.
+ * @begin: The value returned by gw_stats_timer_begin().
+ *
+ * Adds the time elapsed since @begin to @timer.
+ */
+void gw_stats_timer_end(GwStatsTimer timer, gint64 begin)
+{
+    g_return_if_fail(timer < GW_STATS_N_TIMERS);
+
+    if (begin == 0) {
+        return;
+    }
+
+    gint64 elapsed = gw_stats_get_time_ns() - begin;
+
+    g_mutex_lock(&stats_mutex);
+
+    GwStatsTimerValue *value = &stats_timers[timer];
+    value->calls++;
+    value->total_ns += elapsed;
+    value->max_ns = MAX(value->max_ns, elapsed);
+    value->last_ns = elapsed;
+
+    g_mutex_unlock(&stats_mutex);
+}
+
+/**
+ * gw_stats_counter_add:
+ * @counter: The counter.
+ * @delta: The value to add, which may be negative.
+ *
+ * Adds @delta to @counter if instrumentation is enabled.
+ */
+void gw_stats_counter_add(GwStatsCounter counter, gint64 delta)
+{
+    g_return_if_fail(counter < GW_STATS_N_COUNTERS);
+
+    if (!g_atomic_int_get(&stats_enabled)) {
+        return;
+    }
+
+    g_mutex_lock(&stats_mutex);
+
+    GwStatsCounterValue *value = &stats_counters[counter];
+    value->value += delta;
+    value->peak = MAX(value->peak, value->value);
+
+    g_mutex_unlock(&stats_mutex);
+}
+
+/**
+ * gw_stats_set_draw_cost:
+ * @cost: The drawing work of a redraw.
+ *
+ * Replaces the draw cost with @cost if instrumentation is enabled.
+ */
+void gw_stats_set_draw_cost(const GwStatsDrawCost *cost)
+{
+    g_return_if_fail(cost != NULL);
+
+    if (!g_atomic_int_get(&stats_enabled)) {
+        return;
+    }
+
+    g_mutex_lock(&stats_mutex);
+    stats_draw_cost = *cost;
+    g_mutex_unlock(&stats_mutex);
+}
+
+void gw_stats_get_timer(GwStatsTimer timer, GwStatsTimerValue *value)
+{
+    g_return_if_fail(timer < GW_STATS_N_TIMERS);
+    g_return_if_fail(value != NULL);
+
+    g_mutex_lock(&stats_mutex);
+    *value = stats_timers[timer];
+    g_mutex_unlock(&stats_mutex);
+}
+
+void gw_stats_get_counter(GwStatsCounter counter, GwStatsCounterValue *value)
+{
+    g_return_if_fail(counter < GW_STATS_N_COUNTERS);
+    g_return_if_fail(value != NULL);
+
+    g_mutex_lock(&stats_mutex);
+    *value = stats_counters[counter];
+    g_mutex_unlock(&stats_mutex);
+}
+
+void gw_stats_get_draw_cost(GwStatsDrawCost *cost)
+{
+    g_return_if_fail(cost != NULL);
+
+    g_mutex_lock(&stats_mutex);
+    *cost = stats_draw_cost;
+    g_mutex_unlock(&stats_mutex);
+}
+
+const gchar *gw_stats_timer_get_name(GwStatsTimer timer)
+{
+    g_return_val_if_fail(timer < GW_STATS_N_TIMERS, NULL);
+
+    return TIMER_NAMES[timer];
+}
+
+const gchar *gw_stats_counter_get_name(GwStatsCounter counter)
+{
+    g_return_val_if_fail(counter < GW_STATS_N_COUNTERS, NULL);
+
+    return COUNTER_NAMES[counter];
+}
+
+/**
+ * gw_stats_to_string:
+ *
+ * Formats all timers and counters as a plain text table.
+ *
+ * Returns: (transfer full): The report.
+ */
+gchar *gw_stats_to_string(void)
+{
+    GwStatsTimerValue timers[GW_STATS_N_TIMERS];
+    GwStatsCounterValue counters[GW_STATS_N_COUNTERS];
+    GwStatsDrawCost draw_cost;
+
+    g_mutex_lock(&stats_mutex);
+    memcpy(timers, stats_timers, sizeof(timers));
+    memcpy(counters, stats_counters, sizeof(counters));
+    draw_cost = stats_draw_cost;
+    g_mutex_unlock(&stats_mutex);
+
+    GString *str = g_string_new(NULL);
+
+    g_string_append_printf(str,
+                           "%-16s %10s %12s %10s %10s %10s\n",
+                           "timer",
+                           "calls",
+                           "total ms",
+                           "mean ms",
+                           "max ms",
+                           "last ms");
+
+    for (gint i = 0; i < GW_STATS_N_TIMERS; i++) {
+        GwStatsTimerValue *t = &timers[i];
+        gdouble mean = t->calls > 0 ? (gdouble)t->total_ns / t->calls : 0.0;
+
+        g_string_append_printf(str,
+                               "%-16s %10" G_GUINT64_FORMAT " %12.3f %10.3f %10.3f %10.3f\n",
+                               TIMER_NAMES[i],
+                               t->calls,
+                               t->total_ns / 1e6,
+                               mean / 1e6,
+                               t->max_ns / 1e6,
+                               t->last_ns / 1e6);
+    }
+
+    g_string_append_printf(str, "\n%-16s %14s %14s\n", "memory", "current KiB", "peak KiB");
+
+    for (gint i = 0; i < GW_STATS_N_COUNTERS; i++) {
+        g_string_append_printf(str,
+                               "%-16s %14" G_GINT64_FORMAT " %14" G_GINT64_FORMAT "\n",
+                               COUNTER_NAMES[i],
+                               counters[i].value / 1024,
+                               counters[i].peak / 1024);
+    }
+
+    g_string_append_printf(str,
+                           "\n%-16s %14s %14s %14s\n",
+                           "draw cost",
+                           "primitives",
+                           "merged",
+                           "cairo calls");
+    g_string_append_printf(str,
+                           "%-16s %14" G_GUINT64_FORMAT " %14" G_GUINT64_FORMAT
+                           " %14" G_GUINT64_FORMAT "\n",
+                           "last redraw",
+                           draw_cost.primitives,
+                           draw_cost.merged,
+                           draw_cost.calls);
+
+    return g_string_free(str, FALSE);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GwStatsTimer:
+ * @GW_STATS_TIMER_LOAD: Loading dump files.
+ * @GW_STATS_TIMER_IMPORT: Importing traces.
+ * @GW_STATS_TIMER_VLIST_COMPRESS: Compressing vlist blocks.
+ * @GW_STATS_TIMER_RENDER: Rendering the wave view.
+ * @GW_STATS_TIMER_SEARCH: Searching symbols and values.
+ * @GW_STATS_TIMER_FILTER: Running translate filters and the signal filter.
+ * @GW_STATS_TIMER_SORT_FACS: Sorting the facs after loading.
+ * @GW_STATS_TIMER_BUILD_TREE: Building the hierarchy tree after loading.
+ * @GW_STATS_TIMER_SORT_TREE: Sorting the hierarchy tree after loading.
+ *
+ * Instrumented code paths.
+ */
+typedef enum
+{
+    GW_STATS_TIMER_LOAD,
+    GW_STATS_TIMER_IMPORT,
+    GW_STATS_TIMER_VLIST_COMPRESS,
+    GW_STATS_TIMER_RENDER,
+    GW_STATS_TIMER_SEARCH,
+    GW_STATS_TIMER_FILTER,
+    GW_STATS_TIMER_SORT_FACS,
+    GW_STATS_TIMER_BUILD_TREE,
+    GW_STATS_TIMER_SORT_TREE,
+} GwStatsTimer;
+
+#define GW_STATS_N_TIMERS (GW_STATS_TIMER_SORT_TREE + 1)
+
+/**
+ * GwStatsCounter:
+ * @GW_STATS_COUNTER_HIST_ENTS: Bytes in history entry blocks.
+ * @GW_STATS_COUNTER_VLISTS: Bytes in vlist blocks.
+ * @GW_STATS_COUNTER_STRINGS: Bytes in string tables.
+ * @GW_STATS_COUNTER_SURFACES: Bytes in cairo surfaces.
+ *
+ * Memory counters by subsystem.
+ */
+typedef enum
+{
+    GW_STATS_COUNTER_HIST_ENTS,
+    GW_STATS_COUNTER_VLISTS,
+    GW_STATS_COUNTER_STRINGS,
+    GW_STATS_COUNTER_SURFACES,
+} GwStatsCounter;
+
+#define GW_STATS_N_COUNTERS (GW_STATS_COUNTER_SURFACES + 1)
+
+typedef struct
+{
+    guint64 calls;
+    gint64 total_ns;
+    gint64 max_ns;
+    gint64 last_ns;
+} GwStatsTimerValue;
+
+typedef struct
+{
+    gint64 value;
+    gint64 peak;
+} GwStatsCounterValue;
+
+/**
+ * GwStatsDrawCost:
+ * @primitives: The lines, rectangles and text runs queued for drawing.
+ * @merged: The primitives which were merged into others or dropped as duplicates.
+ * @calls: The cairo fill, stroke and text calls issued.
+ *
+ * The drawing work of the last wave view redraw.
+ */
+typedef struct
+{
+    guint64 primitives;
+    guint64 merged;
+    guint64 calls;
+} GwStatsDrawCost;
+
+void gw_stats_set_enabled(gboolean enabled);
+gboolean gw_stats_is_enabled(void);
+void gw_stats_reset(void);
+
+gint64 gw_stats_timer_begin(void);
+void gw_stats_timer_end(GwStatsTimer timer, gint64 begin);
+void gw_stats_counter_add(GwStatsCounter counter, gint64 delta);
+void gw_stats_set_draw_cost(const GwStatsDrawCost *cost);
+
+void gw_stats_get_timer(GwStatsTimer timer, GwStatsTimerValue *value);
+void gw_stats_get_counter(GwStatsCounter counter, GwStatsCounterValue *value);
+void gw_stats_get_draw_cost(GwStatsDrawCost *cost);
+
+const gchar *gw_stats_timer_get_name(GwStatsTimer timer);
+const gchar *gw_stats_counter_get_name(GwStatsCounter counter);
+
+gchar *gw_stats_to_string(void);
+
+G_END_DECLS
@@ -1,4 +1,5 @@
 #include "gw-string-table.h"
+#include "gw-stats.h"
 
 // TODO: Use blocks to allocate strings.
 
@@ -8,6 +9,9 @@ struct _GwStringTable
 
     GHashTable *hash_table;
     GPtrArray *array;
+
+    // Number of bytes in all strings, including the terminators.
+    gsize bytes;
 };
 
 G_DEFINE_TYPE(GwStringTable, gw_string_table, G_TYPE_OBJECT)
@@ -16,6 +20,8 @@ static void gw_string_table_finalize(GObject *object)
 {
     GwStringTable *self = GW_STRING_TABLE(object);
 
+    gw_stats_counter_add(GW_STATS_COUNTER_STRINGS, -(gint64)self->bytes);
+
     g_clear_pointer(&self->hash_table, g_hash_table_destroy);
     g_ptr_array_free(self->array, TRUE);
 
@@ -60,7 +66,10 @@ guint gw_string_table_add(GwStringTable *self, const gchar *str)
 
     // Add new string to hash table and array.
 
+    gsize len = strlen(str) + 1;
     gchar *str_dup = g_strdup(str);
+    self->bytes += len;
+    gw_stats_counter_add(GW_STATS_COUNTER_STRINGS, len);
 
     guint index = self->array->len;
     g_ptr_array_add(self->array, str_dup);
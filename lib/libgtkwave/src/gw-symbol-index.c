@@ -0,0 +1,552 @@
+#include "gw-symbol-index.h"
+#include <string.h>
+
+/*
+ * Case insensitive trigram index of the fac names. Every trigram maps to the
+ * ascending indices of the facs which contain it, stored as variable length
+ * deltas. A query extracts the literal strings a regular expression requires
+ * and intersects the lists of their trigrams, which leaves only a few
+ * candidates for the regular expression itself.
+ *
+ * Caseless matching of non-ASCII characters can't be expressed with ASCII
+ * trigrams, for example `k` matches the Kelvin sign. Names which contain
+ * non-ASCII characters are therefore always returned as candidates.
+ */
+
+#define GW_SYMBOL_INDEX_N 3
+
+typedef struct
+{
+    GByteArray *data;
+    guint count;
+    guint last;
+} GwPostingList;
+
+typedef struct
+{
+    const guint8 *pos;
+    const guint8 *end;
+    guint value;
+} GwPostingReader;
+
+struct _GwSymbolIndex
+{
+    GObject parent_instance;
+
+    GHashTable *postings;
+    GArray *unindexed;
+    gsize bytes;
+};
+
+G_DEFINE_TYPE(GwSymbolIndex, gw_symbol_index, G_TYPE_OBJECT)
+
+static void gw_posting_list_free(gpointer data)
+{
+    GwPostingList *list = data;
+
+    g_byte_array_unref(list->data);
+    g_free(list);
+}
+
+static void gw_posting_list_append(GwPostingList *list, guint index)
+{
+    guint delta = index - list->last;
+
+    while (delta >= 0x80) {
+        guint8 byte = (delta & 0x7F) | 0x80;
+        g_byte_array_append(list->data, &byte, 1);
+        delta >>= 7;
+    }
+    guint8 byte = delta;
+    g_byte_array_append(list->data, &byte, 1);
+
+    list->last = index;
+    list->count++;
+}
+
+static void gw_posting_reader_init(GwPostingReader *reader, GwPostingList *list)
+{
+    reader->pos = list->data->data;
+    reader->end = list->data->data + list->data->len;
+    reader->value = 0;
+}
+
+static gboolean gw_posting_reader_next(GwPostingReader *reader)
+{
+    if (reader->pos >= reader->end) {
+        return FALSE;
+    }
+
+    guint delta = 0;
+    guint shift = 0;
+    while (*reader->pos & 0x80) {
+        delta |= (guint)(*reader->pos++ & 0x7F) << shift;
+        shift += 7;
+    }
+    delta |= (guint)(*reader->pos++) << shift;
+
+    reader->value += delta;
+
+    return TRUE;
+}
+
+static void gw_symbol_index_finalize(GObject *object)
+{
+    GwSymbolIndex *self = GW_SYMBOL_INDEX(object);
+
+    g_hash_table_destroy(self->postings);
+    g_array_free(self->unindexed, TRUE);
+
+    G_OBJECT_CLASS(gw_symbol_index_parent_class)->finalize(object);
+}
+
+static void gw_symbol_index_class_init(GwSymbolIndexClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+    object_class->finalize = gw_symbol_index_finalize;
+}
+
+static void gw_symbol_index_init(GwSymbolIndex *self)
+{
+    self->postings =
+        g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, gw_posting_list_free);
+    self->unindexed = g_array_new(FALSE, FALSE, sizeof(guint));
+}
+
+static inline guint gw_symbol_index_key(const gchar *str)
+{
+    return (guint)g_ascii_tolower(str[0]) << 16 | (guint)g_ascii_tolower(str[1]) << 8 |
+           (guint)g_ascii_tolower(str[2]);
+}
+
+static gboolean is_ascii(const gchar *str, gsize *len)
+{
+    const gchar *p = str;
+
+    for (; *p != '\0'; p++) {
+        if ((guchar)*p >= 0x80) {
+            return FALSE;
+        }
+    }
+    *len = p - str;
+
+    return TRUE;
+}
+
+static void gw_symbol_index_add(GwSymbolIndex *self, guint index, const gchar *name)
+{
+    gsize len;
+
+    if (!is_ascii(name, &len)) {
+        g_array_append_val(self->unindexed, index);
+        return;
+    }
+
+    for (gsize i = 0; i + GW_SYMBOL_INDEX_N <= len; i++) {
+        guint key = gw_symbol_index_key(name + i);
+
+        GwPostingList *list = g_hash_table_lookup(self->postings, GUINT_TO_POINTER(key));
+        if (list == NULL) {
+            list = g_new0(GwPostingList, 1);
+            list->data = g_byte_array_new();
+            g_hash_table_insert(self->postings, GUINT_TO_POINTER(key), list);
+        } else if (list->last == index && list->count > 0) {
+            continue;
+        }
+
+        gw_posting_list_append(list, index);
+    }
+}
+
+/**
+ * gw_symbol_index_new:
+ * @facs: The facs to index.
+ *
+ * Creates an index of the names in @facs. The index refers to the facs by
+ * their position and must be rebuilt if @facs is reordered.
+ *
+ * Returns: (transfer full): The new index.
+ */
+GwSymbolIndex *gw_symbol_index_new(GwFacs *facs)
+{
+    g_return_val_if_fail(GW_IS_FACS(facs), NULL);
+
+    GwSymbolIndex *self = g_object_new(GW_TYPE_SYMBOL_INDEX, NULL);
+
+    guint facs_count = gw_facs_get_length(facs);
+    for (guint i = 0; i < facs_count; i++) {
+        gw_symbol_index_add(self, i, gw_facs_get(facs, i)->name);
+    }
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, self->postings);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        GwPostingList *list = value;
+        self->bytes += sizeof(GwPostingList) + list->data->len;
+    }
+    self->bytes += self->unindexed->len * sizeof(guint);
+
+    return self;
+}
+
+static void flush_literal(GString *literal, GPtrArray *literals)
+{
+    if (literal->len >= GW_SYMBOL_INDEX_N) {
+        g_ptr_array_add(literals, g_strndup(literal->str, literal->len));
+    }
+    g_string_truncate(literal, 0);
+}
+
+// Returns the position after the character class which starts at `i` or -1.
+static gssize skip_class(const gchar *pattern, gssize i)
+{
+    i++;
+    if (pattern[i] == '^') {
+        i++;
+    }
+    if (pattern[i] == ']') {
+        i++;
+    }
+
+    while (pattern[i] != ']') {
+        if (pattern[i] == '\0') {
+            return -1;
+        } else if (pattern[i] == '\\') {
+            if (pattern[i + 1] == '\0') {
+                return -1;
+            }
+            i += 2;
+        } else if (pattern[i] == '[' && pattern[i + 1] == ':') {
+            const gchar *end = strstr(pattern + i + 2, ":]");
+            if (end == NULL) {
+                return -1;
+            }
+            i = end - pattern + 2;
+        } else {
+            i++;
+        }
+    }
+
+    return i + 1;
+}
+
+// Returns the position after the group which starts at `i` or -1.
+static gssize skip_group(const gchar *pattern, gssize i)
+{
+    gint depth = 1;
+
+    i++;
+    while (depth > 0) {
+        switch (pattern[i]) {
+            case '\0':
+                return -1;
+
+            case '\\':
+                if (pattern[i + 1] == '\0') {
+                    return -1;
+                }
+                i += 2;
+                break;
+
+            case '[':
+                i = skip_class(pattern, i);
+                if (i < 0) {
+                    return -1;
+                }
+                break;
+
+            case '(':
+                depth++;
+                i++;
+                break;
+
+            case ')':
+                depth--;
+                i++;
+                break;
+
+            default:
+                i++;
+                break;
+        }
+    }
+
+    return i;
+}
+
+// Returns the position after the counted repetition which starts at `i` or -1.
+static gssize skip_repetition(const gchar *pattern, gssize i)
+{
+    gboolean has_digits = FALSE;
+
+    i++;
+    while (g_ascii_isdigit(pattern[i])) {
+        has_digits = TRUE;
+        i++;
+    }
+    if (pattern[i] == ',') {
+        i++;
+        while (g_ascii_isdigit(pattern[i])) {
+            has_digits = TRUE;
+            i++;
+        }
+    }
+
+    if (!has_digits || pattern[i] != '}') {
+        return -1;
+    }
+
+    return i + 1;
+}
+
+/*
+ * Collects lower case strings which every match of the pattern contains. Only
+ * the top level sequence of the pattern is inspected: groups, classes and
+ * escapes end a literal and a quantifier removes the preceding character.
+ * Returns FALSE if the pattern can't be analyzed, for example because it
+ * contains an alternation or an option setting.
+ */
+static gboolean extract_literals(const gchar *pattern, GPtrArray *literals)
+{
+    GString *literal = g_string_new(NULL);
+    gboolean ret = TRUE;
+    gssize i = 0;
+
+    while (ret && pattern[i] != '\0') {
+        gchar c = pattern[i];
+
+        switch (c) {
+            case '\\':
+                if (g_ascii_isalnum(pattern[i + 1])) {
+                    // Escapes with arguments, like \x41 or \Q...\E, aren't supported.
+                    if (strchr("bBdDwWsShHvVRAzZG", pattern[i + 1]) == NULL) {
+                        ret = FALSE;
+                    }
+                    flush_literal(literal, literals);
+                } else if (pattern[i + 1] == '\0') {
+                    ret = FALSE;
+                } else if ((guchar)pattern[i + 1] >= 0x80) {
+                    flush_literal(literal, literals);
+                } else {
+                    g_string_append_c(literal, g_ascii_tolower(pattern[i + 1]));
+                }
+                i += 2;
+                break;
+
+            case '.':
+            case '^':
+            case '$':
+                flush_literal(literal, literals);
+                i++;
+                break;
+
+            case '[':
+                flush_literal(literal, literals);
+                i = skip_class(pattern, i);
+                ret = i >= 0;
+                break;
+
+            case '(':
+                // Non-capturing groups are skipped, all other extensions
+                // might change the meaning of the rest of the pattern.
+                if (pattern[i + 1] == '?' && pattern[i + 2] != ':') {
+                    ret = FALSE;
+                    break;
+                }
+                flush_literal(literal, literals);
+                i = skip_group(pattern, i);
+                ret = i >= 0;
+                break;
+
+            case ')':
+            case '|':
+                ret = FALSE;
+                break;
+
+            case '?':
+            case '*':
+                if (literal->len > 0) {
+                    g_string_truncate(literal, literal->len - 1);
+                }
+                flush_literal(literal, literals);
+                i++;
+                break;
+
+            case '+':
+                flush_literal(literal, literals);
+                i++;
+                break;
+
+            case '{': {
+                gssize end = skip_repetition(pattern, i);
+                if (end >= 0 && literal->len > 0) {
+                    g_string_truncate(literal, literal->len - 1);
+                }
+                flush_literal(literal, literals);
+                i = end >= 0 ? end : i + 1;
+                break;
+            }
+
+            default:
+                if ((guchar)c >= 0x80) {
+                    flush_literal(literal, literals);
+                } else {
+                    g_string_append_c(literal, g_ascii_tolower(c));
+                }
+                i++;
+                break;
+        }
+    }
+
+    if (ret) {
+        flush_literal(literal, literals);
+    }
+
+    g_string_free(literal, TRUE);
+
+    return ret;
+}
+
+static gint compare_posting_lists(gconstpointer a, gconstpointer b)
+{
+    const GwPostingList *list1 = *(GwPostingList *const *)a;
+    const GwPostingList *list2 = *(GwPostingList *const *)b;
+
+    return (list1->count > list2->count) - (list1->count < list2->count);
+}
+
+static void intersect(GArray *candidates, GwPostingList *list)
+{
+    GwPostingReader reader;
+    gw_posting_reader_init(&reader, list);
+
+    guint n = 0;
+    gboolean has_value = gw_posting_reader_next(&reader);
+
+    for (guint i = 0; i < candidates->len && has_value; i++) {
+        guint candidate = g_array_index(candidates, guint, i);
+
+        while (has_value && reader.value < candidate) {
+            has_value = gw_posting_reader_next(&reader);
+        }
+        if (has_value && reader.value == candidate) {
+            g_array_index(candidates, guint, n++) = candidate;
+        }
+    }
+
+    g_array_set_size(candidates, n);
+}
+
+static GArray *merge(GArray *candidates, GArray *unindexed)
+{
+    GArray *merged =
+        g_array_sized_new(FALSE, FALSE, sizeof(guint), candidates->len + unindexed->len);
+
+    guint i = 0;
+    guint j = 0;
+    while (i < candidates->len || j < unindexed->len) {
+        if (j >= unindexed->len ||
+            (i < candidates->len &&
+             g_array_index(candidates, guint, i) < g_array_index(unindexed, guint, j))) {
+            g_array_append_val(merged, g_array_index(candidates, guint, i));
+            i++;
+        } else {
+            g_array_append_val(merged, g_array_index(unindexed, guint, j));
+            j++;
+        }
+    }
+
+    g_array_free(candidates, TRUE);
+
+    return merged;
+}
+
+/**
+ * gw_symbol_index_find_candidates:
+ * @self: A #GwSymbolIndex.
+ * @pattern: A regular expression, which is matched case insensitively.
+ *
+ * Finds the facs which might match @pattern. Every fac that matches is
+ * contained in the result, but not every candidate needs to match.
+ *
+ * Returns: (transfer full) (element-type guint) (nullable): The ascending
+ *          indices of the candidates or %NULL if every fac is a candidate.
+ */
+GArray *gw_symbol_index_find_candidates(GwSymbolIndex *self, const gchar *pattern)
+{
+    g_return_val_if_fail(GW_IS_SYMBOL_INDEX(self), NULL);
+    g_return_val_if_fail(pattern != NULL, NULL);
+
+    GPtrArray *literals = g_ptr_array_new_with_free_func(g_free);
+
+    if (!extract_literals(pattern, literals) || literals->len == 0) {
+        g_ptr_array_free(literals, TRUE);
+        return NULL;
+    }
+
+    GHashTable *keys = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GPtrArray *lists = g_ptr_array_new();
+    gboolean missing = FALSE;
+
+    for (guint i = 0; i < literals->len && !missing; i++) {
+        const gchar *literal = g_ptr_array_index(literals, i);
+        gsize len = strlen(literal);
+
+        for (gsize j = 0; j + GW_SYMBOL_INDEX_N <= len; j++) {
+            guint key = gw_symbol_index_key(literal + j);
+            if (!g_hash_table_add(keys, GUINT_TO_POINTER(key))) {
+                continue;
+            }
+
+            GwPostingList *list = g_hash_table_lookup(self->postings, GUINT_TO_POINTER(key));
+            if (list == NULL) {
+                missing = TRUE;
+                break;
+            }
+            g_ptr_array_add(lists, list);
+        }
+    }
+
+    GArray *candidates = g_array_new(FALSE, FALSE, sizeof(guint));
+
+    if (!missing) {
+        // Starting with the shortest list keeps the intermediate results small.
+        g_ptr_array_sort(lists, compare_posting_lists);
+
+        GwPostingReader reader;
+        gw_posting_reader_init(&reader, g_ptr_array_index(lists, 0));
+        g_array_set_size(candidates, ((GwPostingList *)g_ptr_array_index(lists, 0))->count);
+        for (guint i = 0; gw_posting_reader_next(&reader); i++) {
+            g_array_index(candidates, guint, i) = reader.value;
+        }
+
+        for (guint i = 1; i < lists->len && candidates->len > 0; i++) {
+            intersect(candidates, g_ptr_array_index(lists, i));
+        }
+    }
+
+    if (self->unindexed->len > 0) {
+        candidates = merge(candidates, self->unindexed);
+    }
+
+    g_ptr_array_free(lists, TRUE);
+    g_hash_table_destroy(keys);
+    g_ptr_array_free(literals, TRUE);
+
+    return candidates;
+}
+
+/**
+ * gw_symbol_index_get_memory_size:
+ * @self: A #GwSymbolIndex.
+ *
+ * Returns: The approximate number of bytes used by the index.
+ */
+gsize gw_symbol_index_get_memory_size(GwSymbolIndex *self)
+{
+    g_return_val_if_fail(GW_IS_SYMBOL_INDEX(self), 0);
+
+    return self->bytes;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <glib-object.h>
+#include "gw-facs.h"
+
+G_BEGIN_DECLS
+
+#define GW_TYPE_SYMBOL_INDEX (gw_symbol_index_get_type())
+G_DECLARE_FINAL_TYPE(GwSymbolIndex, gw_symbol_index, GW, SYMBOL_INDEX, GObject)
+
+GwSymbolIndex *gw_symbol_index_new(GwFacs *facs);
+
+GArray *gw_symbol_index_find_candidates(GwSymbolIndex *self, const gchar *pattern);
+gsize gw_symbol_index_get_memory_size(GwSymbolIndex *self);
+
+G_END_DECLS
@@ -0,0 +1,159 @@
+#include "gw-symbol-search.h"
+#include "gw-stats.h"
+
+/*
+ * A symbol search which is run in steps, so that a user interface can show
+ * the first results early and drop a search that is no longer needed by
+ * releasing it.
+ */
+
+struct _GwSymbolSearch
+{
+    GObject parent_instance;
+
+    GwFacs *facs;
+    GRegex *regex;
+
+    // Indices of the facs which need to be matched, or NULL for all facs.
+    GArray *candidates;
+    guint candidate_count;
+    guint position;
+};
+
+G_DEFINE_TYPE(GwSymbolSearch, gw_symbol_search, G_TYPE_OBJECT)
+
+static void gw_symbol_search_finalize(GObject *object)
+{
+    GwSymbolSearch *self = GW_SYMBOL_SEARCH(object);
+
+    g_clear_object(&self->facs);
+    g_clear_pointer(&self->regex, g_regex_unref);
+    if (self->candidates != NULL) {
+        g_array_free(self->candidates, TRUE);
+    }
+
+    G_OBJECT_CLASS(gw_symbol_search_parent_class)->finalize(object);
+}
+
+static void gw_symbol_search_class_init(GwSymbolSearchClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+    object_class->finalize = gw_symbol_search_finalize;
+}
+
+static void gw_symbol_search_init(GwSymbolSearch *self)
+{
+    (void)self;
+}
+
+/**
+ * gw_symbol_search_new:
+ * @facs: The facs to search.
+ * @index: (nullable): An index of @facs or %NULL.
+ * @pattern: The regular expression to search, which is matched case insensitively.
+ * @error: Return location for a #GError or %NULL.
+ *
+ * Creates a new symbol search. If @index is given, only the facs which might
+ * match @pattern are matched against the regular expression.
+ *
+ * Returns: (transfer full): The new search or %NULL if @pattern is invalid.
+ */
+GwSymbolSearch *gw_symbol_search_new(GwFacs *facs,
+                                     GwSymbolIndex *index,
+                                     const gchar *pattern,
+                                     GError **error)
+{
+    g_return_val_if_fail(GW_IS_FACS(facs), NULL);
+    g_return_val_if_fail(index == NULL || GW_IS_SYMBOL_INDEX(index), NULL);
+    g_return_val_if_fail(pattern != NULL, NULL);
+    g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+    GRegex *regex = g_regex_new(pattern, G_REGEX_CASELESS, 0, error);
+    if (regex == NULL) {
+        return NULL;
+    }
+
+    GwSymbolSearch *self = g_object_new(GW_TYPE_SYMBOL_SEARCH, NULL);
+    self->facs = g_object_ref(facs);
+    self->regex = regex;
+
+    if (index != NULL) {
+        self->candidates = gw_symbol_index_find_candidates(index, pattern);
+    }
+    if (self->candidates != NULL) {
+        self->candidate_count = self->candidates->len;
+    } else {
+        self->candidate_count = gw_facs_get_length(facs);
+    }
+
+    return self;
+}
+
+/**
+ * gw_symbol_search_step:
+ * @self: A #GwSymbolSearch.
+ * @max_candidates: The maximum number of candidates to match in this step.
+ * @results: (element-type GwSymbol): The array the matching symbols are appended to.
+ *
+ * Continues the search. Matching symbols are appended in the order of the
+ * facs.
+ *
+ * Returns: %TRUE if the search isn't finished yet.
+ */
+gboolean gw_symbol_search_step(GwSymbolSearch *self, guint max_candidates, GPtrArray *results)
+{
+    g_return_val_if_fail(GW_IS_SYMBOL_SEARCH(self), FALSE);
+    g_return_val_if_fail(results != NULL, FALSE);
+
+    gint64 stats_begin = gw_stats_timer_begin();
+
+    guint end = self->position + MIN(max_candidates, self->candidate_count - self->position);
+
+    for (; self->position < end; self->position++) {
+        guint i = self->position;
+        if (self->candidates != NULL) {
+            i = g_array_index(self->candidates, guint, i);
+        }
+
+        GwSymbol *fac = gw_facs_get(self->facs, i);
+        if (g_regex_match(self->regex, fac->name, 0, NULL)) {
+            g_ptr_array_add(results, fac);
+        }
+    }
+
+    gw_stats_timer_end(GW_STATS_TIMER_SEARCH, stats_begin);
+
+    return self->position < self->candidate_count;
+}
+
+gboolean gw_symbol_search_is_done(GwSymbolSearch *self)
+{
+    g_return_val_if_fail(GW_IS_SYMBOL_SEARCH(self), TRUE);
+
+    return self->position >= self->candidate_count;
+}
+
+/**
+ * gw_symbol_search_get_progress:
+ * @self: A #GwSymbolSearch.
+ *
+ * Returns: The fraction of the candidates which have already been matched.
+ */
+gdouble gw_symbol_search_get_progress(GwSymbolSearch *self)
+{
+    g_return_val_if_fail(GW_IS_SYMBOL_SEARCH(self), 1.0);
+
+    if (self->candidate_count == 0) {
+        return 1.0;
+    }
+
+    return self->position / (gdouble)self->candidate_count;
+}
+
+guint gw_symbol_search_get_candidate_count(GwSymbolSearch *self)
+{
+    g_return_val_if_fail(GW_IS_SYMBOL_SEARCH(self), 0);
+
+    return self->candidate_count;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glib-object.h>
+#include "gw-facs.h"
+#include "gw-symbol-index.h"
+
+G_BEGIN_DECLS
+
+#define GW_TYPE_SYMBOL_SEARCH (gw_symbol_search_get_type())
+G_DECLARE_FINAL_TYPE(GwSymbolSearch, gw_symbol_search, GW, SYMBOL_SEARCH, GObject)
+
+GwSymbolSearch *gw_symbol_search_new(GwFacs *facs,
+                                     GwSymbolIndex *index,
+                                     const gchar *pattern,
+                                     GError **error);
+
+gboolean gw_symbol_search_step(GwSymbolSearch *self, guint max_candidates, GPtrArray *results);
+gboolean gw_symbol_search_is_done(GwSymbolSearch *self);
+gdouble gw_symbol_search_get_progress(GwSymbolSearch *self);
+guint gw_symbol_search_get_candidate_count(GwSymbolSearch *self);
+
+G_END_DECLS
@@ -51,3 +51,43 @@ GwTimeScaleAndDimension *gw_time_scale_and_dimension_from_exponent(gint exponent
 
     return self;
 }
+
+gint gw_time_scale_and_dimension_to_exponent(GwTime scale, GwTimeDimension dimension)
+{
+    gint exponent;
+
+    switch (dimension) {
+        case GW_TIME_DIMENSION_MILLI:
+            exponent = -3;
+            break;
+        case GW_TIME_DIMENSION_MICRO:
+            exponent = -6;
+            break;
+        case GW_TIME_DIMENSION_NANO:
+            exponent = -9;
+            break;
+        case GW_TIME_DIMENSION_PICO:
+            exponent = -12;
+            break;
+        case GW_TIME_DIMENSION_FEMTO:
+            exponent = -15;
+            break;
+        case GW_TIME_DIMENSION_ATTO:
+            exponent = -18;
+            break;
+        case GW_TIME_DIMENSION_ZEPTO:
+            exponent = -21;
+            break;
+        default:
+            exponent = 0;
+            break;
+    }
+
+    if (scale == 100) {
+        exponent += 2;
+    } else if (scale == 10) {
+        exponent += 1;
+    }
+
+    return exponent;
+}
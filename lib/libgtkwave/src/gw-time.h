@@ -51,3 +51,4 @@ typedef struct
 } GwTimeScaleAndDimension;
 
 GwTimeScaleAndDimension *gw_time_scale_and_dimension_from_exponent(gint exponent);
+gint gw_time_scale_and_dimension_to_exponent(GwTime scale, GwTimeDimension dimension);
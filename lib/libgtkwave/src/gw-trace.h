@@ -2,6 +2,7 @@
 
 #include "gw-types.h"
 #include "gw-time.h"
+#include "gw-analog-envelope.h"
 
 struct _GwTrace
 {
@@ -21,6 +22,15 @@ struct _GwTrace
     double d_minval, d_maxval; /* cached value for when auto scaling is turned off */
     int d_num_ext; /* need to regen if differs from current in analog! */
 
+    GwAnalogEnvelope *analog_envelope; /* cached min/max of the analog values */
+    guint64 analog_envelope_flags; /* flags the envelope was built with */
+    GwTime analog_envelope_last; /* last time the envelope was built with */
+    gconstpointer analog_envelope_samples; /* history array the envelope was built over */
+    unsigned char analog_envelope_fpdecshift;
+
+    char *name_label; /* signal list name last measured */
+    int name_label_width;
+
     union
     {
         GwNode *nd; /* what makes up this trace */
@@ -1,4 +1,5 @@
 #include "gw-tree.h"
+#include "gw-stats.h"
 #include "gw-util.h"
 
 struct _GwTree
@@ -104,64 +105,130 @@ static int tree_qsort_cmp(const void *v1, const void *v2)
     return gw_signal_name_compare(t2->name, t1->name); /* because list must be in rvs */
 }
 
-static void gw_tree_sort_recursive(GwTree *self,
-                                   GwTreeNode *t,
-                                   GwTreeNode *p,
-                                   GwTreeNode ***tm,
-                                   int *tm_siz)
+// Sorts the sibling list starting at `t` and returns the new first sibling.
+static GwTreeNode *gw_tree_sort_siblings(GwTreeNode *t, GwTreeNode ***tm, int *tm_siz)
 {
     GwTreeNode *it;
     GwTreeNode **srt;
     int cnt;
     int i;
 
-    if (t->next) {
-        it = t;
-        cnt = 0;
-        do {
-            cnt++;
-            it = it->next;
-        } while (it);
-
-        if (cnt > *tm_siz) {
-            *tm_siz = cnt;
-            if (*tm) {
-                g_free(*tm);
-            }
-            *tm = g_malloc_n(cnt + 1, sizeof(GwTreeNode *));
+    it = t;
+    cnt = 0;
+    do {
+        cnt++;
+        it = it->next;
+    } while (it);
+
+    if (cnt > *tm_siz) {
+        *tm_siz = cnt;
+        if (*tm) {
+            g_free(*tm);
         }
-        srt = *tm;
+        *tm = g_malloc_n(cnt + 1, sizeof(GwTreeNode *));
+    }
+    srt = *tm;
 
-        for (i = 0; i < cnt; i++) {
-            srt[i] = t;
-            t = t->next;
-        }
-        srt[i] = NULL;
+    for (i = 0; i < cnt; i++) {
+        srt[i] = t;
+        t = t->next;
+    }
+    srt[i] = NULL;
+
+    qsort((void *)srt, cnt, sizeof(GwTreeNode *), tree_qsort_cmp);
+
+    for (i = 0; i < cnt; i++) {
+        srt[i]->next = srt[i + 1];
+    }
+
+    return srt[0];
+}
+
+static void gw_tree_sort_recursive(GwTree *self,
+                                   GwTreeNode *t,
+                                   GwTreeNode *p,
+                                   GwTreeNode ***tm,
+                                   int *tm_siz)
+{
+    GwTreeNode *it;
 
-        qsort((void *)srt, cnt, sizeof(GwTreeNode *), tree_qsort_cmp);
+    if (t->next) {
+        it = gw_tree_sort_siblings(t, tm, tm_siz);
 
         if (p) {
-            p->child = srt[0];
+            p->child = it;
         } else {
-            self->root = srt[0];
+            self->root = it;
         }
 
-        for (i = 0; i < cnt; i++) {
-            srt[i]->next = srt[i + 1];
-        }
-
-        it = srt[0];
-        for (i = 0; i < cnt; i++) {
+        for (; it != NULL; it = it->next) {
             if (it->child) {
                 gw_tree_sort_recursive(self, it->child, it, tm, tm_siz);
             }
-            it = it->next;
         }
     } else if (t->child) {
         gw_tree_sort_recursive(self, t->child, t, tm, tm_siz);
     }
 }
 
+static void gw_tree_sort_subtree(gpointer data, gpointer user_data)
+{
+    GwTreeNode *parent = *(GwTreeNode **)data;
+    GwTree *self = user_data;
+
+    GwTreeNode **tm = NULL;
+    int tm_siz = 0;
+
+    gw_tree_sort_recursive(self, parent->child, parent, &tm, &tm_siz);
+
+    g_free(tm);
+}
+
+/*
+ * Sorts the upper levels of the tree on the calling thread until there are
+ * enough independent subtrees to keep all threads busy, then sorts the
+ * subtrees in parallel. Each subtree only modifies its own nodes.
+ */
+static void gw_tree_sort_parallel(GwTree *self, guint n_threads)
+{
+    GwTreeNode **tm = NULL;
+    int tm_siz = 0;
+
+    self->root = gw_tree_sort_siblings(self->root, &tm, &tm_siz);
+
+    // Parents of the sibling lists that still need to be sorted.
+    GPtrArray *parents = g_ptr_array_new();
+    for (GwTreeNode *it = self->root; it != NULL; it = it->next) {
+        if (it->child) {
+            g_ptr_array_add(parents, it);
+        }
+    }
+
+    while (parents->len > 0 && parents->len < n_threads * 4) {
+        GPtrArray *next = g_ptr_array_new();
+
+        for (guint i = 0; i < parents->len; i++) {
+            GwTreeNode *parent = g_ptr_array_index(parents, i);
+
+            parent->child = gw_tree_sort_siblings(parent->child, &tm, &tm_siz);
+            for (GwTreeNode *it = parent->child; it != NULL; it = it->next) {
+                if (it->child) {
+                    g_ptr_array_add(next, it);
+                }
+            }
+        }
+
+        g_ptr_array_free(parents, TRUE);
+        parents = next;
+    }
+
+    g_free(tm);
+
+    gw_run_parallel(gw_tree_sort_subtree, parents->pdata, sizeof(gpointer), parents->len, self);
+
+    g_ptr_array_free(parents, TRUE);
+}
+
 void gw_tree_sort(GwTree *self)
 {
     g_return_if_fail(GW_IS_TREE(self));
@@ -170,12 +237,22 @@ void gw_tree_sort(GwTree *self)
         return;
     }
 
-    GwTreeNode **tm = NULL;
-    int tm_siz = 0;
+    gint64 stats_begin = gw_stats_timer_begin();
 
-    gw_tree_sort_recursive(self, self->root, NULL, &tm, &tm_siz);
+    guint n_threads = gw_get_thread_count();
 
-    g_free(tm);
+    if (n_threads > 1) {
+        gw_tree_sort_parallel(self, n_threads);
+    } else {
+        GwTreeNode **tm = NULL;
+        int tm_siz = 0;
+
+        gw_tree_sort_recursive(self, self->root, NULL, &tm, &tm_siz);
+
+        g_free(tm);
+    }
+
+    gw_stats_timer_end(GW_STATS_TIMER_SORT_TREE, stats_begin);
 }
 
 void gw_tree_graft(GwTree *self, GwTreeNode *graft_chain)
@@ -1,8 +1,10 @@
 #pragma once
 
+typedef struct _GwAnalogEnvelope GwAnalogEnvelope;
 typedef struct _GwBitAttributes GwBitAttributes;
 typedef struct _GwBits GwBits;
 typedef struct _GwBitVector GwBitVector;
+typedef struct _GwEdgeIndex GwEdgeIndex;
 typedef struct _GwExpandReferences GwExpandReferences;
 typedef struct _GwFac GwFac;
 typedef struct _GwHistEnt GwHistEnt;
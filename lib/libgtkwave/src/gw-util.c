@@ -143,3 +143,55 @@ gint gw_signal_name_compare(const gchar *name1, const gchar *name2)
     return (rc);
 }
 
+
+/*
+ * Number of threads used to process large post-load data structures in
+ * parallel. The GTKWAVE_THREADS environment variable limits the number of
+ * threads, 1 disables multi-threading.
+ */
+guint gw_get_thread_count(void)
+{
+    static gsize thread_count = 0;
+
+    if (g_once_init_enter(&thread_count)) {
+        guint count = g_get_num_processors();
+
+        const gchar *env = g_getenv("GTKWAVE_THREADS");
+        if (env != NULL) {
+            guint64 value = g_ascii_strtoull(env, NULL, 10);
+            if (value > 0) {
+                count = MIN(value, count);
+            }
+        }
+
+        g_once_init_leave(&thread_count, MAX(count, 1));
+    }
+
+    return thread_count;
+}
+
+/*
+ * Calls func for each element of the tasks array on a pool of up to
+ * gw_get_thread_count() threads and returns after all calls have finished.
+ */
+void gw_run_parallel(GFunc func,
+                     gpointer tasks,
+                     gsize task_size,
+                     guint n_tasks,
+                     gpointer user_data)
+{
+    guint n_threads = MIN(gw_get_thread_count(), n_tasks);
+
+    if (n_threads <= 1) {
+        for (guint i = 0; i < n_tasks; i++) {
+            func((guint8 *)tasks + i * task_size, user_data);
+        }
+        return;
+    }
+
+    GThreadPool *pool = g_thread_pool_new(func, user_data, n_threads, FALSE, NULL);
+    for (guint i = 0; i < n_tasks; i++) {
+        g_thread_pool_push(pool, (guint8 *)tasks + i * task_size, NULL);
+    }
+    g_thread_pool_free(pool, FALSE, TRUE);
+}
@@ -11,3 +11,10 @@ GParamSpec *gw_param_spec_time(const gchar *name,
                                GParamFlags flags);
 
 gint gw_signal_name_compare(const gchar *name1, const gchar *name2);
+
+guint gw_get_thread_count(void);
+void gw_run_parallel(GFunc func,
+                     gpointer tasks,
+                     gsize task_size,
+                     guint n_tasks,
+                     gpointer user_data);
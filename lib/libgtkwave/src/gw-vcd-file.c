@@ -32,6 +32,18 @@ static void gw_vcd_file_dispose(GObject *object)
     G_OBJECT_CLASS(gw_vcd_file_parent_class)->dispose(object);
 }
 
+static GwHistEntFactory *gw_vcd_file_get_hist_ent_factory(GwDumpFile *dump_file)
+{
+    return GW_VCD_FILE(dump_file)->hist_ent_factory;
+}
+
+static gsize gw_vcd_file_get_pending_bytes(GwDumpFile *dump_file, GwNode *node)
+{
+    (void)dump_file;
+
+    return gw_vlist_get_allocated_bytes(node->mv.mvlfac_vlist);
+}
+
 static void gw_vcd_file_class_init(GwVcdFileClass *klass)
 {
     GObjectClass *object_class = G_OBJECT_CLASS(klass);
@@ -40,6 +52,8 @@ static void gw_vcd_file_class_init(GwVcdFileClass *klass)
     object_class->dispose = gw_vcd_file_dispose;
 
     dump_file_class->import_traces = gw_vcd_file_import_traces;
+    dump_file_class->get_hist_ent_factory = gw_vcd_file_get_hist_ent_factory;
+    dump_file_class->get_pending_bytes = gw_vcd_file_get_pending_bytes;
 }
 
 static void gw_vcd_file_init(GwVcdFile *self)
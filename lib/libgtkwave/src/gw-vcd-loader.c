@@ -1,6 +1,7 @@
 #include "gw-vcd-loader.h"
 #include "gw-vcd-file.h"
 #include "gw-vcd-file-private.h"
+#include "gw-stats.h"
 #include "gw-util.h"
 #include "gw-hash.h"
 #include "vcd-keywords.h"
@@ -35,6 +36,8 @@ struct vcdsymbol
     int msi, lsi;
     int size;
 
+    fstHandle fst_handle;
+
     unsigned char vartype;
 };
 
@@ -126,6 +129,12 @@ struct _GwVcdLoader
 
     gboolean has_escaped_names;
     guint warning_filesize;
+
+    off_t next_progress;
+
+    gchar *fst_output;
+    void *fst_ctx;
+    GHashTable *fst_handles;
 };
 
 G_DEFINE_TYPE(GwVcdLoader, gw_vcd_loader, GW_TYPE_LOADER)
@@ -135,6 +144,7 @@ enum
     PROP_VLIST_PREPACK = 1,
     PROP_VLIST_COMPRESSION_LEVEL,
     PROP_WARNING_FILESIZE,
+    PROP_FST_OUTPUT,
     N_PROPERTIES,
 };
 
@@ -501,6 +511,242 @@ static void set_vcd_vartype(struct vcdsymbol *v, GwNode *n)
     n->vartype = nvt;
 }
 
+/******************************************************************/
+
+/*
+ * FST output: when an output path is set the parsed VCD is written to an FST
+ * file in the same pass that builds the in-memory vlists. The FST writer
+ * runs in parallel mode, so block compression overlaps with parsing.
+ */
+
+static enum fstScopeType vcd_fst_scope_type(unsigned char ttype)
+{
+    switch (ttype) {
+        case GW_TREE_KIND_VCD_ST_TASK:
+            return FST_ST_VCD_TASK;
+        case GW_TREE_KIND_VCD_ST_FUNCTION:
+            return FST_ST_VCD_FUNCTION;
+        case GW_TREE_KIND_VCD_ST_BEGIN:
+            return FST_ST_VCD_BEGIN;
+        case GW_TREE_KIND_VCD_ST_FORK:
+            return FST_ST_VCD_FORK;
+        case GW_TREE_KIND_VCD_ST_GENERATE:
+            return FST_ST_VCD_GENERATE;
+        case GW_TREE_KIND_VCD_ST_STRUCT:
+            return FST_ST_VCD_STRUCT;
+        case GW_TREE_KIND_VCD_ST_UNION:
+            return FST_ST_VCD_UNION;
+        case GW_TREE_KIND_VCD_ST_CLASS:
+            return FST_ST_VCD_CLASS;
+        case GW_TREE_KIND_VCD_ST_INTERFACE:
+            return FST_ST_VCD_INTERFACE;
+        case GW_TREE_KIND_VCD_ST_PACKAGE:
+            return FST_ST_VCD_PACKAGE;
+        case GW_TREE_KIND_VCD_ST_PROGRAM:
+            return FST_ST_VCD_PROGRAM;
+        case GW_TREE_KIND_VHDL_ST_ARCHITECTURE:
+            return FST_ST_VHDL_ARCHITECTURE;
+        case GW_TREE_KIND_VHDL_ST_RECORD:
+            return FST_ST_VHDL_RECORD;
+        case GW_TREE_KIND_VHDL_ST_BLOCK:
+            return FST_ST_VHDL_BLOCK;
+        case GW_TREE_KIND_VHDL_ST_GENERATE:
+            return FST_ST_VHDL_GENERATE;
+        case GW_TREE_KIND_VHDL_ST_GENIF:
+            return FST_ST_VHDL_IF_GENERATE;
+        case GW_TREE_KIND_VHDL_ST_GENFOR:
+            return FST_ST_VHDL_FOR_GENERATE;
+        case GW_TREE_KIND_VHDL_ST_FUNCTION:
+            return FST_ST_VHDL_FUNCTION;
+        case GW_TREE_KIND_VHDL_ST_PROCESS:
+            return FST_ST_VHDL_PROCESS;
+        case GW_TREE_KIND_VHDL_ST_PROCEDURE:
+            return FST_ST_VHDL_PROCEDURE;
+        default:
+            return FST_ST_VCD_MODULE;
+    }
+}
+
+static enum fstVarType vcd_fst_var_type(unsigned char vartype)
+{
+    switch (vartype) {
+        case V_EVENT:
+            return FST_VT_VCD_EVENT;
+        case V_PARAMETER:
+            return FST_VT_VCD_PARAMETER;
+        case V_INTEGER:
+            return FST_VT_VCD_INTEGER;
+        case V_REAL:
+            return FST_VT_VCD_REAL;
+        case V_REG:
+            return FST_VT_VCD_REG;
+        case V_SUPPLY0:
+            return FST_VT_VCD_SUPPLY0;
+        case V_SUPPLY1:
+            return FST_VT_VCD_SUPPLY1;
+        case V_TIME:
+            return FST_VT_VCD_TIME;
+        case V_TRI:
+            return FST_VT_VCD_TRI;
+        case V_TRIAND:
+            return FST_VT_VCD_TRIAND;
+        case V_TRIOR:
+            return FST_VT_VCD_TRIOR;
+        case V_TRIREG:
+            return FST_VT_VCD_TRIREG;
+        case V_TRI0:
+            return FST_VT_VCD_TRI0;
+        case V_TRI1:
+            return FST_VT_VCD_TRI1;
+        case V_WAND:
+            return FST_VT_VCD_WAND;
+        case V_WOR:
+            return FST_VT_VCD_WOR;
+        case V_STRINGTYPE:
+            return FST_VT_GEN_STRING;
+        case V_BIT:
+            return FST_VT_SV_BIT;
+        case V_LOGIC:
+            return FST_VT_SV_LOGIC;
+        case V_INT:
+            return FST_VT_SV_INT;
+        case V_SHORTINT:
+            return FST_VT_SV_SHORTINT;
+        case V_LONGINT:
+            return FST_VT_SV_LONGINT;
+        case V_BYTE:
+            return FST_VT_SV_BYTE;
+        case V_ENUM:
+            return FST_VT_SV_ENUM;
+        /* EVCD port values are converted to regular VCD values by the parser */
+        case V_PORT:
+        case V_WIRE:
+        default:
+            return FST_VT_VCD_WIRE;
+    }
+}
+
+static void vcd_fst_set_timescale(GwVcdLoader *self)
+{
+    int exponent;
+
+    switch (self->time_dimension) {
+        case ' ':
+            exponent = 0;
+            break;
+        case 'm':
+            exponent = -3;
+            break;
+        case 'u':
+            exponent = -6;
+            break;
+        case 'p':
+            exponent = -12;
+            break;
+        case 'f':
+            exponent = -15;
+            break;
+        case 'a':
+            exponent = -18;
+            break;
+        case 'z':
+            exponent = -21;
+            break;
+        case 'n':
+        default:
+            exponent = -9;
+            break;
+    }
+
+    if (self->time_scale == 10) {
+        exponent++;
+    } else if (self->time_scale == 100) {
+        exponent += 2;
+    }
+
+    fstWriterSetTimescale(self->fst_ctx, exponent);
+}
+
+static void vcd_fst_create_var(GwVcdLoader *self, struct vcdsymbol *v)
+{
+    fstHandle alias = GPOINTER_TO_UINT(g_hash_table_lookup(self->fst_handles, v->id));
+
+    const gchar *leaf = strrchr(v->name, VCD_HIERARCHY_DELIMITER);
+    leaf = leaf != NULL ? leaf + 1 : v->name;
+
+    gchar *name;
+    if (v->vartype != V_REAL && v->vartype != V_STRINGTYPE && v->msi != v->lsi) {
+        name = g_strdup_printf("%s [%d:%d]", leaf, v->msi, v->lsi);
+    } else if (v->vartype != V_REAL && v->vartype != V_STRINGTYPE && v->msi >= 0) {
+        name = g_strdup_printf("%s [%d]", leaf, v->msi);
+    } else {
+        name = g_strdup(leaf);
+    }
+
+    guint32 len = v->vartype == V_STRINGTYPE ? 0 : (guint32)v->size;
+
+    v->fst_handle = fstWriterCreateVar(self->fst_ctx,
+                                       vcd_fst_var_type(v->vartype),
+                                       FST_VD_IMPLICIT,
+                                       len,
+                                       name,
+                                       alias);
+    if (alias == 0) {
+        g_hash_table_insert(self->fst_handles, g_strdup(v->id), GUINT_TO_POINTER(v->fst_handle));
+    }
+
+    g_free(name);
+}
+
+static void vcd_fst_emit_scalar(GwVcdLoader *self, struct vcdsymbol *v, gchar value)
+{
+    if (v->fst_handle == 0) {
+        return;
+    }
+
+    if (v->size <= 1) {
+        gchar ch = g_ascii_tolower(value);
+        fstWriterEmitValueChange(self->fst_ctx, v->fst_handle, &ch);
+    } else {
+        /* scalar assigned to a vector: extend like a short binary value */
+        gchar *bits = g_alloca(v->size);
+        memset(bits, value != '1' ? g_ascii_tolower(value) : '0', v->size - 1);
+        bits[v->size - 1] = g_ascii_tolower(value);
+        fstWriterEmitValueChange(self->fst_ctx, v->fst_handle, bits);
+    }
+}
+
+static void vcd_fst_emit_binary(GwVcdLoader *self,
+                                struct vcdsymbol *v,
+                                gchar typ,
+                                const gchar *vector,
+                                gint vlen)
+{
+    if (v->fst_handle == 0) {
+        return;
+    }
+
+    if (v->vartype == V_REAL) {
+        gdouble d = g_ascii_strtod(vector, NULL);
+        fstWriterEmitValueChange(self->fst_ctx, v->fst_handle, &d);
+    } else if (v->vartype == V_STRINGTYPE || typ == 's' || typ == 'S') {
+        fstWriterEmitVariableLengthValueChange(self->fst_ctx, v->fst_handle, vector, vlen);
+    } else if (typ == 'b' || typ == 'B') {
+        if (vlen >= v->size) {
+            /* over-long vectors keep their rightmost bits like the vlist import does */
+            fstWriterEmitValueChange(self->fst_ctx, v->fst_handle, vector + (vlen - v->size));
+        } else {
+            /* left extend short vectors as described in the VCD spec */
+            gint delta = v->size - vlen;
+            gchar *bits = g_alloca(v->size);
+
+            memset(bits, vector[0] != '1' ? vector[0] : '0', delta);
+            memcpy(bits + delta, vector, vlen);
+            fstWriterEmitValueChange(self->fst_ctx, v->fst_handle, bits);
+        }
+    }
+}
+
 static unsigned int vlist_emit_finalize(GwVcdLoader *self)
 {
     struct vcdsymbol *v /* , *vprime */; /* scan-build */
@@ -603,10 +849,10 @@ static int getch_fetch(GwVcdLoader *self)
         return (-1);
     }
 
-    if (self->vcd_fsiz > 0) {
-        // TODO: update splash
-        // splash_sync(self->vcdbyteno, self->vcd_fsiz); /* gnome 2.18 seems to set errno so splash
-        //                                                                     moved here... */
+    if (self->vcdbyteno >= self->next_progress) {
+        // Limit the number of signal emissions to roughly one per percent of the file.
+        self->next_progress = self->vcdbyteno + MAX(self->vcd_fsiz / 100, VCD_BSIZ);
+        gw_loader_emit_progress(GW_LOADER(self), self->vcdbyteno, self->vcd_fsiz);
     }
 
     return ((int)(*self->vst));
@@ -1002,6 +1248,10 @@ static void parse_valuechange_scalar(GwVcdLoader *self)
             }
 
             gw_vlist_writer_append_uv32(n->mv.mvlfac_vlist_writer, rcv);
+
+            if (self->fst_ctx != NULL) {
+                vcd_fst_emit_scalar(self, v, self->yytext[0]);
+            }
         }
     } else {
         fprintf(stderr,
@@ -1020,6 +1270,11 @@ static void process_binary(GwVcdLoader *self, gchar typ, const gchar *vector, gi
                 (int)(self->vcdbyteno + (self->vst - self->vcdbuf)),
                 self->yytext + 1);
         malform_eof_fix(self);
+        return;
+    }
+
+    if (self->fst_ctx != NULL) {
+        vcd_fst_emit_binary(self, v, typ, vector, vlen);
     }
 
     GwNode *n = v->narray[0];
@@ -1261,6 +1516,10 @@ static void vcd_parse_timezero(GwVcdLoader *self)
 
     self->global_time_offset = atoi_64(self->yytext);
 
+    if (self->fst_ctx != NULL) {
+        fstWriterSetTimezero(self->fst_ctx, self->global_time_offset);
+    }
+
     // DEBUG(fprintf(stderr, "TIMEZERO: %" GW_TIME_FORMAT "\n",
     // self->global_time_offset));
     sync_end(self);
@@ -1315,6 +1574,10 @@ static void vcd_parse_timescale(GwVcdLoader *self)
             break;
     }
 
+    if (self->fst_ctx != NULL) {
+        vcd_fst_set_timescale(self);
+    }
+
     // DEBUG(fprintf(stderr,
     //               "TIMESCALE: %" GW_TIME_FORMAT " %cs\n",
     //               self->time_scale,
@@ -1413,6 +1676,10 @@ static void vcd_parse_scope(GwVcdLoader *self)
     GwTreeNode *scope = gw_tree_builder_push_scope(self->tree_builder, ttype, self->yytext);
     scope->t_which = -1;
 
+    if (self->fst_ctx != NULL) {
+        fstWriterSetScope(self->fst_ctx, vcd_fst_scope_type(ttype), self->yytext, NULL);
+    }
+
     // DEBUG(fprintf(stderr, "SCOPE: %s\n", self->name_prefix->str));
     sync_end(self);
 }
@@ -1422,6 +1689,10 @@ static void vcd_parse_upscope(GwVcdLoader *self)
     // TODO: add warning for upscope without scope
     gw_tree_builder_pop_scope(self->tree_builder);
 
+    if (self->fst_ctx != NULL) {
+        fstWriterSetUpscope(self->fst_ctx);
+    }
+
     sync_end(self);
 }
 
@@ -1705,6 +1976,10 @@ static void vcd_parse_var(GwVcdLoader *self)
     self->vcdsymcurr = v;
     self->numsyms++;
 
+    if (self->fst_ctx != NULL) {
+        vcd_fst_create_var(self, v);
+    }
+
     goto bail;
 err:
     if (v) {
@@ -1794,6 +2069,10 @@ static void vcd_parse_string(GwVcdLoader *self)
         tt = gw_vlist_alloc(&self->time_vlist, FALSE, self->vlist_compression_level);
         *tt = tim;
         self->time_vlist_count++;
+
+        if (self->fst_ctx != NULL) {
+            fstWriterEmitTimeChange(self->fst_ctx, tim);
+        }
     } else {
         if (self->time_vlist_count) {
             /* OK, otherwise fix for System C which doesn't emit time zero... */
@@ -1806,6 +2085,10 @@ static void vcd_parse_string(GwVcdLoader *self)
             tt = gw_vlist_alloc(&self->time_vlist, FALSE, self->vlist_compression_level);
             *tt = tim;
             self->time_vlist_count = 1;
+
+            if (self->fst_ctx != NULL) {
+                fstWriterEmitTimeChange(self->fst_ctx, tim);
+            }
         }
         parse_valuechange(self);
     }
@@ -1864,11 +2147,17 @@ static void vcd_parse(GwVcdLoader *self, GError **error)
             case T_DUMPOFF:
             case T_DUMPPORTSOFF:
                 gw_blackout_regions_add_dumpoff(self->blackout_regions, self->current_time);
+                if (self->fst_ctx != NULL) {
+                    fstWriterEmitDumpActive(self->fst_ctx, 0);
+                }
                 break;
 
             case T_DUMPON:
             case T_DUMPPORTSON:
                 gw_blackout_regions_add_dumpon(self->blackout_regions, self->current_time);
+                if (self->fst_ctx != NULL) {
+                    fstWriterEmitDumpActive(self->fst_ctx, 1);
+                }
                 break;
 
             case T_DUMPVARS:
@@ -2399,6 +2688,10 @@ static void treenamefix(GwTreeNode *t, char delimiter)
 
 static GwTree *vcd_build_tree(GwVcdLoader *self, GwFacs *facs)
 {
+    gint64 stats_begin = gw_stats_timer_begin();
+
+    self->tree_root = gw_tree_builder_build(self->tree_builder);
+
     // TODO: replace module_tree by GString to dynamically allocate enough memory
     self->module_tree = g_malloc0(65536);
 
@@ -2426,6 +2719,9 @@ static GwTree *vcd_build_tree(GwVcdLoader *self, GwFacs *facs)
     if (self->terminals_chain != NULL) {
         gw_tree_graft(tree, self->terminals_chain);
     }
+
+    gw_stats_timer_end(GW_STATS_TIMER_BUILD_TREE, stats_begin);
+
     gw_tree_sort(tree);
 
     if (self->has_escaped_names) {
@@ -2442,6 +2738,12 @@ static void gw_vcd_loader_finalize(GObject *object)
     GwVcdLoader *self = GW_VCD_LOADER(object);
 
     g_free(self->sym_hash);
+    g_free(self->fst_output);
+
+    if (self->fst_ctx != NULL) {
+        fstWriterClose(self->fst_ctx);
+    }
+    g_clear_pointer(&self->fst_handles, g_hash_table_destroy);
 
     G_OBJECT_CLASS(gw_vcd_loader_parent_class)->finalize(object);
 }
@@ -2517,6 +2819,22 @@ static GwDumpFile *gw_vcd_loader_load(GwLoader *loader, const gchar *fname, GErr
     // TODO: update splash
     // /* SPLASH */ splash_create();
 
+    if (self->fst_output != NULL) {
+        self->fst_ctx = fstWriterCreate(self->fst_output, 1);
+        if (self->fst_ctx == NULL) {
+            g_set_error(error,
+                        GW_DUMP_FILE_ERROR,
+                        GW_DUMP_FILE_ERROR_UNKNOWN,
+                        "Error opening FST output file '%s'.\n",
+                        self->fst_output);
+            return NULL;
+        }
+
+        self->fst_handles = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+        fstWriterSetPackType(self->fst_ctx, FST_WR_PT_LZ4);
+        fstWriterSetParallelMode(self->fst_ctx, 1);
+    }
+
     getch_alloc(self); /* alloc membuff for vcd getch buffer */
 
     self->time_vlist = gw_vlist_create(sizeof(GwTime));
@@ -2534,6 +2852,13 @@ static GwDumpFile *gw_vcd_loader_load(GwLoader *loader, const gchar *fname, GErr
         self->varsplit = NULL;
     }
 
+    if (self->fst_ctx != NULL) {
+        fstWriterClose(g_steal_pointer(&self->fst_ctx));
+        g_clear_pointer(&self->fst_handles, g_hash_table_destroy);
+    }
+
+    gw_loader_emit_progress(loader, self->vcd_fsiz, self->vcd_fsiz);
+
     gw_vlist_freeze(&self->time_vlist, self->vlist_compression_level);
 
     vlist_emit_finalize(self);
@@ -2575,8 +2900,6 @@ static GwDumpFile *gw_vcd_loader_load(GwLoader *loader, const gchar *fname, GErr
 
     vcd_build_symbols(self);
     GwFacs *facs = vcd_sortfacs(self);
-
-    self->tree_root = gw_tree_builder_build(self->tree_builder);
     GwTree *tree = vcd_build_tree(self, facs);
 
     vcd_cleanup(self);
@@ -2639,6 +2962,10 @@ static void gw_vcd_loader_set_property(GObject *object,
             gw_vcd_loader_set_warning_filesize(self, g_value_get_uint(value));
             break;
 
+        case PROP_FST_OUTPUT:
+            gw_vcd_loader_set_fst_output(self, g_value_get_string(value));
+            break;
+
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
             break;
@@ -2665,6 +2992,10 @@ static void gw_vcd_loader_get_property(GObject *object,
             g_value_set_uint(value, gw_vcd_loader_get_warning_filesize(self));
             break;
 
+        case PROP_FST_OUTPUT:
+            g_value_set_string(value, gw_vcd_loader_get_fst_output(self));
+            break;
+
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
             break;
@@ -2707,6 +3038,13 @@ static void gw_vcd_loader_class_init(GwVcdLoaderClass *klass)
                           0,
                           G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
+    properties[PROP_FST_OUTPUT] =
+        g_param_spec_string("fst-output",
+                            NULL,
+                            NULL,
+                            NULL,
+                            G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
     g_object_class_install_properties(object_class, N_PROPERTIES, properties);
 }
 
@@ -2791,4 +3129,38 @@ guint gw_vcd_loader_get_warning_filesize(GwVcdLoader *self)
     g_return_val_if_fail(GW_IS_VCD_LOADER(self), FALSE);
 
     return self->warning_filesize;
-}
\ No newline at end of file
+}
+
+/**
+ * gw_vcd_loader_set_fst_output:
+ * @self: A #GwVcdLoader.
+ * @path: (nullable): The path of the FST file or %NULL.
+ *
+ * Sets the path of an FST file that is written while the VCD file is loaded.
+ * The conversion uses the same parser pass that builds the dump file, so the
+ * VCD file only needs to be read once.
+ */
+void gw_vcd_loader_set_fst_output(GwVcdLoader *self, const gchar *path)
+{
+    g_return_if_fail(GW_IS_VCD_LOADER(self));
+
+    if (g_strcmp0(self->fst_output, path) != 0) {
+        g_free(self->fst_output);
+        self->fst_output = g_strdup(path);
+
+        g_object_notify_by_pspec(G_OBJECT(self), properties[PROP_FST_OUTPUT]);
+    }
+}
+
+/**
+ * gw_vcd_loader_get_fst_output:
+ * @self: A #GwVcdLoader.
+ *
+ * Returns: (nullable): The path of the FST output file or %NULL.
+ */
+const gchar *gw_vcd_loader_get_fst_output(GwVcdLoader *self)
+{
+    g_return_val_if_fail(GW_IS_VCD_LOADER(self), NULL);
+
+    return self->fst_output;
+}
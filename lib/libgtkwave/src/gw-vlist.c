@@ -1,12 +1,31 @@
 #include "gw-vlist.h"
+#include "gw-stats.h"
 #include <zlib.h>
 
+/* block allocation, the caller must set the allocated field after copying
+ * the header from another block
+ */
+static GwVlist *gw_vlist_block_alloc(gsize size, gboolean clear)
+{
+    GwVlist *v = clear ? g_malloc0(size) : g_malloc(size);
+    gw_stats_counter_add(GW_STATS_COUNTER_VLISTS, size);
+
+    return v;
+}
+
+static void gw_vlist_block_free(GwVlist *v)
+{
+    gw_stats_counter_add(GW_STATS_COUNTER_VLISTS, -(gint64)v->allocated);
+    g_free(v);
+}
+
 /* create / destroy */
 GwVlist *gw_vlist_create(unsigned int element_size)
 {
-    GwVlist *v = g_malloc0(sizeof(GwVlist) + element_size);
+    GwVlist *v = gw_vlist_block_alloc(sizeof(GwVlist) + element_size, TRUE);
     v->size = 1;
     v->element_size = element_size;
+    v->allocated = sizeof(GwVlist) + element_size;
 
     return v;
 }
@@ -15,7 +34,7 @@ void gw_vlist_destroy(GwVlist *self)
 {
     while (self != NULL) {
         GwVlist *vt = self->next;
-        g_free(self);
+        gw_vlist_block_free(self);
         self = vt;
     }
 }
@@ -30,6 +49,8 @@ static GwVlist *gw_vlist_compress_block(GwVlist *v, guint *rsize, gint compressi
         return v;
     }
 
+    gint64 stats_begin = gw_stats_timer_begin();
+
     GwVlist *vz;
     unsigned int *ipnt;
     char *dmem = g_malloc(compressBound(v->size));
@@ -44,19 +65,22 @@ static GwVlist *gw_vlist_compress_block(GwVlist *v, guint *rsize, gint compressi
     if ((rc == Z_OK) && ((destlen + sizeof(int)) < v->size)) {
         /* printf("siz: %d, dest: %d rc: %d\n", v->siz, (int)destlen, rc); */
 
-        vz = g_malloc(*rsize = sizeof(GwVlist) + sizeof(int) + destlen);
+        vz = gw_vlist_block_alloc(*rsize = sizeof(GwVlist) + sizeof(int) + destlen, FALSE);
         memcpy(vz, v, sizeof(GwVlist));
+        vz->allocated = *rsize;
 
         ipnt = (unsigned int *)(vz + 1);
         ipnt[0] = destlen;
         memcpy(&ipnt[1], dmem, destlen);
         vz->offset = (unsigned int)(-(int)v->offset); /* neg value signified compression */
-        g_free(v);
+        gw_vlist_block_free(v);
         v = vz;
     }
 
     g_free(dmem);
 
+    gw_stats_timer_end(GW_STATS_TIMER_VLIST_COMPRESS, stats_begin);
+
     return (v);
 }
 
@@ -67,13 +91,14 @@ void gw_vlist_uncompress(GwVlist **v)
 
     while (vl != NULL) {
         if ((int)vl->offset < 0) {
-            GwVlist *vz = g_malloc(sizeof(GwVlist) + vl->size);
+            GwVlist *vz = gw_vlist_block_alloc(sizeof(GwVlist) + vl->size, FALSE);
             unsigned int *ipnt;
             unsigned long sourcelen, destlen;
             int rc;
 
             memcpy(vz, vl, sizeof(GwVlist));
             vz->offset = (unsigned int)(-(int)vl->offset);
+            vz->allocated = sizeof(GwVlist) + vl->size;
 
             ipnt = (unsigned int *)(vl + 1);
             sourcelen = (unsigned long)ipnt[0];
@@ -87,7 +112,7 @@ void gw_vlist_uncompress(GwVlist **v)
                 g_error("Error in vlist uncompress(), rc=%d/destlen=%d exiting!", rc, (int)destlen);
             }
 
-            g_free(vl);
+            gw_vlist_block_free(vl);
             vl = vz;
 
             if (vprev) {
@@ -124,16 +149,18 @@ void *gw_vlist_alloc(GwVlist **v, gboolean compressable, gint compression_level)
             }
         }
 
-        v2 = g_malloc0(sizeof(GwVlist) + (vl->size * vl->element_size));
+        v2 = gw_vlist_block_alloc(sizeof(GwVlist) + (vl->size * vl->element_size), TRUE);
         v2->size = siz;
         v2->element_size = vl->element_size;
+        v2->allocated = sizeof(GwVlist) + (vl->size * vl->element_size);
         v2->next = vl;
         *v = v2;
         vl = *v;
     } else if (vl->offset * 2 == vl->size) {
-        v2 = g_malloc0(sizeof(GwVlist) + (vl->size * vl->element_size));
+        v2 = gw_vlist_block_alloc(sizeof(GwVlist) + (vl->size * vl->element_size), TRUE);
         memcpy(v2, vl, sizeof(GwVlist) + (vl->size / 2 * vl->element_size));
-        g_free(vl);
+        v2->allocated = sizeof(GwVlist) + (vl->size * vl->element_size);
+        gw_vlist_block_free(vl);
 
         *v = v2;
         vl = *v;
@@ -151,6 +178,20 @@ guint gw_vlist_size(GwVlist *self)
     return self->size - 1 + self->offset;
 }
 
+/* number of bytes held by all blocks of the vlist, compressed blocks count with
+ * their compressed size
+ */
+gsize gw_vlist_get_allocated_bytes(GwVlist *self)
+{
+    gsize bytes = 0;
+
+    for (GwVlist *v = self; v != NULL; v = v->next) {
+        bytes += v->allocated;
+    }
+
+    return bytes;
+}
+
 void *gw_vlist_locate(GwVlist *self, unsigned int idx)
 {
     unsigned int here = self->size - 1;
@@ -183,9 +224,11 @@ void gw_vlist_freeze(GwVlist **v, gint compression_level)
 
         if (vl->offset * 2 <= vl->size) /* Electric Fence, change < to <= */
         {
-            v2 = g_malloc0(sizeof(GwVlist) + (vl->size /* * vl->elem_siz */)); /* scan-build */
+            v2 = gw_vlist_block_alloc(sizeof(GwVlist) + (vl->size /* * vl->elem_siz */),
+                                      TRUE); /* scan-build */
             memcpy(v2, vl, sizeof(GwVlist) + (vl->size / 2 /* * vl->elem_siz */)); /* scan-build */
-            g_free(vl);
+            v2->allocated = sizeof(GwVlist) + vl->size;
+            gw_vlist_block_free(vl);
 
             *v = v2;
             vl = *v;
@@ -194,9 +237,10 @@ void gw_vlist_freeze(GwVlist **v, gint compression_level)
         w = gw_vlist_compress_block(vl, &rsiz, compression_level);
         *v = w;
     } else if (siz != vl->size) {
-        GwVlist *w = g_malloc(rsiz);
+        GwVlist *w = gw_vlist_block_alloc(rsiz, FALSE);
         memcpy(w, vl, rsiz);
-        g_free(vl);
+        w->allocated = rsiz;
+        gw_vlist_block_free(vl);
         *v = w;
     }
 }
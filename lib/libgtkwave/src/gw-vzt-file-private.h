@@ -0,0 +1,16 @@
+#pragma once
+
+#include <gtkwave.h>
+#include <vzt_read.h>
+#include "gw-lx2.h"
+
+#define VZT_RDLOAD "VZTLOAD | "
+
+struct _GwVztFile
+{
+    GwDumpFile parent_instance;
+
+    struct vzt_rd_trace *lt;
+
+    GwLx2History history;
+};
@@ -0,0 +1,83 @@
+#include "gw-vzt-file.h"
+#include "gw-vzt-file-private.h"
+
+G_DEFINE_TYPE(GwVztFile, gw_vzt_file, GW_TYPE_DUMP_FILE)
+
+static void vzt_callback(struct vzt_rd_trace **lt,
+                         vztint64_t *time,
+                         vztint32_t *facidx,
+                         char **value)
+{
+    GwLx2History *history = vzt_rd_get_user_callback_data_pointer(*lt);
+
+    gw_lx2_history_add_value(history, *facidx, *time, *value);
+}
+
+static gboolean vzt_get_process_mask(gpointer lt, guint32 facidx)
+{
+    return vzt_rd_get_fac_process_mask(lt, facidx);
+}
+
+static void vzt_set_process_mask(gpointer lt, guint32 facidx)
+{
+    vzt_rd_set_fac_process_mask(lt, facidx);
+}
+
+static void vzt_clr_process_mask(gpointer lt, guint32 facidx)
+{
+    vzt_rd_clr_fac_process_mask(lt, facidx);
+}
+
+static void vzt_iter_blocks(gpointer lt, GwLx2History *history)
+{
+    vzt_rd_iter_blocks(lt, vzt_callback, history);
+}
+
+static const GwLx2ReaderFuncs vzt_reader_funcs = {
+    .log_prefix = VZT_RDLOAD,
+    .get_process_mask = vzt_get_process_mask,
+    .set_process_mask = vzt_set_process_mask,
+    .clr_process_mask = vzt_clr_process_mask,
+    .iter_blocks = vzt_iter_blocks,
+};
+
+static gboolean gw_vzt_file_import_traces(GwDumpFile *dump_file, GwNode **nodes, GError **error)
+{
+    GwVztFile *self = GW_VZT_FILE(dump_file);
+    (void)error;
+
+    gw_lx2_history_import(&self->history, &vzt_reader_funcs, self->lt, nodes);
+
+    return TRUE;
+}
+
+static void gw_vzt_file_finalize(GObject *object)
+{
+    GwVztFile *self = GW_VZT_FILE(object);
+
+    g_clear_pointer(&self->lt, vzt_rd_close);
+    gw_lx2_history_clear(&self->history);
+
+    G_OBJECT_CLASS(gw_vzt_file_parent_class)->finalize(object);
+}
+
+static GwHistEntFactory *gw_vzt_file_get_hist_ent_factory(GwDumpFile *dump_file)
+{
+    return GW_VZT_FILE(dump_file)->history.hist_ent_factory;
+}
+
+static void gw_vzt_file_class_init(GwVztFileClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    GwDumpFileClass *dump_file_class = GW_DUMP_FILE_CLASS(klass);
+
+    object_class->finalize = gw_vzt_file_finalize;
+
+    dump_file_class->import_traces = gw_vzt_file_import_traces;
+    dump_file_class->get_hist_ent_factory = gw_vzt_file_get_hist_ent_factory;
+}
+
+static void gw_vzt_file_init(GwVztFile *self)
+{
+    (void)self;
+}
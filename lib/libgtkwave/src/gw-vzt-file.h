@@ -0,0 +1,10 @@
+#pragma once
+
+#include <gtkwave.h>
+
+G_BEGIN_DECLS
+
+#define GW_TYPE_VZT_FILE (gw_vzt_file_get_type())
+G_DECLARE_FINAL_TYPE(GwVztFile, gw_vzt_file, GW, VZT_FILE, GwDumpFile)
+
+G_END_DECLS
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <glib-object.h>
+#include "gw-loader.h"
+
+G_BEGIN_DECLS
+
+#define GW_TYPE_VZT_LOADER (gw_vzt_loader_get_type())
+G_DECLARE_FINAL_TYPE(GwVztLoader, gw_vzt_loader, GW, VZT_LOADER, GwLoader)
+
+GwLoader *gw_vzt_loader_new(void);
+
+G_END_DECLS
@@ -0,0 +1,113 @@
+#include <math.h>
+#include <gtkwave.h>
+
+static gdouble array_value(guint index, gpointer user_data)
+{
+    GArray *values = user_data;
+
+    g_assert_cmpuint(index, <, values->len);
+
+    return g_array_index(values, gdouble, index);
+}
+
+static GwAnalogEnvelope *envelope_new_for_values(GArray *values)
+{
+    return gw_analog_envelope_new(values->len, array_value, values);
+}
+
+static void test_empty(void)
+{
+    GArray *values = g_array_new(FALSE, FALSE, sizeof(gdouble));
+    GwAnalogEnvelope *envelope = envelope_new_for_values(values);
+    GwAnalogRange range;
+
+    g_assert_cmpuint(gw_analog_envelope_get_length(envelope), ==, 0);
+
+    gw_analog_envelope_get_range(envelope, 0, 10, &range);
+    g_assert_cmpint(range.flags, ==, 0);
+
+    gw_analog_envelope_free(envelope);
+    g_array_free(values, TRUE);
+}
+
+static void test_non_finite(void)
+{
+    static const gdouble samples[] = {NAN, -5.0, INFINITY, 7.0, -INFINITY};
+    GArray *values = g_array_new(FALSE, FALSE, sizeof(gdouble));
+    g_array_append_vals(values, samples, G_N_ELEMENTS(samples));
+
+    GwAnalogEnvelope *envelope = envelope_new_for_values(values);
+    GwAnalogRange range;
+
+    g_assert_cmpuint(gw_analog_envelope_get_length(envelope), ==, 5);
+
+    gw_analog_envelope_get_range(envelope, 0, 1, &range);
+    g_assert_cmpint(range.flags, ==, GW_ANALOG_RANGE_NAN);
+
+    gw_analog_envelope_get_range(envelope, 2, 2, &range);
+    g_assert_cmpint(range.flags, ==, 0);
+
+    gw_analog_envelope_get_range(envelope, 1, 4, &range);
+    g_assert_cmpint(range.flags, ==, GW_ANALOG_RANGE_FINITE | GW_ANALOG_RANGE_POSITIVE_INFINITY);
+    g_assert_cmpfloat(range.min, ==, -5.0);
+    g_assert_cmpfloat(range.max, ==, 7.0);
+
+    gw_analog_envelope_get_range(envelope, 3, 100, &range);
+    g_assert_cmpint(range.flags, ==, GW_ANALOG_RANGE_FINITE | GW_ANALOG_RANGE_NEGATIVE_INFINITY);
+    g_assert_cmpfloat(range.min, ==, 7.0);
+    g_assert_cmpfloat(range.max, ==, 7.0);
+
+    gw_analog_envelope_free(envelope);
+    g_array_free(values, TRUE);
+}
+
+static void test_large(void)
+{
+    // Enough samples for multiple summary levels, compared against a linear scan.
+    const guint n = 20000;
+    GArray *values = g_array_sized_new(FALSE, FALSE, sizeof(gdouble), n);
+
+    GRand *rand = g_rand_new_with_seed(42);
+    for (guint i = 0; i < n; i++) {
+        gdouble value = g_rand_double_range(rand, -1000.0, 1000.0);
+        g_array_append_val(values, value);
+    }
+
+    GwAnalogEnvelope *envelope = envelope_new_for_values(values);
+
+    for (guint k = 0; k < 500; k++) {
+        guint start = g_rand_int_range(rand, 0, n);
+        guint end = g_rand_int_range(rand, start + 1, n + 1);
+
+        gdouble min = g_array_index(values, gdouble, start);
+        gdouble max = min;
+        for (guint i = start; i < end; i++) {
+            min = MIN(min, g_array_index(values, gdouble, i));
+            max = MAX(max, g_array_index(values, gdouble, i));
+        }
+
+        GwAnalogRange range;
+        gw_analog_envelope_get_range(envelope, start, end, &range);
+        g_assert_cmpint(range.flags, ==, GW_ANALOG_RANGE_FINITE);
+        g_assert_cmpfloat(range.min, ==, min);
+        g_assert_cmpfloat(range.max, ==, max);
+    }
+
+    // Only the summary levels are held, about one range per BLOCK_SIZE samples.
+    g_assert_cmpuint(gw_analog_envelope_get_memory_size(envelope), <, n * sizeof(gdouble) / 4);
+
+    g_rand_free(rand);
+    gw_analog_envelope_free(envelope);
+    g_array_free(values, TRUE);
+}
+
+int main(int argc, char *argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/analog_envelope/empty", test_empty);
+    g_test_add_func("/analog_envelope/non_finite", test_non_finite);
+    g_test_add_func("/analog_envelope/large", test_large);
+
+    return g_test_run();
+}
@@ -77,6 +77,134 @@ static void test_find_symbols(void)
     g_object_unref(file);
 }
 
+static void test_lookup_symbols(void)
+{
+    GwLoader *loader = gw_vcd_loader_new();
+    GwDumpFile *file = gw_loader_load(loader, "files/basic.vcd", NULL);
+    g_assert_nonnull(file);
+    g_object_unref(loader);
+
+    GwFacs *facs = gw_dump_file_get_facs(file);
+
+    // Look up all facs in reverse order, the names without a trailing `[0]`
+    // and a name which doesn't exist.
+
+    GPtrArray *names = g_ptr_array_new_with_free_func(g_free);
+    for (guint i = gw_facs_get_length(facs); i > 0; i--) {
+        const gchar *name = gw_facs_get(facs, i - 1)->name;
+        g_ptr_array_add(names, g_strdup(name));
+        if (g_str_has_suffix(name, "[0]")) {
+            g_ptr_array_add(names, g_strndup(name, strlen(name) - 3));
+        }
+    }
+    g_ptr_array_add(names, g_strdup("doesNotExist"));
+
+    GwSymbol **symbols = g_new(GwSymbol *, names->len);
+    gw_dump_file_lookup_symbols(file, (const gchar *const *)names->pdata, names->len, symbols);
+
+    for (guint i = 0; i < names->len; i++) {
+        const gchar *name = g_ptr_array_index(names, i);
+        g_assert_true(symbols[i] == gw_dump_file_lookup_symbol(file, name));
+    }
+    g_assert_null(symbols[names->len - 1]);
+
+    g_free(symbols);
+    g_ptr_array_free(names, TRUE);
+    g_object_unref(file);
+}
+
+static void test_search_symbols(void)
+{
+    GwLoader *loader = gw_vcd_loader_new();
+    GwDumpFile *file = gw_loader_load(loader, "files/basic.vcd", NULL);
+    g_assert_nonnull(file);
+    g_object_unref(loader);
+
+    GwSymbolSearch *search = gw_dump_file_search_symbols(file, "_ALIAS$", NULL);
+    g_assert_nonnull(search);
+    g_assert_cmpuint(gw_symbol_search_get_candidate_count(search), ==, 6);
+
+    // The incremental search returns the same results as a full search.
+
+    GPtrArray *results = g_ptr_array_new();
+    guint steps = 0;
+    while (gw_symbol_search_step(search, 1, results)) {
+        g_assert_cmpuint(results->len, ==, steps + 1);
+        steps++;
+    }
+    g_assert_true(gw_symbol_search_is_done(search));
+    g_assert_cmpfloat(gw_symbol_search_get_progress(search), ==, 1.0);
+    g_object_unref(search);
+
+    GPtrArray *symbols = gw_dump_file_find_symbols(file, "_alias$", NULL);
+    g_assert_cmpuint(results->len, ==, symbols->len);
+    for (guint i = 0; i < symbols->len; i++) {
+        g_assert_true(g_ptr_array_index(results, i) == g_ptr_array_index(symbols, i));
+    }
+
+    g_ptr_array_free(symbols, TRUE);
+    g_ptr_array_free(results, TRUE);
+    g_object_unref(file);
+}
+
+static void test_memory_usage(void)
+{
+    GwLoader *loader = gw_vcd_loader_new();
+    GwDumpFile *file = gw_loader_load(loader, "files/basic.vcd", NULL);
+    g_assert_nonnull(file);
+    g_object_unref(loader);
+
+    GwMemoryUsage usage;
+
+    // Before the import all value changes are pending.
+
+    gw_dump_file_get_memory_usage(file, &usage);
+    g_assert_cmpuint(usage.pending, >, 0);
+    g_assert_cmpuint(usage.hist_ents, ==, 0);
+    g_assert_cmpuint(gw_memory_usage_get_total(&usage), ==, usage.pending);
+
+    g_assert_true(gw_dump_file_import_all(file, NULL));
+
+    gw_dump_file_get_memory_usage(file, &usage);
+    g_assert_cmpuint(usage.pending, ==, 0);
+    g_assert_cmpuint(usage.hist_ents, >, 0);
+    g_assert_cmpuint(usage.vectors, >, 0);
+    g_assert_cmpuint(usage.strings, >, 0);
+
+    // The `aliases` scope only contains aliases of the `variables` scope,
+    // which share their histories.
+
+    GwTreeNode *variables = gw_tree_get_root(gw_dump_file_get_tree(file));
+    g_assert_cmpstr(variables->name, ==, "variables");
+    g_assert_nonnull(variables->next);
+
+    GwMemoryUsage scope_usage;
+    gw_dump_file_get_scope_memory_usage(file, variables, &scope_usage);
+    g_assert_cmpuint(gw_memory_usage_get_total(&scope_usage),
+                     ==,
+                     gw_memory_usage_get_total(&usage));
+    g_assert_cmpuint(scope_usage.transitions, ==, usage.transitions);
+
+    GwMemoryUsage sum = {0};
+    for (GwTreeNode *child = variables->child; child != NULL; child = child->next) {
+        GwSymbol *symbol = gw_facs_get(gw_dump_file_get_facs(file), child->t_which);
+
+        GwMemoryUsage node_usage;
+        gw_dump_file_get_node_memory_usage(file, symbol->n, &node_usage);
+        g_assert_cmpuint(node_usage.transitions, >, 0);
+        gw_memory_usage_add(&sum, &node_usage);
+    }
+    g_assert_cmpuint(gw_memory_usage_get_total(&sum), ==, gw_memory_usage_get_total(&usage));
+
+    GwHistEntBlockUsage block_usage;
+    gw_dump_file_get_hist_ent_block_usage(file, &block_usage);
+    g_assert_cmpuint(block_usage.live, ==, usage.hist_ents);
+    g_assert_cmpuint(block_usage.used, >=, block_usage.live);
+    g_assert_cmpuint(block_usage.allocated, >=, block_usage.used);
+
+    g_object_unref(file);
+}
+
 int main(int argc, char *argv[])
 {
     g_test_init(&argc, &argv, NULL);
@@ -84,6 +212,9 @@ int main(int argc, char *argv[])
     g_test_add_func("/dump_file/blackout_regions", test_blackout_regions);
     g_test_add_func("/dump_file/stems", test_stems);
     g_test_add_func("/dump_file/find_symbols", test_find_symbols);
+    g_test_add_func("/dump_file/lookup_symbols", test_lookup_symbols);
+    g_test_add_func("/dump_file/search_symbols", test_search_symbols);
+    g_test_add_func("/dump_file/memory_usage", test_memory_usage);
 
     return g_test_run();
 }
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include <gtkwave.h>
+
+static GwDumpFile *load_basic_vcd(void)
+{
+    GwLoader *loader = gw_vcd_loader_new();
+    GwDumpFile *file = gw_loader_load(loader, "files/basic.vcd", NULL);
+    g_assert_nonnull(file);
+    g_object_unref(loader);
+
+    return file;
+}
+
+static void test_node(void)
+{
+    GwDumpFile *file = load_basic_vcd();
+
+    GwSymbol *symbol = gw_dump_file_lookup_symbol(file, "variables.bit");
+    g_assert_nonnull(symbol);
+
+    GwEdgeIndex *index = gw_edge_index_new_for_node(symbol->n);
+    g_assert_nonnull(index);
+
+    // 0 @ 0, x @ 1, z @ 2, 1 @ 3, h @ 4, u @ 5, w @ 6, l @ 7, - @ 8
+    GwTime t = -1;
+    g_assert_true(gw_edge_index_find_next(index, GW_EDGE_TYPE_ANY, -1, &t));
+    g_assert_cmpint(t, ==, 0);
+    g_assert_true(gw_edge_index_find_next(index, GW_EDGE_TYPE_ANY, 4, &t));
+    g_assert_cmpint(t, ==, 5);
+    g_assert_false(gw_edge_index_find_next(index, GW_EDGE_TYPE_ANY, 8, &t));
+
+    g_assert_true(gw_edge_index_find_previous(index, GW_EDGE_TYPE_ANY, 4, &t));
+    g_assert_cmpint(t, ==, 3);
+    g_assert_false(gw_edge_index_find_previous(index, GW_EDGE_TYPE_ANY, 0, &t));
+
+    g_assert_true(gw_edge_index_find_next(index, GW_EDGE_TYPE_RISING, 0, &t));
+    g_assert_cmpint(t, ==, 3);
+    g_assert_false(gw_edge_index_find_next(index, GW_EDGE_TYPE_RISING, 3, &t));
+
+    g_assert_true(gw_edge_index_find_previous(index, GW_EDGE_TYPE_FALLING, 100, &t));
+    g_assert_cmpint(t, ==, 7);
+    g_assert_true(gw_edge_index_find_previous(index, GW_EDGE_TYPE_FALLING, 7, &t));
+    g_assert_cmpint(t, ==, 0);
+
+    g_assert_cmpuint(gw_edge_index_count(index, GW_EDGE_TYPE_ANY, 0, 8), ==, 9);
+    g_assert_cmpuint(gw_edge_index_count(index, GW_EDGE_TYPE_ANY, 2, 4), ==, 3);
+    g_assert_cmpuint(gw_edge_index_count(index, GW_EDGE_TYPE_RISING, 0, 8), ==, 1);
+    g_assert_cmpuint(gw_edge_index_count(index, GW_EDGE_TYPE_FALLING, 0, 8), ==, 2);
+    g_assert_cmpuint(gw_edge_index_count(index, GW_EDGE_TYPE_ANY, 4, 2), ==, 0);
+
+    gw_edge_index_free(index);
+
+    // Multi bit nodes only have value changes.
+    symbol = gw_dump_file_lookup_symbol(file, "variables.vector[7:0]");
+    g_assert_nonnull(symbol);
+
+    index = gw_edge_index_new_for_node(symbol->n);
+    g_assert_cmpuint(gw_edge_index_count(index, GW_EDGE_TYPE_ANY, 0, 100), ==, 9);
+    g_assert_cmpuint(gw_edge_index_count(index, GW_EDGE_TYPE_RISING, 0, 100), ==, 0);
+    g_assert_cmpuint(gw_edge_index_count(index, GW_EDGE_TYPE_FALLING, 0, 100), ==, 0);
+    gw_edge_index_free(index);
+
+    g_object_unref(file);
+}
+
+static void test_vector(void)
+{
+    const gint n = 1000;
+    GwBitVector *vector = g_malloc0(sizeof(GwBitVector) + (n + 2) * sizeof(GwVectorEnt *));
+    vector->numregions = n + 2;
+
+    for (gint i = 0; i < vector->numregions; i++) {
+        vector->vectors[i] = g_malloc0(sizeof(GwVectorEnt));
+    }
+    for (gint i = 0; i < vector->numregions; i++) {
+        GwTime time;
+        if (i == 0) {
+            time = -2;
+        } else if (i == vector->numregions - 1) {
+            time = GW_TIME_MAX;
+        } else {
+            time = (i / 2) * 10; // pairs of entries at the same time
+        }
+        vector->vectors[i]->time = time;
+        vector->vectors[i]->next = i + 1 < vector->numregions ? vector->vectors[i + 1] : NULL;
+    }
+
+    GwEdgeIndex *index = gw_edge_index_new_for_vector(vector);
+
+    // Times 0 .. 5000 with a distance of 10.
+    g_assert_cmpuint(gw_edge_index_count(index, GW_EDGE_TYPE_ANY, 0, GW_TIME_MAX), ==, 501);
+    g_assert_cmpuint(gw_edge_index_count(index, GW_EDGE_TYPE_ANY, 1000, 1999), ==, 100);
+
+    for (GwTime time = -5; time < 5000; time += 7) {
+        GwTime t;
+        GwTime expected_next = time < 0 ? 0 : (time / 10 + 1) * 10;
+
+        g_assert_true(gw_edge_index_find_next(index, GW_EDGE_TYPE_ANY, time, &t));
+        g_assert_cmpint(t, ==, expected_next);
+
+        if (time > 0) {
+            g_assert_true(gw_edge_index_find_previous(index, GW_EDGE_TYPE_ANY, time, &t));
+            g_assert_cmpint(t, ==, ((time - 1) / 10) * 10);
+        } else {
+            g_assert_false(gw_edge_index_find_previous(index, GW_EDGE_TYPE_ANY, time, &t));
+        }
+    }
+
+    GwTime t;
+    g_assert_false(gw_edge_index_find_next(index, GW_EDGE_TYPE_ANY, 5000, &t));
+
+    gw_edge_index_free(index);
+
+    for (gint i = 0; i < vector->numregions; i++) {
+        g_free(vector->vectors[i]);
+    }
+    g_free(vector);
+}
+
+int main(int argc, char *argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/edge_index/node", test_node);
+    g_test_add_func("/edge_index/vector", test_vector);
+
+    return g_test_run();
+}
@@ -64,12 +64,85 @@ static void test_sort()
     g_assert_cmpstr(gw_facs_get(facs, 4)->name, ==, "c");
 }
 
+static void test_sort_large()
+{
+    // Enough facs to be sorted on multiple threads.
+    const guint n_scopes = 300;
+    const guint n_signals = 400;
+    guint n = n_scopes * n_signals;
+
+    GwSymbol *symbols = g_new0(GwSymbol, n);
+    for (guint i = 0; i < n; i++) {
+        symbols[i].name = g_strdup_printf("top.u%u.s%u", i / n_signals, i % n_signals);
+    }
+
+    GRand *rand = g_rand_new_with_seed(42);
+    GwFacs *facs = gw_facs_new(n);
+    for (guint i = 0; i < n; i++) {
+        gw_facs_set(facs, i, &symbols[i]);
+    }
+    for (guint i = n - 1; i > 0; i--) {
+        guint j = g_rand_int_range(rand, 0, i + 1);
+        GwSymbol *tmp = gw_facs_get(facs, i);
+        gw_facs_set(facs, i, gw_facs_get(facs, j));
+        gw_facs_set(facs, j, tmp);
+    }
+
+    gw_facs_sort(facs);
+
+    for (guint i = 0; i < n; i++) {
+        g_assert_true(gw_facs_get(facs, i) == &symbols[i]);
+    }
+
+    g_object_unref(facs);
+    g_rand_free(rand);
+    for (guint i = 0; i < n; i++) {
+        g_free(symbols[i].name);
+    }
+    g_free(symbols);
+}
+
+static void test_lookup_many()
+{
+    GwSymbol *symbols = g_new0(GwSymbol, 5);
+    symbols[0].name = "a";
+    symbols[1].name = "a.b";
+    symbols[2].name = "a.c";
+    symbols[3].name = "b";
+    symbols[4].name = "top.x";
+
+    GwFacs *facs = gw_facs_new(5);
+    for (gint i = 0; i < 5; i++) {
+        gw_facs_set(facs, i, &symbols[i]);
+    }
+    gw_facs_sort(facs);
+
+    const gchar *names[] = {"top.x", "missing", "a.c", "a", "a.c", "b", "0", "zzz"};
+    GwSymbol *results[G_N_ELEMENTS(names)];
+
+    gw_facs_lookup_many(facs, names, G_N_ELEMENTS(names), results);
+
+    for (guint i = 0; i < G_N_ELEMENTS(names); i++) {
+        g_assert_true(results[i] == gw_facs_lookup(facs, names[i]));
+    }
+    g_assert_true(results[0] == &symbols[4]);
+    g_assert_null(results[1]);
+    g_assert_true(results[2] == &symbols[2]);
+    g_assert_true(results[4] == &symbols[2]);
+    g_assert_null(results[7]);
+
+    g_object_unref(facs);
+    g_free(symbols);
+}
+
 int main(int argc, char *argv[])
 {
     g_test_init(&argc, &argv, NULL);
 
     g_test_add_func("/facs/order_from_tree", test_order_from_tree);
     g_test_add_func("/facs/sort", test_sort);
+    g_test_add_func("/facs/sort_large", test_sort_large);
+    g_test_add_func("/facs/lookup_many", test_lookup_many);
 
     return g_test_run();
 }
\ No newline at end of file
@@ -12,11 +12,89 @@ static void test_error_file_not_found()
     g_object_unref(loader);
 }
 
+static void test_lazy_import()
+{
+    GwLoader *loader = gw_ghw_loader_new();
+
+    GError *error = NULL;
+    GwDumpFile *file = gw_loader_load(loader, "files/basic.ghw", &error);
+    g_assert_no_error(error);
+    g_object_unref(loader);
+
+    GwSymbol *sig_bit = gw_dump_file_lookup_symbol(file, "top.ghw_test.sig_bit");
+    GwSymbol *sig_integer = gw_dump_file_lookup_symbol(file, "top.ghw_test.sig_integer");
+    g_assert_nonnull(sig_bit);
+    g_assert_nonnull(sig_integer);
+
+    // histories are only read on import
+    g_assert_nonnull(sig_bit->n->mv.mvlfac);
+    g_assert_null(sig_bit->n->head.next);
+
+    GwNode *nodes[] = {sig_bit->n, NULL};
+    g_assert_true(gw_dump_file_import_traces(file, nodes, &error));
+    g_assert_no_error(error);
+
+    g_assert_null(sig_bit->n->mv.mvlfac);
+    g_assert_nonnull(sig_integer->n->mv.mvlfac);
+    g_assert_null(sig_integer->n->head.next);
+
+    GwHistEnt *h = sig_bit->n->head.next;
+    g_assert_cmpint(h->time, ==, -1);
+    h = h->next;
+    g_assert_cmpint(h->time, ==, 1000000);
+    g_assert_cmpint(h->v.h_val, ==, GW_BIT_1);
+
+    guint count = 0;
+    for (h = &sig_bit->n->head; h != NULL; h = h->next) {
+        count++;
+    }
+    g_assert_cmpint(count, ==, 14);
+
+    // importing again is a no-op
+    g_assert_true(gw_dump_file_import_traces(file, nodes, NULL));
+    g_assert_true(gw_dump_file_import_all(file, NULL));
+    g_assert_null(sig_integer->n->mv.mvlfac);
+    g_assert_nonnull(sig_integer->n->head.next);
+
+    g_object_unref(file);
+}
+
+static void test_compressed(gconstpointer data)
+{
+    const gchar *filename = data;
+    GwLoader *loader = gw_ghw_loader_new();
+
+    GError *error = NULL;
+    GwDumpFile *file = gw_loader_load(loader, filename, &error);
+    g_assert_no_error(error);
+    g_object_unref(loader);
+
+    GwTimeRange *time_range = gw_dump_file_get_time_range(file);
+    g_assert_cmpint(gw_time_range_get_end(time_range), ==, 10000000);
+
+    // compressed files are imported lazily too, which requires seeking back
+    GwSymbol *sig_bit = gw_dump_file_lookup_symbol(file, "top.ghw_test.sig_bit");
+    g_assert_nonnull(sig_bit->n->mv.mvlfac);
+    g_assert_true(gw_dump_file_import_all(file, &error));
+    g_assert_no_error(error);
+
+    guint count = 0;
+    for (GwHistEnt *h = &sig_bit->n->head; h != NULL; h = h->next) {
+        count++;
+    }
+    g_assert_cmpint(count, ==, 14);
+
+    g_object_unref(file);
+}
+
 int main(int argc, char *argv[])
 {
     g_test_init(&argc, &argv, NULL);
 
     g_test_add_func("/ghw_loader/error_file_not_found", test_error_file_not_found);
+    g_test_add_func("/ghw_loader/lazy_import", test_lazy_import);
+    g_test_add_data_func("/ghw_loader/compressed/gzip", "files/basic.ghw.gz", test_compressed);
+    g_test_add_data_func("/ghw_loader/compressed/bzip2", "files/basic.ghw.bz2", test_compressed);
 
     return g_test_run();
 }
@@ -0,0 +1,141 @@
+#include <gtkwave.h>
+
+// LXT2 and VZT files are read by the same code in gw-lx2.c, so both loaders
+// run the same tests on files written from the same source.
+typedef struct
+{
+    GwLoader *(*loader_new)(void);
+    const gchar *missing_file;
+    const gchar *basic_file;
+} Lx2LoaderTest;
+
+static const Lx2LoaderTest lxt2_test = {
+    gw_lxt2_loader_new,
+    "files/does_not_exist.lxt2",
+    "files/basic.lxt2",
+};
+
+static const Lx2LoaderTest vzt_test = {
+    gw_vzt_loader_new,
+    "files/does_not_exist.vzt",
+    "files/basic.vzt",
+};
+
+static void test_error_file_not_found(gconstpointer data)
+{
+    const Lx2LoaderTest *test = data;
+    GwLoader *loader = test->loader_new();
+
+    GError *error = NULL;
+    GwDumpFile *file = gw_loader_load(loader, test->missing_file, &error);
+    g_assert_null(file);
+    g_assert_error(error, GW_DUMP_FILE_ERROR, GW_DUMP_FILE_ERROR_UNKNOWN);
+
+    g_object_unref(loader);
+}
+
+static void test_basic(gconstpointer data)
+{
+    const Lx2LoaderTest *test = data;
+    GwLoader *loader = test->loader_new();
+
+    GError *error = NULL;
+    GwDumpFile *file = gw_loader_load(loader, test->basic_file, &error);
+    g_assert_no_error(error);
+    g_object_unref(loader);
+
+    GwTimeRange *time_range = gw_dump_file_get_time_range(file);
+    g_assert_cmpint(gw_time_range_get_start(time_range), ==, 0);
+    g_assert_cmpint(gw_time_range_get_end(time_range), ==, 9);
+    g_assert_cmpint(gw_dump_file_get_time_dimension(file), ==, GW_TIME_DIMENSION_NANO);
+
+    g_assert_cmpint(gw_facs_get_length(gw_dump_file_get_facs(file)), ==, 12);
+    g_assert_nonnull(gw_dump_file_lookup_symbol(file, "variables.vector[7:0]"));
+    g_assert_nonnull(gw_dump_file_lookup_symbol(file, "aliases.vector_alias[7:0]"));
+
+    GwSymbol *real = gw_dump_file_lookup_symbol(file, "variables.real");
+    g_assert_nonnull(real);
+    g_assert_cmpint(real->n->vartype, ==, GW_VAR_TYPE_VCD_REAL);
+
+    g_object_unref(file);
+}
+
+static void test_lazy_import(gconstpointer data)
+{
+    const Lx2LoaderTest *test = data;
+    GwLoader *loader = test->loader_new();
+
+    GError *error = NULL;
+    GwDumpFile *file = gw_loader_load(loader, test->basic_file, &error);
+    g_assert_no_error(error);
+    g_object_unref(loader);
+
+    GwSymbol *bit = gw_dump_file_lookup_symbol(file, "variables.bit");
+    GwSymbol *bit_alias = gw_dump_file_lookup_symbol(file, "aliases.bit_alias");
+    GwSymbol *integer = gw_dump_file_lookup_symbol(file, "variables.integer");
+    g_assert_nonnull(bit);
+    g_assert_nonnull(bit_alias);
+    g_assert_nonnull(integer);
+
+    // histories are only read on import
+    g_assert_nonnull(bit->n->mv.mvlfac);
+    g_assert_null(bit->n->head.next);
+
+    // importing an alias imports the signal it refers to
+    GwNode *nodes[] = {bit_alias->n, NULL};
+    g_assert_true(gw_dump_file_import_traces(file, nodes, &error));
+    g_assert_no_error(error);
+
+    g_assert_null(bit_alias->n->mv.mvlfac);
+    g_assert_null(bit->n->mv.mvlfac);
+    g_assert_nonnull(integer->n->mv.mvlfac);
+
+    static const GwBit expected[] = {
+        GW_BIT_0,
+        GW_BIT_X,
+        GW_BIT_Z,
+        GW_BIT_1,
+        GW_BIT_H,
+        GW_BIT_U,
+        GW_BIT_W,
+        GW_BIT_L,
+        GW_BIT_DASH,
+    };
+
+    GwHistEnt *h = bit_alias->n->head.next;
+    g_assert_cmpint(h->time, ==, -1);
+    for (guint i = 0; i < G_N_ELEMENTS(expected); i++) {
+        h = h->next;
+        g_assert_cmpint(h->time, ==, i);
+        g_assert_cmpint(h->v.h_val, ==, expected[i]);
+    }
+    g_assert_cmpint(h->next->time, ==, GW_TIME_MAX - 1);
+    g_assert_cmpint(h->next->next->time, ==, GW_TIME_MAX);
+
+    g_assert_true(gw_dump_file_import_all(file, NULL));
+    g_assert_null(integer->n->mv.mvlfac);
+
+    h = integer->n->head.next->next;
+    g_assert_cmpint(h->time, ==, 0);
+    for (guint i = 0; i < 32; i++) {
+        g_assert_cmpint(h->v.h_vector[i], ==, GW_BIT_0);
+    }
+
+    g_object_unref(file);
+}
+
+int main(int argc, char *argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_data_func("/lxt2_loader/error_file_not_found",
+                         &lxt2_test,
+                         test_error_file_not_found);
+    g_test_add_data_func("/lxt2_loader/basic", &lxt2_test, test_basic);
+    g_test_add_data_func("/lxt2_loader/lazy_import", &lxt2_test, test_lazy_import);
+    g_test_add_data_func("/vzt_loader/error_file_not_found", &vzt_test, test_error_file_not_found);
+    g_test_add_data_func("/vzt_loader/basic", &vzt_test, test_basic);
+    g_test_add_data_func("/vzt_loader/lazy_import", &vzt_test, test_lazy_import);
+
+    return g_test_run();
+}
@@ -0,0 +1,180 @@
+#include <gtkwave.h>
+
+static gint64 get_counter(GwStatsCounter counter)
+{
+    GwStatsCounterValue value;
+    gw_stats_get_counter(counter, &value);
+
+    return value.value;
+}
+
+static void test_disabled(void)
+{
+    gw_stats_set_enabled(FALSE);
+    gw_stats_reset();
+
+    g_assert_false(gw_stats_is_enabled());
+    g_assert_cmpint(gw_stats_timer_begin(), ==, 0);
+
+    gw_stats_timer_end(GW_STATS_TIMER_LOAD, gw_stats_timer_begin());
+    gw_stats_counter_add(GW_STATS_COUNTER_STRINGS, 100);
+
+    GwStatsTimerValue timer;
+    gw_stats_get_timer(GW_STATS_TIMER_LOAD, &timer);
+    g_assert_cmpuint(timer.calls, ==, 0);
+    g_assert_cmpint(get_counter(GW_STATS_COUNTER_STRINGS), ==, 0);
+}
+
+static void test_timers(void)
+{
+    gw_stats_set_enabled(TRUE);
+    gw_stats_reset();
+
+    for (gint i = 0; i < 3; i++) {
+        gint64 begin = gw_stats_timer_begin();
+        g_assert_cmpint(begin, !=, 0);
+        g_usleep(1000);
+        gw_stats_timer_end(GW_STATS_TIMER_RENDER, begin);
+    }
+
+    GwStatsTimerValue timer;
+    gw_stats_get_timer(GW_STATS_TIMER_RENDER, &timer);
+    g_assert_cmpuint(timer.calls, ==, 3);
+    g_assert_cmpint(timer.last_ns, >=, 1000000);
+    g_assert_cmpint(timer.max_ns, >=, timer.last_ns);
+    g_assert_cmpint(timer.total_ns, >=, 3 * 1000000);
+
+    gw_stats_reset();
+
+    gw_stats_get_timer(GW_STATS_TIMER_RENDER, &timer);
+    g_assert_cmpuint(timer.calls, ==, 0);
+    g_assert_cmpint(timer.total_ns, ==, 0);
+
+    gw_stats_set_enabled(FALSE);
+}
+
+static void test_counters(void)
+{
+    gw_stats_set_enabled(TRUE);
+    gw_stats_reset();
+
+    gw_stats_counter_add(GW_STATS_COUNTER_SURFACES, 1000);
+    gw_stats_counter_add(GW_STATS_COUNTER_SURFACES, 500);
+    gw_stats_counter_add(GW_STATS_COUNTER_SURFACES, -1500);
+
+    GwStatsCounterValue value;
+    gw_stats_get_counter(GW_STATS_COUNTER_SURFACES, &value);
+    g_assert_cmpint(value.value, ==, 0);
+    g_assert_cmpint(value.peak, ==, 1500);
+
+    gw_stats_reset();
+
+    gw_stats_get_counter(GW_STATS_COUNTER_SURFACES, &value);
+    g_assert_cmpint(value.peak, ==, 0);
+
+    gw_stats_set_enabled(FALSE);
+}
+
+static void test_draw_cost(void)
+{
+    GwStatsDrawCost cost = {
+        .primitives = 1000,
+        .merged = 250,
+        .calls = 12,
+    };
+
+    gw_stats_set_enabled(FALSE);
+    gw_stats_reset();
+    gw_stats_set_draw_cost(&cost);
+
+    GwStatsDrawCost value;
+    gw_stats_get_draw_cost(&value);
+    g_assert_cmpuint(value.primitives, ==, 0);
+
+    gw_stats_set_enabled(TRUE);
+    gw_stats_set_draw_cost(&cost);
+
+    gw_stats_get_draw_cost(&value);
+    g_assert_cmpuint(value.primitives, ==, 1000);
+    g_assert_cmpuint(value.merged, ==, 250);
+    g_assert_cmpuint(value.calls, ==, 12);
+
+    gchar *report = gw_stats_to_string();
+    g_assert_nonnull(strstr(report, "last redraw"));
+    g_free(report);
+
+    gw_stats_reset();
+
+    gw_stats_get_draw_cost(&value);
+    g_assert_cmpuint(value.calls, ==, 0);
+
+    gw_stats_set_enabled(FALSE);
+}
+
+static void test_memory(void)
+{
+    gw_stats_set_enabled(TRUE);
+    gw_stats_reset();
+
+    // Compressed vlist blocks change size, which must be tracked.
+
+    GwVlist *vlist = gw_vlist_create(1);
+    for (gint i = 0; i < 10000; i++) {
+        char *t = gw_vlist_alloc(&vlist, TRUE, 9);
+        *t = i % 7;
+    }
+    gw_vlist_freeze(&vlist, 9);
+    g_assert_cmpint(get_counter(GW_STATS_COUNTER_VLISTS), >, 0);
+
+    gw_vlist_uncompress(&vlist);
+    gw_vlist_destroy(vlist);
+    g_assert_cmpint(get_counter(GW_STATS_COUNTER_VLISTS), ==, 0);
+
+    GwStringTable *strings = gw_string_table_new();
+    gw_string_table_add(strings, "abc");
+    gw_string_table_add(strings, "abc");
+    gw_string_table_add(strings, "de");
+    g_assert_cmpint(get_counter(GW_STATS_COUNTER_STRINGS), ==, 7);
+    g_object_unref(strings);
+    g_assert_cmpint(get_counter(GW_STATS_COUNTER_STRINGS), ==, 0);
+
+    GwHistEntFactory *factory = gw_hist_ent_factory_new();
+    gw_hist_ent_factory_alloc(factory);
+    g_assert_cmpint(get_counter(GW_STATS_COUNTER_HIST_ENTS), >, 0);
+    g_object_unref(factory);
+    g_assert_cmpint(get_counter(GW_STATS_COUNTER_HIST_ENTS), ==, 0);
+
+    GwStatsTimerValue timer;
+    gw_stats_get_timer(GW_STATS_TIMER_VLIST_COMPRESS, &timer);
+    g_assert_cmpuint(timer.calls, >, 0);
+
+    gw_stats_set_enabled(FALSE);
+}
+
+static void test_to_string(void)
+{
+    gchar *report = gw_stats_to_string();
+
+    for (gint i = 0; i < GW_STATS_N_TIMERS; i++) {
+        g_assert_nonnull(strstr(report, gw_stats_timer_get_name(i)));
+    }
+    for (gint i = 0; i < GW_STATS_N_COUNTERS; i++) {
+        g_assert_nonnull(strstr(report, gw_stats_counter_get_name(i)));
+    }
+
+    g_free(report);
+}
+
+int main(int argc, char *argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/stats/disabled", test_disabled);
+    g_test_add_func("/stats/timers", test_timers);
+    g_test_add_func("/stats/counters", test_counters);
+    g_test_add_func("/stats/draw_cost", test_draw_cost);
+    g_test_add_func("/stats/memory", test_memory);
+    g_test_add_func("/stats/to_string", test_to_string);
+
+    return g_test_run();
+}
@@ -0,0 +1,163 @@
+#include <gtkwave.h>
+
+static const gchar *NAMES[] = {
+    "top.clk",
+    "top.cpu.Clock_Enable",
+    "top.cpu.pc[31:0]",
+    "top.cpu.alu.result",
+    "top.mem.addr",
+    "top.mem.data",
+    "top.uart.tx",
+    "top.uart.tx_data",
+    "top.\xc3\xa9tat", // non-ASCII names are always candidates
+    "a",
+};
+
+static GwFacs *create_facs(void)
+{
+    guint n = G_N_ELEMENTS(NAMES);
+
+    GwSymbol *symbols = g_new0(GwSymbol, n);
+    GwFacs *facs = gw_facs_new(n);
+    for (guint i = 0; i < n; i++) {
+        symbols[i].name = (gchar *)NAMES[i];
+        gw_facs_set(facs, i, &symbols[i]);
+    }
+    g_object_set_data_full(G_OBJECT(facs), "symbols", symbols, g_free);
+
+    return facs;
+}
+
+static void assert_candidates(GwSymbolIndex *index, const gchar *pattern, const gchar *expected)
+{
+    GArray *candidates = gw_symbol_index_find_candidates(index, pattern);
+    g_assert_nonnull(candidates);
+
+    GString *str = g_string_new(NULL);
+    for (guint i = 0; i < candidates->len; i++) {
+        if (i > 0) {
+            g_string_append_c(str, ' ');
+        }
+        g_string_append_printf(str, "%u", g_array_index(candidates, guint, i));
+    }
+    g_assert_cmpstr(str->str, ==, expected);
+
+    g_string_free(str, TRUE);
+    g_array_free(candidates, TRUE);
+}
+
+static void test_candidates(void)
+{
+    GwFacs *facs = create_facs();
+    GwSymbolIndex *index = gw_symbol_index_new(facs);
+
+    assert_candidates(index, "clk", "0 8");
+    assert_candidates(index, "CLOCK", "1 8");
+    assert_candidates(index, "\\buart\\.tx", "6 7 8");
+    assert_candidates(index, "uart.*data", "7 8");
+    assert_candidates(index, "top\\.mem\\.", "4 5 8");
+    assert_candidates(index, "\\bresult(?:\\[.*\\])*$", "3 8");
+    assert_candidates(index, "\\bresult[3]*(?:\\[.*\\])*$", "3 8");
+    assert_candidates(index, "doesNotExist", "8");
+
+    // Quantifiers make the preceding character optional.
+    assert_candidates(index, "datx?", "5 7 8");
+    assert_candidates(index, "memx?\\.da", "5 8");
+    assert_candidates(index, "memx{0,1}\\.da", "5 8");
+    assert_candidates(index, "[a-z]{2}result", "3 8");
+
+    g_object_unref(index);
+    g_object_unref(facs);
+}
+
+static void test_no_prefilter(void)
+{
+    GwFacs *facs = create_facs();
+    GwSymbolIndex *index = gw_symbol_index_new(facs);
+
+    // Patterns without a literal of at least three characters or with
+    // constructs that aren't analyzed match against all facs.
+
+    const gchar *patterns[] = {
+        "",
+        "tx",
+        ".*",
+        "cl?k",
+        "clk|mem",
+        "(?i)clk",
+        "\\x41BC",
+        "\\Qclk\\E",
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS(patterns); i++) {
+        g_assert_null(gw_symbol_index_find_candidates(index, patterns[i]));
+    }
+
+    g_assert_cmpuint(gw_symbol_index_get_memory_size(index), >, 0);
+
+    g_object_unref(index);
+    g_object_unref(facs);
+}
+
+static void test_search(void)
+{
+    GwFacs *facs = create_facs();
+    GwSymbolIndex *index = gw_symbol_index_new(facs);
+
+    const gchar *patterns[] = {
+        "clk",
+        "\\bdata$",
+        "^top\\.(cpu|mem)\\.",
+        "[0-9]+:0",
+        "\xc3\x89tat",
+        "tx(_data)?$",
+        "a",
+    };
+
+    // The indexed search must return the same results as a full scan.
+
+    for (guint i = 0; i < G_N_ELEMENTS(patterns); i++) {
+        GPtrArray *expected = g_ptr_array_new();
+        GPtrArray *results = g_ptr_array_new();
+
+        GwSymbolSearch *search = gw_symbol_search_new(facs, NULL, patterns[i], NULL);
+        while (gw_symbol_search_step(search, 3, expected)) {
+        }
+        g_object_unref(search);
+
+        search = gw_symbol_search_new(facs, index, patterns[i], NULL);
+        g_assert_cmpuint(gw_symbol_search_get_candidate_count(search),
+                         <=,
+                         gw_facs_get_length(facs));
+        while (gw_symbol_search_step(search, 3, results)) {
+        }
+        g_object_unref(search);
+
+        g_assert_cmpuint(results->len, ==, expected->len);
+        for (guint j = 0; j < expected->len; j++) {
+            g_assert_true(g_ptr_array_index(results, j) == g_ptr_array_index(expected, j));
+        }
+
+        g_ptr_array_free(expected, TRUE);
+        g_ptr_array_free(results, TRUE);
+    }
+
+    GError *error = NULL;
+    g_assert_null(gw_symbol_search_new(facs, index, "(invalid", &error));
+    g_assert_nonnull(error);
+    g_error_free(error);
+
+    g_object_unref(index);
+    g_object_unref(facs);
+}
+
+int main(int argc, char *argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/symbol_index/candidates", test_candidates);
+    g_test_add_func("/symbol_index/no_prefilter", test_no_prefilter);
+    g_test_add_func("/symbol_index/search", test_search);
+
+    return g_test_run();
+}
@@ -25,12 +25,27 @@ static void test_time_scale_and_dimension_from_exponent(void)
     g_assert_cmpint(exponent, ==, -22);
 }
 
+static void test_time_scale_and_dimension_to_exponent(void)
+{
+    for (gint exponent = 2; exponent >= -21; exponent--) {
+        GwTimeScaleAndDimension *value = gw_time_scale_and_dimension_from_exponent(exponent);
+
+        g_assert_cmpint(gw_time_scale_and_dimension_to_exponent(value->scale, value->dimension),
+                        ==,
+                        exponent);
+
+        g_free(value);
+    }
+}
+
 int main(int argc, char *argv[])
 {
     g_test_init(&argc, &argv, NULL);
 
     g_test_add_func("/time/time_scale_and_dimension_from_exponent",
                     test_time_scale_and_dimension_from_exponent);
+    g_test_add_func("/time/time_scale_and_dimension_to_exponent",
+                    test_time_scale_and_dimension_to_exponent);
 
     return g_test_run();
 }
@@ -74,6 +74,68 @@ static void test_sort(void)
     g_object_unref(tree);
 }
 
+static void assert_siblings_sorted(GwTreeNode *node, guint expected_count)
+{
+    guint count = 0;
+    guint64 previous = G_MAXUINT64;
+
+    // Sibling lists are sorted in reverse order.
+    for (; node != NULL; node = node->next) {
+        guint64 number = g_ascii_strtoull(node->name + 1, NULL, 10);
+        g_assert_cmpuint(number, <, previous);
+        previous = number;
+        count++;
+
+        if (node->child != NULL) {
+            assert_siblings_sorted(node->child, expected_count);
+        }
+    }
+
+    g_assert_cmpuint(count, ==, expected_count);
+}
+
+static GwTreeNode *alloc_shuffled_siblings(GRand *rand, guint count, guint depth)
+{
+    GwTreeNode **nodes = g_new(GwTreeNode *, count);
+    for (guint i = 0; i < count; i++) {
+        gchar name[16];
+        g_snprintf(name, sizeof(name), "n%u", i);
+        nodes[i] = alloc_node(name);
+        if (depth > 1) {
+            nodes[i]->child = alloc_shuffled_siblings(rand, count, depth - 1);
+        }
+    }
+
+    for (guint i = count - 1; i > 0; i--) {
+        guint j = g_rand_int_range(rand, 0, i + 1);
+        GwTreeNode *tmp = nodes[i];
+        nodes[i] = nodes[j];
+        nodes[j] = tmp;
+    }
+    for (guint i = 0; i + 1 < count; i++) {
+        nodes[i]->next = nodes[i + 1];
+    }
+
+    GwTreeNode *first = nodes[0];
+    g_free(nodes);
+
+    return first;
+}
+
+static void test_sort_large(void)
+{
+    // Large trees are sorted on multiple threads, which must give the same
+    // result for every level.
+    GRand *rand = g_rand_new_with_seed(42);
+    GwTree *tree = gw_tree_new(alloc_shuffled_siblings(rand, 20, 4));
+
+    gw_tree_sort(tree);
+    assert_siblings_sorted(gw_tree_get_root(tree), 20);
+
+    g_object_unref(tree);
+    g_rand_free(rand);
+}
+
 static void test_graft(void)
 {
     GwTree *tree;
@@ -126,6 +188,7 @@ int main(int argc, char *argv[])
 
     g_test_add_func("/tree/to_string", test_to_string);
     g_test_add_func("/tree/sort", test_sort);
+    g_test_add_func("/tree/sort_large", test_sort_large);
     g_test_add_func("/tree/graft", test_graft);
 
     return g_test_run();
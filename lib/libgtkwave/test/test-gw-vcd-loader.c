@@ -1,4 +1,6 @@
 #include <gtkwave.h>
+#include <glib/gstdio.h>
+#include <unistd.h>
 
 static void test_error_common(const gchar *filename, GQuark error_domain, gint error_code)
 {
@@ -32,6 +34,154 @@ static void test_error_no_transitions()
     test_error_common("files/error_no_transitions.vcd", GW_DUMP_FILE_ERROR, GW_DUMP_FILE_ERROR_NO_TRANSITIONS);
 }
 
+static void on_progress(GwLoader *loader, guint64 current, guint64 total, gpointer user_data)
+{
+    (void)loader;
+
+    guint64 *last = user_data;
+    g_assert_cmpuint(current, <=, total);
+    g_assert_cmpuint(current, >=, last[0]);
+
+    last[0] = current;
+    last[1] = total;
+}
+
+static void test_progress()
+{
+    GwLoader *loader = gw_vcd_loader_new();
+
+    guint64 last[2] = {0, 0};
+    g_signal_connect(loader, "progress", G_CALLBACK(on_progress), last);
+
+    GError *error = NULL;
+    GwDumpFile *file = gw_loader_load(loader, "files/basic.vcd", &error);
+    g_assert_no_error(error);
+    g_assert_nonnull(file);
+
+    g_assert_cmpuint(last[1], >, 0);
+    g_assert_cmpuint(last[0], ==, last[1]);
+
+    g_object_unref(file);
+    g_object_unref(loader);
+}
+
+static void test_fst_output()
+{
+    gchar *fst_name = NULL;
+    gint fd = g_file_open_tmp("test-gw-vcd-loader-XXXXXX.fst", &fst_name, NULL);
+    g_assert_cmpint(fd, >=, 0);
+    close(fd);
+
+    GwLoader *vcd_loader = gw_vcd_loader_new();
+    gw_vcd_loader_set_fst_output(GW_VCD_LOADER(vcd_loader), fst_name);
+    g_assert_cmpstr(gw_vcd_loader_get_fst_output(GW_VCD_LOADER(vcd_loader)), ==, fst_name);
+
+    GError *error = NULL;
+    GwDumpFile *vcd_file = gw_loader_load(vcd_loader, "files/basic.vcd", &error);
+    g_assert_no_error(error);
+    g_object_unref(vcd_loader);
+
+    GwLoader *fst_loader = gw_fst_loader_new();
+    GwDumpFile *fst_file = gw_loader_load(fst_loader, fst_name, &error);
+    g_assert_no_error(error);
+    g_object_unref(fst_loader);
+
+    GwFacs *vcd_facs = gw_dump_file_get_facs(vcd_file);
+    GwFacs *fst_facs = gw_dump_file_get_facs(fst_file);
+    g_assert_cmpint(gw_facs_get_length(fst_facs), ==, gw_facs_get_length(vcd_facs));
+
+    GwTimeRange *vcd_range = gw_dump_file_get_time_range(vcd_file);
+    GwTimeRange *fst_range = gw_dump_file_get_time_range(fst_file);
+    g_assert_cmpint(gw_time_range_get_start(fst_range), ==, gw_time_range_get_start(vcd_range));
+    g_assert_cmpint(gw_time_range_get_end(fst_range), ==, gw_time_range_get_end(vcd_range));
+
+    g_object_unref(vcd_file);
+    g_object_unref(fst_file);
+
+    g_remove(fst_name);
+    g_free(fst_name);
+}
+
+static gchar *fst_output_vector_value(GwDumpFile *file, GwTime time)
+{
+    GError *error = NULL;
+    g_assert_true(gw_dump_file_import_all(file, &error));
+    g_assert_no_error(error);
+
+    GwSymbol *symbol = gw_dump_file_lookup_symbol(file, "top.v[3:0]");
+    g_assert_nonnull(symbol);
+
+    for (GwHistEnt *iter = &symbol->n->head; iter != NULL; iter = iter->next) {
+        if (iter->time == time) {
+            gchar *value = g_malloc0(5);
+            for (gint i = 0; i < 4; i++) {
+                value[i] = gw_bit_to_char(iter->v.h_vector[i]);
+            }
+            return value;
+        }
+    }
+
+    return NULL;
+}
+
+static void test_fst_output_long_vector()
+{
+    static const gchar *vcd = "$timescale 1ns $end\n"
+                              "$scope module top $end\n"
+                              "$var wire 4 ! v [3:0] $end\n"
+                              "$upscope $end\n"
+                              "$enddefinitions $end\n"
+                              "#0\n"
+                              "b110011 !\n"
+                              "#10\n"
+                              "b01 !\n";
+
+    gchar *vcd_name = NULL;
+    gint fd = g_file_open_tmp("test-gw-vcd-loader-XXXXXX.vcd", &vcd_name, NULL);
+    g_assert_cmpint(fd, >=, 0);
+    close(fd);
+    g_assert_true(g_file_set_contents(vcd_name, vcd, -1, NULL));
+
+    gchar *fst_name = NULL;
+    fd = g_file_open_tmp("test-gw-vcd-loader-XXXXXX.fst", &fst_name, NULL);
+    g_assert_cmpint(fd, >=, 0);
+    close(fd);
+
+    GwLoader *vcd_loader = gw_vcd_loader_new();
+    gw_vcd_loader_set_fst_output(GW_VCD_LOADER(vcd_loader), fst_name);
+
+    GError *error = NULL;
+    GwDumpFile *vcd_file = gw_loader_load(vcd_loader, vcd_name, &error);
+    g_assert_no_error(error);
+    g_object_unref(vcd_loader);
+
+    GwLoader *fst_loader = gw_fst_loader_new();
+    GwDumpFile *fst_file = gw_loader_load(fst_loader, fst_name, &error);
+    g_assert_no_error(error);
+    g_object_unref(fst_loader);
+
+    // the leading bits of an over-long value are dropped, short ones are left extended
+    gchar *value = fst_output_vector_value(vcd_file, 0);
+    g_assert_cmpstr(value, ==, "0011");
+    g_free(value);
+
+    value = fst_output_vector_value(fst_file, 0);
+    g_assert_cmpstr(value, ==, "0011");
+    g_free(value);
+
+    value = fst_output_vector_value(fst_file, 10);
+    g_assert_cmpstr(value, ==, "0001");
+    g_free(value);
+
+    g_object_unref(vcd_file);
+    g_object_unref(fst_file);
+
+    g_remove(vcd_name);
+    g_remove(fst_name);
+    g_free(vcd_name);
+    g_free(fst_name);
+}
+
 int main(int argc, char *argv[])
 {
     g_test_init(&argc, &argv, NULL);
@@ -40,6 +190,9 @@ int main(int argc, char *argv[])
     g_test_add_func("/vcd_loader/error_empty", test_error_empty);
     g_test_add_func("/vcd_loader/error_no_symbols", test_error_no_symbols);
     g_test_add_func("/vcd_loader/error_no_transitions", test_error_no_transitions);
+    g_test_add_func("/vcd_loader/progress", test_progress);
+    g_test_add_func("/vcd_loader/fst_output", test_fst_output);
+    g_test_add_func("/vcd_loader/fst_output_long_vector", test_fst_output_long_vector);
 
     return g_test_run();
 }
@@ -25,6 +25,7 @@
 #include "ptranslate.h"
 #include "ttranslate.h"
 #include "analyzer.h"
+#include "wavewindow.h"
 #include <gtkwave.h>
 
 void UpdateTraceSelection(GwTrace *t);
@@ -590,6 +591,8 @@ void FreeTrace(GwTrace *t)
         return;
     }
 
+    ttrans_forget_trace(t);
+
     if (t->vector) {
         GwBitVector *bv;
         GwBitVector *bv2;
@@ -610,6 +613,10 @@ void FreeTrace(GwTrace *t)
                     free_2(bv->vectors[i]);
                 }
 
+                if (bv->edge_index) {
+                    gw_edge_index_free(bv->edge_index);
+                }
+
                 free_2(bv);
                 bv = bv2;
             }
@@ -636,6 +643,8 @@ void FreeTrace(GwTrace *t)
 
         if (bv->bvname)
             free_2(bv->bvname);
+        if (bv->edge_index)
+            gw_edge_index_free(bv->edge_index);
         if (t->n.vec)
             free_2(t->n.vec);
     } else {
@@ -644,6 +653,9 @@ void FreeTrace(GwTrace *t)
         }
     }
 
+    if (t->analog_envelope)
+        gw_analog_envelope_free(t->analog_envelope);
+    forget_trace_name(t);
     if (t->asciivalue)
         free_2(t->asciivalue);
     if (t->name_full)
@@ -660,6 +672,7 @@ void FreeTrace(GwTrace *t)
 void RemoveTrace(GwTrace *t, int dofree)
 {
     GLOBALS->traces.dirty = 1;
+    forget_trace_name(t);
     GLOBALS->traces.total--;
     if (t == GLOBALS->traces.first) {
         GLOBALS->traces.first = t->t_next;
@@ -49,12 +49,15 @@ static char *lzremoval(char *s)
  */
 static char *dofilter(GwTrace *t, char *s)
 {
-    GLOBALS->xl_file_filter[t->f_filter] = xl_splay(s, GLOBALS->xl_file_filter[t->f_filter]);
+    gint64 stats_begin = gw_stats_timer_begin();
 
-    if (!strcasecmp(s, GLOBALS->xl_file_filter[t->f_filter]->item)) {
+    GHashTable *filter = GLOBALS->xl_file_filter[t->f_filter];
+    const char *xlt = filter ? g_hash_table_lookup(filter, s) : NULL;
+
+    if (xlt) {
         free_2(s);
-        s = malloc_2(strlen(GLOBALS->xl_file_filter[t->f_filter]->trans) + 1);
-        strcpy(s, GLOBALS->xl_file_filter[t->f_filter]->trans);
+        s = malloc_2(strlen(xlt) + 1);
+        strcpy(s, xlt);
     }
 
     if ((*s == '?') && (!GLOBALS->color_active_in_filter)) {
@@ -69,6 +72,8 @@ static char *dofilter(GwTrace *t, char *s)
         }
     }
 
+    gw_stats_timer_end(GW_STATS_TIMER_FILTER, stats_begin);
+
     return (s);
 }
 
@@ -78,6 +83,8 @@ static char *edofilter(GwTrace *t, char *s)
         return s;
     }
 
+    gint64 stats_begin = gw_stats_timer_begin();
+
     GwEnumFilterList *filters = gw_dump_file_get_enum_filters(GLOBALS->dump_file);
     GwEnumFilter *filter = gw_enum_filter_list_get(filters, t->e_filter - 1);
 
@@ -100,59 +107,23 @@ static char *edofilter(GwTrace *t, char *s)
         }
     }
 
+    gw_stats_timer_end(GW_STATS_TIMER_FILTER, stats_begin);
+
     return (s);
 }
 
 static char *pdofilter(GwTrace *t, char *s)
 {
+    gint64 stats_begin = gw_stats_timer_begin();
+
     struct pipe_ctx *p = GLOBALS->proc_filter[t->p_filter];
-    char buf[1025];
-    int n;
 
     if (p) {
-#if !defined __MINGW32__
-        fputs(s, p->sout);
-        fputc('\n', p->sout);
-        fflush(p->sout);
-
-        buf[0] = 0;
-
-        n = fgets(buf, 1024, p->sin) ? strlen(buf) : 0;
-        buf[n] = 0;
-#else
-        {
-            BOOL bSuccess;
-            DWORD dwWritten, dwRead;
-
-            WriteFile(p->g_hChildStd_IN_Wr, s, strlen(s), &dwWritten, NULL);
-            WriteFile(p->g_hChildStd_IN_Wr, "\n", 1, &dwWritten, NULL);
-
-            for (n = 0; n < 1024; n++) {
-                do {
-                    bSuccess = ReadFile(p->g_hChildStd_OUT_Rd, buf + n, 1, &dwRead, NULL);
-                    if ((!bSuccess) || (buf[n] == '\n')) {
-                        goto ex;
-                    }
-
-                } while (buf[n] == '\r');
-            }
-        ex:
-            buf[n] = 0;
-        }
-
-#endif
+        char *reply = pipeio_translate(p, s, proc_filter_batch_active());
 
-        if (n) {
-            if (buf[n - 1] == '\n') {
-                buf[n - 1] = 0;
-                n--;
-            }
-        }
-
-        if (buf[0]) {
+        if (reply) {
             free_2(s);
-            s = malloc_2(n + 1);
-            strcpy(s, buf);
+            s = reply;
         }
     }
 
@@ -167,6 +138,9 @@ static char *pdofilter(GwTrace *t, char *s)
             s = s2a;
         }
     }
+
+    gw_stats_timer_end(GW_STATS_TIMER_FILTER, stats_begin);
+
     return (s);
 }
 
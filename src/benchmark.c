@@ -0,0 +1,222 @@
+#include <config.h>
+#include <gtk/gtk.h>
+#include "globals.h"
+#include "analyzer.h"
+#include "baseconvert.h"
+#include "benchmark.h"
+#include "bench-util.h"
+#include "gw-wave-view.h"
+#include "gw-wave-view-traces.h"
+#include "lx2.h"
+#include "symbol.h"
+#include "zoombuttons.h"
+
+/*
+ * Benchmarks for the code paths that depend on the GUI state, enabled with
+ * --benchmark. The results are printed as JSON lines by bench_report() of the
+ * libgtkwave benchmarks.
+ */
+
+#define BENCHMARK_MAX_TRACES 256
+#define BENCHMARK_MAX_BITS 4096
+#define BENCHMARK_BITS_PER_VECTOR 32
+#define BENCHMARK_ITERATIONS 3
+#define BENCHMARK_RENDER_FRAMES 50
+
+static void benchmark_report(const gchar *name,
+                             guint iterations,
+                             gdouble seconds,
+                             gdouble seconds_min,
+                             guint64 items)
+{
+    gchar *file = g_path_get_basename(GLOBALS->loaded_file_name);
+    BenchResult result = {
+        .name = name,
+        .file = file,
+        .iterations = iterations,
+        .seconds = seconds / iterations,
+        .seconds_min = seconds_min,
+        .items = items,
+    };
+
+    bench_report(&result);
+
+    g_free(file);
+}
+
+static void benchmark_add_traces(void)
+{
+    GwFacs *facs = gw_dump_file_get_facs(GLOBALS->dump_file);
+    guint count = MIN(gw_facs_get_length(facs), BENCHMARK_MAX_TRACES);
+
+    for (guint i = 0; i < count; i++) {
+        GwSymbol *s = gw_facs_get(facs, i);
+        if (s->n->mv.mvlfac != NULL) {
+            lx2_set_fac_process_mask(s->n);
+        }
+    }
+    lx2_import_masked();
+
+    for (guint i = 0; i < count; i++) {
+        AddNode(gw_facs_get(facs, i)->n, NULL);
+    }
+}
+
+static void benchmark_bits2vector(void)
+{
+    GwFacs *facs = gw_dump_file_get_facs(GLOBALS->dump_file);
+    GPtrArray *nodes = g_ptr_array_new();
+
+    for (guint i = 0; i < gw_facs_get_length(facs) && nodes->len < BENCHMARK_MAX_BITS; i++) {
+        GwNode *n = gw_facs_get(facs, i)->n;
+        if (!n->extvals) {
+            g_ptr_array_add(nodes, n);
+            if (n->mv.mvlfac != NULL) {
+                lx2_set_fac_process_mask(n);
+            }
+        }
+    }
+    lx2_import_masked();
+
+    if (nodes->len < BENCHMARK_BITS_PER_VECTOR) {
+        g_ptr_array_free(nodes, TRUE);
+        return;
+    }
+
+    /* the vectors are kept until exit, so this is only run once */
+    guint64 items = 0;
+    GTimer *timer = g_timer_new();
+
+    for (guint i = 0; i + BENCHMARK_BITS_PER_VECTOR <= nodes->len;
+         i += BENCHMARK_BITS_PER_VECTOR) {
+        GwBits *b =
+            calloc_2(1, sizeof(GwBits) + BENCHMARK_BITS_PER_VECTOR * sizeof(GwNode *));
+        b->name = strdup_2("benchmark");
+        b->nnbits = BENCHMARK_BITS_PER_VECTOR;
+        for (gint j = 0; j < BENCHMARK_BITS_PER_VECTOR; j++) {
+            b->nodes[j] = g_ptr_array_index(nodes, i + j);
+        }
+
+        GwBitVector *v = bits2vector(b);
+        if (v != NULL) {
+            v->bits = b;
+            items += v->numregions;
+        }
+    }
+
+    gdouble seconds = g_timer_elapsed(timer, NULL);
+    benchmark_report("bits2vector", 1, seconds, seconds, items);
+
+    g_timer_destroy(timer);
+    g_ptr_array_free(nodes, TRUE);
+}
+
+static void benchmark_convert_ascii_vec(void)
+{
+    guint64 items = 0;
+    gdouble seconds = 0.0;
+    gdouble seconds_min = G_MAXDOUBLE;
+    GTimer *timer = g_timer_new();
+
+    for (gint i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        items = 0;
+        g_timer_start(timer);
+
+        for (GwTrace *t = GLOBALS->traces.first; t != NULL; t = t->t_next) {
+            if (t->vector || !t->n.nd->extvals) {
+                continue;
+            }
+
+            for (GwHistEnt *h = t->n.nd->head.next; h != NULL; h = h->next) {
+                if (h->flags & (GW_HIST_ENT_FLAG_REAL | GW_HIST_ENT_FLAG_STRING)) {
+                    continue;
+                }
+                if (h->time >= 0 && h->time < GW_TIME_MAX - 1 && h->v.h_vector != NULL) {
+                    free_2(convert_ascii_vec(t, h->v.h_vector));
+                    items++;
+                }
+            }
+        }
+
+        gdouble elapsed = g_timer_elapsed(timer, NULL);
+        seconds += elapsed;
+        seconds_min = MIN(seconds_min, elapsed);
+    }
+
+    if (items > 0) {
+        benchmark_report("convert_ascii_vec", BENCHMARK_ITERATIONS, seconds, seconds_min, items);
+    }
+
+    g_timer_destroy(timer);
+}
+
+void benchmark_traces(void)
+{
+    if (GLOBALS->traces.total == 0) {
+        benchmark_add_traces();
+    }
+
+    benchmark_bits2vector();
+    benchmark_convert_ascii_vec();
+}
+
+static gboolean benchmark_render_timeout(gpointer user_data)
+{
+    (void)user_data;
+
+    GtkWidget *widget = GLOBALS->wavearea;
+    GtkAllocation allocation;
+    gtk_widget_get_allocation(widget, &allocation);
+
+    /* wait until the wave view has been laid out */
+    if (!gtk_widget_get_realized(widget) || allocation.width <= 1 || allocation.height <= 1) {
+        return G_SOURCE_CONTINUE;
+    }
+
+    service_zoom_fit(NULL, NULL);
+    GLOBALS->tims.end = GLOBALS->tims.start + GLOBALS->nspx * GLOBALS->wavewidth;
+
+    cairo_surface_t *surface =
+        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, allocation.width, allocation.height);
+    gdouble seconds = 0.0;
+    gdouble seconds_min = G_MAXDOUBLE;
+    GTimer *timer = g_timer_new();
+
+    for (gint i = 0; i < BENCHMARK_RENDER_FRAMES; i++) {
+        cairo_t *cr = cairo_create(surface);
+
+        g_timer_start(timer);
+
+        cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+        cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.0);
+        cairo_paint(cr);
+        cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+        cairo_set_line_width(cr, GLOBALS->cr_line_width);
+        cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+
+        gw_wave_view_render_traces(GW_WAVE_VIEW(widget), cr);
+        cairo_surface_flush(surface);
+
+        gdouble elapsed = g_timer_elapsed(timer, NULL);
+        seconds += elapsed;
+        seconds_min = MIN(seconds_min, elapsed);
+
+        cairo_destroy(cr);
+    }
+
+    benchmark_report("gw_wave_view_render_traces",
+                     BENCHMARK_RENDER_FRAMES,
+                     seconds,
+                     seconds_min,
+                     1);
+
+    g_timer_destroy(timer);
+    cairo_surface_destroy(surface);
+
+    exit(0);
+}
+
+void benchmark_render(void)
+{
+    g_timeout_add(100, benchmark_render_timeout, NULL);
+}
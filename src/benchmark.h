@@ -0,0 +1,10 @@
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+void benchmark_traces(void);
+void benchmark_render(void);
+
+G_END_DECLS
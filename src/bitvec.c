@@ -26,6 +26,7 @@
 #include "main.h"
 #include "menu.h"
 #include "busy.h"
+#include "savefile.h"
 #include <stdlib.h>
 
 /*
@@ -457,7 +458,7 @@ int maketraces(char *str, char *alias, int quick_return)
                 }
             }
 
-            s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, str + i);
+            s = savefile_lookup_symbol(str + i);
             if (s) {
                 nexp = ExtractNodeSingleBit(s->n, atoi(str + 1));
                 if (nexp) {
@@ -468,7 +469,7 @@ int maketraces(char *str, char *alias, int quick_return)
 
             return (0);
         } else {
-            if ((s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, str))) {
+            if ((s = savefile_lookup_symbol(str))) {
                 AddNode(s->n, alias);
                 return (~0);
             } else {
@@ -481,7 +482,7 @@ int maketraces(char *str, char *alias, int quick_return)
                 str2[l + 1] = '0';
                 str2[l + 2] = ']';
                 str2[l + 3] = 0;
-                if ((s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, str2))) {
+                if ((s = savefile_lookup_symbol(str2))) {
                     AddNode(s->n, alias);
                     return (~0);
                 } else
@@ -582,7 +583,7 @@ GwBits *makevec(char *vec, char *str)
                             break;
                         if ((wild[i] == ')') && (wild[i + 1])) {
                             i++;
-                            s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, wild + i);
+                            s = savefile_lookup_symbol(wild + i);
                             if (s) {
                                 nexp = ExtractNodeSingleBit(s->n, atoi(wild + 1));
                                 if (nexp) {
@@ -617,7 +618,7 @@ GwBits *makevec(char *vec, char *str)
                                     sprintf(ns, "%s[%d]", wild + i, actual);
                                     *lp = '[';
 
-                                    s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, ns);
+                                    s = savefile_lookup_symbol(ns);
                                     if (s) {
                                         nexp = s->n;
                                         if (nexp) {
@@ -636,7 +637,7 @@ GwBits *makevec(char *vec, char *str)
                         }
                     }
                 } else {
-                    if ((s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, wild))) {
+                    if ((s = savefile_lookup_symbol(wild))) {
                         n[nodepnt++] = s->n;
                         if (nodepnt == BITATTRIBUTES_MAX) {
                             free_2(wild);
@@ -755,7 +756,7 @@ GwBits *makevec_annotated(char *vec, char *str)
                             break;
                         if ((wild[i] == ')') && (wild[i + 1])) {
                             i++;
-                            s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, wild + i);
+                            s = savefile_lookup_symbol(wild + i);
                             if (s) {
                                 nexp = ExtractNodeSingleBit(s->n, atoi(wild + 1));
                                 if (nexp) {
@@ -790,7 +791,7 @@ GwBits *makevec_annotated(char *vec, char *str)
                                     sprintf(ns, "%s[%d]", wild + i, actual);
                                     *lp = '[';
 
-                                    s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, ns);
+                                    s = savefile_lookup_symbol(ns);
                                     if (s) {
                                         nexp = s->n;
                                         if (nexp) {
@@ -810,7 +811,7 @@ GwBits *makevec_annotated(char *vec, char *str)
                         }
                     }
                 } else {
-                    if ((s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, wild))) {
+                    if ((s = savefile_lookup_symbol(wild))) {
                         n[nodepnt++] = s->n;
                     }
                 }
@@ -1667,6 +1668,9 @@ void DeleteNode(GwNode *n)
                 free_2(n->harray[i]);
             }
             free_2(n->harray);
+            if (n->edge_index) {
+                gw_edge_index_free(n->edge_index);
+            }
             free_2(n->expansion);
             free_2(n->nname);
             free_2(n);
@@ -4,6 +4,8 @@
 #include "gw-vcd-loader.h"
 #include "gw-ghw-loader.h"
 #include "gw-fst-loader.h"
+#include "gw-lxt2-loader.h"
+#include "gw-vzt-loader.h"
 #include "lx2.h"
 
 static void set_common_settings(GwLoader *loader)
@@ -37,6 +39,19 @@ static GwDumpFile *load(GwLoader *loader, const gchar *fname)
     return file;
 }
 
+static void vcd_optimize_progress(GwLoader *loader, guint64 current, guint64 total, gpointer data)
+{
+    (void)loader;
+    (void)data;
+
+    if (total > 0) {
+        fprintf(stderr, "\rGTKWAVE | Converting to FST: %3d%%", (int)(current * 100 / total));
+        if (current >= total) {
+            fprintf(stderr, "\n");
+        }
+    }
+}
+
 // TODO: remove
 GwDumpFile *vcd_recoder_main(char *fname)
 {
@@ -59,6 +74,22 @@ GwDumpFile *vcd_recoder_main(char *fname)
     return file;
 }
 
+// Writes fst_name while fname is parsed. The parsed dump is dropped right away, the caller
+// browses the FST file instead.
+void vcd_optimize_main(char *fname, const char *fst_name)
+{
+    GwLoader *loader = gw_vcd_loader_new();
+    set_common_settings(loader);
+    gw_vcd_loader_set_vlist_prepack(GW_VCD_LOADER(loader), TRUE);
+    gw_vcd_loader_set_fst_output(GW_VCD_LOADER(loader), fst_name);
+    g_signal_connect(loader, "progress", G_CALLBACK(vcd_optimize_progress), NULL);
+
+    GwDumpFile *file = load(loader, fname);
+
+    g_object_unref(file);
+    g_object_unref(loader);
+}
+
 // TODO: remove
 GwDumpFile *ghw_main(char *fname)
 {
@@ -69,6 +100,8 @@ GwDumpFile *ghw_main(char *fname)
 
     g_object_unref(loader);
 
+    GLOBALS->is_lx2 = LXT2_IS_GHW;
+
     return file;
 }
 
@@ -89,3 +122,33 @@ GwDumpFile *fst_main(char *fname, char *skip_start, char *skip_end)
 
     return file;
 }
+
+// TODO: remove
+GwDumpFile *lxt2_main(char *fname)
+{
+    GwLoader *loader = gw_lxt2_loader_new();
+    set_common_settings(loader);
+
+    GwDumpFile *file = load(loader, fname);
+
+    g_object_unref(loader);
+
+    GLOBALS->is_lx2 = LXT2_IS_LXT2;
+
+    return file;
+}
+
+// TODO: remove
+GwDumpFile *vzt_main(char *fname)
+{
+    GwLoader *loader = gw_vzt_loader_new();
+    set_common_settings(loader);
+
+    GwDumpFile *file = load(loader, fname);
+
+    g_object_unref(loader);
+
+    GLOBALS->is_lx2 = LXT2_IS_VZT;
+
+    return file;
+}
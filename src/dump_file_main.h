@@ -1,5 +1,8 @@
 #pragma once
 
 GwDumpFile *vcd_recoder_main(char *fname);
+void vcd_optimize_main(char *fname, const char *fst_name);
 GwDumpFile *ghw_main(char *fname);
-GwDumpFile *fst_main(char *fname, char *skip_start, char *skip_end);
\ No newline at end of file
+GwDumpFile *fst_main(char *fname, char *skip_start, char *skip_end);
+GwDumpFile *lxt2_main(char *fname);
+GwDumpFile *vzt_main(char *fname);
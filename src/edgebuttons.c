@@ -50,430 +50,206 @@ static GwTrace *find_next_highlighted_trace(GwTrace *t)
 /************************************************/
 
 /*
- * strace backward or forward..this was cut and
- * pasted from strace.c and special cased to handle
- * just a single trace.  this might be relaxed later.
+ * edge searches walk the per trace edge indices, the highlighted
+ * traces are merged with a heap ordered by the pending edge time
  */
-static void edge_search_2(int direction, int is_last_iteration)
+struct edge_cursor
 {
-    struct strace s_tmp;
-    struct strace *s_head, *s;
-    GwTime basetime, maxbase, sttim, fintim;
-    GwTrace *t = find_first_highlighted_trace();
-    int totaltraces;
-#ifdef DEBUG_PRINTF
-    int passcount;
-#endif
-    int whichpass;
-    GwTime middle = 0, width;
+    GwEdgeIndex *index;
+    GwTime shift;
+    GwTime time; /* shifted time of the pending edge */
+};
 
-    if (!t)
-        return;
-    memset(s_head = &s_tmp, 0, sizeof(struct strace));
-    s_head->trace = t;
-    s_head->value = ST_ANY;
-    s = s_head;
-
-    while (t) {
-        t = find_next_highlighted_trace(t);
-        if (t) {
-            s->next = g_alloca(sizeof(struct strace));
-            memset(s = s->next, 0, sizeof(struct strace));
-            s->trace = t;
-            s->value = ST_ANY;
+struct edge_heap
+{
+    struct edge_cursor *cursors;
+    int count;
+    int direction;
+};
+
+static GwEdgeIndex *get_edge_index(GwTrace *t)
+{
+    if (t->vector) {
+        if (!t->n.vec->edge_index) {
+            t->n.vec->edge_index = gw_edge_index_new_for_vector(t->n.vec);
         }
+        return t->n.vec->edge_index;
+    } else {
+        if (!t->n.nd->edge_index) {
+            t->n.nd->edge_index = gw_edge_index_new_for_node(t->n.nd);
+        }
+        return t->n.nd->edge_index;
     }
+}
 
-    GwMarker *primary_marker = gw_project_get_primary_marker(GLOBALS->project);
+static gboolean edge_cursor_seek(struct edge_cursor *c, int direction, GwTime time)
+{
+    GwTime edge;
+    gboolean found;
 
-    if (gw_marker_is_enabled(primary_marker)) {
-        basetime = gw_marker_get_position(primary_marker);
+    if (direction == STRACE_BACKWARD) {
+        found = gw_edge_index_find_previous(c->index, GW_EDGE_TYPE_ANY, time - c->shift, &edge);
     } else {
-        if (direction == STRACE_BACKWARD) {
-            basetime = MAX_HISTENT_TIME; // backwards
-        } else {
-            basetime = GLOBALS->tims.first; // go forwards
-        }
+        found = gw_edge_index_find_next(c->index, GW_EDGE_TYPE_ANY, time - c->shift, &edge);
     }
 
-    sttim = GLOBALS->tims.first;
-    fintim = GLOBALS->tims.last;
-
-    for (whichpass = 0;; whichpass++) {
-        if (direction == STRACE_BACKWARD) /* backwards */
-        {
-            maxbase = -1;
-            s = s_head;
-            while (s) {
-                t = s->trace;
-                GLOBALS->shift_timebase = t->shift;
-                if (!(t->vector)) {
-                    GwHistEnt *h;
-                    GwHistEnt **hp;
-                    GwUTime utt;
-                    GwTime tt;
-
-                    /* h= */ bsearch_node(t->n.nd, basetime - t->shift); /* scan-build */
-                    hp = GLOBALS->max_compare_index;
-                    if ((hp == &(t->n.nd->harray[1])) || (hp == &(t->n.nd->harray[0])))
-                        return;
-                    if (basetime == ((*hp)->time + GLOBALS->shift_timebase))
-                        hp--;
-                    h = *hp;
-                    s->his.h = h;
-                    utt = strace_adjust(h->time, GLOBALS->shift_timebase);
-                    tt = utt;
-                    if (tt > maxbase)
-                        maxbase = tt;
-                } else {
-                    GwVectorEnt *v;
-                    GwVectorEnt **vp;
-                    GwUTime utt;
-                    GwTime tt;
-
-                    /* v= */ bsearch_vector(t->n.vec, basetime - t->shift); /* scan-build */
-                    vp = GLOBALS->vmax_compare_index;
-                    if ((vp == &(t->n.vec->vectors[1])) || (vp == &(t->n.vec->vectors[0])))
-                        return;
-                    if (basetime == ((*vp)->time + GLOBALS->shift_timebase))
-                        vp--;
-                    v = *vp;
-                    s->his.v = v;
-                    utt = strace_adjust(v->time, GLOBALS->shift_timebase);
-                    tt = utt;
-                    if (tt > maxbase)
-                        maxbase = tt;
-                }
-
-                s = s->next;
-            }
-        } else /* go forward */
-        {
-            maxbase = MAX_HISTENT_TIME;
-            s = s_head;
-            while (s) {
-                t = s->trace;
-                GLOBALS->shift_timebase = t->shift;
-                if (!(t->vector)) {
-                    GwHistEnt *h;
-                    GwUTime utt;
-                    GwTime tt;
-
-                    h = bsearch_node(t->n.nd, basetime - t->shift);
-                    while (h->next && h->time == h->next->time)
-                        h = h->next;
-                    if ((whichpass) || gw_marker_is_enabled(primary_marker))
-                        h = h->next;
-                    if (!h)
-                        return;
-                    s->his.h = h;
-                    utt = strace_adjust(h->time, GLOBALS->shift_timebase);
-                    tt = utt;
-                    if (tt < maxbase)
-                        maxbase = tt;
-                } else {
-                    GwVectorEnt *v;
-                    GwUTime utt;
-                    GwTime tt;
-
-                    v = bsearch_vector(t->n.vec, basetime - t->shift);
-                    while (v->next && v->time == v->next->time)
-                        v = v->next;
-                    if ((whichpass) || gw_marker_is_enabled(primary_marker))
-                        v = v->next;
-                    if (!v)
-                        return;
-                    s->his.v = v;
-                    utt = strace_adjust(v->time, GLOBALS->shift_timebase);
-                    tt = utt;
-                    if (tt < maxbase)
-                        maxbase = tt;
-                }
-
-                s = s->next;
-            }
-        }
+    if (found) {
+        c->time = strace_adjust(edge, c->shift);
+    }
 
-        s = s_head;
-        totaltraces = 0; /* increment when not don't care */
-        while (s) {
-/* commented out, maybe will have possible future expansion later,
- * this was cut and pasted from strace.c */
-#if 0
-	char str[2];
-#endif
-            t = s->trace;
-            s->search_result = 0; /* explicitly must set this */
-            GLOBALS->shift_timebase = t->shift;
-
-            if ((!t->vector) && (!(t->n.nd->extvals))) {
-                if (strace_adjust(s->his.h->time, GLOBALS->shift_timebase) != maxbase) {
-                    s->his.h = bsearch_node(t->n.nd, maxbase - t->shift);
-                    while (s->his.h->next && s->his.h->time == s->his.h->next->time)
-                        s->his.h = s->his.h->next;
-                }
-/* commented out, maybe will have possible future expansion later,
- * this was cut and pasted from strace.c */
-#if 0
-		if(t->flags&TR_INVERT)
-                	{
-                        str[0]=AN_STR_INV[s->his.h->v.h_val];
-                        }
-                        else
-                        {
-                        str[0]=AN_STR[s->his.h->v.h_val];
-                        }
-		str[1]=0x00;
-#endif
-
-                switch (s->value) {
-                    case ST_ANY:
-                        totaltraces++;
-                        s->search_result = 1;
-                        break;
-
-/* commented out, maybe will have possible future expansion later,
- * this was cut and pasted from strace.c */
-#if 0
-			case ST_DC:
-				break;
-
-			case ST_HIGH:
-				totaltraces++;
-				if((str[0]=='1')||(str[0]=='H')) s->search_result=1;
-				break;
-
-			case ST_RISE:
-				if((str[0]=='1')||(str[0]=='H')) s->search_result=1;
-				totaltraces++;
-				break;
-
-			case ST_LOW:
-				totaltraces++;
-				if((str[0]=='0')||(str[0]=='L')) s->search_result=1;
-				break;
-
-			case ST_FALL:
-				totaltraces++;
-				if((str[0]=='0')||(str[0]=='L')) s->search_result=1;
-				break;
-
-			case ST_MID:
-				totaltraces++;
-				if(str[0]=='Z')
- 					s->search_result=1;
-				break;
-
-			case ST_X:
-				totaltraces++;
-				if(str[0]=='X') s->search_result=1;
-				break;
-
-			case ST_STRING:
-				totaltraces++;
-				if(s->string)
-				if(strstr_i(s->string,str)) s->search_result=1;
-				break;
-#endif
-
-                    default:
-                        fprintf(stderr, "Internal error: st_type of %d\n", s->value);
-                        exit(255);
-                }
+    return found;
+}
 
-            } else {
-                char *chval, *chval2;
-                char ch;
-
-                if (t->vector) {
-                    if (strace_adjust(s->his.v->time, GLOBALS->shift_timebase) != maxbase) {
-                        s->his.v = bsearch_vector(t->n.vec, maxbase - t->shift);
-                        while (s->his.v->next && s->his.v->time == s->his.v->next->time)
-                            s->his.v = s->his.v->next;
-                    }
-                    chval = convert_ascii(t, s->his.v);
-                } else {
-                    if (strace_adjust(s->his.h->time, GLOBALS->shift_timebase) != maxbase) {
-                        s->his.h = bsearch_node(t->n.nd, maxbase - t->shift);
-                        while (s->his.h->next && s->his.h->time == s->his.h->next->time)
-                            s->his.h = s->his.h->next;
-                    }
-                    if (s->his.h->flags & GW_HIST_ENT_FLAG_REAL) {
-                        if (!(s->his.h->flags & GW_HIST_ENT_FLAG_STRING)) {
-                            chval = convert_ascii_real(t, &s->his.h->v.h_double);
-                        } else {
-                            chval = convert_ascii_string((char *)s->his.h->v.h_vector);
-                            chval2 = chval;
-                            while ((ch = *chval2)) /* toupper() the string */
-                            {
-                                if ((ch >= 'a') && (ch <= 'z')) {
-                                    *chval2 = ch - ('a' - 'A');
-                                }
-                                chval2++;
-                            }
-                        }
-                    } else {
-                        chval = convert_ascii_vec(t, s->his.h->v.h_vector);
-                    }
-                }
-
-                switch (s->value) {
-                    case ST_ANY:
-                        totaltraces++;
-                        s->search_result = 1;
-                        break;
-
-/* commented out, maybe will have possible future expansion later,
- * this was cut and pasted from strace.c */
-#if 0
-			case ST_DC:
-				break;
-
-			case ST_RISE:
-			case ST_FALL:
-				totaltraces++;
-				break;
-
-			case ST_HIGH:
-				totaltraces++;
-				if((chval2=chval))
-				while((ch=*(chval2++)))
-					{
-					if(((ch>='1')&&(ch<='9'))||(ch=='h')||(ch=='H')||((ch>='A')&&(ch<='F')))
-						{
-						s->search_result=1;
-						break;
-						}
-					}
-				break;
-
-			case ST_LOW:
-				totaltraces++;
-				if((chval2=chval))
-				{
-				s->search_result=1;
-				while((ch=*(chval2++)))
-					{
-					if((ch!='0')&&(ch!='l')&&(ch!='L'))
-						{
-						s->search_result=0;
-						break;
-						}
-					}
-				}
-				break;
-
-			case ST_MID:
-				totaltraces++;
-				if((chval2=chval))
-				{
-				s->search_result=1;
-				while((ch=*(chval2++)))
-					{
-					if((ch!='z')&&(ch!='Z'))
-						{
-						s->search_result=0;
-						break;
-						}
-					}
-				}
-				break;
-
-			case ST_X:
-				totaltraces++;
-				if((chval2=chval))
-				{
-				s->search_result=1;
-				while((ch=*(chval2++)))
-					{
-					if((ch!='X')&&(ch!='W')&&(ch!='x')&&(ch!='w'))
-						{
-						s->search_result=0;
-						break;
-						}
-					}
-				}
-				break;
-
-			case ST_STRING:
-				totaltraces++;
-				if(s->string)
-				if(strstr_i(chval, s->string)) s->search_result=1;
-				break;
-#endif
-
-                    default:
-                        fprintf(stderr, "Internal error: st_type of %d\n", s->value);
-                        exit(255);
-                }
-
-                free_2(chval);
-            }
-            s = s->next;
-        }
+static gboolean edge_heap_before(struct edge_heap *heap, int a, int b)
+{
+    if (heap->direction == STRACE_BACKWARD) {
+        return heap->cursors[a].time > heap->cursors[b].time;
+    } else {
+        return heap->cursors[a].time < heap->cursors[b].time;
+    }
+}
 
-        if ((maxbase < sttim) || (maxbase > fintim))
-            return;
-
-#ifdef DEBUG_PRINTF
-        DEBUG(printf("Maxbase: %" GW_TIME_FORMAT ", total traces: %d\n", maxbase, totaltraces));
-        s = s_head;
-        passcount = 0;
-        while (s) {
-            DEBUG(printf("\tPass: %d, Name: %s\n", s->search_result, s->trace->name));
-            if (s->search_result)
-                passcount++;
-            s = s->next;
-        }
-#endif
+static void edge_heap_swap(struct edge_heap *heap, int a, int b)
+{
+    struct edge_cursor tmp = heap->cursors[a];
+    heap->cursors[a] = heap->cursors[b];
+    heap->cursors[b] = tmp;
+}
 
-        if (totaltraces) {
+static void edge_heap_sift_down(struct edge_heap *heap, int i)
+{
+    for (;;) {
+        int best = i;
+        int l = 2 * i + 1;
+        int r = 2 * i + 2;
+
+        if (l < heap->count && edge_heap_before(heap, l, best))
+            best = l;
+        if (r < heap->count && edge_heap_before(heap, r, best))
+            best = r;
+        if (best == i)
             break;
-        }
 
-        basetime = maxbase;
+        edge_heap_swap(heap, i, best);
+        i = best;
     }
+}
 
-    gw_marker_set_position(primary_marker, maxbase);
-    gw_marker_set_enabled(primary_marker, TRUE);
+static void edge_heap_push(struct edge_heap *heap, struct edge_cursor *c)
+{
+    int i = heap->count++;
 
-    if (is_last_iteration) {
-        update_time_box();
-
-        width = (GwTime)(((gdouble)GLOBALS->wavewidth) * GLOBALS->nspx);
-        if ((maxbase < GLOBALS->tims.start) || (maxbase >= GLOBALS->tims.start + width)) {
-            if ((maxbase < 0) || (maxbase < GLOBALS->tims.first) ||
-                (maxbase > GLOBALS->tims.last)) {
-                if (GLOBALS->tims.end > GLOBALS->tims.last)
-                    GLOBALS->tims.end = GLOBALS->tims.last;
-                middle = (GLOBALS->tims.start / 2) + (GLOBALS->tims.end / 2);
-                if ((GLOBALS->tims.start & 1) && (GLOBALS->tims.end & 1))
-                    middle++;
-            } else {
-                middle = maxbase;
-            }
+    heap->cursors[i] = *c;
+    while (i > 0 && edge_heap_before(heap, i, (i - 1) / 2)) {
+        edge_heap_swap(heap, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
 
-            GLOBALS->tims.start = time_trunc(middle - (width / 2));
-            if (GLOBALS->tims.start + width > GLOBALS->tims.last)
-                GLOBALS->tims.start = GLOBALS->tims.last - width;
-            if (GLOBALS->tims.start < GLOBALS->tims.first)
-                GLOBALS->tims.start = GLOBALS->tims.first;
-            gtk_adjustment_set_value(GTK_ADJUSTMENT(GLOBALS->wave_hslider),
-                                     GLOBALS->tims.timecache = GLOBALS->tims.start);
+/*
+ * moves the top cursor past time, drops it when the trace has no more edges
+ */
+static void edge_heap_advance_top(struct edge_heap *heap, GwTime time)
+{
+    if (!edge_cursor_seek(&heap->cursors[0], heap->direction, time)) {
+        heap->cursors[0] = heap->cursors[--heap->count];
+    }
+    edge_heap_sift_down(heap, 0);
+}
+
+static void edge_search_show(GwTime maxbase)
+{
+    GwTime middle = 0, width;
+
+    update_time_box();
+
+    width = (GwTime)(((gdouble)GLOBALS->wavewidth) * GLOBALS->nspx);
+    if ((maxbase < GLOBALS->tims.start) || (maxbase >= GLOBALS->tims.start + width)) {
+        if ((maxbase < 0) || (maxbase < GLOBALS->tims.first) || (maxbase > GLOBALS->tims.last)) {
+            if (GLOBALS->tims.end > GLOBALS->tims.last)
+                GLOBALS->tims.end = GLOBALS->tims.last;
+            middle = (GLOBALS->tims.start / 2) + (GLOBALS->tims.end / 2);
+            if ((GLOBALS->tims.start & 1) && (GLOBALS->tims.end & 1))
+                middle++;
+        } else {
+            middle = maxbase;
         }
 
-        redraw_signals_and_waves();
+        GLOBALS->tims.start = time_trunc(middle - (width / 2));
+        if (GLOBALS->tims.start + width > GLOBALS->tims.last)
+            GLOBALS->tims.start = GLOBALS->tims.last - width;
+        if (GLOBALS->tims.start < GLOBALS->tims.first)
+            GLOBALS->tims.start = GLOBALS->tims.first;
+        gtk_adjustment_set_value(GTK_ADJUSTMENT(GLOBALS->wave_hslider),
+                                 GLOBALS->tims.timecache = GLOBALS->tims.start);
     }
+
+    redraw_signals_and_waves();
 }
 
+/*
+ * moves the primary marker to the next/previous edge of any highlighted
+ * trace, repeated strace_repeat_count times
+ */
 void edge_search(int direction)
 {
+    int repeat = (GLOBALS->strace_repeat_count > 0) ? GLOBALS->strace_repeat_count : 1;
+    struct edge_heap heap;
+    struct edge_cursor c;
+    GwTime basetime, maxbase = 0;
+    GwTrace *t;
+    int num_traces = 0;
     int i;
-    int i_high_cnt = ((GLOBALS->strace_repeat_count > 0) ? GLOBALS->strace_repeat_count : 1) - 1;
 
-    for (i = 0; i <= i_high_cnt; i++) {
-        edge_search_2(direction, (i == i_high_cnt));
+    for (t = find_first_highlighted_trace(); t; t = find_next_highlighted_trace(t)) {
+        num_traces++;
     }
+    if (!num_traces)
+        return;
+
+    GwMarker *primary_marker = gw_project_get_primary_marker(GLOBALS->project);
+
+    if (gw_marker_is_enabled(primary_marker)) {
+        basetime = gw_marker_get_position(primary_marker);
+    } else if (direction == STRACE_BACKWARD) {
+        basetime = GLOBALS->tims.last + 1;
+    } else {
+        basetime = GLOBALS->tims.first - 1;
+    }
+
+    heap.cursors = g_new(struct edge_cursor, num_traces);
+    heap.count = 0;
+    heap.direction = direction;
+
+    for (t = find_first_highlighted_trace(); t; t = find_next_highlighted_trace(t)) {
+        c.index = get_edge_index(t);
+        c.shift = t->shift;
+        if (edge_cursor_seek(&c, direction, basetime)) {
+            edge_heap_push(&heap, &c);
+        }
+    }
+
+    for (i = 0; i < repeat && heap.count; i++) {
+        GwTime edge = heap.cursors[0].time;
+
+        if ((edge < GLOBALS->tims.first) || (edge > GLOBALS->tims.last))
+            break;
+
+        maxbase = edge;
+        while (heap.count && heap.cursors[0].time == edge) {
+            edge_heap_advance_top(&heap, edge);
+        }
+    }
+
+    g_free(heap.cursors);
+
+    if (i == 0)
+        return;
+
+    gw_marker_set_position(primary_marker, maxbase);
+    gw_marker_set_enabled(primary_marker, TRUE);
+
+    edge_search_show(maxbase);
 }
 
 /************************************************/
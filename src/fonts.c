@@ -28,6 +28,113 @@
 #define WAVE_SANS_10 "Sans 10"
 #endif
 
+/*
+ * Value labels repeat a lot (0000, IDLE, XXXX...), so the widths and shaped
+ * layouts of short strings are cached and evicted in LRU order. Entries are
+ * keyed by the font description pointer, which is shared by all tabs and never
+ * freed. The color is not part of the key because it is taken from the cairo
+ * source when a layout is shown.
+ */
+#define LABEL_CACHE_SIZE 2048
+#define LABEL_CACHE_MAX_STRING 64
+
+typedef struct
+{
+    PangoFontDescription *desc;
+    gchar *string;
+    gint width;
+    PangoLayout *layout; /* created when the label is drawn the first time */
+    GList link;
+} LabelCacheEntry;
+
+static GHashTable *label_cache = NULL;
+static GQueue label_cache_lru = G_QUEUE_INIT;
+
+static guint label_cache_entry_hash(gconstpointer key)
+{
+    const LabelCacheEntry *entry = key;
+
+    return g_str_hash(entry->string) ^ g_direct_hash(entry->desc);
+}
+
+static gboolean label_cache_entry_equal(gconstpointer a, gconstpointer b)
+{
+    const LabelCacheEntry *ea = a;
+    const LabelCacheEntry *eb = b;
+
+    return ea->desc == eb->desc && strcmp(ea->string, eb->string) == 0;
+}
+
+static void label_cache_entry_free(LabelCacheEntry *entry)
+{
+    g_clear_object(&entry->layout);
+    g_free(entry->string);
+    g_free(entry);
+}
+
+static void label_cache_clear(void)
+{
+    if (label_cache != NULL) {
+        g_queue_init(&label_cache_lru); /* the links are owned by the entries */
+        g_hash_table_destroy(label_cache);
+        label_cache = NULL;
+    }
+}
+
+static gint measure_string(struct font_engine_font_t *font, const gchar *string)
+{
+    PangoRectangle ink, logical;
+
+    pango_layout_set_text(GLOBALS->fonts_layout, string, -1);
+    pango_layout_set_font_description(GLOBALS->fonts_layout, font->desc);
+    pango_layout_get_extents(GLOBALS->fonts_layout, &ink, &logical);
+
+    return logical.width / 1000;
+}
+
+/* Returns NULL for strings which are too long to be worth caching. */
+static LabelCacheEntry *label_cache_lookup(struct font_engine_font_t *font, const gchar *string)
+{
+    if (strlen(string) > LABEL_CACHE_MAX_STRING) {
+        return NULL;
+    }
+
+    if (label_cache == NULL) {
+        label_cache = g_hash_table_new_full(label_cache_entry_hash,
+                                            label_cache_entry_equal,
+                                            (GDestroyNotify)label_cache_entry_free,
+                                            NULL);
+    }
+
+    LabelCacheEntry key = {
+        .desc = font->desc,
+        .string = (gchar *)string,
+    };
+
+    LabelCacheEntry *entry = g_hash_table_lookup(label_cache, &key);
+    if (entry != NULL) {
+        g_queue_unlink(&label_cache_lru, &entry->link);
+        g_queue_push_head_link(&label_cache_lru, &entry->link);
+        return entry;
+    }
+
+    if (label_cache_lru.length >= LABEL_CACHE_SIZE) {
+        GList *oldest = g_queue_pop_tail_link(&label_cache_lru);
+        g_hash_table_remove(label_cache, oldest->data);
+    }
+
+    entry = g_new0(LabelCacheEntry, 1);
+    entry->desc = font->desc;
+    entry->string = g_strdup(string);
+    entry->width = measure_string(font, string);
+    entry->link.data = entry;
+
+    g_hash_table_add(label_cache, entry);
+    g_queue_push_head_link(&label_cache_lru, &entry->link);
+
+    return entry;
+}
+
 static struct font_engine_font_t *do_font_load(const char *name)
 {
     struct font_engine_font_t *fef = NULL;
@@ -57,9 +164,16 @@ static struct font_engine_font_t *do_font_load(const char *name)
 
 static int setup_fonts(void)
 {
+    label_cache_clear(); /* cached layouts belong to the previous context */
+
     GdkScreen *fonts_screen = gdk_screen_get_default();
 
-    GLOBALS->fonts_context = gdk_pango_context_get_for_screen(fonts_screen);
+    if (fonts_screen != NULL) {
+        GLOBALS->fonts_context = gdk_pango_context_get_for_screen(fonts_screen);
+    } else {
+        /* no display, e.g. when rendering to a file */
+        GLOBALS->fonts_context = pango_font_map_create_context(pango_cairo_font_map_get_default());
+    }
     GLOBALS->fonts_layout = pango_layout_new(GLOBALS->fonts_context);
 
     return 0;
@@ -123,12 +237,8 @@ gint font_engine_string_measure(struct font_engine_font_t *font, const gchar *st
     if (font->is_mono) {
         rc = strlen(string) * font->mono_width;
     } else {
-        PangoRectangle ink, logical;
-
-        pango_layout_set_text(GLOBALS->fonts_layout, string, -1);
-        pango_layout_set_font_description(GLOBALS->fonts_layout, font->desc);
-        pango_layout_get_extents(GLOBALS->fonts_layout, &ink, &logical);
-        rc = logical.width / 1000;
+        LabelCacheEntry *entry = label_cache_lookup(font, string);
+        rc = entry != NULL ? entry->width : measure_string(font, string);
     }
 
     return (rc);
@@ -151,13 +261,32 @@ void XXX_font_engine_draw_string(cairo_t *cr,
                                  gint y,
                                  const gchar *string)
 {
-    /* PangoRectangle ink,logical; */
+    cairo_set_source_rgba(cr, color->r, color->g, color->b, color->a);
+    font_engine_show_string(cr, font, x, y, string);
+}
 
-    pango_layout_set_text(GLOBALS->fonts_layout, string, -1);
-    pango_layout_set_font_description(GLOBALS->fonts_layout, font->desc);
-    /* pango_layout_get_extents(GLOBALS->fonts_layout,&ink,&logical); */
+/* Draws a string with the current source of @cr. */
+void font_engine_show_string(cairo_t *cr,
+                             struct font_engine_font_t *font,
+                             gint x,
+                             gint y,
+                             const gchar *string)
+{
+    PangoLayout *layout = GLOBALS->fonts_layout;
+
+    LabelCacheEntry *entry = label_cache_lookup(font, string);
+    if (entry != NULL) {
+        if (entry->layout == NULL) {
+            entry->layout = pango_layout_new(GLOBALS->fonts_context);
+            pango_layout_set_font_description(entry->layout, font->desc);
+            pango_layout_set_text(entry->layout, string, -1);
+        }
+        layout = entry->layout;
+    } else {
+        pango_layout_set_text(layout, string, -1);
+        pango_layout_set_font_description(layout, font->desc);
+    }
 
-    cairo_set_source_rgba(cr, color->r, color->g, color->b, color->a);
     cairo_move_to(cr, x, y - font->ascent);
-    pango_cairo_show_layout(cr, GLOBALS->fonts_layout);
+    pango_cairo_show_layout(cr, layout);
 }
@@ -38,5 +38,10 @@ void XXX_font_engine_draw_string(cairo_t *cr,
                                  gint x,
                                  gint y,
                                  const gchar *string);
+void font_engine_show_string(cairo_t *cr,
+                             struct font_engine_font_t *font,
+                             gint x,
+                             gint y,
+                             const gchar *string);
 
 #endif
@@ -56,6 +56,7 @@ static const struct Global globals_base_values = {
     {
         .vlist_compression_level = 4,
         .vcd_warning_filesize = 256,
+        .vcd_saver_parallel_min = 1024 * 1024,
     }, // settings
 
     /*
@@ -274,6 +275,7 @@ static const struct Global globals_base_values = {
     0, /* save_success_menu_c_1 248 */
     NULL, /* filesel_vcd_writesave 249 */
     NULL, /* filesel_tim_writesave */
+    NULL, /* filesel_fst_writesave */
     0, /* lock_menu_c_1 251 */
     0, /* lock_menu_c_2 252 */
     NULL, /* buf_menu_c_1 253 128 */
@@ -395,6 +397,8 @@ static const struct Global globals_base_values = {
     NULL, /* signalfont 370 */
     0, /* max_signal_name_pixel_width 372 */
     0, /* signal_pixmap_width 373 */
+    0, /* signal_name_max_width */
+    0, /* signal_name_max_count */
     1, /* fontheight 376 */
     0, /* dnd_state 377 */
     0, /* cached_mouseover_x */
@@ -578,6 +582,7 @@ static const struct Global globals_base_values = {
     {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* buf_vcd_saver_c_3 580 */
     NULL, /* hp_vcd_saver_c_1 581 */
     NULL, /* nhold_vcd_saver_c_1 582 */
+    NULL, /* fst_vcd_saver_c_1 */
 
     /*
      * wavewindow.c
@@ -755,6 +760,8 @@ static int handle_setjmp(void)
                 break;
             case GHW_FILE:
             case FST_FILE:
+            case LXT2_FILE:
+            case VZT_FILE:
             case DUMPLESS_FILE:
             case MISSING_FILE:
             default:
@@ -1126,6 +1133,9 @@ void reload_into_new_context_2(void)
     strcpy2_into_new_context(new_globals,
                              &new_globals->filesel_tim_writesave,
                              &GLOBALS->filesel_tim_writesave);
+    strcpy2_into_new_context(new_globals,
+                             &new_globals->filesel_fst_writesave,
+                             &GLOBALS->filesel_fst_writesave);
 
     strcpy2_into_new_context(
         new_globals,
@@ -1224,6 +1234,9 @@ void reload_into_new_context_2(void)
 
     g_clear_object(&GLOBALS->dump_file);
 
+    ttrans_cancel_jobs();
+    remove_all_file_filters();
+
     /* window destruction (of windows that aren't the parent window) */
 
     kill_stems_browser(); /* for now, need to rework the stems browser dumpfile access routines to
@@ -1343,11 +1356,10 @@ void reload_into_new_context_2(void)
         set_window_busy(NULL);
 
         /* Check to see if we need to reload a vcd file */
-#if !defined __MINGW32__
         if (GLOBALS->optimize_vcd) {
             optimize_vcd_file();
         }
-#endif
+
         /* Load new file from disk, no reload on partial vcd or vcd from stdin. */
         switch (GLOBALS->loaded_file_type) {
 #ifdef EXTLOAD_SUFFIX
@@ -1371,6 +1383,16 @@ void reload_into_new_context_2(void)
                 load_was_success = GLOBALS->dump_file != NULL;
                 break;
 
+            case LXT2_FILE:
+                GLOBALS->dump_file = lxt2_main(GLOBALS->loaded_file_name);
+                load_was_success = GLOBALS->dump_file != NULL;
+                break;
+
+            case VZT_FILE:
+                GLOBALS->dump_file = vzt_main(GLOBALS->loaded_file_name);
+                load_was_success = GLOBALS->dump_file != NULL;
+                break;
+
             case VCD_RECODER_FILE:
                 load_was_success = handle_setjmp();
                 break;
@@ -1642,6 +1664,9 @@ void free_and_destroy_page_context(void)
 
     g_clear_object(&GLOBALS->dump_file);
 
+    ttrans_cancel_jobs();
+    remove_all_file_filters();
+
     /* window destruction (of windows that aren't the parent window) */
 
     widget_only_destroy(&GLOBALS->window_ptranslate_c_5); /* ptranslate.c */
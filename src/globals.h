@@ -78,6 +78,7 @@ typedef struct
     gboolean preserve_glitches_real;
 
     gsize vcd_warning_filesize;
+    guint64 vcd_saver_parallel_min; /* value changes before the saver formats in parallel */
 } Settings;
 
 struct Global
@@ -311,6 +312,7 @@ struct Global
     char save_success_menu_c_1; /* from menu.c 265 */
     char *filesel_vcd_writesave; /* from menu.c 266 */
     char *filesel_tim_writesave; /* from menu.c */
+    char *filesel_fst_writesave; /* from menu.c */
     int lock_menu_c_1; /* from menu.c 268 */
     int lock_menu_c_2; /* from menu.c 269 */
     char *buf_menu_c_1; /* from menu.c 270 */
@@ -432,6 +434,8 @@ struct Global
     struct font_engine_font_t *signalfont; /* from signalwindow.c 397 */
     int max_signal_name_pixel_width; /* from signalwindow.c 399 */
     int signal_pixmap_width; /* from signalwindow.c 400 */
+    int signal_name_max_width; /* widest measured signal list name */
+    int signal_name_max_count; /* number of traces with that width */
     int fontheight; /* from signalwindow.c 404 */
     char dnd_state; /* from signalwindow.c 405 */
     gint cached_mouseover_x; /* from signalwindow.c */
@@ -487,7 +491,7 @@ struct Global
     int current_filter_translate_c_2; /* from translate.c 465 */
     int num_file_filters; /* from translate.c 466 */
     char **filesel_filter; /* from translate.c 467 */
-    struct xl_tree_node **xl_file_filter; /* from translate.c 468 */
+    GHashTable **xl_file_filter; /* from translate.c 468 */
     int is_active_translate_c_5; /* from translate.c 469 */
     char *fcurr_translate_c_2; /* from translate.c 470 */
     GtkWidget *window_translate_c_11; /* from translate.c 471 */
@@ -572,6 +576,7 @@ struct Global
     char buf_vcd_saver_c_3[16]; /* from vcd_saver.c 631 */
     struct vcdsav_tree_node **hp_vcd_saver_c_1; /* from vcd_saver.c 632 */
     struct namehier *nhold_vcd_saver_c_1; /* from vcd_saver.c 633 */
+    void *fst_vcd_saver_c_1;
 
     /*
      * wavewindow.c
@@ -10,6 +10,7 @@ struct _GwWaveView
     GtkDrawingArea parent_instance;
 
     cairo_surface_t *traces_surface;
+    gint64 traces_surface_bytes;
 
     gboolean dirty;
 };
@@ -16,21 +16,21 @@ static GwColor XXX_get_gc_from_name(const char *str)
     return color;
 }
 
+/*
+ * All lines, rectangles and text runs of a redraw are collected per color and
+ * drawn at the end with one fill, stroke or text pass per color. Rectangles
+ * are drawn below lines and text, so that highlighted rows and value fills
+ * stay in the background. Overlapping horizontal and vertical lines are
+ * merged before stroking, because dense traces emit many lines on the same
+ * pixels.
+ */
+
 typedef enum
 {
-    LINE_COLOR_X,
-    LINE_COLOR_U,
-    LINE_COLOR_W,
-    LINE_COLOR_DASH,
-    LINE_COLOR_TRANS,
-    LINE_COLOR_0,
-    LINE_COLOR_LOW,
-    LINE_COLOR_MID,
-    LINE_COLOR_1,
-    LINE_COLOR_HIGH,
-    LINE_COLOR_VBOX,
-    N_LINE_COLORS,
-} LineColor;
+    DRAW_LAYER_BACKGROUND, /* highlighted trace rows */
+    DRAW_LAYER_FILL,
+    N_DRAW_LAYERS,
+} DrawLayer;
 
 typedef struct
 {
@@ -42,41 +42,101 @@ typedef struct
 
 typedef struct
 {
-    GwColor colors[N_LINE_COLORS];
-    GArray *lines[N_LINE_COLORS];
-} LineBuffer;
+    gint x;
+    gint y;
+    gint width;
+    gint height;
+} Rect;
+
+typedef struct
+{
+    gdouble x;
+    gdouble y;
+    gboolean move;
+} PathPoint;
+
+typedef struct
+{
+    struct font_engine_font_t *font;
+    gint x;
+    gint y;
+    const gchar *text;
+} TextRun;
+
+typedef struct
+{
+    GwColor color;
+    GArray *rects[N_DRAW_LAYERS];
+    GArray *lines;
+    GArray *path;
+    GArray *texts;
+} DrawBatchColor;
+
+typedef struct
+{
+    GPtrArray *colors;
+    DrawBatchColor *last;
+    GStringChunk *strings;
+    guint64 primitives;
+} DrawBatch;
 
-static LineBuffer *line_buffer_new(const GwWaveformColors *colors)
+static void draw_batch_color_free(DrawBatchColor *self)
 {
-    LineBuffer *self = g_new0(LineBuffer, 1);
-    self->colors[LINE_COLOR_X] = colors->stroke_x;
-    self->colors[LINE_COLOR_U] = colors->stroke_u;
-    self->colors[LINE_COLOR_W] = colors->stroke_w;
-    self->colors[LINE_COLOR_DASH] = colors->stroke_dash;
-    self->colors[LINE_COLOR_TRANS] = colors->stroke_transition;
-    self->colors[LINE_COLOR_0] = colors->stroke_0;
-    self->colors[LINE_COLOR_LOW] = colors->stroke_l;
-    self->colors[LINE_COLOR_MID] = colors->stroke_z;
-    self->colors[LINE_COLOR_1] = colors->stroke_1;
-    self->colors[LINE_COLOR_HIGH] = colors->stroke_h;
-    self->colors[LINE_COLOR_VBOX] = colors->stroke_vector;
-
-    for (gint i = 0; i < N_LINE_COLORS; i++) {
-        self->lines[i] = g_array_new(FALSE, FALSE, sizeof(Line));
+    for (gint i = 0; i < N_DRAW_LAYERS; i++) {
+        g_array_free(self->rects[i], TRUE);
     }
+    g_array_free(self->lines, TRUE);
+    g_array_free(self->path, TRUE);
+    g_array_free(self->texts, TRUE);
+    g_free(self);
+}
+
+static DrawBatch *draw_batch_new(void)
+{
+    DrawBatch *self = g_new0(DrawBatch, 1);
+    self->colors = g_ptr_array_new_with_free_func((GDestroyNotify)draw_batch_color_free);
+    self->strings = g_string_chunk_new(4096);
 
     return self;
 }
 
-static void line_buffer_free(LineBuffer *self)
+static void draw_batch_free(DrawBatch *self)
 {
-    for (gint i = 0; i < N_LINE_COLORS; i++) {
-        g_array_free(self->lines[i], TRUE);
-    }
+    g_ptr_array_free(self->colors, TRUE);
+    g_string_chunk_free(self->strings);
     g_free(self);
 }
 
-static void line_buffer_add(LineBuffer *self, LineColor color, gint x1, gint y1, gint x2, gint y2)
+static DrawBatchColor *draw_batch_get_color(DrawBatch *self, const GwColor *color)
+{
+    if (self->last != NULL && gw_color_equal(&self->last->color, color)) {
+        return self->last;
+    }
+
+    /* a redraw only uses a few dozen distinct colors */
+    for (guint i = 0; i < self->colors->len; i++) {
+        DrawBatchColor *c = g_ptr_array_index(self->colors, i);
+        if (gw_color_equal(&c->color, color)) {
+            self->last = c;
+            return c;
+        }
+    }
+
+    DrawBatchColor *c = g_new0(DrawBatchColor, 1);
+    c->color = *color;
+    for (gint i = 0; i < N_DRAW_LAYERS; i++) {
+        c->rects[i] = g_array_new(FALSE, FALSE, sizeof(Rect));
+    }
+    c->lines = g_array_new(FALSE, FALSE, sizeof(Line));
+    c->path = g_array_new(FALSE, FALSE, sizeof(PathPoint));
+    c->texts = g_array_new(FALSE, FALSE, sizeof(TextRun));
+    g_ptr_array_add(self->colors, c);
+
+    self->last = c;
+    return c;
+}
+
+static void draw_batch_line(DrawBatch *self, GwColor color, gint x1, gint y1, gint x2, gint y2)
 {
     Line line = (Line){
         .x1 = x1,
@@ -84,36 +144,282 @@ static void line_buffer_add(LineBuffer *self, LineColor color, gint x1, gint y1,
         .x2 = x2,
         .y2 = y2,
     };
-    g_array_append_val(self->lines[color], line);
+    g_array_append_val(draw_batch_get_color(self, &color)->lines, line);
+    self->primitives++;
+}
+
+static void draw_batch_rectangle(DrawBatch *self,
+                                 DrawLayer layer,
+                                 GwColor color,
+                                 gint x,
+                                 gint y,
+                                 gint width,
+                                 gint height)
+{
+    Rect rect = (Rect){
+        .x = x,
+        .y = y,
+        .width = width,
+        .height = height,
+    };
+    g_array_append_val(draw_batch_get_color(self, &color)->rects[layer], rect);
+    self->primitives++;
+}
+
+/* Starts a new subpath for lines which must be stroked with joins. */
+static void draw_batch_move_to(DrawBatch *self, GwColor color, gdouble x, gdouble y)
+{
+    PathPoint point = (PathPoint){
+        .x = x,
+        .y = y,
+        .move = TRUE,
+    };
+    g_array_append_val(draw_batch_get_color(self, &color)->path, point);
+}
+
+static void draw_batch_line_to(DrawBatch *self, GwColor color, gdouble x, gdouble y)
+{
+    PathPoint point = (PathPoint){
+        .x = x,
+        .y = y,
+        .move = FALSE,
+    };
+    g_array_append_val(draw_batch_get_color(self, &color)->path, point);
+    self->primitives++;
+}
+
+static void draw_batch_text(DrawBatch *self,
+                            struct font_engine_font_t *font,
+                            const GwColor *color,
+                            gint x,
+                            gint y,
+                            const gchar *text)
+{
+    TextRun run = (TextRun){
+        .font = font,
+        .x = x,
+        .y = y,
+        .text = g_string_chunk_insert(self->strings, text),
+    };
+    g_array_append_val(draw_batch_get_color(self, color)->texts, run);
+    self->primitives++;
+}
+
+typedef enum
+{
+    LINE_HORIZONTAL,
+    LINE_VERTICAL,
+    LINE_DIAGONAL,
+} LineKind;
+
+static LineKind line_get_kind(const Line *line)
+{
+    if (line->x1 == line->x2) {
+        return LINE_VERTICAL;
+    } else if (line->y1 == line->y2) {
+        return LINE_HORIZONTAL;
+    } else {
+        return LINE_DIAGONAL;
+    }
+}
+
+static void line_normalize(Line *line)
+{
+    if (line->x1 > line->x2 || (line->x1 == line->x2 && line->y1 > line->y2)) {
+        gint x = line->x1;
+        gint y = line->y1;
+        line->x1 = line->x2;
+        line->y1 = line->y2;
+        line->x2 = x;
+        line->y2 = y;
+    }
+}
+
+static gint compare_lines(gconstpointer a, gconstpointer b)
+{
+    const Line *la = a;
+    const Line *lb = b;
+    LineKind ka = line_get_kind(la);
+    LineKind kb = line_get_kind(lb);
+
+    if (ka != kb) {
+        return ka < kb ? -1 : 1;
+    }
+
+    /* horizontal lines are ordered by row, all others by column */
+    gint keys_a[4] = {la->x1, la->y1, la->x2, la->y2};
+    gint keys_b[4] = {lb->x1, lb->y1, lb->x2, lb->y2};
+    if (ka == LINE_HORIZONTAL) {
+        keys_a[0] = la->y1;
+        keys_a[1] = la->x1;
+        keys_b[0] = lb->y1;
+        keys_b[1] = lb->x1;
+    }
+
+    for (gint i = 0; i < 4; i++) {
+        if (keys_a[i] != keys_b[i]) {
+            return keys_a[i] < keys_b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Merges overlapping and touching horizontal and vertical lines and drops
+ * duplicate diagonal lines. Returns the number of removed lines.
+ */
+static guint draw_batch_merge_lines(GArray *lines)
+{
+    guint len = lines->len;
+    guint n = 0;
+
+    for (guint i = 0; i < len; i++) {
+        line_normalize(&g_array_index(lines, Line, i));
+    }
+    g_array_sort(lines, compare_lines);
+
+    for (guint i = 0; i < len; i++) {
+        Line line = g_array_index(lines, Line, i);
+
+        if (n > 0) {
+            Line *prev = &g_array_index(lines, Line, n - 1);
+            LineKind kind = line_get_kind(&line);
+
+            if (kind == line_get_kind(prev)) {
+                if (kind == LINE_HORIZONTAL && prev->y1 == line.y1 && line.x1 <= prev->x2) {
+                    prev->x2 = MAX(prev->x2, line.x2);
+                    continue;
+                } else if (kind == LINE_VERTICAL && prev->x1 == line.x1 && line.y1 <= prev->y2) {
+                    prev->y2 = MAX(prev->y2, line.y2);
+                    continue;
+                } else if (kind == LINE_DIAGONAL && compare_lines(prev, &line) == 0) {
+                    continue;
+                }
+            }
+        }
+
+        g_array_index(lines, Line, n++) = line;
+    }
+
+    g_array_set_size(lines, n);
+
+    return len - n;
+}
+
+static gint compare_rects(gconstpointer a, gconstpointer b)
+{
+    const Rect *ra = a;
+    const Rect *rb = b;
+    gint keys_a[4] = {ra->y, ra->x, ra->width, ra->height};
+    gint keys_b[4] = {rb->y, rb->x, rb->width, rb->height};
+
+    for (gint i = 0; i < 4; i++) {
+        if (keys_a[i] != keys_b[i]) {
+            return keys_a[i] < keys_b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/* Drops duplicate rectangles. Returns the number of removed rectangles. */
+static guint draw_batch_merge_rects(GArray *rects)
+{
+    guint len = rects->len;
+    guint n = 0;
+
+    g_array_sort(rects, compare_rects);
+
+    for (guint i = 0; i < len; i++) {
+        Rect *rect = &g_array_index(rects, Rect, i);
+        if (n > 0 && compare_rects(&g_array_index(rects, Rect, n - 1), rect) == 0) {
+            continue;
+        }
+        g_array_index(rects, Rect, n++) = *rect;
+    }
+
+    g_array_set_size(rects, n);
+
+    return len - n;
 }
 
-static void line_buffer_draw(LineBuffer *self, cairo_t *cr)
+static void draw_batch_draw(DrawBatch *self, cairo_t *cr)
 {
     gdouble offset = GLOBALS->cairo_050_offset;
+    GwStatsDrawCost cost = {
+        .primitives = self->primitives,
+    };
+
+    for (gint layer = 0; layer < N_DRAW_LAYERS; layer++) {
+        for (guint i = 0; i < self->colors->len; i++) {
+            DrawBatchColor *c = g_ptr_array_index(self->colors, i);
+            GArray *rects = c->rects[layer];
 
-    for (gint i = 0; i < N_LINE_COLORS; i++) {
-        GwColor *color = &self->colors[i];
-        GArray *lines = self->lines[i];
+            if (rects->len == 0) {
+                continue;
+            }
 
-        if (lines->len == 0) {
+            cost.merged += draw_batch_merge_rects(rects);
+
+            cairo_set_source_rgba(cr, c->color.r, c->color.g, c->color.b, c->color.a);
+            for (guint j = 0; j < rects->len; j++) {
+                Rect *rect = &g_array_index(rects, Rect, j);
+                cairo_rectangle(cr, rect->x, rect->y, rect->width, rect->height);
+            }
+            cairo_fill(cr);
+            cost.calls++;
+        }
+    }
+
+    for (guint i = 0; i < self->colors->len; i++) {
+        DrawBatchColor *c = g_ptr_array_index(self->colors, i);
+
+        if (c->lines->len == 0 && c->path->len == 0) {
             continue;
         }
 
-        cairo_set_source_rgba(cr, color->r, color->g, color->b, color->a);
+        cost.merged += draw_batch_merge_lines(c->lines);
 
-        for (guint j = 0; j < lines->len; j++) {
-            Line *line = &g_array_index(lines, Line, j);
+        cairo_set_source_rgba(cr, c->color.r, c->color.g, c->color.b, c->color.a);
+        for (guint j = 0; j < c->lines->len; j++) {
+            Line *line = &g_array_index(c->lines, Line, j);
 
             cairo_move_to(cr, line->x1 + offset, line->y1 + offset);
             cairo_line_to(cr, line->x2 + offset, line->y2 + offset);
         }
+        for (guint j = 0; j < c->path->len; j++) {
+            PathPoint *point = &g_array_index(c->path, PathPoint, j);
 
+            if (point->move) {
+                cairo_move_to(cr, point->x + offset, point->y + offset);
+            } else {
+                cairo_line_to(cr, point->x + offset, point->y + offset);
+            }
+        }
         cairo_stroke(cr);
+        cost.calls++;
     }
+
+    for (guint i = 0; i < self->colors->len; i++) {
+        DrawBatchColor *c = g_ptr_array_index(self->colors, i);
+
+        if (c->texts->len == 0) {
+            continue;
+        }
+
+        cairo_set_source_rgba(cr, c->color.r, c->color.g, c->color.b, c->color.a);
+        for (guint j = 0; j < c->texts->len; j++) {
+            TextRun *run = &g_array_index(c->texts, TextRun, j);
+
+            font_engine_show_string(cr, run->font, run->x, run->y, run->text);
+            cost.calls++;
+        }
+    }
+
+    gw_stats_set_draw_cost(&cost);
 }
 
 static void draw_hptr_trace(GwWaveView *self,
-                            cairo_t *cr,
+                            DrawBatch *batch,
                             GwWaveformColors *colors,
                             GwTrace *t,
                             GwHistEnt *h,
@@ -121,13 +427,13 @@ static void draw_hptr_trace(GwWaveView *self,
                             int dodraw,
                             int kill_grid);
 static void draw_hptr_trace_vector(GwWaveView *self,
-                                   cairo_t *cr,
+                                   DrawBatch *batch,
                                    GwWaveformColors *colors,
                                    GwTrace *t,
                                    GwHistEnt *h,
                                    int which);
 static void draw_vptr_trace(GwWaveView *self,
-                            cairo_t *cr,
+                            DrawBatch *batch,
                             GwWaveformColors *colors,
                             GwTrace *t,
                             GwVectorEnt *v,
@@ -135,7 +441,17 @@ static void draw_vptr_trace(GwWaveView *self,
 
 void gw_wave_view_render_traces(GwWaveView *self, cairo_t *cr)
 {
-    GwTrace *t = gw_signal_list_get_trace(GW_SIGNAL_LIST(GLOBALS->signalarea), 0);
+    GwTrace *t;
+    if (GLOBALS->signalarea != NULL) {
+        t = gw_signal_list_get_trace(GW_SIGNAL_LIST(GLOBALS->signalarea), 0);
+    } else {
+        t = GLOBALS->traces.first; /* rendering without widgets */
+    }
+
+    DrawBatch *batch = draw_batch_new();
+
+    begin_proc_filter_batch();
+
     if (t) {
         GwTrace *tback = t;
         GwHistEnt *h;
@@ -143,10 +459,7 @@ void gw_wave_view_render_traces(GwWaveView *self, cairo_t *cr)
         int i = 0, num_traces_displayable;
         int iback = 0;
 
-        GtkAllocation allocation;
-        gtk_widget_get_allocation(GLOBALS->wavearea, &allocation);
-
-        num_traces_displayable = allocation.height / (GLOBALS->fontheight);
+        num_traces_displayable = GLOBALS->waveheight / (GLOBALS->fontheight);
         num_traces_displayable--; /* for the time trace that is always there */
 
         /* ensure that transaction traces are visible even if the topmost traces are blanks */
@@ -189,9 +502,9 @@ void gw_wave_view_render_traces(GwWaveView *self, cairo_t *cr)
 
                     if (i >= 0) {
                         if (!t->n.nd->extvals) {
-                            draw_hptr_trace(self, cr, colors, t, h, i, 1, 0);
+                            draw_hptr_trace(self, batch, colors, t, h, i, 1, 0);
                         } else {
-                            draw_hptr_trace_vector(self, cr, colors, t, h, i);
+                            draw_hptr_trace_vector(self, batch, colors, t, h, i);
                         }
                     }
                 } else {
@@ -206,7 +519,7 @@ void gw_wave_view_render_traces(GwWaveView *self, cairo_t *cr)
                                  GLOBALS->tims.start,
                                  (v->time + GLOBALS->shift_timebase)));
                     if (i >= 0) {
-                        draw_vptr_trace(self, cr, colors, t, v, i);
+                        draw_vptr_trace(self, batch, colors, t, v, i);
                     }
 
                     if ((bv->transaction_chain) && (t->flags & TR_TTRANSLATED)) {
@@ -220,7 +533,7 @@ void gw_wave_view_render_traces(GwWaveView *self, cairo_t *cr)
                                 if (i < num_traces_displayable) {
                                     v = bsearch_vector(bv, GLOBALS->tims.start - t->shift);
                                     if (i >= 0) {
-                                        draw_vptr_trace(self, cr, colors, t_orig, v, i);
+                                        draw_vptr_trace(self, batch, colors, t_orig, v, i);
                                     }
                                     t = tn;
                                     continue;
@@ -243,7 +556,7 @@ void gw_wave_view_render_traces(GwWaveView *self, cairo_t *cr)
                 }
 
                 if (i >= 0) {
-                    draw_hptr_trace(self, cr, colors, NULL, NULL, i, 0, kill_dodraw_grid);
+                    draw_hptr_trace(self, batch, colors, NULL, NULL, i, 0, kill_dodraw_grid);
                 }
             }
             t = GiveNextTrace(t);
@@ -254,6 +567,11 @@ void gw_wave_view_render_traces(GwWaveView *self, cairo_t *cr)
             }
         }
     }
+
+    end_proc_filter_batch(self);
+
+    draw_batch_draw(batch, cr);
+    draw_batch_free(batch);
 }
 
 /*
@@ -261,7 +579,7 @@ void gw_wave_view_render_traces(GwWaveView *self, cairo_t *cr)
  * for "excluded" traces
  */
 static void draw_hptr_trace(GwWaveView *self,
-                            cairo_t *cr,
+                            DrawBatch *batch,
                             GwWaveformColors *colors,
                             GwTrace *t,
                             GwHistEnt *h,
@@ -275,13 +593,11 @@ static void draw_hptr_trace(GwWaveView *self,
     GwHistEnt *h2;
     GwHistEnt *h3;
     char hval, h2val, invert;
-    LineColor c;
+    GwColor c;
     GwColor gcx, gcxf;
     char identifier_str[2];
     int is_event = t && t->n.nd && (t->n.nd->vartype == GW_VAR_TYPE_VCD_EVENT);
 
-    LineBuffer *lines = line_buffer_new(colors);
-
     GLOBALS->tims.start -= GLOBALS->shift_timebase;
     GLOBALS->tims.end -= GLOBALS->shift_timebase;
 
@@ -300,45 +616,45 @@ static void draw_hptr_trace(GwWaveView *self,
 
     if ((GLOBALS->highlight_wavewindow) && (t) && (t->flags & TR_HIGHLIGHT) &&
         (!GLOBALS->black_and_white) && (!kill_grid)) {
-        XXX_gdk_draw_rectangle(cr,
-                               colors->grid,
-                               TRUE,
-                               0,
-                               liney - GLOBALS->fontheight,
-                               GLOBALS->wavewidth,
-                               GLOBALS->fontheight);
+        draw_batch_rectangle(batch,
+                             DRAW_LAYER_BACKGROUND,
+                             colors->grid,
+                             0,
+                             liney - GLOBALS->fontheight,
+                             GLOBALS->wavewidth,
+                             GLOBALS->fontheight);
     } else if ((GLOBALS->display_grid) && (GLOBALS->enable_horiz_grid) && (!kill_grid)) {
-        XXX_gdk_draw_line(cr,
-                          colors->grid,
-                          (GLOBALS->tims.start < GLOBALS->tims.first)
-                              ? (GLOBALS->tims.first - GLOBALS->tims.start) * GLOBALS->pxns
-                              : 0,
-                          liney,
-                          (GLOBALS->tims.last <= GLOBALS->tims.end)
-                              ? (GLOBALS->tims.last - GLOBALS->tims.start) * GLOBALS->pxns
-                              : GLOBALS->wavewidth - 1,
-                          liney);
+        draw_batch_line(batch,
+                        colors->grid,
+                        (GLOBALS->tims.start < GLOBALS->tims.first)
+                            ? (GLOBALS->tims.first - GLOBALS->tims.start) * GLOBALS->pxns
+                            : 0,
+                        liney,
+                        (GLOBALS->tims.last <= GLOBALS->tims.end)
+                            ? (GLOBALS->tims.last - GLOBALS->tims.start) * GLOBALS->pxns
+                            : GLOBALS->wavewidth - 1,
+                        liney);
     }
 
     if ((h) && (GLOBALS->tims.start == h->time))
         if (h->v.h_val != GW_BIT_Z) {
             switch (h->v.h_val) {
                 case GW_BIT_X:
-                    c = LINE_COLOR_X;
+                    c = colors->stroke_x;
                     break;
                 case GW_BIT_U:
-                    c = LINE_COLOR_U;
+                    c = colors->stroke_u;
                     break;
                 case GW_BIT_W:
-                    c = LINE_COLOR_W;
+                    c = colors->stroke_w;
                     break;
                 case GW_BIT_DASH:
-                    c = LINE_COLOR_DASH;
+                    c = colors->stroke_dash;
                     break;
                 default:
-                    c = (h->v.h_val == GW_BIT_X) ? LINE_COLOR_X : LINE_COLOR_TRANS;
+                    c = (h->v.h_val == GW_BIT_X) ? colors->stroke_x : colors->stroke_transition;
             }
-            line_buffer_add(lines, c, 0, _y0, 0, _y1);
+            draw_batch_line(batch, c, 0, _y0, 0, _y1);
         }
 
     if (dodraw && t)
@@ -375,9 +691,9 @@ static void draw_hptr_trace(GwWaveView *self,
             if (_x0 != _x1) {
                 if (is_event) {
                     if (h->time >= GLOBALS->tims.first) {
-                        line_buffer_add(lines, LINE_COLOR_W, _x0, _y0, _x0, _y1);
-                        line_buffer_add(lines, LINE_COLOR_W, _x0, _y1, _x0 + 2, _y1 + 2);
-                        line_buffer_add(lines, LINE_COLOR_W, _x0, _y1, _x0 - 2, _y1 + 2);
+                        draw_batch_line(batch, colors->stroke_w, _x0, _y0, _x0, _y1);
+                        draw_batch_line(batch, colors->stroke_w, _x0, _y1, _x0 + 2, _y1 + 2);
+                        draw_batch_line(batch, colors->stroke_w, _x0, _y1, _x0 - 2, _y1 + 2);
                     }
                     h = h->next;
                     continue;
@@ -388,19 +704,19 @@ static void draw_hptr_trace(GwWaveView *self,
 
                 switch (h2val) {
                     case GW_BIT_X:
-                        c = LINE_COLOR_X;
+                        c = colors->stroke_x;
                         break;
                     case GW_BIT_U:
-                        c = LINE_COLOR_U;
+                        c = colors->stroke_u;
                         break;
                     case GW_BIT_W:
-                        c = LINE_COLOR_W;
+                        c = colors->stroke_w;
                         break;
                     case GW_BIT_DASH:
-                        c = LINE_COLOR_DASH;
+                        c = colors->stroke_dash;
                         break;
                     default:
-                        c = (hval == GW_BIT_X) ? LINE_COLOR_X : LINE_COLOR_TRANS;
+                        c = (hval == GW_BIT_X) ? colors->stroke_x : colors->stroke_transition;
                 }
 
                 switch (hval) {
@@ -418,16 +734,16 @@ static void draw_hptr_trace(GwWaveView *self,
                                     g_warn_if_reached();
                                     break;
                             }
-                            XXX_gdk_draw_rectangle(cr,
-                                                   gcxf,
-                                                   TRUE,
-                                                   _x0 + 1,
-                                                   _y0,
-                                                   _x1 - _x0,
-                                                   _y1 - _y0 + 1);
+                            draw_batch_rectangle(batch,
+                                                 DRAW_LAYER_FILL,
+                                                 gcxf,
+                                                 _x0 + 1,
+                                                 _y0,
+                                                 _x1 - _x0,
+                                                 _y1 - _y0 + 1);
                         }
-                        line_buffer_add(lines,
-                                        (hval == GW_BIT_0) ? LINE_COLOR_0 : LINE_COLOR_LOW,
+                        draw_batch_line(batch,
+                                        (hval == GW_BIT_0) ? colors->stroke_0 : colors->stroke_l,
                                         _x0,
                                         _y0,
                                         _x1,
@@ -440,10 +756,10 @@ static void draw_hptr_trace(GwWaveView *self,
                                     break;
 
                                 case GW_BIT_Z:
-                                    line_buffer_add(lines, c, _x1, _y0, _x1, yu);
+                                    draw_batch_line(batch, c, _x1, _y0, _x1, yu);
                                     break;
                                 default:
-                                    line_buffer_add(lines, c, _x1, _y0, _x1, _y1);
+                                    draw_batch_line(batch, c, _x1, _y0, _x1, _y1);
                                     break;
                             }
                         break;
@@ -456,25 +772,25 @@ static void draw_hptr_trace(GwWaveView *self,
                         identifier_str[1] = 0;
                         switch (hval) {
                             case GW_BIT_X:
-                                c = LINE_COLOR_X;
+                                c = colors->stroke_x;
                                 gcx = colors->stroke_x;
                                 gcxf = colors->fill_x;
                                 identifier_str[0] = 0;
                                 break;
                             case GW_BIT_W:
-                                c = LINE_COLOR_W;
+                                c = colors->stroke_w;
                                 gcx = colors->stroke_w;
                                 gcxf = colors->fill_w;
                                 identifier_str[0] = 'W';
                                 break;
                             case GW_BIT_U:
-                                c = LINE_COLOR_U;
+                                c = colors->stroke_u;
                                 gcx = colors->stroke_u;
                                 gcxf = colors->fill_u;
                                 identifier_str[0] = 'U';
                                 break;
                             default:
-                                c = LINE_COLOR_DASH;
+                                c = colors->stroke_dash;
                                 gcx = colors->stroke_dash;
                                 gcxf = colors->fill_dash;
                                 identifier_str[0] = '-';
@@ -482,21 +798,21 @@ static void draw_hptr_trace(GwWaveView *self,
                         }
 
                         if (invert) {
-                            XXX_gdk_draw_rectangle(cr,
-                                                   gcx,
-                                                   TRUE,
-                                                   _x0 + 1,
-                                                   _y0,
-                                                   _x1 - _x0,
-                                                   _y1 - _y0 + 1);
+                            draw_batch_rectangle(batch,
+                                                 DRAW_LAYER_FILL,
+                                                 gcx,
+                                                 _x0 + 1,
+                                                 _y0,
+                                                 _x1 - _x0,
+                                                 _y1 - _y0 + 1);
                         } else {
-                            XXX_gdk_draw_rectangle(cr,
-                                                   gcxf,
-                                                   TRUE,
-                                                   _x0 + 1,
-                                                   _y1,
-                                                   _x1 - _x0,
-                                                   _y0 - _y1 + 1);
+                            draw_batch_rectangle(batch,
+                                                 DRAW_LAYER_FILL,
+                                                 gcxf,
+                                                 _x0 + 1,
+                                                 _y1,
+                                                 _x1 - _x0,
+                                                 _y0 - _y1 + 1);
                         }
 
                         if (identifier_str[0]) {
@@ -508,36 +824,36 @@ static void draw_hptr_trace(GwWaveView *self,
                                     (font_engine_string_measure(GLOBALS->wavefont, identifier_str) +
                                          GLOBALS->vector_padding <=
                                      width)) {
-                                    XXX_font_engine_draw_string(cr,
-                                                                GLOBALS->wavefont,
-                                                                &colors->value_text,
-                                                                _x0 + 2 + GLOBALS->cairo_050_offset,
-                                                                ytext + GLOBALS->cairo_050_offset,
-                                                                identifier_str);
+                                    draw_batch_text(batch,
+                                                    GLOBALS->wavefont,
+                                                    &colors->value_text,
+                                                    _x0 + 2 + GLOBALS->cairo_050_offset,
+                                                    ytext + GLOBALS->cairo_050_offset,
+                                                    identifier_str);
                                 }
                             }
                         }
 
-                        line_buffer_add(lines, c, _x0, _y0, _x1, _y0);
-                        line_buffer_add(lines, c, _x0, _y1, _x1, _y1);
+                        draw_batch_line(batch, c, _x0, _y0, _x1, _y0);
+                        draw_batch_line(batch, c, _x0, _y1, _x1, _y1);
                         if (h2tim <= GLOBALS->tims.end)
-                            line_buffer_add(lines, c, _x1, _y0, _x1, _y1);
+                            draw_batch_line(batch, c, _x1, _y0, _x1, _y1);
                         break;
 
                     case GW_BIT_Z: /* Z */
-                        line_buffer_add(lines, LINE_COLOR_MID, _x0, yu, _x1, yu);
+                        draw_batch_line(batch, colors->stroke_z, _x0, yu, _x1, yu);
                         if (h2tim <= GLOBALS->tims.end)
                             switch (h2val) {
                                 case GW_BIT_0:
                                 case GW_BIT_L:
-                                    line_buffer_add(lines, c, _x1, yu, _x1, _y0);
+                                    draw_batch_line(batch, c, _x1, yu, _x1, _y0);
                                     break;
                                 case GW_BIT_1:
                                 case GW_BIT_H:
-                                    line_buffer_add(lines, c, _x1, yu, _x1, _y1);
+                                    draw_batch_line(batch, c, _x1, yu, _x1, _y1);
                                     break;
                                 default:
-                                    line_buffer_add(lines, c, _x1, _y0, _x1, _y1);
+                                    draw_batch_line(batch, c, _x1, _y0, _x1, _y1);
                                     break;
                             }
                         break;
@@ -556,16 +872,16 @@ static void draw_hptr_trace(GwWaveView *self,
                                     g_warn_if_reached();
                                     break;
                             }
-                            XXX_gdk_draw_rectangle(cr,
-                                                   gcxf,
-                                                   TRUE,
-                                                   _x0 + 1,
-                                                   _y1,
-                                                   _x1 - _x0,
-                                                   _y0 - _y1 + 1);
+                            draw_batch_rectangle(batch,
+                                                 DRAW_LAYER_FILL,
+                                                 gcxf,
+                                                 _x0 + 1,
+                                                 _y1,
+                                                 _x1 - _x0,
+                                                 _y0 - _y1 + 1);
                         }
-                        line_buffer_add(lines,
-                                        (hval == GW_BIT_1) ? LINE_COLOR_1 : LINE_COLOR_HIGH,
+                        draw_batch_line(batch,
+                                        (hval == GW_BIT_1) ? colors->stroke_1 : colors->stroke_h,
                                         _x0,
                                         _y1,
                                         _x1,
@@ -578,13 +894,13 @@ static void draw_hptr_trace(GwWaveView *self,
 
                                 case GW_BIT_0:
                                 case GW_BIT_L:
-                                    line_buffer_add(lines, c, _x1, _y1, _x1, _y0);
+                                    draw_batch_line(batch, c, _x1, _y1, _x1, _y0);
                                     break;
                                 case GW_BIT_Z:
-                                    line_buffer_add(lines, c, _x1, _y1, _x1, yu);
+                                    draw_batch_line(batch, c, _x1, _y1, _x1, yu);
                                     break;
                                 default:
-                                    line_buffer_add(lines, c, _x1, _y0, _x1, _y1);
+                                    draw_batch_line(batch, c, _x1, _y0, _x1, _y1);
                                     break;
                             }
                         break;
@@ -594,11 +910,11 @@ static void draw_hptr_trace(GwWaveView *self,
                 }
             } else {
                 if (!is_event) {
-                    line_buffer_add(lines, LINE_COLOR_TRANS, _x1, _y0, _x1, _y1);
+                    draw_batch_line(batch, colors->stroke_transition, _x1, _y0, _x1, _y1);
                 } else {
-                    line_buffer_add(lines, LINE_COLOR_W, _x1, _y0, _x1, _y1);
-                    line_buffer_add(lines, LINE_COLOR_W, _x0, _y1, _x0 + 2, _y1 + 2);
-                    line_buffer_add(lines, LINE_COLOR_W, _x0, _y1, _x0 - 2, _y1 + 2);
+                    draw_batch_line(batch, colors->stroke_w, _x1, _y0, _x1, _y1);
+                    draw_batch_line(batch, colors->stroke_w, _x0, _y1, _x0 + 2, _y1 + 2);
+                    draw_batch_line(batch, colors->stroke_w, _x0, _y1, _x0 - 2, _y1 + 2);
                 }
                 newtime = (((gdouble)(_x1 + WAVE_OPT_SKIP)) * GLOBALS->nspx) +
                           GLOBALS->tims.start /*+GLOBALS->shift_timebase*/; /* skip to next pixel */
@@ -610,23 +926,273 @@ static void draw_hptr_trace(GwWaveView *self,
             }
 
             if ((h->flags & GW_HIST_ENT_FLAG_GLITCH) && (GLOBALS->settings.preserve_glitches)) {
-                XXX_gdk_draw_rectangle(cr, colors->stroke_z, TRUE, _x1 - 1, yu - 1, 3, 3);
+                draw_batch_rectangle(batch,
+                                     DRAW_LAYER_FILL,
+                                     colors->stroke_z,
+                                     _x1 - 1,
+                                     yu - 1,
+                                     3,
+                                     3);
             }
 
             h = h->next;
         }
 
-    line_buffer_draw(lines, cr);
-    line_buffer_free(lines);
-
     GLOBALS->tims.start += GLOBALS->shift_timebase;
     GLOBALS->tims.end += GLOBALS->shift_timebase;
 }
 
 /********************************************************************************************************/
 
+#define ANALOG_ENVELOPE_FLAGS \
+    (TR_NUMMASK | TR_ATTRIBS | TR_GRAYMASK | TR_REAL2BITS | TR_ZEROFILL | TR_ONEFILL | \
+     TR_FPDECSHIFT)
+
+static double analog_hist_ent_value(GwTrace *t, GwHistEnt *h)
+{
+    double tv = strtod("NaN", NULL);
+
+    if (h->flags & GW_HIST_ENT_FLAG_REAL) {
+        if (!(h->flags & GW_HIST_ENT_FLAG_STRING))
+            tv = h->v.h_double;
+    } else {
+        if (h->time <= GLOBALS->tims.last)
+            tv = convert_real_vec(t, h->v.h_vector);
+    }
+
+    return tv;
+}
+
+/*
+ * the history entries of a trace that are summarized by an analog envelope,
+ * GwHistEnt pointers for nodes and GwVectorEnt pointers for vectors
+ */
+typedef struct
+{
+    GwTrace *t;
+    gpointer *ents;
+    guint len;
+    GwAnalogEnvelope *envelope;
+} AnalogSamples;
+
+static GwTime analog_samples_time(const AnalogSamples *s, guint i)
+{
+    if (s->t->vector)
+        return ((GwVectorEnt *)s->ents[i])->time;
+
+    return ((GwHistEnt *)s->ents[i])->time;
+}
+
+/*
+ * number of entries up to and including the given time, bsearch_node() and
+ * bsearch_vector() clamp to the first entry and don't return an index
+ */
+static guint analog_samples_count(const AnalogSamples *s, GwTime time)
+{
+    guint lo = 0;
+    guint hi = s->len;
+
+    while (lo < hi) {
+        guint mid = lo + (hi - lo) / 2;
+
+        if (analog_samples_time(s, mid) <= time)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+static gdouble analog_trace_value(guint index, gpointer user_data)
+{
+    GwTrace *t = user_data;
+
+    if (t->vector)
+        return convert_real(t, t->n.vec->vectors[index]);
+
+    return analog_hist_ent_value(t, t->n.nd->harray[index]);
+}
+
+static gdouble analog_vector_ents_value(guint index, gpointer user_data)
+{
+    AnalogSamples *s = user_data;
+
+    return convert_real(s->t, s->ents[index]);
+}
+
+/*
+ * summarizes the entries from v up to the first one after the end time, the
+ * entries are collected in ents which has to be kept until s is no longer used
+ */
+static void analog_samples_init_for_vector_ents(AnalogSamples *s,
+                                                GwTrace *t,
+                                                GwVectorEnt *v,
+                                                GwTime end,
+                                                GPtrArray *ents)
+{
+    for (; v != NULL; v = v->next) {
+        g_ptr_array_add(ents, v);
+        if (v->time > end) {
+            break;
+        }
+    }
+
+    s->t = t;
+    s->ents = ents->pdata;
+    s->len = ents->len;
+    s->envelope = gw_analog_envelope_new(s->len, analog_vector_ents_value, s);
+}
+
+/*
+ * returns the cached min/max envelope of the analog values of a trace, which
+ * is rebuilt when the data format of the trace, the end time or the history
+ * changes. Only the summary levels are cached, the values are read from the
+ * history entries of the trace.
+ */
+static void get_analog_envelope(GwTrace *t, AnalogSamples *s)
+{
+    guint64 flags = t->flags & ANALOG_ENVELOPE_FLAGS;
+
+    s->t = t;
+    if (t->vector) {
+        s->ents = (gpointer *)t->n.vec->vectors;
+        s->len = t->n.vec->numregions;
+    } else {
+        s->ents = (gpointer *)t->n.nd->harray;
+        s->len = t->n.nd->numhist;
+    }
+
+    if (t->analog_envelope == NULL || t->analog_envelope_flags != flags ||
+        t->analog_envelope_fpdecshift != t->t_fpdecshift ||
+        t->analog_envelope_last != GLOBALS->tims.last ||
+        t->analog_envelope_samples != s->ents ||
+        gw_analog_envelope_get_length(t->analog_envelope) != s->len) {
+        g_clear_pointer(&t->analog_envelope, gw_analog_envelope_free);
+        t->analog_envelope = gw_analog_envelope_new(s->len, analog_trace_value, t);
+
+        t->analog_envelope_flags = flags;
+        t->analog_envelope_fpdecshift = t->t_fpdecshift;
+        t->analog_envelope_last = GLOBALS->tims.last;
+        t->analog_envelope_samples = s->ents;
+    }
+
+    s->envelope = t->analog_envelope;
+}
+
+/* index of the entry which is in effect at the given time */
+static guint analog_samples_index(const AnalogSamples *s, GwTime time)
+{
+    guint count = analog_samples_count(s, time);
+
+    return count > 0 ? count - 1 : 0;
+}
+
+/* range of all values between the first and last time of the dump file */
+static void get_analog_fullscale_range(const AnalogSamples *s, GwAnalogRange *range)
+{
+    gw_analog_envelope_get_range(s->envelope,
+                                 analog_samples_count(s, GLOBALS->tims.first - 1),
+                                 analog_samples_count(s, GLOBALS->tims.last),
+                                 range);
+}
+
+/* range of the values from the given start time up to the first value after the window */
+static void get_analog_visible_range(const AnalogSamples *s, GwTime start, GwAnalogRange *range)
+{
+    guint end = MIN(analog_samples_count(s, GLOBALS->tims.end) + 1,
+                    analog_samples_count(s, GLOBALS->tims.last));
+
+    gw_analog_envelope_get_range(s->envelope, analog_samples_index(s, start), end, range);
+}
+
+/* converts a value range to the offset (tmin) and scale (tmax) of the y coordinates */
+static void analog_scale_from_range(const GwAnalogRange *range,
+                                    int _y0,
+                                    int _y1,
+                                    double *tmin,
+                                    double *tmax)
+{
+    double min = 0.0;
+    double max = 0.0;
+
+    if (range->flags & GW_ANALOG_RANGE_FINITE) {
+        min = range->min;
+        max = range->max;
+    }
+
+    if (range->flags &
+        (GW_ANALOG_RANGE_POSITIVE_INFINITY | GW_ANALOG_RANGE_NEGATIVE_INFINITY)) {
+        double tdelta = (max - min) * WAVE_INF_SCALING;
+
+        if (range->flags & GW_ANALOG_RANGE_POSITIVE_INFINITY)
+            max = max + tdelta;
+        if (range->flags & GW_ANALOG_RANGE_NEGATIVE_INFINITY)
+            min = min - tdelta;
+    }
+
+    if ((max - min) < 1e-20) {
+        *tmax = 1;
+        *tmin = min - 0.5 * (_y1 - _y0);
+    } else {
+        *tmax = (_y1 - _y0) / (max - min);
+        *tmin = min;
+    }
+}
+
+/*
+ * draws the values from the start time up to the end time as a single
+ * vertical line in pixel column x, so dense analog traces only need one
+ * line per column regardless of the number of samples
+ */
+static void draw_analog_column(DrawBatch *batch,
+                               GwColor color,
+                               const AnalogSamples *s,
+                               GwTime start,
+                               GwTime end,
+                               GwTime x,
+                               int _y0,
+                               int _y1,
+                               double tmin,
+                               double tmax)
+{
+    GwAnalogRange range;
+    int ytop, ybottom;
+
+    if (x < -1 || x > GLOBALS->wavewidth + 1)
+        return;
+
+    gw_analog_envelope_get_range(s->envelope,
+                                 analog_samples_index(s, start),
+                                 analog_samples_count(s, end),
+                                 &range);
+
+    if (range.flags & GW_ANALOG_RANGE_POSITIVE_INFINITY) {
+        ytop = _y1;
+    } else if (range.flags & GW_ANALOG_RANGE_FINITE) {
+        ytop = _y0 + (range.max - tmin) * tmax;
+    } else if (range.flags & GW_ANALOG_RANGE_NEGATIVE_INFINITY) {
+        ytop = _y0;
+    } else {
+        return; /* only NaNs */
+    }
+
+    if (range.flags & GW_ANALOG_RANGE_NEGATIVE_INFINITY) {
+        ybottom = _y0;
+    } else if (range.flags & GW_ANALOG_RANGE_FINITE) {
+        ybottom = _y0 + (range.min - tmin) * tmax;
+    } else {
+        ybottom = _y1;
+    }
+
+    ytop = CLAMP(ytop, _y1, _y0);
+    ybottom = CLAMP(ybottom, _y1, _y0);
+
+    draw_batch_line(batch, color, x, ytop, x, ybottom);
+}
+
 static void draw_hptr_trace_vector_analog(GwWaveView *self,
-                                          cairo_t *cr,
+                                          DrawBatch *batch,
                                           GwWaveformColors *colors,
                                           GwTrace *t,
                                           GwHistEnt *h,
@@ -638,7 +1204,6 @@ static void draw_hptr_trace_vector_analog(GwWaveView *self,
     GwTime tim, h2tim;
     GwHistEnt *h2;
     GwHistEnt *h3;
-    int endcnt = 0;
     int type;
     /* int lasttype=-1; */ /* scan-build */
     GwColor c;
@@ -650,7 +1215,6 @@ static void draw_hptr_trace_vector_analog(GwWaveView *self,
     double tmin = mynan, tmax = mynan, tv, tv2;
     gint rmargin;
     int is_nan = 0, is_nan2 = 0, is_inf = 0, is_inf2 = 0;
-    int any_infs = 0, any_infp = 0, any_infm = 0;
     int skipcnt = 0;
 
     GwTimeRange *time_range = gw_dump_file_get_time_range(GLOBALS->dump_file);
@@ -661,61 +1225,16 @@ static void draw_hptr_trace_vector_analog(GwWaveView *self,
     _y0 = liney - 2;
     yu = (_y0 + _y1) / 2;
 
+    AnalogSamples samples;
+    GwAnalogRange range;
+
+    get_analog_envelope(t, &samples);
+
     if (t->flags & TR_ANALOG_FULLSCALE) /* otherwise use dynamic */
     {
         if ((!t->minmax_valid) || (t->d_num_ext != num_extension)) {
-            h3 = &t->n.nd->head;
-            for (;;) {
-                if (!h3)
-                    break;
-
-                if ((h3->time >= GLOBALS->tims.first) && (h3->time <= GLOBALS->tims.last)) {
-                    tv = mynan;
-                    if (h3->flags & GW_HIST_ENT_FLAG_REAL) {
-                        if (!(h3->flags & GW_HIST_ENT_FLAG_STRING))
-                            tv = h3->v.h_double;
-                    } else {
-                        if (h3->time <= GLOBALS->tims.last)
-                            tv = convert_real_vec(t, h3->v.h_vector);
-                    }
-
-                    if (!isnan(tv) && !isinf(tv)) {
-                        if (isnan(tmin) || tv < tmin)
-                            tmin = tv;
-                        if (isnan(tmax) || tv > tmax)
-                            tmax = tv;
-                    } else if (isinf(tv)) {
-                        any_infs = 1;
-
-                        if (tv > 0) {
-                            any_infp = 1;
-                        } else {
-                            any_infm = 1;
-                        }
-                    }
-                }
-                h3 = h3->next;
-            }
-
-            if (isnan(tmin) || isnan(tmax)) {
-                tmin = tmax = 0;
-            }
-
-            if (any_infs) {
-                double tdelta = (tmax - tmin) * WAVE_INF_SCALING;
-
-                if (any_infp)
-                    tmax = tmax + tdelta;
-                if (any_infm)
-                    tmin = tmin - tdelta;
-            }
-
-            if ((tmax - tmin) < 1e-20) {
-                tmax = 1;
-                tmin -= 0.5 * (_y1 - _y0);
-            } else {
-                tmax = (_y1 - _y0) / (tmax - tmin);
-            }
+            get_analog_fullscale_range(&samples, &range);
+            analog_scale_from_range(&range, _y0, _y1, &tmin, &tmax);
 
             t->minmax_valid = 1;
             t->d_minval = tmin;
@@ -726,68 +1245,8 @@ static void draw_hptr_trace_vector_analog(GwWaveView *self,
             tmax = t->d_maxval;
         }
     } else {
-        h3 = h;
-        for (;;) {
-            if (!h3)
-                break;
-            tim = (h3->time);
-            if (tim > GLOBALS->tims.end) {
-                endcnt++;
-                if (endcnt == 2)
-                    break;
-            }
-            if (tim > GLOBALS->tims.last)
-                break;
-
-            _x0 = (tim - GLOBALS->tims.start) * GLOBALS->pxns;
-            if ((_x0 > GLOBALS->wavewidth) && (endcnt == 2)) {
-                break;
-            }
-
-            tv = mynan;
-            if (h3->flags & GW_HIST_ENT_FLAG_REAL) {
-                if (!(h3->flags & GW_HIST_ENT_FLAG_STRING))
-                    tv = h3->v.h_double;
-            } else {
-                if (h3->time <= GLOBALS->tims.last)
-                    tv = convert_real_vec(t, h3->v.h_vector);
-            }
-
-            if (!isnan(tv) && !isinf(tv)) {
-                if (isnan(tmin) || tv < tmin)
-                    tmin = tv;
-                if (isnan(tmax) || tv > tmax)
-                    tmax = tv;
-            } else if (isinf(tv)) {
-                any_infs = 1;
-                if (tv > 0) {
-                    any_infp = 1;
-                } else {
-                    any_infm = 1;
-                }
-            }
-
-            h3 = h3->next;
-        }
-
-        if (isnan(tmin) || isnan(tmax))
-            tmin = tmax = 0;
-
-        if (any_infs) {
-            double tdelta = (tmax - tmin) * WAVE_INF_SCALING;
-
-            if (any_infp)
-                tmax = tmax + tdelta;
-            if (any_infm)
-                tmin = tmin - tdelta;
-        }
-
-        if ((tmax - tmin) < 1e-20) {
-            tmax = 1;
-            tmin -= 0.5 * (_y1 - _y0);
-        } else {
-            tmax = (_y1 - _y0) / (tmax - tmin);
-        }
+        get_analog_visible_range(&samples, h ? h->time : GLOBALS->tims.start, &range);
+        analog_scale_from_range(&range, _y0, _y1, &tmin, &tmax);
     }
 
     if (GLOBALS->tims.last - GLOBALS->tims.start < GLOBALS->wavewidth) {
@@ -844,23 +1303,8 @@ static void draw_hptr_trace_vector_analog(GwWaveView *self,
         type = (!(h->flags & (GW_HIST_ENT_FLAG_REAL | GW_HIST_ENT_FLAG_STRING)))
                    ? vtype(t, h->v.h_vector)
                    : GW_BIT_COUNT;
-        tv = tv2 = mynan;
-
-        if (h->flags & GW_HIST_ENT_FLAG_REAL) {
-            if (!(h->flags & GW_HIST_ENT_FLAG_STRING))
-                tv = h->v.h_double;
-        } else {
-            if (h->time <= GLOBALS->tims.last)
-                tv = convert_real_vec(t, h->v.h_vector);
-        }
-
-        if (h2->flags & GW_HIST_ENT_FLAG_REAL) {
-            if (!(h2->flags & GW_HIST_ENT_FLAG_STRING))
-                tv2 = h2->v.h_double;
-        } else {
-            if (h2->time <= GLOBALS->tims.last)
-                tv2 = convert_real_vec(t, h2->v.h_vector);
-        }
+        tv = analog_hist_ent_value(t, h);
+        tv2 = analog_hist_ent_value(t, h2);
 
         if ((is_inf = isinf(tv))) {
             if (tv < 0) {
@@ -985,63 +1429,69 @@ static void draw_hptr_trace_vector_analog(GwWaveView *self,
 
             if (is_nan || is_nan2) {
                 if (is_nan) {
-                    XXX_gdk_draw_rectangle(cr, cnan, TRUE, _x0, _y1, _x1 - _x0, _y0 - _y1);
+                    draw_batch_rectangle(batch,
+                                         DRAW_LAYER_FILL,
+                                         cnan,
+                                         _x0,
+                                         _y1,
+                                         _x1 - _x0,
+                                         _y0 - _y1);
 
                     if ((t->flags & (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) ==
                         (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) {
-                        XXX_gdk_draw_line(cr, ci, _x1 - 1, yt1, _x1 + 1, yt1);
-                        XXX_gdk_draw_line(cr, ci, _x1, yt1 - 1, _x1, yt1 + 1);
+                        draw_batch_line(batch, ci, _x1 - 1, yt1, _x1 + 1, yt1);
+                        draw_batch_line(batch, ci, _x1, yt1 - 1, _x1, yt1 + 1);
 
-                        XXX_gdk_draw_line(cr, ci, _x0 - 1, _y0, _x0 + 1, _y0);
-                        XXX_gdk_draw_line(cr, ci, _x0, _y0 - 1, _x0, _y0 + 1);
+                        draw_batch_line(batch, ci, _x0 - 1, _y0, _x0 + 1, _y0);
+                        draw_batch_line(batch, ci, _x0, _y0 - 1, _x0, _y0 + 1);
 
-                        XXX_gdk_draw_line(cr, ci, _x0 - 1, _y1, _x0 + 1, _y1);
-                        XXX_gdk_draw_line(cr, ci, _x0, _y1 - 1, _x0, _y1 + 1);
+                        draw_batch_line(batch, ci, _x0 - 1, _y1, _x0 + 1, _y1);
+                        draw_batch_line(batch, ci, _x0, _y1 - 1, _x0, _y1 + 1);
                     }
                 }
                 if (is_nan2) {
-                    XXX_gdk_draw_line(cr, cfixed, _x0, yt0, _x1, yt0);
+                    draw_batch_line(batch, cfixed, _x0, yt0, _x1, yt0);
 
                     if ((t->flags & (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) ==
                         (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) {
-                        XXX_gdk_draw_line(cr, cnan, _x1, yt1, _x1, yt0);
+                        draw_batch_line(batch, cnan, _x1, yt1, _x1, yt0);
 
-                        XXX_gdk_draw_line(cr, ci, _x1 - 1, _y0, _x1 + 1, _y0);
-                        XXX_gdk_draw_line(cr, ci, _x1, _y0 - 1, _x1, _y0 + 1);
+                        draw_batch_line(batch, ci, _x1 - 1, _y0, _x1 + 1, _y0);
+                        draw_batch_line(batch, ci, _x1, _y0 - 1, _x1, _y0 + 1);
 
-                        XXX_gdk_draw_line(cr, ci, _x1 - 1, _y1, _x1 + 1, _y1);
-                        XXX_gdk_draw_line(cr, ci, _x1, _y1 - 1, _x1, _y1 + 1);
+                        draw_batch_line(batch, ci, _x1 - 1, _y1, _x1 + 1, _y1);
+                        draw_batch_line(batch, ci, _x1, _y1 - 1, _x1, _y1 + 1);
                     }
                 }
             } else if ((t->flags & TR_ANALOG_INTERPOLATED) && !is_inf && !is_inf2) {
                 if (t->flags & TR_ANALOG_STEP) {
-                    XXX_gdk_draw_line(cr, ci, _x0 - 1, yt0, _x0 + 1, yt0);
-                    XXX_gdk_draw_line(cr, ci, _x0, yt0 - 1, _x0, yt0 + 1);
+                    draw_batch_line(batch, ci, _x0 - 1, yt0, _x0 + 1, yt0);
+                    draw_batch_line(batch, ci, _x0, yt0 - 1, _x0, yt0 + 1);
                 }
 
                 if (rmargin != GLOBALS->wavewidth) /* the window is clipped in postscript */
                 {
                     if ((yt0 == yt1) && ((_x0 > _x1) || (_x0 < 0))) {
-                        XXX_gdk_draw_line(cr, cfixed, 0, yt0, _x1, yt1);
+                        draw_batch_line(batch, cfixed, 0, yt0, _x1, yt1);
                     } else {
-                        XXX_gdk_draw_line(cr, cfixed, _x0, yt0, _x1, yt1);
+                        draw_batch_line(batch, cfixed, _x0, yt0, _x1, yt1);
                     }
                 } else {
-                    XXX_gdk_draw_line(cr, cfixed, _x0, yt0, _x1, yt1);
+                    draw_batch_line(batch, cfixed, _x0, yt0, _x1, yt1);
                 }
             } else
             /* if(t->flags & TR_ANALOG_STEP) */
             {
-                XXX_gdk_draw_line(cr, cfixed, _x0, yt0, _x1, yt0);
+                draw_batch_line(batch, cfixed, _x0, yt0, _x1, yt0);
 
                 if (is_inf2)
                     cfixed = cinf;
-                XXX_gdk_draw_line(cr, cfixed, _x1, yt0, _x1, yt1);
+                draw_batch_line(batch, cfixed, _x1, yt0, _x1, yt1);
 
                 if ((t->flags & (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) ==
                     (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) {
-                    XXX_gdk_draw_line(cr, ci, _x0 - 1, yt0, _x0 + 1, yt0);
-                    XXX_gdk_draw_line(cr, ci, _x0, yt0 - 1, _x0, yt0 + 1);
+                    draw_batch_line(batch, ci, _x0 - 1, yt0, _x0 + 1, yt0);
+                    draw_batch_line(batch, ci, _x0, yt0 - 1, _x0, yt0 + 1);
                 }
             }
         } else {
@@ -1049,6 +1499,16 @@ static void draw_hptr_trace_vector_analog(GwWaveView *self,
                       GLOBALS->tims.start /*+GLOBALS->shift_timebase*/; /* skip to next pixel */
             h3 = bsearch_node(t->n.nd, newtime);
             if (h3->time > h->time) {
+                draw_analog_column(batch,
+                                   type != GW_BIT_X ? colors->stroke_vector : colors->stroke_x,
+                                   &samples,
+                                   h->time,
+                                   newtime,
+                                   _x0,
+                                   _y0,
+                                   _y1,
+                                   tmin,
+                                   tmax);
                 h = h3;
                 /* lasttype=type; */ /* scan-build */
                 continue;
@@ -1064,7 +1524,7 @@ static void draw_hptr_trace_vector_analog(GwWaveView *self,
  * draw hptr vectors (integer+real)
  */
 static void draw_hptr_trace_vector(GwWaveView *self,
-                                   cairo_t *cr,
+                                   DrawBatch *batch,
                                    GwWaveformColors *colors,
                                    GwTrace *t,
                                    GwHistEnt *h,
@@ -1091,36 +1551,36 @@ static void draw_hptr_trace_vector(GwWaveView *self,
         (!GLOBALS->black_and_white)) {
         GwTrace *tn = GiveNextTrace(t);
         if ((t->flags & TR_ANALOGMASK) && (tn) && (tn->flags & TR_ANALOG_BLANK_STRETCH)) {
-            XXX_gdk_draw_rectangle(cr,
-                                   colors->grid,
-                                   TRUE,
-                                   0,
-                                   liney - GLOBALS->fontheight,
-                                   GLOBALS->wavewidth,
-                                   GLOBALS->fontheight);
+            draw_batch_rectangle(batch,
+                                 DRAW_LAYER_BACKGROUND,
+                                 colors->grid,
+                                 0,
+                                 liney - GLOBALS->fontheight,
+                                 GLOBALS->wavewidth,
+                                 GLOBALS->fontheight);
         } else {
-            XXX_gdk_draw_rectangle(cr,
-                                   colors->grid,
-                                   TRUE,
-                                   0,
-                                   liney - GLOBALS->fontheight,
-                                   GLOBALS->wavewidth,
-                                   GLOBALS->fontheight);
+            draw_batch_rectangle(batch,
+                                 DRAW_LAYER_BACKGROUND,
+                                 colors->grid,
+                                 0,
+                                 liney - GLOBALS->fontheight,
+                                 GLOBALS->wavewidth,
+                                 GLOBALS->fontheight);
         }
     } else if ((GLOBALS->display_grid) && (GLOBALS->enable_horiz_grid)) {
         GwTrace *tn = GiveNextTrace(t);
         if ((t->flags & TR_ANALOGMASK) && (tn) && (tn->flags & TR_ANALOG_BLANK_STRETCH)) {
         } else {
-            XXX_gdk_draw_line(cr,
-                              colors->grid,
-                              (GLOBALS->tims.start < GLOBALS->tims.first)
-                                  ? (GLOBALS->tims.first - GLOBALS->tims.start) * GLOBALS->pxns
-                                  : 0,
-                              liney,
-                              (GLOBALS->tims.last <= GLOBALS->tims.end)
-                                  ? (GLOBALS->tims.last - GLOBALS->tims.start) * GLOBALS->pxns
-                                  : GLOBALS->wavewidth - 1,
-                              liney);
+            draw_batch_line(batch,
+                            colors->grid,
+                            (GLOBALS->tims.start < GLOBALS->tims.first)
+                                ? (GLOBALS->tims.first - GLOBALS->tims.start) * GLOBALS->pxns
+                                : 0,
+                            liney,
+                            (GLOBALS->tims.last <= GLOBALS->tims.end)
+                                ? (GLOBALS->tims.last - GLOBALS->tims.start) * GLOBALS->pxns
+                                : GLOBALS->wavewidth - 1,
+                            liney);
         }
     }
 
@@ -1140,16 +1600,16 @@ static void draw_hptr_trace_vector(GwWaveView *self,
 
         if ((ext) && (GLOBALS->highlight_wavewindow) && (t) && (t->flags & TR_HIGHLIGHT) &&
             (!GLOBALS->black_and_white)) {
-            XXX_gdk_draw_rectangle(cr,
-                                   colors->grid,
-                                   TRUE,
-                                   0,
-                                   liney,
-                                   GLOBALS->wavewidth,
-                                   GLOBALS->fontheight * ext);
+            draw_batch_rectangle(batch,
+                                 DRAW_LAYER_BACKGROUND,
+                                 colors->grid,
+                                 0,
+                                 liney,
+                                 GLOBALS->wavewidth,
+                                 GLOBALS->fontheight * ext);
         }
 
-        draw_hptr_trace_vector_analog(self, cr, colors, t, h, which, ext);
+        draw_hptr_trace_vector_analog(self, batch, colors, t, h, which, ext);
         GLOBALS->tims.start += GLOBALS->shift_timebase;
         GLOBALS->tims.end += GLOBALS->shift_timebase;
         return;
@@ -1212,20 +1672,14 @@ static void draw_hptr_trace_vector(GwWaveView *self,
 
         if (_x0 != _x1) {
             if (type == GW_BIT_Z) {
-                gdouble offset = GLOBALS->cairo_050_offset;
-                XXX_gdk_set_color(cr, colors->stroke_z);
-
                 if (GLOBALS->use_roundcaps) {
-                    cairo_move_to(cr, _x0 + 1 + offset, yu + offset);
-                    cairo_line_to(cr, _x1 - 1 + offset, yu + offset);
+                    draw_batch_line(batch, colors->stroke_z, _x0 + 1, yu, _x1 - 1, yu);
                 } else {
-                    cairo_move_to(cr, _x0 + offset, yu + offset);
-                    cairo_line_to(cr, _x1 + offset, yu + offset);
+                    draw_batch_line(batch, colors->stroke_z, _x0, yu, _x1, yu);
                 }
-                cairo_stroke(cr);
             } else {
-                gdouble offset = GLOBALS->cairo_050_offset;
                 GwColor color;
+                GwColor c;
                 if (type != GW_BIT_X && type != GW_BIT_U) {
                     color = colors->stroke_vector;
                 } else {
@@ -1235,64 +1689,57 @@ static void draw_hptr_trace_vector(GwWaveView *self,
                 GwTime width = _x1 - _x0;
 
                 if (width == 1) {
-                    XXX_gdk_set_color(cr, color);
-                    cairo_move_to(cr, _x0 + offset, _y0 + offset);
-                    cairo_line_to(cr, _x0 + offset, _y1 + offset);
-                    cairo_stroke(cr);
+                    draw_batch_line(batch, color, _x0, _y0, _x0, _y1);
                 } else {
+                    c = color;
                     if (type == GW_BIT_1) {
-                        GwColor c = colors->stroke_vector;
-                        cairo_set_source_rgba(cr, c.r, c.g, c.b, c.a / 3.0);
-                    } else {
-                        XXX_gdk_set_color(cr, color);
+                        c = colors->stroke_vector;
+                        c.a /= 3.0;
                     }
 
                     if (GLOBALS->use_roundcaps) {
                         if (width > 4) {
-                            cairo_move_to(cr, _x0 + offset, yu + offset);
-                            cairo_line_to(cr, _x0 + 2 + offset, _y0 + offset);
-                            cairo_line_to(cr, _x1 - 2 + offset, _y0 + offset);
-                            cairo_line_to(cr, _x1 + offset, yu + offset);
+                            draw_batch_move_to(batch, c, _x0, yu);
+                            draw_batch_line_to(batch, c, _x0 + 2, _y0);
+                            draw_batch_line_to(batch, c, _x1 - 2, _y0);
+                            draw_batch_line_to(batch, c, _x1, yu);
                         } else {
-                            cairo_move_to(cr, _x0 + offset, yu + offset);
-                            cairo_line_to(cr, _x0 + width / 2.0 + offset, _y0 + offset);
-                            cairo_move_to(cr, _x0 + width / 2.0 + offset, _y0 + offset);
-                            cairo_line_to(cr, _x1 + offset, yu + offset);
+                            draw_batch_move_to(batch, c, _x0, yu);
+                            draw_batch_line_to(batch, c, _x0 + width / 2.0, _y0);
+                            draw_batch_move_to(batch, c, _x0 + width / 2.0, _y0);
+                            draw_batch_line_to(batch, c, _x1, yu);
                         }
                     } else {
-                        cairo_move_to(cr, _x0 + offset, yu + offset);
-                        cairo_line_to(cr, _x0 + offset, _y0 + offset);
-                        cairo_line_to(cr, _x1 + offset, _y0 + offset);
-                        cairo_line_to(cr, _x1 + offset, yu + offset);
+                        draw_batch_move_to(batch, c, _x0, yu);
+                        draw_batch_line_to(batch, c, _x0, _y0);
+                        draw_batch_line_to(batch, c, _x1, _y0);
+                        draw_batch_line_to(batch, c, _x1, yu);
                     }
-                    cairo_stroke(cr);
 
+                    c = color;
                     if (type == GW_BIT_0) {
-                        GwColor c = colors->stroke_vector;
-                        cairo_set_source_rgba(cr, c.r, c.g, c.b, c.a / 3.0);
-                    } else {
-                        XXX_gdk_set_color(cr, color);
+                        c = colors->stroke_vector;
+                        c.a /= 3.0;
                     }
 
                     if (GLOBALS->use_roundcaps) {
                         if (width > 4) {
-                            cairo_move_to(cr, _x0 + offset, yu + offset);
-                            cairo_line_to(cr, _x0 + 2 + offset, _y1 + offset);
-                            cairo_line_to(cr, _x1 - 2 + offset, _y1 + offset);
-                            cairo_line_to(cr, _x1 + offset, yu + offset);
+                            draw_batch_move_to(batch, c, _x0, yu);
+                            draw_batch_line_to(batch, c, _x0 + 2, _y1);
+                            draw_batch_line_to(batch, c, _x1 - 2, _y1);
+                            draw_batch_line_to(batch, c, _x1, yu);
                         } else {
-                            cairo_move_to(cr, _x0 + offset, yu + offset);
-                            cairo_line_to(cr, _x0 + width / 2.0 + offset, _y1 + offset);
-                            cairo_move_to(cr, _x0 + width / 2.0 + offset, _y1 + offset);
-                            cairo_line_to(cr, _x1 + offset, yu + offset);
+                            draw_batch_move_to(batch, c, _x0, yu);
+                            draw_batch_line_to(batch, c, _x0 + width / 2.0, _y1);
+                            draw_batch_move_to(batch, c, _x0 + width / 2.0, _y1);
+                            draw_batch_line_to(batch, c, _x1, yu);
                         }
                     } else {
-                        cairo_move_to(cr, _x0 + offset, yu + offset);
-                        cairo_line_to(cr, _x0 + offset, _y1 + offset);
-                        cairo_line_to(cr, _x1 + offset, _y1 + offset);
-                        cairo_line_to(cr, _x1 + offset, yu + offset);
+                        draw_batch_move_to(batch, c, _x0, yu);
+                        draw_batch_line_to(batch, c, _x0, _y1);
+                        draw_batch_line_to(batch, c, _x1, _y1);
+                        draw_batch_line_to(batch, c, _x1, yu);
                     }
-                    cairo_stroke(cr);
                 }
 
                 if (_x0 < 0)
@@ -1322,13 +1769,13 @@ static void draw_hptr_trace_vector(GwWaveView *self,
                                 ascii2 = srch_for_color + 1;
                                 if (!gw_color_equal(&colors->background, &GW_COLOR_WHITE)) {
                                     if (!GLOBALS->black_and_white)
-                                        XXX_gdk_draw_rectangle(cr,
-                                                               cb,
-                                                               TRUE,
-                                                               _x0 + 1,
-                                                               _y1 + 1,
-                                                               width - 1,
-                                                               (_y0 - 1) - (_y1 + 1) + 1);
+                                        draw_batch_rectangle(batch,
+                                                             DRAW_LAYER_FILL,
+                                                             cb,
+                                                             _x0 + 1,
+                                                             _y1 + 1,
+                                                             width - 1,
+                                                             (_y0 - 1) - (_y1 + 1) + 1);
                                 }
                                 GLOBALS->fill_in_smaller_rgb_areas_wavewindow_c_1 = 1;
                             } else {
@@ -1341,12 +1788,12 @@ static void draw_hptr_trace_vector(GwWaveView *self,
                         (font_engine_string_measure(GLOBALS->wavefont, ascii2) +
                              GLOBALS->vector_padding <=
                          width)) {
-                        XXX_font_engine_draw_string(cr,
-                                                    GLOBALS->wavefont,
-                                                    &colors->value_text,
-                                                    _x0 + 2 + GLOBALS->cairo_050_offset,
-                                                    ytext + GLOBALS->cairo_050_offset,
-                                                    ascii2);
+                        draw_batch_text(batch,
+                                        GLOBALS->wavefont,
+                                        &colors->value_text,
+                                        _x0 + 2 + GLOBALS->cairo_050_offset,
+                                        ytext + GLOBALS->cairo_050_offset,
+                                        ascii2);
                     } else {
                         char *mod;
 
@@ -1355,12 +1802,12 @@ static void draw_hptr_trace_vector(GwWaveView *self,
                             *mod = '+';
                             *(mod + 1) = 0;
 
-                            XXX_font_engine_draw_string(cr,
-                                                        GLOBALS->wavefont,
-                                                        &colors->value_text,
-                                                        _x0 + 2 + GLOBALS->cairo_050_offset,
-                                                        ytext + GLOBALS->cairo_050_offset,
-                                                        ascii2);
+                            draw_batch_text(batch,
+                                            GLOBALS->wavefont,
+                                            &colors->value_text,
+                                            _x0 + 2 + GLOBALS->cairo_050_offset,
+                                            ytext + GLOBALS->cairo_050_offset,
+                                            ascii2);
                         }
                     }
                 } else if (GLOBALS->fill_in_smaller_rgb_areas_wavewindow_c_1) {
@@ -1387,13 +1834,13 @@ static void draw_hptr_trace_vector(GwWaveView *self,
                                 /* ascii2 =  srch_for_color + 1; */ /* scan-build */
                                 if (!gw_color_equal(&colors->background, &GW_COLOR_WHITE)) {
                                     if (!GLOBALS->black_and_white)
-                                        XXX_gdk_draw_rectangle(cr,
-                                                               cb,
-                                                               TRUE,
-                                                               _x0,
-                                                               _y1 + 1,
-                                                               width,
-                                                               (_y0 - 1) - (_y1 + 1) + 1);
+                                        draw_batch_rectangle(batch,
+                                                             DRAW_LAYER_FILL,
+                                                             cb,
+                                                             _x0,
+                                                             _y1 + 1,
+                                                             width,
+                                                             (_y0 - 1) - (_y1 + 1) + 1);
                                 }
                             } else {
                                 *srch_for_color = '?'; /* replace name as color is a miss */
@@ -1428,7 +1875,7 @@ static void draw_hptr_trace_vector(GwWaveView *self,
 /********************************************************************************************************/
 
 static void draw_vptr_trace_analog(GwWaveView *self,
-                                   cairo_t *cr,
+                                   DrawBatch *batch,
                                    GwWaveformColors *colors,
                                    GwTrace *t,
                                    GwVectorEnt *v,
@@ -1441,7 +1888,6 @@ static void draw_vptr_trace_analog(GwWaveView *self,
     GwVectorEnt *h;
     GwVectorEnt *h2;
     GwVectorEnt *h3;
-    int endcnt = 0;
     int type;
     /* int lasttype=-1; */ /* scan-build */
     GwColor c;
@@ -1453,7 +1899,6 @@ static void draw_vptr_trace_analog(GwWaveView *self,
     double tmin = mynan, tmax = mynan, tv = 0.0, tv2;
     gint rmargin;
     int is_nan = 0, is_nan2 = 0, is_inf = 0, is_inf2 = 0;
-    int any_infs = 0, any_infp = 0, any_infm = 0;
     int skipcnt = 0;
 
     GwTimeRange *time_range = gw_dump_file_get_time_range(GLOBALS->dump_file);
@@ -1465,55 +1910,27 @@ static void draw_vptr_trace_analog(GwWaveView *self,
     _y0 = liney - 2;
     yu = (_y0 + _y1) / 2;
 
+    /* the entries of transaction traces don't belong to t->n.vec, so only the visible ones are
+     * summarized and not cached */
+    GPtrArray *transient_ents = NULL;
+    AnalogSamples samples;
+    GwAnalogRange range;
+
+    if (t->flags & TR_TTRANSLATED) {
+        transient_ents = g_ptr_array_new();
+        analog_samples_init_for_vector_ents(&samples, t, v, GLOBALS->tims.end, transient_ents);
+    } else {
+        get_analog_envelope(t, &samples);
+    }
+
     if (t->flags & TR_ANALOG_FULLSCALE) /* otherwise use dynamic */
     {
         if ((!t->minmax_valid) || (t->d_num_ext != num_extension)) {
-            h3 = t->n.vec->vectors[0];
-            for (;;) {
-                if (!h3)
-                    break;
+            AnalogSamples full_samples;
 
-                if ((h3->time >= GLOBALS->tims.first) && (h3->time <= GLOBALS->tims.last)) {
-                    /* tv = mynan; */ /* scan-build */
-
-                    tv = convert_real(t, h3);
-                    if (!isnan(tv) && !isinf(tv)) {
-                        if (isnan(tmin) || tv < tmin)
-                            tmin = tv;
-                        if (isnan(tmax) || tv > tmax)
-                            tmax = tv;
-                    }
-                } else if (isinf(tv)) {
-                    any_infs = 1;
-
-                    if (tv > 0) {
-                        any_infp = 1;
-                    } else {
-                        any_infm = 1;
-                    }
-                }
-
-                h3 = h3->next;
-            }
-
-            if (isnan(tmin) || isnan(tmax))
-                tmin = tmax = 0;
-
-            if (any_infs) {
-                double tdelta = (tmax - tmin) * WAVE_INF_SCALING;
-
-                if (any_infp)
-                    tmax = tmax + tdelta;
-                if (any_infm)
-                    tmin = tmin - tdelta;
-            }
-
-            if ((tmax - tmin) < 1e-20) {
-                tmax = 1;
-                tmin -= 0.5 * (_y1 - _y0);
-            } else {
-                tmax = (_y1 - _y0) / (tmax - tmin);
-            }
+            get_analog_envelope(t, &full_samples);
+            get_analog_fullscale_range(&full_samples, &range);
+            analog_scale_from_range(&range, _y0, _y1, &tmin, &tmax);
 
             t->minmax_valid = 1;
             t->d_minval = tmin;
@@ -1524,60 +1941,8 @@ static void draw_vptr_trace_analog(GwWaveView *self,
             tmax = t->d_maxval;
         }
     } else {
-        h3 = h;
-        for (;;) {
-            if (!h3)
-                break;
-            tim = (h3->time);
-
-            if (tim > GLOBALS->tims.end) {
-                endcnt++;
-                if (endcnt == 2)
-                    break;
-            }
-            if (tim > GLOBALS->tims.last)
-                break;
-
-            _x0 = (tim - GLOBALS->tims.start) * GLOBALS->pxns;
-            if ((_x0 > GLOBALS->wavewidth) && (endcnt == 2)) {
-                break;
-            }
-
-            tv = convert_real(t, h3);
-            if (!isnan(tv) && !isinf(tv)) {
-                if (isnan(tmin) || tv < tmin)
-                    tmin = tv;
-                if (isnan(tmax) || tv > tmax)
-                    tmax = tv;
-            } else if (isinf(tv)) {
-                any_infs = 1;
-                if (tv > 0) {
-                    any_infp = 1;
-                } else {
-                    any_infm = 1;
-                }
-            }
-
-            h3 = h3->next;
-        }
-        if (isnan(tmin) || isnan(tmax))
-            tmin = tmax = 0;
-
-        if (any_infs) {
-            double tdelta = (tmax - tmin) * WAVE_INF_SCALING;
-
-            if (any_infp)
-                tmax = tmax + tdelta;
-            if (any_infm)
-                tmin = tmin - tdelta;
-        }
-
-        if ((tmax - tmin) < 1e-20) {
-            tmax = 1;
-            tmin -= 0.5 * (_y1 - _y0);
-        } else {
-            tmax = (_y1 - _y0) / (tmax - tmin);
-        }
+        get_analog_visible_range(&samples, h ? h->time : GLOBALS->tims.start, &range);
+        analog_scale_from_range(&range, _y0, _y1, &tmin, &tmax);
     }
 
     if (GLOBALS->tims.last - GLOBALS->tims.start < GLOBALS->wavewidth) {
@@ -1756,63 +2121,69 @@ static void draw_vptr_trace_analog(GwWaveView *self,
 
             if (is_nan || is_nan2) {
                 if (is_nan) {
-                    XXX_gdk_draw_rectangle(cr, cnan, TRUE, _x0, _y1, _x1 - _x0, _y0 - _y1);
+                    draw_batch_rectangle(batch,
+                                         DRAW_LAYER_FILL,
+                                         cnan,
+                                         _x0,
+                                         _y1,
+                                         _x1 - _x0,
+                                         _y0 - _y1);
 
                     if ((t->flags & (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) ==
                         (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) {
-                        XXX_gdk_draw_line(cr, ci, _x1 - 1, yt1, _x1 + 1, yt1);
-                        XXX_gdk_draw_line(cr, ci, _x1, yt1 - 1, _x1, yt1 + 1);
+                        draw_batch_line(batch, ci, _x1 - 1, yt1, _x1 + 1, yt1);
+                        draw_batch_line(batch, ci, _x1, yt1 - 1, _x1, yt1 + 1);
 
-                        XXX_gdk_draw_line(cr, ci, _x0 - 1, _y0, _x0 + 1, _y0);
-                        XXX_gdk_draw_line(cr, ci, _x0, _y0 - 1, _x0, _y0 + 1);
+                        draw_batch_line(batch, ci, _x0 - 1, _y0, _x0 + 1, _y0);
+                        draw_batch_line(batch, ci, _x0, _y0 - 1, _x0, _y0 + 1);
 
-                        XXX_gdk_draw_line(cr, ci, _x0 - 1, _y1, _x0 + 1, _y1);
-                        XXX_gdk_draw_line(cr, ci, _x0, _y1 - 1, _x0, _y1 + 1);
+                        draw_batch_line(batch, ci, _x0 - 1, _y1, _x0 + 1, _y1);
+                        draw_batch_line(batch, ci, _x0, _y1 - 1, _x0, _y1 + 1);
                     }
                 }
                 if (is_nan2) {
-                    XXX_gdk_draw_line(cr, cfixed, _x0, yt0, _x1, yt0);
+                    draw_batch_line(batch, cfixed, _x0, yt0, _x1, yt0);
 
                     if ((t->flags & (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) ==
                         (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) {
-                        XXX_gdk_draw_line(cr, cnan, _x1, yt1, _x1, yt0);
+                        draw_batch_line(batch, cnan, _x1, yt1, _x1, yt0);
 
-                        XXX_gdk_draw_line(cr, ci, _x1 - 1, _y0, _x1 + 1, _y0);
-                        XXX_gdk_draw_line(cr, ci, _x1, _y0 - 1, _x1, _y0 + 1);
+                        draw_batch_line(batch, ci, _x1 - 1, _y0, _x1 + 1, _y0);
+                        draw_batch_line(batch, ci, _x1, _y0 - 1, _x1, _y0 + 1);
 
-                        XXX_gdk_draw_line(cr, ci, _x1 - 1, _y1, _x1 + 1, _y1);
-                        XXX_gdk_draw_line(cr, ci, _x1, _y1 - 1, _x1, _y1 + 1);
+                        draw_batch_line(batch, ci, _x1 - 1, _y1, _x1 + 1, _y1);
+                        draw_batch_line(batch, ci, _x1, _y1 - 1, _x1, _y1 + 1);
                     }
                 }
             } else if ((t->flags & TR_ANALOG_INTERPOLATED) && !is_inf && !is_inf2) {
                 if (t->flags & TR_ANALOG_STEP) {
-                    XXX_gdk_draw_line(cr, ci, _x0 - 1, yt0, _x0 + 1, yt0);
-                    XXX_gdk_draw_line(cr, ci, _x0, yt0 - 1, _x0, yt0 + 1);
+                    draw_batch_line(batch, ci, _x0 - 1, yt0, _x0 + 1, yt0);
+                    draw_batch_line(batch, ci, _x0, yt0 - 1, _x0, yt0 + 1);
                 }
 
                 if (rmargin != GLOBALS->wavewidth) /* the window is clipped in postscript */
                 {
                     if ((yt0 == yt1) && ((_x0 > _x1) || (_x0 < 0))) {
-                        XXX_gdk_draw_line(cr, cfixed, 0, yt0, _x1, yt1);
+                        draw_batch_line(batch, cfixed, 0, yt0, _x1, yt1);
                     } else {
-                        XXX_gdk_draw_line(cr, cfixed, _x0, yt0, _x1, yt1);
+                        draw_batch_line(batch, cfixed, _x0, yt0, _x1, yt1);
                     }
                 } else {
-                    XXX_gdk_draw_line(cr, cfixed, _x0, yt0, _x1, yt1);
+                    draw_batch_line(batch, cfixed, _x0, yt0, _x1, yt1);
                 }
             } else
             /* if(t->flags & TR_ANALOG_STEP) */
             {
-                XXX_gdk_draw_line(cr, cfixed, _x0, yt0, _x1, yt0);
+                draw_batch_line(batch, cfixed, _x0, yt0, _x1, yt0);
 
                 if (is_inf2)
                     cfixed = cinf;
-                XXX_gdk_draw_line(cr, cfixed, _x1, yt0, _x1, yt1);
+                draw_batch_line(batch, cfixed, _x1, yt0, _x1, yt1);
 
                 if ((t->flags & (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) ==
                     (TR_ANALOG_INTERPOLATED | TR_ANALOG_STEP)) {
-                    XXX_gdk_draw_line(cr, ci, _x0 - 1, yt0, _x0 + 1, yt0);
-                    XXX_gdk_draw_line(cr, ci, _x0, yt0 - 1, _x0, yt0 + 1);
+                    draw_batch_line(batch, ci, _x0 - 1, yt0, _x0 + 1, yt0);
+                    draw_batch_line(batch, ci, _x0, yt0 - 1, _x0, yt0 + 1);
                 }
             }
         } else {
@@ -1820,6 +2191,16 @@ static void draw_vptr_trace_analog(GwWaveView *self,
                       GLOBALS->tims.start /*+GLOBALS->shift_timebase*/; /* skip to next pixel */
             h3 = bsearch_vector(t->n.vec, newtime);
             if (h3->time > h->time) {
+                draw_analog_column(batch,
+                                   type != GW_BIT_X ? colors->stroke_vector : colors->stroke_x,
+                                   &samples,
+                                   h->time,
+                                   newtime,
+                                   _x0,
+                                   _y0,
+                                   _y1,
+                                   tmin,
+                                   tmax);
                 h = h3;
                 /* lasttype=type; */
                 continue;
@@ -1830,6 +2211,11 @@ static void draw_vptr_trace_analog(GwWaveView *self,
         /* lasttype=type; */
     }
 
+    if (transient_ents != NULL) {
+        gw_analog_envelope_free(samples.envelope);
+        g_ptr_array_free(transient_ents, TRUE);
+    }
+
     GLOBALS->tims.start += GLOBALS->shift_timebase;
     GLOBALS->tims.end += GLOBALS->shift_timebase;
 }
@@ -1838,7 +2224,7 @@ static void draw_vptr_trace_analog(GwWaveView *self,
  * draw vector traces
  */
 static void draw_vptr_trace(GwWaveView *self,
-                            cairo_t *cr,
+                            DrawBatch *batch,
                             GwWaveformColors *colors,
                             GwTrace *t,
                             GwVectorEnt *v,
@@ -1868,36 +2254,36 @@ static void draw_vptr_trace(GwWaveView *self,
         (!GLOBALS->black_and_white)) {
         GwTrace *tn = GiveNextTrace(t);
         if ((t->flags & TR_ANALOGMASK) && (tn) && (tn->flags & TR_ANALOG_BLANK_STRETCH)) {
-            XXX_gdk_draw_rectangle(cr,
-                                   colors->grid,
-                                   TRUE,
-                                   0,
-                                   liney - GLOBALS->fontheight,
-                                   GLOBALS->wavewidth,
-                                   GLOBALS->fontheight);
+            draw_batch_rectangle(batch,
+                                 DRAW_LAYER_BACKGROUND,
+                                 colors->grid,
+                                 0,
+                                 liney - GLOBALS->fontheight,
+                                 GLOBALS->wavewidth,
+                                 GLOBALS->fontheight);
         } else {
-            XXX_gdk_draw_rectangle(cr,
-                                   colors->grid,
-                                   TRUE,
-                                   0,
-                                   liney - GLOBALS->fontheight,
-                                   GLOBALS->wavewidth,
-                                   GLOBALS->fontheight);
+            draw_batch_rectangle(batch,
+                                 DRAW_LAYER_BACKGROUND,
+                                 colors->grid,
+                                 0,
+                                 liney - GLOBALS->fontheight,
+                                 GLOBALS->wavewidth,
+                                 GLOBALS->fontheight);
         }
     } else if ((GLOBALS->display_grid) && (GLOBALS->enable_horiz_grid)) {
         GwTrace *tn = GiveNextTrace(t);
         if ((t->flags & TR_ANALOGMASK) && (tn) && (tn->flags & TR_ANALOG_BLANK_STRETCH)) {
         } else {
-            XXX_gdk_draw_line(cr,
-                              colors->grid,
-                              (GLOBALS->tims.start < GLOBALS->tims.first)
-                                  ? (GLOBALS->tims.first - GLOBALS->tims.start) * GLOBALS->pxns
-                                  : 0,
-                              liney,
-                              (GLOBALS->tims.last <= GLOBALS->tims.end)
-                                  ? (GLOBALS->tims.last - GLOBALS->tims.start) * GLOBALS->pxns
-                                  : GLOBALS->wavewidth - 1,
-                              liney);
+            draw_batch_line(batch,
+                            colors->grid,
+                            (GLOBALS->tims.start < GLOBALS->tims.first)
+                                ? (GLOBALS->tims.first - GLOBALS->tims.start) * GLOBALS->pxns
+                                : 0,
+                            liney,
+                            (GLOBALS->tims.last <= GLOBALS->tims.end)
+                                ? (GLOBALS->tims.last - GLOBALS->tims.start) * GLOBALS->pxns
+                                : GLOBALS->wavewidth - 1,
+                            liney);
         }
     }
 
@@ -1929,16 +2315,16 @@ static void draw_vptr_trace(GwWaveView *self,
 
         if ((ext) && (GLOBALS->highlight_wavewindow) && (t) && (t->flags & TR_HIGHLIGHT) &&
             (!GLOBALS->black_and_white)) {
-            XXX_gdk_draw_rectangle(cr,
-                                   colors->grid,
-                                   TRUE,
-                                   0,
-                                   liney,
-                                   GLOBALS->wavewidth,
-                                   GLOBALS->fontheight * ext);
+            draw_batch_rectangle(batch,
+                                 DRAW_LAYER_BACKGROUND,
+                                 colors->grid,
+                                 0,
+                                 liney,
+                                 GLOBALS->wavewidth,
+                                 GLOBALS->fontheight * ext);
         }
 
-        draw_vptr_trace_analog(self, cr, colors, t, v, which, ext);
+        draw_vptr_trace_analog(self, batch, colors, t, v, which, ext);
 
         GLOBALS->tims.start += GLOBALS->shift_timebase;
         GLOBALS->tims.end += GLOBALS->shift_timebase;
@@ -2008,38 +2394,38 @@ static void draw_vptr_trace(GwWaveView *self,
             if (GLOBALS->use_roundcaps) {
                 if (type == GW_BIT_Z) {
                     if (lasttype != -1) {
-                        XXX_gdk_draw_line(cr, gltype, _x0 - 1, _y0, _x0, yu);
+                        draw_batch_line(batch, gltype, _x0 - 1, _y0, _x0, yu);
                         if (lasttype != GW_BIT_0)
-                            XXX_gdk_draw_line(cr, gltype, _x0, yu, _x0 - 1, _y1);
+                            draw_batch_line(batch, gltype, _x0, yu, _x0 - 1, _y1);
                     }
                 } else if (lasttype == GW_BIT_Z) {
-                    XXX_gdk_draw_line(cr, gtype, _x0 + 1, _y0, _x0, yu);
+                    draw_batch_line(batch, gtype, _x0 + 1, _y0, _x0, yu);
                     if (type != GW_BIT_0)
-                        XXX_gdk_draw_line(cr, gtype, _x0, yu, _x0 + 1, _y1);
+                        draw_batch_line(batch, gtype, _x0, yu, _x0 + 1, _y1);
                 } else {
                     if (lasttype != type) {
-                        XXX_gdk_draw_line(cr, gltype, _x0 - 1, _y0, _x0, yu);
+                        draw_batch_line(batch, gltype, _x0 - 1, _y0, _x0, yu);
                         if (lasttype != GW_BIT_0)
-                            XXX_gdk_draw_line(cr, gltype, _x0, yu, _x0 - 1, _y1);
-                        XXX_gdk_draw_line(cr, gtype, _x0 + 1, _y0, _x0, yu);
+                            draw_batch_line(batch, gltype, _x0, yu, _x0 - 1, _y1);
+                        draw_batch_line(batch, gtype, _x0 + 1, _y0, _x0, yu);
                         if (type != GW_BIT_0)
-                            XXX_gdk_draw_line(cr, gtype, _x0, yu, _x0 + 1, _y1);
+                            draw_batch_line(batch, gtype, _x0, yu, _x0 + 1, _y1);
                     } else {
-                        XXX_gdk_draw_line(cr, gtype, _x0 - 2, _y0, _x0 + 2, _y1);
-                        XXX_gdk_draw_line(cr, gtype, _x0 + 2, _y0, _x0 - 2, _y1);
+                        draw_batch_line(batch, gtype, _x0 - 2, _y0, _x0 + 2, _y1);
+                        draw_batch_line(batch, gtype, _x0 + 2, _y0, _x0 - 2, _y1);
                     }
                 }
             } else {
-                XXX_gdk_draw_line(cr, gtype, _x0, _y0, _x0, _y1);
+                draw_batch_line(batch, gtype, _x0, _y0, _x0, _y1);
             }
         }
 
         if (_x0 != _x1) {
             if (type == GW_BIT_Z) {
                 if (GLOBALS->use_roundcaps) {
-                    XXX_gdk_draw_line(cr, colors->stroke_z, _x0 + 1, yu, _x1 - 1, yu);
+                    draw_batch_line(batch, colors->stroke_z, _x0 + 1, yu, _x1 - 1, yu);
                 } else {
-                    XXX_gdk_draw_line(cr, colors->stroke_z, _x0, yu, _x1, yu);
+                    draw_batch_line(batch, colors->stroke_z, _x0, yu, _x1, yu);
                 }
             } else {
                 if ((type != GW_BIT_X) && (type != GW_BIT_U)) {
@@ -2049,17 +2435,17 @@ static void draw_vptr_trace(GwWaveView *self,
                 }
 
                 if (GLOBALS->use_roundcaps) {
-                    XXX_gdk_draw_line(cr, c, _x0 + 2, _y0, _x1 - 2, _y0);
+                    draw_batch_line(batch, c, _x0 + 2, _y0, _x1 - 2, _y0);
                     if (type != GW_BIT_0)
-                        XXX_gdk_draw_line(cr, c, _x0 + 2, _y1, _x1 - 2, _y1);
+                        draw_batch_line(batch, c, _x0 + 2, _y1, _x1 - 2, _y1);
                     if (type == GW_BIT_1)
-                        XXX_gdk_draw_line(cr, c, _x0 + 2, _y1 + 1, _x1 - 2, _y1 + 1);
+                        draw_batch_line(batch, c, _x0 + 2, _y1 + 1, _x1 - 2, _y1 + 1);
                 } else {
-                    XXX_gdk_draw_line(cr, c, _x0, _y0, _x1, _y0);
+                    draw_batch_line(batch, c, _x0, _y0, _x1, _y0);
                     if (type != GW_BIT_0)
-                        XXX_gdk_draw_line(cr, c, _x0, _y1, _x1, _y1);
+                        draw_batch_line(batch, c, _x0, _y1, _x1, _y1);
                     if (type == GW_BIT_1)
-                        XXX_gdk_draw_line(cr, c, _x0, _y1 + 1, _x1, _y1 + 1);
+                        draw_batch_line(batch, c, _x0, _y1 + 1, _x1, _y1 + 1);
                 }
 
                 if (_x0 < 0)
@@ -2080,13 +2466,13 @@ static void draw_vptr_trace(GwWaveView *self,
                             if (cb.a != 0.0) {
                                 ascii2 = srch_for_color + 1;
                                 if (!GLOBALS->black_and_white)
-                                    XXX_gdk_draw_rectangle(cr,
-                                                           cb,
-                                                           TRUE,
-                                                           _x0 + 1,
-                                                           _y1 + 1,
-                                                           width - 1,
-                                                           (_y0 - 1) - (_y1 + 1) + 1);
+                                    draw_batch_rectangle(batch,
+                                                         DRAW_LAYER_FILL,
+                                                         cb,
+                                                         _x0 + 1,
+                                                         _y1 + 1,
+                                                         width - 1,
+                                                         (_y0 - 1) - (_y1 + 1) + 1);
                                 GLOBALS->fill_in_smaller_rgb_areas_wavewindow_c_1 = 1;
                             } else {
                                 *srch_for_color = '?'; /* replace name as color is a miss */
@@ -2098,12 +2484,12 @@ static void draw_vptr_trace(GwWaveView *self,
                         (font_engine_string_measure(GLOBALS->wavefont, ascii2) +
                              GLOBALS->vector_padding <=
                          width)) {
-                        XXX_font_engine_draw_string(cr,
-                                                    GLOBALS->wavefont,
-                                                    &colors->value_text,
-                                                    _x0 + 2,
-                                                    ytext,
-                                                    ascii2);
+                        draw_batch_text(batch,
+                                        GLOBALS->wavefont,
+                                        &colors->value_text,
+                                        _x0 + 2,
+                                        ytext,
+                                        ascii2);
                     } else {
                         char *mod;
 
@@ -2112,12 +2498,12 @@ static void draw_vptr_trace(GwWaveView *self,
                             *mod = '+';
                             *(mod + 1) = 0;
 
-                            XXX_font_engine_draw_string(cr,
-                                                        GLOBALS->wavefont,
-                                                        &colors->value_text,
-                                                        _x0 + 2,
-                                                        ytext,
-                                                        ascii2);
+                            draw_batch_text(batch,
+                                            GLOBALS->wavefont,
+                                            &colors->value_text,
+                                            _x0 + 2,
+                                            ytext,
+                                            ascii2);
                         }
                     }
 
@@ -2137,13 +2523,13 @@ static void draw_vptr_trace(GwWaveView *self,
                                 /* ascii2 =  srch_for_color + 1; */
                                 if (!gw_color_equal(&colors->background, &GW_COLOR_WHITE)) {
                                     if (!GLOBALS->black_and_white)
-                                        XXX_gdk_draw_rectangle(cr,
-                                                               cb,
-                                                               TRUE,
-                                                               _x0,
-                                                               _y1 + 1,
-                                                               width,
-                                                               (_y0 - 1) - (_y1 + 1) + 1);
+                                        draw_batch_rectangle(batch,
+                                                             DRAW_LAYER_FILL,
+                                                             cb,
+                                                             _x0,
+                                                             _y1 + 1,
+                                                             width,
+                                                             (_y0 - 1) - (_y1 + 1) + 1);
                                 }
                             } else {
                                 *srch_for_color = '?'; /* replace name as color is a miss */
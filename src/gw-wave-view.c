@@ -444,9 +444,13 @@ static void rendertimes(GwWaveView *self, cairo_t *cr, GwWaveformColors *colors)
 
 static void rendertimebar(GwWaveView *self, cairo_t *cr, GwWaveformColors *colors)
 {
-    gint width = gtk_widget_get_allocated_width(GTK_WIDGET(self));
-
-    XXX_gdk_draw_rectangle(cr, colors->timebar_background, TRUE, 0, -1, width, GLOBALS->fontheight);
+    XXX_gdk_draw_rectangle(cr,
+                           colors->timebar_background,
+                           TRUE,
+                           0,
+                           -1,
+                           GLOBALS->wavewidth,
+                           GLOBALS->fontheight);
     rendertimes(self, cr, colors);
 }
 
@@ -499,7 +503,6 @@ static void renderblackout(GwTime start, GwTime end, gpointer user_data)
 
 typedef struct
 {
-    GwWaveView *widget;
     cairo_t *cr;
     GwColor color;
 } DrawNamedMarkerData;
@@ -521,7 +524,7 @@ static void draw_named_marker(gpointer data, gpointer user_data)
     gdouble pixstep = GLOBALS->nsperframe / GLOBALS->pixelsperframe;
     gint x = (t - GLOBALS->tims.start) / pixstep; /* snap to integer */
 
-    if (x < 0 || x > gtk_widget_get_allocated_width(GTK_WIDGET(draw_data->widget))) {
+    if (x < 0 || x > GLOBALS->wavewidth) {
         return;
     }
 
@@ -580,7 +583,6 @@ static void draw_named_markers(GwWaveView *self, cairo_t *cr, GwWaveformColors *
     (void)self;
 
     DrawNamedMarkerData data = {
-        .widget = self,
         .cr = cr,
         .color = colors->marker_named,
     };
@@ -597,6 +599,22 @@ static void draw_named_markers(GwWaveView *self, cairo_t *cr, GwWaveformColors *
     // }
 }
 
+static void render_traces_layer(GwWaveView *self, cairo_t *cr, GwWaveformColors *colors)
+{
+    cairo_set_line_width(cr, GLOBALS->cr_line_width);
+    cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+
+    GwBlackoutRegions *blackout_regions = gw_dump_file_get_blackout_regions(GLOBALS->dump_file);
+
+    RenderBlackoutData data = {.cr = cr, .colors = colors};
+    gw_blackout_regions_foreach(blackout_regions, renderblackout, &data);
+
+    if (GLOBALS->disable_antialiasing) {
+        cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
+    }
+    gw_wave_view_render_traces(self, cr);
+}
+
 static gboolean gw_wave_view_draw(GtkWidget *widget, cairo_t *cr)
 {
     GwWaveView *self = GW_WAVE_VIEW(widget);
@@ -624,7 +642,7 @@ static gboolean gw_wave_view_draw(GtkWidget *widget, cairo_t *cr)
     }
 
     if (self->dirty) {
-        // GTimer *timer = g_timer_new();
+        gint64 stats_begin = gw_stats_timer_begin();
 
         GLOBALS->tims.end = GLOBALS->tims.start + GLOBALS->nspx * GLOBALS->wavewidth;
 
@@ -635,24 +653,11 @@ static gboolean gw_wave_view_draw(GtkWidget *widget, cairo_t *cr)
         cairo_paint(traces_cr);
         cairo_set_operator(traces_cr, CAIRO_OPERATOR_OVER);
 
-        cairo_set_line_width(traces_cr, GLOBALS->cr_line_width);
-        cairo_set_line_cap(traces_cr, CAIRO_LINE_CAP_SQUARE);
-
-        GwBlackoutRegions *blackout_regions = gw_dump_file_get_blackout_regions(GLOBALS->dump_file);
-
-        RenderBlackoutData data = {.cr = traces_cr, .colors = colors};
-        gw_blackout_regions_foreach(blackout_regions, renderblackout, &data);
-
-        if (GLOBALS->disable_antialiasing) {
-            cairo_set_antialias(traces_cr, CAIRO_ANTIALIAS_NONE);
-        }
-        gw_wave_view_render_traces(self, traces_cr);
+        render_traces_layer(self, traces_cr, colors);
 
         cairo_destroy(traces_cr);
 
-        // gdouble time = g_timer_elapsed(timer, NULL);
-        // g_printerr("Draw: %f\n", time);
-        // g_timer_destroy(timer);
+        gw_stats_timer_end(GW_STATS_TIMER_RENDER, stats_begin);
 
         self->dirty = FALSE;
     }
@@ -691,6 +696,57 @@ static gboolean gw_wave_view_draw(GtkWidget *widget, cairo_t *cr)
     return FALSE;
 }
 
+/**
+ * gw_wave_view_render_offscreen:
+ * @cr: The cairo context to render to.
+ * @colors: The waveform colors.
+ * @width: The width of the rendered area.
+ * @height: The height of the rendered area.
+ *
+ * Renders the time bar, traces and markers starting with the first trace
+ * without a #GwWaveView widget, e.g. to write them to a file when there is
+ * no display.
+ */
+void gw_wave_view_render_offscreen(cairo_t *cr, GwWaveformColors *colors, gint width, gint height)
+{
+    GLOBALS->wavewidth = width;
+    GLOBALS->waveheight = height;
+    GLOBALS->tims.end = GLOBALS->tims.start + GLOBALS->nspx * GLOBALS->wavewidth;
+
+    cairo_save(cr);
+    cairo_rectangle(cr, 0, 0, width, height);
+    cairo_clip(cr);
+
+    cairo_set_source_rgba(cr,
+                          colors->background.r,
+                          colors->background.g,
+                          colors->background.b,
+                          colors->background.a);
+    cairo_paint(cr);
+
+    rendertimebar(NULL, cr, colors);
+
+    cairo_save(cr);
+    render_traces_layer(NULL, cr, colors);
+    cairo_restore(cr);
+
+    cairo_set_line_width(cr, GLOBALS->cr_line_width);
+    cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+
+    draw_marker(NULL, cr, colors);
+    draw_named_markers(NULL, cr, colors);
+
+    cairo_restore(cr);
+}
+
+static void gw_wave_view_clear_traces_surface(GwWaveView *self)
+{
+    gw_stats_counter_add(GW_STATS_COUNTER_SURFACES, -self->traces_surface_bytes);
+    self->traces_surface_bytes = 0;
+
+    g_clear_pointer(&self->traces_surface, cairo_surface_destroy);
+}
+
 static void gw_wave_view_size_allocate(GtkWidget *widget, GtkAllocation *allocation)
 {
     GwWaveView *self = GW_WAVE_VIEW(widget);
@@ -706,7 +762,7 @@ static void gw_wave_view_size_allocate(GtkWidget *widget, GtkAllocation *allocat
     GLOBALS->wavewidth = allocation->width;
     GLOBALS->waveheight = allocation->height;
 
-    g_clear_pointer(&self->traces_surface, cairo_surface_destroy);
+    gw_wave_view_clear_traces_surface(self);
 
     scale = gtk_widget_get_scale_factor(widget);
 
@@ -715,14 +771,27 @@ static void gw_wave_view_size_allocate(GtkWidget *widget, GtkAllocation *allocat
                                                                    allocation->width * scale,
                                                                    allocation->height * scale,
                                                                    scale);
+    self->traces_surface_bytes = (gint64)cairo_image_surface_get_stride(self->traces_surface) *
+                                 cairo_image_surface_get_height(self->traces_surface);
+    gw_stats_counter_add(GW_STATS_COUNTER_SURFACES, self->traces_surface_bytes);
 
     self->dirty = TRUE;
 }
 
+static void gw_wave_view_finalize(GObject *object)
+{
+    gw_wave_view_clear_traces_surface(GW_WAVE_VIEW(object));
+
+    G_OBJECT_CLASS(gw_wave_view_parent_class)->finalize(object);
+}
+
 static void gw_wave_view_class_init(GwWaveViewClass *klass)
 {
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
     GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
 
+    object_class->finalize = gw_wave_view_finalize;
+
     widget_class->configure_event = gw_wave_view_configure_event;
     widget_class->size_allocate = gw_wave_view_size_allocate;
     widget_class->draw = gw_wave_view_draw;
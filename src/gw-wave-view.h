@@ -1,6 +1,7 @@
 #pragma  once
 
 #include <gtk/gtk.h>
+#include <gtkwave.h>
 
 G_BEGIN_DECLS
 
@@ -9,5 +10,6 @@ G_DECLARE_FINAL_TYPE(GwWaveView, gw_wave_view, GW, WAVE_VIEW, GtkDrawingArea)
 
 GtkWidget *gw_wave_view_new(void);
 void gw_wave_view_force_redraw(GwWaveView *self);
+void gw_wave_view_render_offscreen(cairo_t *cr, GwWaveformColors *colors, gint width, gint height);
 
 G_END_DECLS
\ No newline at end of file
@@ -0,0 +1,656 @@
+/*
+ * gtkwave-query: answers batch queries on VCD, FST and GHW files without
+ * starting the GUI.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gtkwave.h>
+#include "wave_locale.h"
+
+typedef enum
+{
+    QUERY_INFO,
+    QUERY_LIST,
+    QUERY_VALUE,
+    QUERY_COUNT,
+    QUERY_FIRST,
+    QUERY_LAST,
+} QueryKind;
+
+typedef struct
+{
+    gchar *text; /* the query as given by the user, used in the output */
+    QueryKind kind;
+    gchar *argument; /* signal name or regular expression */
+    GwSymbol *symbol;
+    GArray *times; /* QUERY_VALUE: times to sample, otherwise the [start, end] window */
+    gchar *error;
+} Query;
+
+typedef struct
+{
+    const gchar *query;
+    const gchar *signal;
+    gboolean has_time;
+    GwTime time;
+    gchar *value;
+    gboolean has_count;
+    guint64 count;
+    const gchar *error;
+} Row;
+
+typedef enum
+{
+    FORMAT_JSON,
+    FORMAT_CSV,
+} OutputFormat;
+
+static void query_free(Query *query)
+{
+    g_free(query->text);
+    g_free(query->argument);
+    if (query->times != NULL) {
+        g_array_unref(query->times);
+    }
+    g_free(query->error);
+    g_free(query);
+}
+
+static gboolean parse_time(const gchar *str, GwTime *time)
+{
+    gint64 value;
+
+    if (!g_ascii_string_to_signed(str, 10, G_MININT64, G_MAXINT64, &value, NULL)) {
+        return FALSE;
+    }
+
+    *time = value;
+    return TRUE;
+}
+
+static Query *query_parse(const gchar *text, GwTimeRange *range)
+{
+    Query *query = g_new0(Query, 1);
+    query->text = g_strdup(text);
+
+    // The regular expression of list is taken verbatim to avoid shell style unescaping.
+    const gchar *pnt = text;
+    while (g_ascii_isspace(*pnt)) {
+        pnt++;
+    }
+    if (g_str_has_prefix(pnt, "list") && (pnt[4] == '\0' || g_ascii_isspace(pnt[4]))) {
+        query->kind = QUERY_LIST;
+        query->argument = g_strstrip(g_strdup(pnt + 4));
+        if (query->argument[0] == '\0') {
+            query->error = g_strdup("wrong number of arguments for 'list'");
+        }
+        return query;
+    }
+
+    gchar **argv = NULL;
+    gint argc = 0;
+    GError *error = NULL;
+    if (!g_shell_parse_argv(text, &argc, &argv, &error)) {
+        query->error = g_strdup(error->message);
+        g_error_free(error);
+        return query;
+    }
+
+    const gchar *command = argv[0];
+    gint min_args = 2;
+    gint max_args = 4;
+
+    if (g_strcmp0(command, "info") == 0) {
+        query->kind = QUERY_INFO;
+        min_args = max_args = 1;
+    } else if (g_strcmp0(command, "value") == 0) {
+        query->kind = QUERY_VALUE;
+        min_args = 3;
+        max_args = G_MAXINT;
+    } else if (g_strcmp0(command, "count") == 0) {
+        query->kind = QUERY_COUNT;
+    } else if (g_strcmp0(command, "first") == 0) {
+        query->kind = QUERY_FIRST;
+    } else if (g_strcmp0(command, "last") == 0) {
+        query->kind = QUERY_LAST;
+    } else {
+        query->error = g_strdup_printf("unknown query '%s'", command);
+        goto out;
+    }
+
+    if (argc < min_args || argc > max_args) {
+        query->error = g_strdup_printf("wrong number of arguments for '%s'", command);
+        goto out;
+    }
+
+    if (argc > 1) {
+        query->argument = g_strdup(argv[1]);
+    }
+
+    if (query->kind == QUERY_INFO) {
+        goto out;
+    }
+
+    query->times = g_array_new(FALSE, FALSE, sizeof(GwTime));
+    if (query->kind != QUERY_VALUE) {
+        GwTime start = gw_time_range_get_start(range);
+        GwTime end = gw_time_range_get_end(range);
+        g_array_append_val(query->times, start);
+        g_array_append_val(query->times, end);
+    }
+
+    for (gint i = 2; i < argc; i++) {
+        GwTime time;
+        if (!parse_time(argv[i], &time)) {
+            query->error = g_strdup_printf("invalid time '%s'", argv[i]);
+            goto out;
+        }
+
+        if (query->kind == QUERY_VALUE) {
+            g_array_append_val(query->times, time);
+        } else {
+            g_array_index(query->times, GwTime, i - 2) = time;
+        }
+    }
+
+out:
+    g_strfreev(argv);
+    return query;
+}
+
+static const gchar *time_dimension_to_unit(GwTimeDimension dimension)
+{
+    switch (dimension) {
+        case GW_TIME_DIMENSION_BASE:
+            return "s";
+        case GW_TIME_DIMENSION_MILLI:
+            return "ms";
+        case GW_TIME_DIMENSION_MICRO:
+            return "us";
+        case GW_TIME_DIMENSION_NANO:
+            return "ns";
+        case GW_TIME_DIMENSION_PICO:
+            return "ps";
+        case GW_TIME_DIMENSION_FEMTO:
+            return "fs";
+        case GW_TIME_DIMENSION_ATTO:
+            return "as";
+        case GW_TIME_DIMENSION_ZEPTO:
+            return "zs";
+        default:
+            return "";
+    }
+}
+
+// Makes the history of node available as an array, harray[0] is the head entry.
+static void ensure_harray(GwNode *node)
+{
+    if (node->harray != NULL) {
+        return;
+    }
+
+    gint count = 0;
+    for (GwHistEnt *iter = &node->head; iter != NULL; iter = iter->next) {
+        count++;
+    }
+
+    node->numhist = count;
+    node->harray = g_new(GwHistEnt *, count);
+
+    count = 0;
+    for (GwHistEnt *iter = &node->head; iter != NULL; iter = iter->next) {
+        node->harray[count++] = iter;
+    }
+}
+
+// Returns the index of the first history entry after the head that is at or after time (or after
+// time if inclusive is FALSE), numhist if there is none.
+static gint find_hist_index(GwNode *node, GwTime time, gboolean inclusive)
+{
+    gint lo = 1;
+    gint hi = node->numhist;
+
+    while (lo < hi) {
+        gint mid = lo + (hi - lo) / 2;
+        GwTime t = node->harray[mid]->time;
+
+        if (t < time || (!inclusive && t == time)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static gchar *hist_ent_to_string(GwNode *node, GwHistEnt *h)
+{
+    if (h->flags & GW_HIST_ENT_FLAG_STRING) {
+        return g_strdup(h->time < 0 || h->v.h_vector == NULL ? "" : h->v.h_vector);
+    } else if (h->flags & GW_HIST_ENT_FLAG_REAL) {
+        gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+        return g_strdup(g_ascii_dtostr(buf, sizeof(buf), h->v.h_double));
+    } else if (node->msi == node->lsi) {
+        return g_strnfill(1, gw_bit_to_char(h->v.h_val));
+    } else {
+        gint bits = ABS(node->msi - node->lsi) + 1;
+
+        if (h->v.h_vector == NULL) {
+            return g_strnfill(bits, 'x');
+        }
+
+        gchar *str = g_malloc(bits + 1);
+        for (gint i = 0; i < bits; i++) {
+            str[i] = gw_bit_to_char(h->v.h_vector[i]);
+        }
+        str[bits] = '\0';
+
+        return str;
+    }
+}
+
+static GwHistEnt *find_value_at(GwNode *node, GwTime time)
+{
+    ensure_harray(node);
+
+    // The last entry at or before time, the head entry if there is none.
+    gint index = find_hist_index(node, time, FALSE) - 1;
+
+    return node->harray[MAX(index, 0)];
+}
+
+static void emit_row(GArray *rows, const Row *row)
+{
+    g_array_append_vals(rows, row, 1);
+}
+
+static void evaluate_query(GwDumpFile *file, Query *query, GArray *rows)
+{
+    GwTimeRange *range = gw_dump_file_get_time_range(file);
+    Row row = {0};
+    row.query = query->text;
+
+    if (query->error != NULL) {
+        row.error = query->error;
+        emit_row(rows, &row);
+        return;
+    }
+
+    switch (query->kind) {
+        case QUERY_INFO:
+            row.value = g_strdup_printf(
+                "timescale=%" GW_TIME_FORMAT " %s timezero=%" GW_TIME_FORMAT
+                " start=%" GW_TIME_FORMAT " end=%" GW_TIME_FORMAT " signals=%u",
+                gw_dump_file_get_time_scale(file),
+                time_dimension_to_unit(gw_dump_file_get_time_dimension(file)),
+                gw_dump_file_get_global_time_offset(file),
+                gw_time_range_get_start(range),
+                gw_time_range_get_end(range),
+                gw_facs_get_length(gw_dump_file_get_facs(file)));
+            emit_row(rows, &row);
+            break;
+
+        case QUERY_LIST: {
+            GError *error = NULL;
+            GPtrArray *symbols = gw_dump_file_find_symbols(file, query->argument, &error);
+            if (symbols == NULL) {
+                query->error = g_strdup(error->message);
+                g_error_free(error);
+                row.error = query->error;
+                emit_row(rows, &row);
+                break;
+            }
+
+            row.has_count = TRUE;
+            row.count = symbols->len;
+            for (guint i = 0; i < symbols->len; i++) {
+                GwSymbol *symbol = g_ptr_array_index(symbols, i);
+                row.signal = symbol->name;
+                emit_row(rows, &row);
+            }
+            g_ptr_array_free(symbols, TRUE);
+            break;
+        }
+
+        case QUERY_VALUE:
+            row.signal = query->symbol->name;
+            row.has_time = TRUE;
+            for (guint i = 0; i < query->times->len; i++) {
+                row.time = g_array_index(query->times, GwTime, i);
+                row.value =
+                    hist_ent_to_string(query->symbol->n, find_value_at(query->symbol->n, row.time));
+                emit_row(rows, &row);
+            }
+            break;
+
+        case QUERY_COUNT:
+        case QUERY_FIRST:
+        case QUERY_LAST: {
+            GwNode *node = query->symbol->n;
+            GwTime range_start = gw_time_range_get_start(range);
+            GwTime start = MAX(g_array_index(query->times, GwTime, 0), range_start);
+            GwTime end = MIN(g_array_index(query->times, GwTime, 1), gw_time_range_get_end(range));
+            GwHistEnt *first = NULL;
+            GwHistEnt *last = NULL;
+            guint64 count = 0;
+
+            ensure_harray(node);
+
+            // The history contains sentinel entries before the start and after the end of the
+            // dump, those are outside of [start, end]. The first entry in the range is the
+            // initial value of the signal and isn't a transition.
+            gint initial = find_hist_index(node, range_start, TRUE);
+            gint lo = MAX(find_hist_index(node, start, TRUE), initial + 1);
+            gint hi = find_hist_index(node, end, FALSE) - 1;
+
+            if (start <= end && lo <= hi) {
+                first = node->harray[lo];
+                last = node->harray[hi];
+                count = hi - lo + 1;
+            }
+
+            row.signal = query->symbol->name;
+            if (query->kind == QUERY_COUNT) {
+                row.has_count = TRUE;
+                row.count = count;
+            } else {
+                GwHistEnt *h = query->kind == QUERY_FIRST ? first : last;
+                if (h != NULL) {
+                    row.has_time = TRUE;
+                    row.time = h->time;
+                    row.value = hist_ent_to_string(node, h);
+                }
+            }
+            emit_row(rows, &row);
+            break;
+        }
+    }
+}
+
+static void print_json_string(GString *out, const gchar *str)
+{
+    g_string_append_c(out, '"');
+    for (const gchar *p = str; *p != '\0'; p++) {
+        guchar c = *p;
+        switch (c) {
+            case '"':
+                g_string_append(out, "\\\"");
+                break;
+            case '\\':
+                g_string_append(out, "\\\\");
+                break;
+            case '\n':
+                g_string_append(out, "\\n");
+                break;
+            case '\t':
+                g_string_append(out, "\\t");
+                break;
+            default:
+                if (c < 0x20) {
+                    g_string_append_printf(out, "\\u%04x", c);
+                } else {
+                    g_string_append_c(out, c);
+                }
+                break;
+        }
+    }
+    g_string_append_c(out, '"');
+}
+
+static void print_csv_string(GString *out, const gchar *str)
+{
+    if (strpbrk(str, ",\"\r\n") == NULL) {
+        g_string_append(out, str);
+        return;
+    }
+
+    g_string_append_c(out, '"');
+    for (const gchar *p = str; *p != '\0'; p++) {
+        if (*p == '"') {
+            g_string_append_c(out, '"');
+        }
+        g_string_append_c(out, *p);
+    }
+    g_string_append_c(out, '"');
+}
+
+static void print_rows(GArray *rows, OutputFormat format)
+{
+    GString *out = g_string_new(NULL);
+
+    if (format == FORMAT_CSV) {
+        g_string_append(out, "query,signal,time,value,count,error\n");
+    } else {
+        g_string_append(out, "[\n");
+    }
+
+    for (guint i = 0; i < rows->len; i++) {
+        Row *row = &g_array_index(rows, Row, i);
+
+        if (format == FORMAT_CSV) {
+            print_csv_string(out, row->query);
+            g_string_append_c(out, ',');
+            print_csv_string(out, row->signal != NULL ? row->signal : "");
+            g_string_append_c(out, ',');
+            if (row->has_time) {
+                g_string_append_printf(out, "%" GW_TIME_FORMAT, row->time);
+            }
+            g_string_append_c(out, ',');
+            print_csv_string(out, row->value != NULL ? row->value : "");
+            g_string_append_c(out, ',');
+            if (row->has_count) {
+                g_string_append_printf(out, "%" G_GUINT64_FORMAT, row->count);
+            }
+            g_string_append_c(out, ',');
+            print_csv_string(out, row->error != NULL ? row->error : "");
+            g_string_append_c(out, '\n');
+        } else {
+            g_string_append(out, "  {\"query\": ");
+            print_json_string(out, row->query);
+            if (row->signal != NULL) {
+                g_string_append(out, ", \"signal\": ");
+                print_json_string(out, row->signal);
+            }
+            if (row->has_time) {
+                g_string_append_printf(out, ", \"time\": %" GW_TIME_FORMAT, row->time);
+            }
+            if (row->value != NULL) {
+                g_string_append(out, ", \"value\": ");
+                print_json_string(out, row->value);
+            }
+            if (row->has_count) {
+                g_string_append_printf(out, ", \"count\": %" G_GUINT64_FORMAT, row->count);
+            }
+            if (row->error != NULL) {
+                g_string_append(out, ", \"error\": ");
+                print_json_string(out, row->error);
+            }
+            g_string_append(out, i + 1 < rows->len ? "},\n" : "}\n");
+        }
+    }
+
+    if (format == FORMAT_JSON) {
+        g_string_append(out, "]\n");
+    }
+
+    fwrite(out->str, 1, out->len, stdout);
+    g_string_free(out, TRUE);
+}
+
+static GwLoader *create_loader(const gchar *filename)
+{
+    if (g_str_has_suffix(filename, ".fst")) {
+        return gw_fst_loader_new();
+    } else if (g_str_has_suffix(filename, ".ghw") || g_str_has_suffix(filename, ".ghw.gz") ||
+               g_str_has_suffix(filename, ".ghw.bz2")) {
+        return gw_ghw_loader_new();
+    } else {
+        return gw_vcd_loader_new();
+    }
+}
+
+static void read_queries(const gchar *path, GPtrArray *texts)
+{
+    gchar *contents = NULL;
+    GError *error = NULL;
+
+    if (g_strcmp0(path, "-") == 0) {
+        GString *str = g_string_new(NULL);
+        gchar buf[4096];
+        gsize len;
+        while ((len = fread(buf, 1, sizeof(buf), stdin)) > 0) {
+            g_string_append_len(str, buf, len);
+        }
+        contents = g_string_free(str, FALSE);
+    } else if (!g_file_get_contents(path, &contents, NULL, &error)) {
+        g_printerr("gtkwave-query: %s\n", error->message);
+        exit(EXIT_FAILURE);
+    }
+
+    gchar **lines = g_strsplit(contents, "\n", -1);
+    for (gchar **line = lines; *line != NULL; line++) {
+        g_strstrip(*line);
+        if ((*line)[0] != '\0' && (*line)[0] != '#') {
+            g_ptr_array_add(texts, g_strdup(*line));
+        }
+    }
+    g_strfreev(lines);
+    g_free(contents);
+}
+
+int main(int argc, char *argv[])
+{
+    gchar *format_name = NULL;
+    gchar *query_file = NULL;
+    gchar **remaining = NULL;
+    GError *error = NULL;
+
+    WAVE_LOCALE_FIX
+
+    GOptionEntry entries[] = {
+        {"format", 'f', 0, G_OPTION_ARG_STRING, &format_name, "Output format", "json|csv"},
+        {"queries", 'q', 0, G_OPTION_ARG_FILENAME, &query_file, "Read queries from FILE", "FILE"},
+        {G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_STRING_ARRAY, &remaining, NULL, NULL},
+        G_OPTION_ENTRY_NULL};
+
+    GOptionContext *context = g_option_context_new("DUMPFILE [QUERY...]");
+    g_option_context_set_summary(context,
+                                 "Queries:\n"
+                                 "  info                       time scale, time zero, time range "
+                                 "and signal count\n"
+                                 "  list REGEX                 signals matching REGEX\n"
+                                 "  value SIGNAL TIME...       value of SIGNAL at each TIME\n"
+                                 "  count SIGNAL [START [END]] number of transitions\n"
+                                 "  first SIGNAL [START [END]] first transition\n"
+                                 "  last SIGNAL [START [END]]  last transition");
+    g_option_context_add_main_entries(context, entries, NULL);
+
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        g_printerr("gtkwave-query: %s\n", error->message);
+        exit(EXIT_FAILURE);
+    }
+
+    OutputFormat format = FORMAT_JSON;
+    if (format_name != NULL && g_ascii_strcasecmp(format_name, "csv") == 0) {
+        format = FORMAT_CSV;
+    } else if (format_name != NULL && g_ascii_strcasecmp(format_name, "json") != 0) {
+        g_printerr("gtkwave-query: unknown output format '%s'\n", format_name);
+        exit(EXIT_FAILURE);
+    }
+
+    if (remaining == NULL || remaining[0] == NULL) {
+        gchar *help = g_option_context_get_help(context, TRUE, NULL);
+        g_printerr("%s", help);
+        g_free(help);
+        exit(EXIT_FAILURE);
+    }
+    g_option_context_free(context);
+
+    GPtrArray *texts = g_ptr_array_new_with_free_func(g_free);
+    for (gchar **iter = remaining + 1; *iter != NULL; iter++) {
+        g_ptr_array_add(texts, g_strdup(*iter));
+    }
+    if (query_file != NULL) {
+        read_queries(query_file, texts);
+    }
+    if (texts->len == 0) {
+        g_ptr_array_add(texts, g_strdup("info"));
+    }
+
+    GwLoader *loader = create_loader(remaining[0]);
+    GwDumpFile *file = gw_loader_load(loader, remaining[0], &error);
+    g_object_unref(loader);
+    if (file == NULL) {
+        g_printerr("gtkwave-query: couldn't load %s: %s\n", remaining[0], error->message);
+        exit(EXIT_FAILURE);
+    }
+
+    // Not all loaders sort the facs, so a name table is used instead of gw_facs_lookup().
+    GwFacs *facs = gw_dump_file_get_facs(file);
+    GHashTable *symbols = g_hash_table_new(g_str_hash, g_str_equal);
+    for (guint i = 0; i < gw_facs_get_length(facs); i++) {
+        GwSymbol *symbol = gw_facs_get(facs, i);
+        g_hash_table_insert(symbols, symbol->name, symbol);
+    }
+
+    // Resolve all signals first, so that their traces can be imported in a single pass.
+    GwTimeRange *range = gw_dump_file_get_time_range(file);
+    GPtrArray *queries = g_ptr_array_new_with_free_func((GDestroyNotify)query_free);
+    GHashTable *nodes = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    for (guint i = 0; i < texts->len; i++) {
+        Query *query = query_parse(g_ptr_array_index(texts, i), range);
+        g_ptr_array_add(queries, query);
+
+        if (query->error != NULL || query->kind == QUERY_INFO || query->kind == QUERY_LIST) {
+            continue;
+        }
+
+        query->symbol = g_hash_table_lookup(symbols, query->argument);
+        if (query->symbol == NULL) {
+            query->error = g_strdup_printf("unknown signal '%s'", query->argument);
+            continue;
+        }
+        g_hash_table_add(nodes, query->symbol->n);
+    }
+
+    if (g_hash_table_size(nodes) > 0) {
+        guint n_nodes = 0;
+        GwNode **node_array = (GwNode **)g_hash_table_get_keys_as_array(nodes, &n_nodes);
+        if (!gw_dump_file_import_traces(file, node_array, &error)) {
+            g_printerr("gtkwave-query: couldn't import traces: %s\n", error->message);
+            exit(EXIT_FAILURE);
+        }
+        g_free(node_array);
+    }
+    g_hash_table_destroy(nodes);
+    g_hash_table_destroy(symbols);
+
+    GArray *rows = g_array_new(FALSE, TRUE, sizeof(Row));
+    for (guint i = 0; i < queries->len; i++) {
+        evaluate_query(file, g_ptr_array_index(queries, i), rows);
+    }
+
+    print_rows(rows, format);
+
+    gboolean has_errors = FALSE;
+    for (guint i = 0; i < rows->len; i++) {
+        Row *row = &g_array_index(rows, Row, i);
+        has_errors |= row->error != NULL;
+        g_free(row->value);
+    }
+    g_array_unref(rows);
+
+    g_ptr_array_free(queries, TRUE);
+    g_ptr_array_free(texts, TRUE);
+    g_object_unref(file);
+    g_strfreev(remaining);
+    g_free(format_name);
+    g_free(query_file);
+
+    return has_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -26,6 +26,7 @@
 #include <getopt.h>
 #endif
 
+#include <glib.h>
 #include <fstapi.h>
 #include "../../contrib/rtlbrowse/jrb.h"
 #include "wave_locale.h"
@@ -53,6 +54,8 @@
 #define VCD2FST_EXTLOADERS_CONV
 #endif
 
+static uint64_t bytes_in = 0;
+
 static uint32_t var_direction_idx = 0;
 static unsigned char *var_direction = NULL;
 
@@ -371,6 +374,8 @@ static inline int getline_replace(char **wbuf, char **buf, size_t *len, FILE *f)
         *len = 2 * (*len);
     }
 
+    bytes_in += strlen(*wbuf);
+
     *buf = *wbuf;
     while (*(buf)[0] == ' ') {
         (*buf)++;
@@ -383,7 +388,15 @@ static inline int getline_replace(char **wbuf, char **buf, size_t *len, FILE *f)
     }
 }
 
-JRB vcd_ids = NULL;
+struct vcd2fst_id
+{
+    fstHandle handle;
+    int len;
+};
+
+static GHashTable *vcd_ids = NULL; /* vcdid hash -> struct vcd2fst_id */
+static struct vcd2fst_id *vcd_id_array = NULL; /* direct lookup when the vcdids are dense */
+static unsigned int vcd_id_max = 0;
 
 static unsigned int vcdid_hash(char *s, int len)
 {
@@ -404,6 +417,582 @@ int pack_type = FST_WR_PT_LZ4; /* set to fstWriterPackType */
 int compression_explicitly_set = 0;
 int repack_all = 0; /* 0 is normal, 1 does the repack (via fstapi) at end */
 int parallel_mode = 0; /* 0 is is single threaded, 1 is multi-threaded */
+int num_threads = 1; /* number of value change parser threads */
+int print_stats = 0; /* 1 prints the conversion rate to stderr */
+
+/*
+ * Value change section: the input is read in large chunks which are split at
+ * line boundaries (preferably in front of a timestamp). Each chunk is parsed
+ * into a compact list of writer operations, which can be done in parallel by
+ * several parser threads. The operations are then replayed into the FST writer
+ * in chunk order, so the output is identical to a single threaded conversion.
+ */
+
+#define VCD2FST_CHUNK_SIZE (4 * 1024 * 1024)
+
+/* the VCD2FST_CHUNK_SIZE environment variable overrides it so tests can split small files */
+static size_t chunk_size = VCD2FST_CHUNK_SIZE;
+
+enum vcd2fst_op
+{
+    VCD2FST_OP_TIME,
+    VCD2FST_OP_VALUE,
+    VCD2FST_OP_VARLEN,
+    VCD2FST_OP_REAL,
+    VCD2FST_OP_DUMPON,
+    VCD2FST_OP_DUMPOFF
+};
+
+struct vcd2fst_chunk
+{
+    uint64_t seq;
+    int is_eof;
+
+    char *data; /* VCD text, zero terminated */
+    size_t data_len;
+    size_t data_alloc;
+
+    unsigned char *out; /* encoded writer operations */
+    size_t out_len;
+    size_t out_alloc;
+
+    uint64_t value_changes;
+};
+
+struct vcd2fst_pipeline
+{
+    FILE *f;
+    void *ctx;
+
+    char *carry; /* partial line left over from the previous chunk */
+    size_t carry_len;
+    size_t carry_alloc;
+
+    GAsyncQueue *free_chunks;
+    GAsyncQueue *parse_queue;
+    GAsyncQueue *emit_queue;
+
+    uint64_t prev_tim;
+    uint64_t value_changes;
+};
+
+static struct vcd2fst_chunk vcd2fst_stop; /* tells parser threads to exit */
+
+static inline const struct vcd2fst_id *vcd2fst_find_id(const char *s, int len)
+{
+    unsigned int hash = vcdid_hash((char *)s, len);
+
+    if (vcd_id_array) {
+        return ((hash > 0) && (hash <= vcd_id_max)) ? &vcd_id_array[hash] : NULL;
+    }
+
+    return (g_hash_table_lookup(vcd_ids, GUINT_TO_POINTER(hash)));
+}
+
+static unsigned char *vcd2fst_chunk_reserve(struct vcd2fst_chunk *c, size_t len)
+{
+    if (c->out_len + len > c->out_alloc) {
+        c->out_alloc = MAX(c->out_alloc * 2, c->out_len + len);
+        c->out = realloc_2(c->out, c->out_alloc);
+    }
+
+    return (c->out + c->out_len);
+}
+
+static void vcd2fst_put_op(struct vcd2fst_chunk *c, unsigned char op)
+{
+    *vcd2fst_chunk_reserve(c, 1) = op;
+    c->out_len++;
+}
+
+static void vcd2fst_put_time(struct vcd2fst_chunk *c, uint64_t tim)
+{
+    unsigned char *p = vcd2fst_chunk_reserve(c, 1 + sizeof(uint64_t));
+
+    *p = VCD2FST_OP_TIME;
+    memcpy(p + 1, &tim, sizeof(uint64_t));
+    c->out_len += 1 + sizeof(uint64_t);
+}
+
+static void vcd2fst_put_real(struct vcd2fst_chunk *c, fstHandle handle, double doub)
+{
+    unsigned char *p = vcd2fst_chunk_reserve(c, 1 + sizeof(fstHandle) + sizeof(double));
+
+    *p = VCD2FST_OP_REAL;
+    memcpy(p + 1, &handle, sizeof(fstHandle));
+    memcpy(p + 1 + sizeof(fstHandle), &doub, sizeof(double));
+    c->out_len += 1 + sizeof(fstHandle) + sizeof(double);
+    c->value_changes++;
+}
+
+/* returns a buffer of len bytes (plus terminating zero) which receives the value */
+static char *vcd2fst_put_value_buffer(struct vcd2fst_chunk *c,
+                                      unsigned char op,
+                                      fstHandle handle,
+                                      uint32_t len)
+{
+    size_t rec_len = 1 + sizeof(fstHandle) + sizeof(uint32_t) + len + 1;
+    unsigned char *p = vcd2fst_chunk_reserve(c, rec_len);
+
+    *p = op;
+    memcpy(p + 1, &handle, sizeof(fstHandle));
+    memcpy(p + 1 + sizeof(fstHandle), &len, sizeof(uint32_t));
+    p += 1 + sizeof(fstHandle) + sizeof(uint32_t);
+    p[len] = 0;
+
+    c->out_len += rec_len;
+    c->value_changes++;
+
+    return ((char *)p);
+}
+
+static void vcd2fst_put_value(struct vcd2fst_chunk *c,
+                              const struct vcd2fst_id *id,
+                              const char *val,
+                              int val_len,
+                              int left_extend)
+{
+    int len = id->len;
+    char *dst;
+
+    if (val_len > len) {
+        /* too many bits, the rightmost ones are kept */
+        val += val_len - len;
+        val_len = len;
+    }
+
+    dst = vcd2fst_put_value_buffer(c, VCD2FST_OP_VALUE, id->handle, len);
+
+    if (val_len == len) {
+        memcpy(dst, val, val_len);
+    } else if (left_extend) {
+        int delta = len - val_len;
+
+        memset(dst, val[0] != '1' ? val[0] : '0', delta);
+        memcpy(dst + delta, val, val_len);
+    } else {
+        memcpy(dst, val, val_len);
+        memset(dst + val_len, 0, len - val_len);
+    }
+}
+
+static void vcd2fst_parse_line(struct vcd2fst_chunk *c, char *buf, char *nl)
+{
+    const struct vcd2fst_id *id;
+    char *sp;
+    double doub;
+
+    switch (buf[0]) {
+        case '0':
+        case '1':
+        case 'x':
+        case 'z':
+        case 'h':
+        case 'u':
+        case 'w':
+        case 'l':
+        case '-':
+            id = vcd2fst_find_id(buf + 1, nl - (buf + 1));
+            if (id) {
+                vcd2fst_put_value(c, id, buf, 1, 1);
+            }
+            break;
+
+        case 'b': /* as the odds are the VCD ID will be small compared to the vector length */
+            sp = NULL;
+            {
+                char *sp_scan = nl;
+
+                while (buf != --sp_scan) {
+                    if (*sp_scan == ' ') {
+                        sp = sp_scan;
+                        break;
+                    }
+                }
+            }
+
+            if (!sp)
+                break;
+            *sp = 0;
+            id = vcd2fst_find_id(sp + 1, nl - (sp + 1));
+            if (id) {
+                vcd2fst_put_value(c, id, buf + 1, sp - (buf + 1), 1);
+            }
+            break;
+
+        case 's':
+            sp = strchr(buf, ' ');
+            if (!sp)
+                break;
+            *sp = 0;
+            id = vcd2fst_find_id(sp + 1, nl - (sp + 1));
+            if (id) {
+                int bin_len = sp - (buf + 1); /* strlen(buf+1) */
+                char *dst;
+
+                bin_len = fstUtilityEscToBin(NULL, (unsigned char *)(buf + 1), bin_len);
+                dst = vcd2fst_put_value_buffer(c, VCD2FST_OP_VARLEN, id->handle, bin_len);
+                memcpy(dst, buf + 1, bin_len);
+            }
+            break;
+
+        case 'p': {
+            /* collapse whitespace in place, the result is never longer than the source */
+            char *src = buf + 1;
+            char *pnt = buf + 1;
+            int pchar = 0;
+
+            for (;;) {
+                if (!*src)
+                    break;
+                if (isspace((int)(unsigned char)*src)) {
+                    if (pchar != ' ') {
+                        *(pnt++) = pchar = ' ';
+                    }
+                    src++;
+                    continue;
+                }
+                *(pnt++) = pchar = *(src++);
+            }
+            *pnt = 0;
+
+            sp = strchr(buf + 1, ' ');
+            if (!sp)
+                break;
+            sp = strchr(sp + 1, ' ');
+            if (!sp)
+                break;
+            sp = strchr(sp + 1, ' ');
+            if (!sp)
+                break;
+            *sp = 0;
+
+            id = vcd2fst_find_id(sp + 1, strlen(sp + 1)); /* nl is no longer good here */
+            if (id) {
+                vcd2fst_put_value(c, id, buf + 1, sp - (buf + 1), 0);
+            }
+        } break;
+
+        case 'r':
+            sp = strchr(buf, ' ');
+            if (!sp)
+                break;
+            id = vcd2fst_find_id(sp + 1, nl - (sp + 1));
+            if (id) {
+                sscanf(buf + 1, "%lg", &doub);
+                vcd2fst_put_real(c, id->handle, doub);
+            }
+            break;
+
+        case '#':
+            vcd2fst_put_time(c, atoi_2((unsigned char *)(buf + 1)));
+            break;
+
+        default:
+            if (!strncmp(buf, "$dumpon", 7)) {
+                vcd2fst_put_op(c, VCD2FST_OP_DUMPON);
+            } else if (!strncmp(buf, "$dumpoff", 8)) {
+                vcd2fst_put_op(c, VCD2FST_OP_DUMPOFF);
+            } else if (!strncmp(buf, "$dumpvars", 9)) {
+                /* nothing */
+            } else {
+                /* printf("FST '%s'\n", buf); */
+            }
+            break;
+    }
+}
+
+static void vcd2fst_parse_chunk(struct vcd2fst_chunk *c)
+{
+    char *pnt = c->data;
+    char *end = c->data + c->data_len;
+
+    c->out_len = 0;
+    c->value_changes = 0;
+
+    while (pnt < end) {
+        char *buf = pnt;
+        char *nl = memchr(pnt, '\n', end - pnt);
+
+        if (!nl) {
+            nl = end;
+        }
+        pnt = nl + 1;
+
+        *nl = 0;
+        if ((nl != buf) && (*(nl - 1) == '\r')) {
+            *(--nl) = 0;
+        }
+
+        while (*buf == ' ') {
+            buf++;
+        } /* verilator leading spaces fix */
+
+        vcd2fst_parse_line(c, buf, nl);
+    }
+}
+
+/* returns 0 when no more data is available */
+static int vcd2fst_read_chunk(struct vcd2fst_pipeline *p, struct vcd2fst_chunk *c)
+{
+    size_t len = p->carry_len;
+
+    if (c->data_alloc < len + chunk_size + 1) {
+        c->data_alloc = len + chunk_size + 1;
+        c->data = realloc_2(c->data, c->data_alloc);
+    }
+
+    if (len) {
+        memcpy(c->data, p->carry, len);
+        p->carry_len = 0;
+    }
+
+    for (;;) {
+        size_t rd = fread(c->data + len, 1, c->data_alloc - 1 - len, p->f);
+        size_t split;
+        char *pnt;
+
+        len += rd;
+        bytes_in += rd;
+
+        if (feof(p->f) || ferror(p->f)) {
+            c->data_len = len;
+            c->data[len] = 0;
+            return (len != 0);
+        }
+
+        /* split in front of the last timestamp, fall back to the last complete line */
+        split = 0;
+        for (pnt = c->data + len - 1; pnt > c->data; pnt--) {
+            if ((*pnt == '#') && (*(pnt - 1) == '\n')) {
+                split = pnt - c->data;
+                break;
+            }
+        }
+        if (!split) {
+            for (pnt = c->data + len - 1; pnt >= c->data; pnt--) {
+                if (*pnt == '\n') {
+                    split = pnt - c->data + 1;
+                    break;
+                }
+            }
+        }
+
+        if (split) {
+            p->carry_len = len - split;
+            if (p->carry_len > p->carry_alloc) {
+                p->carry_alloc = p->carry_len;
+                p->carry = realloc_2(p->carry, p->carry_alloc);
+            }
+            memcpy(p->carry, c->data + split, p->carry_len);
+
+            c->data_len = split;
+            c->data[split] = 0;
+            return (1);
+        }
+
+        /* a single line longer than the chunk */
+        c->data_alloc = c->data_alloc * 2;
+        c->data = realloc_2(c->data, c->data_alloc);
+    }
+}
+
+static void vcd2fst_emit_chunk(struct vcd2fst_pipeline *p, struct vcd2fst_chunk *c)
+{
+    const unsigned char *pnt = c->out;
+    const unsigned char *end = c->out + c->out_len;
+
+    while (pnt < end) {
+        unsigned char op = *(pnt++);
+        fstHandle handle;
+        uint32_t len;
+        uint64_t tim;
+        double doub;
+
+        switch (op) {
+            case VCD2FST_OP_TIME:
+                memcpy(&tim, pnt, sizeof(uint64_t));
+                pnt += sizeof(uint64_t);
+                if ((tim >= p->prev_tim) || (!p->prev_tim)) {
+                    p->prev_tim = tim;
+                    fstWriterEmitTimeChange(p->ctx, tim);
+                }
+                break;
+
+            case VCD2FST_OP_VALUE:
+            case VCD2FST_OP_VARLEN:
+                memcpy(&handle, pnt, sizeof(fstHandle));
+                pnt += sizeof(fstHandle);
+                memcpy(&len, pnt, sizeof(uint32_t));
+                pnt += sizeof(uint32_t);
+                if (op == VCD2FST_OP_VALUE) {
+                    fstWriterEmitValueChange(p->ctx, handle, pnt);
+                } else {
+                    fstWriterEmitVariableLengthValueChange(p->ctx, handle, pnt, len);
+                }
+                pnt += len + 1;
+                break;
+
+            case VCD2FST_OP_REAL:
+                memcpy(&handle, pnt, sizeof(fstHandle));
+                pnt += sizeof(fstHandle);
+                memcpy(&doub, pnt, sizeof(double));
+                pnt += sizeof(double);
+                fstWriterEmitValueChange(p->ctx, handle, &doub);
+                break;
+
+            case VCD2FST_OP_DUMPON:
+                fstWriterEmitDumpActive(p->ctx, 1);
+                break;
+
+            case VCD2FST_OP_DUMPOFF:
+                fstWriterEmitDumpActive(p->ctx, 0);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    p->value_changes += c->value_changes;
+}
+
+static gpointer vcd2fst_reader_thread(gpointer data)
+{
+    struct vcd2fst_pipeline *p = data;
+    uint64_t seq;
+
+    for (seq = 0;; seq++) {
+        struct vcd2fst_chunk *c = g_async_queue_pop(p->free_chunks);
+
+        c->seq = seq;
+        c->is_eof = !vcd2fst_read_chunk(p, c);
+        if (c->is_eof) {
+            c->data_len = 0;
+        }
+
+        g_async_queue_push(p->parse_queue, c);
+        if (c->is_eof) {
+            break;
+        }
+    }
+
+    return (NULL);
+}
+
+static gpointer vcd2fst_parser_thread(gpointer data)
+{
+    struct vcd2fst_pipeline *p = data;
+
+    for (;;) {
+        struct vcd2fst_chunk *c = g_async_queue_pop(p->parse_queue);
+
+        if (c == &vcd2fst_stop) {
+            break;
+        }
+
+        vcd2fst_parse_chunk(c);
+        g_async_queue_push(p->emit_queue, c);
+    }
+
+    return (NULL);
+}
+
+/* converts the value change section, returns the number of value changes */
+static uint64_t vcd2fst_convert_body(void *ctx, FILE *f, int threads)
+{
+    struct vcd2fst_pipeline p;
+    struct vcd2fst_chunk *chunks;
+    int num_chunks;
+    int i;
+
+    memset(&p, 0, sizeof(struct vcd2fst_pipeline));
+    p.f = f;
+    p.ctx = ctx;
+
+    if (threads <= 1) {
+        struct vcd2fst_chunk c;
+
+        memset(&c, 0, sizeof(struct vcd2fst_chunk));
+        while (vcd2fst_read_chunk(&p, &c)) {
+            vcd2fst_parse_chunk(&c);
+            vcd2fst_emit_chunk(&p, &c);
+        }
+
+        free(c.data);
+        free(c.out);
+        free(p.carry);
+        return (p.value_changes);
+    }
+
+    /* the number of chunks in flight bounds the memory used by the pipeline */
+    num_chunks = threads * 2 + 2;
+    chunks = calloc(num_chunks, sizeof(struct vcd2fst_chunk));
+    {
+        struct vcd2fst_chunk **pending = calloc(num_chunks, sizeof(struct vcd2fst_chunk *));
+        GThread **parsers = calloc(threads, sizeof(GThread *));
+        GThread *reader;
+        uint64_t next_seq = 0;
+
+        p.free_chunks = g_async_queue_new();
+        p.parse_queue = g_async_queue_new();
+        p.emit_queue = g_async_queue_new();
+
+        for (i = 0; i < num_chunks; i++) {
+            g_async_queue_push(p.free_chunks, &chunks[i]);
+        }
+
+        for (i = 0; i < threads; i++) {
+            parsers[i] = g_thread_new("vcd2fst-parse", vcd2fst_parser_thread, &p);
+        }
+        reader = g_thread_new("vcd2fst-read", vcd2fst_reader_thread, &p);
+
+        /* FST writer calls stay on this thread, chunks are emitted in input order */
+        for (;;) {
+            struct vcd2fst_chunk *c;
+            int slot = next_seq % num_chunks;
+
+            while (!pending[slot]) {
+                c = g_async_queue_pop(p.emit_queue);
+                pending[c->seq % num_chunks] = c;
+            }
+
+            c = pending[slot];
+            pending[slot] = NULL;
+            next_seq++;
+
+            if (c->is_eof) {
+                break;
+            }
+
+            vcd2fst_emit_chunk(&p, c);
+            g_async_queue_push(p.free_chunks, c);
+        }
+
+        g_thread_join(reader);
+        for (i = 0; i < threads; i++) {
+            g_async_queue_push(p.parse_queue, &vcd2fst_stop);
+        }
+        for (i = 0; i < threads; i++) {
+            g_thread_join(parsers[i]);
+        }
+
+        g_async_queue_unref(p.free_chunks);
+        g_async_queue_unref(p.parse_queue);
+        g_async_queue_unref(p.emit_queue);
+        free(parsers);
+        free(pending);
+    }
+
+    for (i = 0; i < num_chunks; i++) {
+        free(chunks[i].data);
+        free(chunks[i].out);
+    }
+    free(chunks);
+    free(p.carry);
+
+    return (p.value_changes);
+}
 
 #ifdef VCD2FST_EXTLOADERS_CONV
 static int suffix_check(const char *s, const char *sfx)
@@ -421,15 +1010,15 @@ int fst_main(char *vname, char *fstname)
     void *ctx;
     int line = 0;
     int ss;
-    fstHandle returnedhandle;
-    JRB node;
-    uint64_t prev_tim = 0;
+    struct vcd2fst_id *id;
     ssize_t bin_fixbuff_len = 65537;
     char *bin_fixbuff = NULL;
     int hash_kill = 0;
     unsigned int hash_max = 0;
-    int *node_len_array = NULL;
     int is_popen = 0;
+    gint64 start_time = g_get_monotonic_time();
+    double elapsed;
+    uint64_t value_changes;
 #ifdef VCD2FST_EXTLOAD_CONV
     int is_extload = 0;
     void *xc = NULL;
@@ -503,10 +1092,10 @@ int fst_main(char *vname, char *fstname)
     }
 #endif
 
-    vcd_ids = make_jrb();
+    vcd_ids = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free);
     fstWriterSetPackType(ctx, pack_type);
     fstWriterSetRepackOnClose(ctx, repack_all);
-    fstWriterSetParallelMode(ctx, parallel_mode);
+    fstWriterSetParallelMode(ctx, parallel_mode || (num_threads > 1));
 
     while (!feof(f)) {
         char *buf1;
@@ -688,26 +1277,26 @@ int fst_main(char *vname, char *fstname)
                     *(st - 1) = ' ';
                 }
 
-                node = jrb_find_int(vcd_ids, hash);
-                if (!node) {
-                    Jval val;
-                    returnedhandle = fstWriterCreateVar(
+                id = g_hash_table_lookup(vcd_ids, GUINT_TO_POINTER(hash));
+                if (!id) {
+                    id = malloc(sizeof(struct vcd2fst_id));
+                    id->handle = fstWriterCreateVar(
                         ctx,
                         vartype,
                         !var_direction ? FST_VD_IMPLICIT : var_direction[var_direction_idx++],
                         len,
                         nam,
                         0);
-                    val.i = returnedhandle;
-                    jrb_insert_int(vcd_ids, hash, val)->val2.i = len;
+                    id->len = len;
+                    g_hash_table_insert(vcd_ids, GUINT_TO_POINTER(hash), id);
                 } else {
                     fstWriterCreateVar(ctx,
                                        vartype,
                                        !var_direction ? FST_VD_IMPLICIT
                                                       : var_direction[var_direction_idx++],
-                                       node->val2.i,
+                                       id->len,
                                        nam,
-                                       node->val.i);
+                                       id->handle);
                 }
 
 #if defined(VCD2FST_EXTLOAD_CONV)
@@ -1084,254 +1673,24 @@ int fst_main(char *vname, char *fstname)
         }
     }
 
-    if ((!hash_kill) && (vcd_ids)) {
+    if (!hash_kill) {
         unsigned int hash;
 
-        node_len_array = calloc(hash_max + 1, sizeof(int));
+        vcd_id_max = hash_max;
+        vcd_id_array = calloc(hash_max + 1, sizeof(struct vcd2fst_id));
 
         for (hash = 1; hash <= hash_max; hash++) {
-            node = jrb_find_int(vcd_ids, hash);
-            if (node) {
-                node_len_array[hash] = node->val2.i;
+            id = g_hash_table_lookup(vcd_ids, GUINT_TO_POINTER(hash));
+            if (id) {
+                vcd_id_array[hash] = *id;
             } else {
-                node_len_array[hash] = 1; /* should never happen */
+                vcd_id_array[hash].handle = hash; /* should never happen */
+                vcd_id_array[hash].len = 1;
             }
         }
-
-        jrb_free_tree(vcd_ids);
-        vcd_ids = NULL;
-    } else {
-        hash_kill = 1; /* scan-build */
     }
 
-    for (;;) /* was while(!feof(f)) */
-    {
-        unsigned int hash;
-        uint64_t tim;
-        char *nl, *sp;
-        double doub;
-
-        ss = getline_replace(&wbuf, &buf, &glen, f);
-        if (!ss) {
-            break;
-        }
-
-        nl = buf;
-        while (*nl) {
-            if ((*nl == '\n') || (*nl == '\r')) {
-                *nl = 0;
-                break;
-            }
-            nl++;
-        }
-
-        switch (buf[0]) {
-            case '0':
-            case '1':
-            case 'x':
-            case 'z':
-                hash = vcdid_hash(buf + 1, nl - (buf + 1));
-                if (!hash_kill) {
-                    fstWriterEmitValueChange(ctx, hash, buf);
-                } else {
-                    node = jrb_find_int(vcd_ids, hash);
-                    if (node) {
-                        fstWriterEmitValueChange(ctx, node->val.i, buf);
-                    } else {
-                    }
-                }
-                break;
-
-            case 'b': { /* this block replaces the single statement sp = strchr(buf, ' ');        */
-                /* as the odds are the VCD ID will be small compared to the vector length */
-                char *sp_scan = nl;
-                sp = NULL;
-
-                /* if(buf != sp_scan) [can't happen or switch() wouldn't get here] */
-                {
-                    while (buf != --sp_scan) {
-                        if (*sp_scan == ' ') {
-                            sp = sp_scan;
-                            break;
-                        }
-                    }
-                }
-            }
-
-                if (!sp)
-                    break;
-                *sp = 0;
-                hash = vcdid_hash(sp + 1, nl - (sp + 1));
-                if (!hash_kill) {
-                    int bin_len = sp - (buf + 1); /* strlen(buf+1) */
-                    int node_len = node_len_array[hash];
-
-                    if (bin_len >= node_len) {
-                        fstWriterEmitValueChange(ctx, hash, buf + 1);
-                    } else {
-                        int delta = node_len - bin_len;
-
-                        if (node_len >= bin_fixbuff_len) {
-                            bin_fixbuff_len = node_len + 1;
-                            bin_fixbuff = realloc_2(bin_fixbuff, bin_fixbuff_len);
-                        }
-
-                        memset(bin_fixbuff, buf[1] != '1' ? buf[1] : '0', delta);
-                        memcpy(bin_fixbuff + delta, buf + 1, bin_len);
-                        fstWriterEmitValueChange(ctx, hash, bin_fixbuff);
-                    }
-                } else {
-                    node = jrb_find_int(vcd_ids, hash);
-                    if (node) {
-                        int bin_len = sp - (buf + 1); /* strlen(buf+1) */
-                        int node_len = node->val2.i;
-                        if (bin_len >= node_len) {
-                            fstWriterEmitValueChange(ctx, node->val.i, buf + 1);
-                        } else {
-                            int delta = node_len - bin_len;
-
-                            if (node_len >= bin_fixbuff_len) {
-                                bin_fixbuff_len = node_len + 1;
-                                bin_fixbuff = realloc_2(bin_fixbuff, bin_fixbuff_len);
-                            }
-
-                            memset(bin_fixbuff, buf[1] != '1' ? buf[1] : '0', delta);
-                            memcpy(bin_fixbuff + delta, buf + 1, bin_len);
-                            fstWriterEmitValueChange(ctx, node->val.i, bin_fixbuff);
-                        }
-                    } else {
-                    }
-                }
-                break;
-
-            case 's':
-                sp = strchr(buf, ' ');
-                if (!sp)
-                    break;
-                *sp = 0;
-                hash = vcdid_hash(sp + 1, nl - (sp + 1));
-                if (!hash_kill) {
-                    int bin_len = sp - (buf + 1); /* strlen(buf+1) */
-
-                    bin_len = fstUtilityEscToBin(NULL, (unsigned char *)(buf + 1), bin_len);
-                    fstWriterEmitVariableLengthValueChange(ctx, hash, buf + 1, bin_len);
-                } else {
-                    node = jrb_find_int(vcd_ids, hash);
-                    if (node) {
-                        int bin_len = sp - (buf + 1); /* strlen(buf+1) */
-
-                        bin_len = fstUtilityEscToBin(NULL, (unsigned char *)(buf + 1), bin_len);
-                        fstWriterEmitVariableLengthValueChange(ctx, node->val.i, buf + 1, bin_len);
-                    } else {
-                    }
-                }
-                break;
-
-            case 'p': {
-                char *src = buf + 1;
-                char *pnt;
-                int pchar = 0;
-                int p_len = strlen(src);
-
-                if (p_len >= bin_fixbuff_len) {
-                    bin_fixbuff_len = p_len + 1;
-                    bin_fixbuff = realloc_2(bin_fixbuff, bin_fixbuff_len);
-                }
-                pnt = bin_fixbuff;
-
-                for (;;) {
-                    if (!*src)
-                        break;
-                    if (isspace((int)(unsigned char)*src)) {
-                        if (pchar != ' ') {
-                            *(pnt++) = pchar = ' ';
-                        }
-                        src++;
-                        continue;
-                    }
-                    *(pnt++) = pchar = *(src++);
-                }
-                *pnt = 0;
-
-                sp = strchr(bin_fixbuff, ' ');
-                if (!sp)
-                    break;
-                sp = strchr(sp + 1, ' ');
-                if (!sp)
-                    break;
-                sp = strchr(sp + 1, ' ');
-                if (!sp)
-                    break;
-                *sp = 0;
-
-                hash = vcdid_hash(sp + 1, strlen(sp + 1)); /* nl is no longer good here */
-                if (!hash_kill) {
-                    fstWriterEmitValueChange(ctx, hash, bin_fixbuff);
-                } else {
-                    node = jrb_find_int(vcd_ids, hash);
-                    if (node) {
-                        fstWriterEmitValueChange(ctx, node->val.i, bin_fixbuff);
-                    } else {
-                    }
-                }
-            } break;
-
-            case 'r':
-                sp = strchr(buf, ' ');
-                if (!sp)
-                    break;
-                hash = vcdid_hash(sp + 1, nl - (sp + 1));
-                if (!hash_kill) {
-                    sscanf(buf + 1, "%lg", &doub);
-                    fstWriterEmitValueChange(ctx, hash, &doub);
-                } else {
-                    node = jrb_find_int(vcd_ids, hash);
-                    if (node) {
-                        sscanf(buf + 1, "%lg", &doub);
-                        fstWriterEmitValueChange(ctx, node->val.i, &doub);
-                    } else {
-                    }
-                }
-                break;
-
-            case 'h': /* same as 01xz above but moved down here as it's less common */
-            case 'u':
-            case 'w':
-            case 'l':
-            case '-':
-                hash = vcdid_hash(buf + 1, nl - (buf + 1));
-                if (!hash_kill) {
-                    fstWriterEmitValueChange(ctx, hash, buf);
-                } else {
-                    node = jrb_find_int(vcd_ids, hash);
-                    if (node) {
-                        fstWriterEmitValueChange(ctx, node->val.i, buf);
-                    } else {
-                    }
-                }
-                break;
-
-            case '#':
-                tim = atoi_2((unsigned char *)(buf + 1));
-                if ((tim >= prev_tim) || (!prev_tim)) {
-                    prev_tim = tim;
-                    fstWriterEmitTimeChange(ctx, tim);
-                }
-                break;
-
-            default:
-                if (!strncmp(buf, "$dumpon", 7)) {
-                    fstWriterEmitDumpActive(ctx, 1);
-                } else if (!strncmp(buf, "$dumpoff", 8)) {
-                    fstWriterEmitDumpActive(ctx, 0);
-                } else if (!strncmp(buf, "$dumpvars", 9)) {
-                    /* nothing */
-                } else {
-                    /* printf("FST '%s'\n", buf); */
-                }
-                break;
-        }
-    }
+    value_changes = vcd2fst_convert_body(ctx, f, num_threads);
 
     fstWriterClose(ctx);
 
@@ -1341,17 +1700,32 @@ int fst_main(char *vname, char *fstname)
     }
 #endif
 
-    if (vcd_ids) {
-        jrb_free_tree(vcd_ids);
-        vcd_ids = NULL;
-    }
+    g_hash_table_destroy(vcd_ids);
+    vcd_ids = NULL;
+    free(vcd_id_array);
+    vcd_id_array = NULL;
 
     free(bin_fixbuff);
     bin_fixbuff = NULL;
     free(wbuf);
     wbuf = NULL;
-    free(node_len_array);
-    node_len_array = NULL;
+
+    if (print_stats) {
+        elapsed = (g_get_monotonic_time() - start_time) / (double)G_USEC_PER_SEC;
+        if (elapsed <= 0.0) {
+            elapsed = 1e-6;
+        }
+        fprintf(stderr,
+                "vcd2fst: %.1f MB in %.2f s (%.1f MB/s), %" PRIu64
+                " value changes (%.0f value changes/s), %d thread%s\n",
+                bytes_in / (1024.0 * 1024.0),
+                elapsed,
+                bytes_in / (1024.0 * 1024.0) / elapsed,
+                value_changes,
+                value_changes / elapsed,
+                num_threads,
+                (num_threads == 1) ? "" : "s");
+    }
 
     if (f != stdin) {
         if (is_popen) {
@@ -1410,6 +1784,8 @@ void print_help(char *nam)
            "  -Z, --zlibpack             use zlib algorithm for size\n"
            "  -c, --compress             zlib compress entire file on close\n"
            "  -p, --parallel             enable parallel mode\n"
+           "  -t, --threads=NUM          parse value changes with NUM threads\n"
+           "  -s, --stats                print the conversion rate to stderr\n"
            "  -h, --help                 display this help then exit\n\n"
 
            "Note that VCDFILE and FSTFILE are optional provided the\n"
@@ -1434,6 +1810,8 @@ void print_help(char *nam)
            "  -Z                         use zlib algorithm for size\n"
            "  -c                         zlib compress entire file on close\n"
            "  -p                         enable parallel mode\n"
+           "  -t NUM                     parse value changes with NUM threads\n"
+           "  -s                         print the conversion rate to stderr\n"
            "  -h                         display this help then exit\n\n"
 
            "Note that VCDFILE and FSTFILE are optional provided the\n"
@@ -1473,12 +1851,14 @@ int main(int argc, char **argv)
                                                {"zlibpack", 0, 0, 'Z'},
                                                {"compress", 0, 0, 'c'},
                                                {"parallel", 0, 0, 'p'},
+                                               {"threads", 1, 0, 't'},
+                                               {"stats", 0, 0, 's'},
                                                {"help", 0, 0, 'h'},
                                                {0, 0, 0, 0}};
 
-        c = getopt_long(argc, argv, "v:f:ZF4cph", long_options, &option_index);
+        c = getopt_long(argc, argv, "v:f:t:sZF4cph", long_options, &option_index);
 #else
-        c = getopt(argc, argv, "v:f:ZF4cph");
+        c = getopt(argc, argv, "v:f:t:sZF4cph");
 #endif
 
         if (c == -1)
@@ -1522,6 +1902,17 @@ int main(int argc, char **argv)
                 parallel_mode = 1;
                 break;
 
+            case 't':
+                num_threads = atoi(optarg);
+                if (num_threads < 1) {
+                    num_threads = 1;
+                }
+                break;
+
+            case 's':
+                print_stats = 1;
+                break;
+
             case 'h':
                 print_help(argv[0]);
                 break;
@@ -1558,6 +1949,14 @@ int main(int argc, char **argv)
         print_help(argv[0]);
     }
 
+    if (getenv("VCD2FST_CHUNK_SIZE")) {
+        long size = atol(getenv("VCD2FST_CHUNK_SIZE"));
+
+        if (size > 0) {
+            chunk_size = size;
+        }
+    }
+
     fst_main(vname, lxname);
 
     free(vname);
@@ -23,6 +23,9 @@ enum LXT2_Loader_Type_Encodings
     LXT2_IS_INACTIVE,
     LXT2_IS_VLIST,
     LXT2_IS_FST,
+    LXT2_IS_GHW,
+    LXT2_IS_LXT2,
+    LXT2_IS_VZT,
 };
 
 void import_lx2_trace(GwNode *np);
@@ -19,6 +19,8 @@
 #include <gtk/gtk.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 
 #ifdef __MINGW32__
 #include <windows.h>
@@ -65,6 +67,10 @@
 #include "ttranslate.h"
 #include "signal_list.h"
 #include "dump_file_main.h"
+#include "benchmark.h"
+#include "render_file.h"
+#include "vcd_saver.h"
+#include "stats.h"
 #include "gw-time-display.h"
 #include "gw-vcd-file.h"
 #include "gw-fst-file.h"
@@ -229,6 +235,35 @@ void wave_gtk_window_set_title(GtkWindow *window, const gchar *title, int typ, i
     }
 }
 
+/* long options without a short option */
+enum
+{
+    OPT_RENDER = 256,
+    OPT_RENDER_SIZE,
+    OPT_RENDER_START,
+    OPT_RENDER_END,
+    OPT_EXPORT,
+};
+
+/* writes the displayed traces for --export, as FST if the name ends in .fst and as VCD otherwise */
+static gboolean export_to_file(const char *fname)
+{
+    int export_typ = g_str_has_suffix(fname, ".fst") ? WAVE_EXPORT_FST : WAVE_EXPORT_VCD;
+
+    switch (save_nodes_to_export(fname, export_typ)) {
+        case VCDSAV_EMPTY:
+            fprintf(stderr, "GTKWAVE | No traces to export to '%s'.\n", fname);
+            return FALSE;
+
+        case VCDSAV_FILE_ERROR:
+            fprintf(stderr, "GTKWAVE | Could not write '%s': %s\n", fname, strerror(errno));
+            return FALSE;
+
+        default:
+            return TRUE;
+    }
+}
+
 static void print_help(char *nam)
 {
 #if !defined __MINGW32__ && !defined __FreeBSD__ && !defined __CYGWIN__
@@ -292,6 +327,13 @@ static void print_help(char *nam)
         "  -5, --sstexclude           specify sst exclusion filter filename\n"
         "  -6, --dark                 set gtk-application-prefer-dark-theme = TRUE\n"
         "  -7, --saveonexit           prompt user to write save file at exit\n"
+        "  -8, --benchmark            print benchmark results for the loaded trace then exit\n"
+        "  -9, --stats                print timing and memory statistics at exit\n"
+        "      --render=FILE          render the waveforms to a PNG or SVG file then exit\n"
+        "      --render-size=WxH      specify the rendered image size (default 1280x800)\n"
+        "      --render-start=TIME    specify the start time of the rendered image\n"
+        "      --render-end=TIME      specify the end time of the rendered image\n"
+        "      --export=FILE          export the displayed traces to a VCD or FST file then exit\n"
         "  -g, --giga                 use gigabyte mempacking when recoding (slower)\n"
         "  -v, --vcd                  use stdin as a VCD dumpfile\n" OUTPUT_GETOPT
         "  -V, --version              display version banner then exit\n"
@@ -618,6 +660,10 @@ static void on_dbus_method_call(GDBusConnection *connection,
             return;
         }
         reload_into_new_context();
+    } else if (g_strcmp0(method_name, "GetStats") == 0) {
+        gchar *report = gw_stats_to_string();
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(s)", report));
+        g_free(report);
     }
 }
 
@@ -629,7 +675,8 @@ static void on_bus_acquired(GDBusConnection *connection, const gchar *name, gpoi
 {
     GDBusNodeInfo *node_info =
         g_dbus_node_info_new_for_xml("<node><interface name='io.github.gtkwave.GTKWave'><method "
-                                     "name='Reload' /></interface></node>",
+                                     "name='Reload' /><method name='GetStats'><arg type='s' "
+                                     "name='report' direction='out' /></method></interface></node>",
                                      NULL);
 
     g_dbus_connection_register_object(connection,
@@ -674,6 +721,15 @@ int main_2(int opt_vcd, int argc, char *argv[])
     char is_smartsave = 0;
     char is_giga = 0;
     char fast_exit = 0;
+    char benchmark = 0;
+    char stats = 0;
+    gboolean headless = FALSE;
+    RenderFileOptions render_options = {
+        .filename = NULL,
+        .width = 1280,
+        .height = 800,
+    };
+    const char *export_filename = NULL;
     char opt_errors_encountered = 0;
     char is_missing_file = 0;
 
@@ -828,10 +884,18 @@ int main_2(int opt_vcd, int argc, char *argv[])
     strcpy(GLOBALS->whoami, argv[0]);
 
     if (!mainwindow_already_built) {
+        /* --render and --export don't need a display, so look for them before initializing GTK */
+        for (int i = 1; i < argc; i++) {
+            if (g_str_has_prefix(argv[i], "--render=") || strcmp(argv[i], "--render") == 0 ||
+                g_str_has_prefix(argv[i], "--export=") || strcmp(argv[i], "--export") == 0) {
+                headless = TRUE;
+            }
+        }
+
 #ifdef __MINGW32__
         gtk_disable_setlocale();
 #endif
-        if (!gtk_init_check(&argc, &argv)) {
+        if (!gtk_init_check(&argc, &argv) && !headless) {
 #if defined(__APPLE__)
 #ifndef MAC_INTEGRATION
             if (!getenv("DISPLAY")) {
@@ -876,7 +940,7 @@ do_primary_inits:
 #endif
 #endif
 
-    if (!mainwindow_already_built) {
+    if (!mainwindow_already_built && !headless) {
         dbus_init();
     }
 
@@ -931,11 +995,18 @@ do_primary_inits:
                                                    {"sstexclude", 1, 0, '5'},
                                                    {"dark", 0, 0, '6'},
                                                    {"saveonexit", 0, 0, '7'},
+                                                   {"benchmark", 0, 0, '8'},
+                                                   {"stats", 0, 0, '9'},
+                                                   {"render", 1, 0, OPT_RENDER},
+                                                   {"render-size", 1, 0, OPT_RENDER_SIZE},
+                                                   {"render-start", 1, 0, OPT_RENDER_START},
+                                                   {"render-end", 1, 0, OPT_RENDER_END},
+                                                   {"export", 1, 0, OPT_EXPORT},
                                                    {0, 0, 0, 0}};
 
             c = getopt_long(argc,
                             argv,
-                            "zf:Fon:a:r:dl:s:e:c:t:NvVhxX:MD:IgC:O:1:2:34:5:67",
+                            "zf:Fon:a:r:dl:s:e:c:t:NvVhxX:MD:IgC:O:1:2:34:5:6789",
                             long_options,
                             &option_index);
 
@@ -1129,6 +1200,41 @@ do_primary_inits:
                     GLOBALS->save_on_exit = TRUE;
                     break;
 
+                case '8':
+                    benchmark = 1;
+                    break;
+
+                case '9':
+                    stats = 1;
+                    break;
+
+                case OPT_RENDER:
+                    render_options.filename = optarg;
+                    splash_disable_rc_override = 1;
+                    break;
+
+                case OPT_RENDER_SIZE:
+                    if (!render_file_parse_size(optarg,
+                                                &render_options.width,
+                                                &render_options.height)) {
+                        fprintf(stderr, "Malformed render size '%s', must be WxH.\n", optarg);
+                        opt_errors_encountered = 1;
+                    }
+                    break;
+
+                case OPT_RENDER_START:
+                    render_options.start = optarg;
+                    break;
+
+                case OPT_RENDER_END:
+                    render_options.end = optarg;
+                    break;
+
+                case OPT_EXPORT:
+                    export_filename = optarg;
+                    splash_disable_rc_override = 1;
+                    break;
+
                 case 's':
                     if (GLOBALS->skip_start)
                         free_2(GLOBALS->skip_start);
@@ -1296,6 +1402,8 @@ do_primary_inits:
         read_rc_file(override_rc);
     }
 
+    stats_init(stats);
+
     GLOBALS->splash_disable |= splash_disable_rc_override;
 
     if (!GLOBALS->loaded_file_name) {
@@ -1383,13 +1491,18 @@ loader_check_head:
 
     if (is_missing_file) {
         GLOBALS->loaded_file_type = MISSING_FILE;
-    } else if (suffix_check(GLOBALS->loaded_file_name, ".lxt") ||
-               suffix_check(GLOBALS->loaded_file_name, ".lx2") ||
-               suffix_check(GLOBALS->loaded_file_name, ".lxt2")) {
-        fprintf(
-            stderr,
-            "GTKWAVE | LXT and LXT2 files are no longer supported by this version of GTKWave.\n");
+    } else if (suffix_check(GLOBALS->loaded_file_name, ".lxt")) {
+        fprintf(stderr,
+                "GTKWAVE | LXT files are no longer supported by this version of GTKWave.\n");
         vcd_exit(255);
+    } else if (suffix_check(GLOBALS->loaded_file_name, ".lx2") ||
+               suffix_check(GLOBALS->loaded_file_name, ".lxt2")) {
+        GLOBALS->loaded_file_type = LXT2_FILE;
+        GLOBALS->dump_file = lxt2_main(GLOBALS->loaded_file_name);
+        if (GLOBALS->dump_file == NULL) {
+            /* error message printed in lxt2_main() */
+            vcd_exit(255);
+        }
     } else if ((magic_word_filetype == G_FT_FST) ||
                suffix_check(GLOBALS->loaded_file_name, ".fst")) {
         GLOBALS->stems_type = WAVE_ANNO_FST;
@@ -1406,9 +1519,12 @@ loader_check_head:
             vcd_exit(255);
         }
     } else if (suffix_check(GLOBALS->loaded_file_name, ".vzt")) {
-        fprintf(stderr,
-                "GTKWAVE | VZT files are no longer supported by this version of GTKWave.\n");
-        vcd_exit(255);
+        GLOBALS->loaded_file_type = VZT_FILE;
+        GLOBALS->dump_file = vzt_main(GLOBALS->loaded_file_name);
+        if (GLOBALS->dump_file == NULL) {
+            /* error message printed in vzt_main() */
+            vcd_exit(255);
+        }
     } else if (suffix_check(GLOBALS->loaded_file_name, ".aet") ||
                suffix_check(GLOBALS->loaded_file_name, ".ae2")) {
         fprintf(stderr,
@@ -1439,18 +1555,15 @@ loader_check_head:
     } else /* nothing else left so default to "something" */
     {
     load_vcd:
-#if !defined __MINGW32__
         if (opt_vcd) {
             GLOBALS->unoptimized_vcd_file_name = calloc_2(1, strlen(GLOBALS->loaded_file_name) + 1);
             strcpy(GLOBALS->unoptimized_vcd_file_name, GLOBALS->loaded_file_name);
             optimize_vcd_file();
-            /* is_vcd = 0; */ /* scan-build */
             GLOBALS->optimize_vcd = 1;
+            opt_vcd = 0;
             goto loader_check_head;
         }
 
-#endif
-
         if (strcmp(GLOBALS->loaded_file_name, "-vcd")) {
             GLOBALS->loaded_file_type = VCD_RECODER_FILE;
         } else {
@@ -1542,9 +1655,15 @@ loader_check_head:
         if (!wave) {
             fprintf(stderr, "** WARNING: Error opening save file '%s', skipping.\n", wname);
         } else {
-            char *iline;
+            GPtrArray *lines;
             int s_ctx_iter;
 
+            lines = read_save_lines(wave);
+            if (wave_is_compressed)
+                pclose(wave);
+            else
+                fclose(wave);
+
             WAVE_STRACE_ITERATOR(s_ctx_iter)
             {
                 GLOBALS->strace_ctx =
@@ -1552,51 +1671,14 @@ loader_check_head:
                 GLOBALS->strace_ctx->shadow_encountered_parsewavline = 0;
             }
 
-            if (GLOBALS->is_lx2) {
-                while ((iline = fgetmalloc(wave))) {
-                    parsewavline_lx2(iline, NULL, 0);
-                    free_2(iline);
-                }
-
-                lx2_import_masked();
-
-                if (wave_is_compressed) {
-                    pclose(wave);
-                    wave = popen(str, "r");
-                } else {
-                    fclose(wave);
-                    wave = fopen(wname, "rb");
-                }
-
-                if (!wave) {
-                    fprintf(stderr, "** WARNING: Error opening save file '%s', skipping.\n", wname);
-                    EnsureGroupsMatch();
-                    goto savefile_bail;
-                }
-            }
-
             read_save_helper_relative_init(wname);
-            GLOBALS->default_flags = TR_RJUSTIFY;
-            GLOBALS->default_fpshift = 0;
-            GLOBALS->shift_timebase_default_for_add = GW_TIME_CONSTANT(0);
-            GLOBALS->strace_current_window = 0; /* in case there are shadow traces */
-            GLOBALS->which_t_color = 0;
-            while ((iline = fgetmalloc(wave))) {
-                parsewavline(iline, NULL, 0);
-                GLOBALS->strace_ctx->shadow_encountered_parsewavline |=
-                    GLOBALS->strace_ctx->shadow_active;
-                free_2(iline);
-            }
-            GLOBALS->which_t_color = 0;
+            parse_save_lines(lines);
+            g_ptr_array_free(lines, TRUE);
+
             GLOBALS->default_flags = TR_RJUSTIFY;
             GLOBALS->default_fpshift = 0;
             GLOBALS->shift_timebase_default_for_add = GW_TIME_CONSTANT(0);
 
-            if (wave_is_compressed)
-                pclose(wave);
-            else
-                fclose(wave);
-
             EnsureGroupsMatch();
 
             WAVE_STRACE_ITERATOR(s_ctx_iter)
@@ -1621,7 +1703,6 @@ loader_check_head:
         }
     }
 
-savefile_bail:
     GLOBALS->current_translate_file = 0;
 
     if (fast_exit) {
@@ -1629,12 +1710,24 @@ savefile_bail:
         exit(0);
     }
 
+    if (benchmark) {
+        benchmark_traces();
+    }
+
     if ((GLOBALS->loaded_file_type != MISSING_FILE) && (!GLOBALS->zoom_was_explicitly_set) &&
         ((GLOBALS->tims.last - GLOBALS->tims.first) <= 400))
         GLOBALS->do_initial_zoom_fit = 1; /* force zoom on small traces */
 
     calczoom(GLOBALS->tims.zoom);
 
+    if (render_options.filename != NULL) {
+        exit(render_to_file(&render_options) ? 0 : 1);
+    }
+
+    if (export_filename != NULL) {
+        exit(export_to_file(export_filename) ? 0 : 1);
+    }
+
     add_custom_css();
 
     if (!mainwindow_already_built) {
@@ -2001,6 +2094,10 @@ savefile_bail:
     }
 #endif
 
+    if (benchmark) {
+        benchmark_render();
+    }
+
     if (GLOBALS->dual_attach_id_main_c_1) {
         fprintf(stderr,
                 "GTKWAVE | Attaching %08X as dual head session %d\n",
@@ -2483,89 +2580,22 @@ void activate_stems_reader(char *stems_name)
     }
 }
 
-#if !defined __MINGW32__
+/*
+ * converts the VCD file to FST in-process, the session then loads and
+ * browses the FST file like the vcd2fst output it replaces
+ */
 void optimize_vcd_file(void)
 {
-    if (!strcmp("-vcd", GLOBALS->unoptimized_vcd_file_name)) {
-#ifdef __CYGWIN__
-        char *buf = strdup_2("vcd2fst -- - vcd.fst");
-        system(buf);
-        free_2(buf);
-        GLOBALS->loaded_file_name = strdup_2("vcd.fst");
+    char *vcd_name = GLOBALS->unoptimized_vcd_file_name;
+    int is_stdin = !strcmp("-vcd", vcd_name);
+    char *buf = malloc_2(strlen(is_stdin ? "vcd" : vcd_name) + 4 + 1);
+
+    sprintf(buf, "%s.fst", is_stdin ? "vcd" : vcd_name);
+    vcd_optimize_main(vcd_name, buf);
+
+    free_2(GLOBALS->loaded_file_name);
+    GLOBALS->loaded_file_name = buf;
+    if (is_stdin) {
         GLOBALS->is_optimized_stdin_vcd = 1;
-#else
-        pid_t pid;
-        char *buf = malloc_2(strlen("vcd") + 4 + 1);
-        sprintf(buf, "%s.fst", "vcd");
-        pid = fork();
-        if (((int)pid) < 0) {
-            /* can't do anything about this */
-        } else {
-            if (pid) {
-                int mystat;
-                int rc = waitpid(pid, &mystat, 0);
-                if (rc > 0) {
-                    free_2(GLOBALS->loaded_file_name);
-                    GLOBALS->loaded_file_name = buf;
-                    GLOBALS->is_optimized_stdin_vcd = 1;
-                }
-            } else {
-                execlp("vcd2fst", "vcd2fst", "--", "-", buf, NULL);
-                exit(255);
-            }
-        }
-#endif
-    } else {
-#ifdef __CYGWIN__
-        char *buf = malloc_2(9 + (strlen(GLOBALS->unoptimized_vcd_file_name) + 1) +
-                             (strlen(GLOBALS->unoptimized_vcd_file_name) + 4 + 1));
-        sprintf(buf,
-                "vcd2fst %s %s.fst",
-                GLOBALS->unoptimized_vcd_file_name,
-                GLOBALS->unoptimized_vcd_file_name);
-        system(buf);
-        free_2(buf);
-        buf = malloc_2(strlen(GLOBALS->unoptimized_vcd_file_name) + 4 + 1);
-        sprintf(buf, "%s.fst", GLOBALS->unoptimized_vcd_file_name);
-        GLOBALS->loaded_file_name = buf;
-#else
-        pid_t pid;
-        char *buf = malloc_2(strlen(GLOBALS->unoptimized_vcd_file_name) + 4 + 1);
-        sprintf(buf, "%s.fst", GLOBALS->unoptimized_vcd_file_name);
-        pid = fork();
-        if (((int)pid) < 0) {
-            /* can't do anything about this */
-        } else {
-            if (pid) {
-                int mystat;
-                int rc = waitpid(pid, &mystat, 0);
-                if (rc > 0) {
-                    free_2(GLOBALS->loaded_file_name);
-                    GLOBALS->loaded_file_name = buf;
-                }
-            } else {
-#ifdef MAC_INTEGRATION
-                const gchar *p = gtkosx_application_get_executable_path();
-                if (p && strstr(p, "Contents/")) {
-                    const char *xec = "../Resources/bin/vcd2fst";
-                    char *res = strdup_2(p);
-                    char *slsh = strrchr(res, '/');
-                    if (slsh) {
-                        *(slsh + 1) = 0;
-                        res = realloc_2(res, strlen(res) + strlen(xec) + 1);
-                        strcat(res, xec);
-                        execlp(res, "vcd2fst", GLOBALS->unoptimized_vcd_file_name, buf, NULL);
-                        fprintf(stderr, "GTKWAVE | Could not find '%s' in .app!\n", res);
-                        free_2(res);
-                    }
-                }
-#endif
-                execlp("vcd2fst", "vcd2fst", GLOBALS->unoptimized_vcd_file_name, buf, NULL);
-                fprintf(stderr, "GTKWAVE | Could not find vcd2fst executable, exiting!\n");
-                exit(255);
-            }
-        }
-#endif
     }
 }
-#endif
@@ -24,6 +24,9 @@ struct logfile_chain
 
 int main_2(int opt_vcd, int argc, char *argv[]);
 
+/* function for vcd conversions */
+void optimize_vcd_file(void);
+
 GtkWidget *create_text(void);
 GtkWidget *create_entry_box(void);
 GtkWidget *create_wavewindow(void);
@@ -48,9 +51,6 @@ void kill_stems_browser_single(void *G);
 /* prototype only used in main.c */
 void menu_reload_waveform_marshal(GtkWidget *widget, gpointer data);
 
-/* function for spawning vcd conversions */
-void optimize_vcd_file(void);
-
 enum FileType
 {
     MISSING_FILE,
@@ -60,6 +60,8 @@ enum FileType
     EXTLOAD_FILE,
 #endif
     FST_FILE,
+    LXT2_FILE,
+    VZT_FILE,
     DUMPLESS_FILE
 };
 
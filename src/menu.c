@@ -27,6 +27,7 @@
 #include "lx2.h"
 #include "tcl_helper.h"
 #include "signal_list.h"
+#include "stats.h"
 #include "gw-named-marker-dialog.h"
 #include <cocoa_misc.h>
 #include <assert.h>
@@ -518,6 +519,65 @@ void menu_write_tim_file(gpointer null_data, guint callback_action, GtkWidget *w
 
 /******************************************************************/
 
+void menu_write_fst_file_cleanup(GtkWidget *widget, gpointer data)
+{
+    (void)widget;
+    (void)data;
+
+    int rc;
+
+    if (!GLOBALS->filesel_ok) {
+        return;
+    }
+
+    if (GLOBALS->lock_menu_c_2 == 1)
+        return; /* avoid recursion */
+    GLOBALS->lock_menu_c_2 = 1;
+
+    status_text("Saving FST...\n");
+    gtkwave_main_iteration(); /* make requester disappear requester */
+
+    rc = save_nodes_to_export(*GLOBALS->fileselbox_text, WAVE_EXPORT_FST);
+
+    GLOBALS->lock_menu_c_2 = 0;
+
+    switch (rc) {
+        case VCDSAV_EMPTY:
+            status_text("No traces onscreen to save!\n");
+            break;
+
+        case VCDSAV_FILE_ERROR:
+            status_text("Problem writing FST: ");
+            status_text(strerror(errno));
+            break;
+
+        case VCDSAV_OK:
+            status_text("FST written successfully.\n");
+        default:
+            break;
+    }
+}
+
+void menu_write_fst_file(gpointer null_data, guint callback_action, GtkWidget *widget)
+{
+    (void)null_data;
+    (void)callback_action;
+    (void)widget;
+
+    if (GLOBALS->traces.first) {
+        fileselbox("Write FST File As",
+                   &GLOBALS->filesel_fst_writesave,
+                   G_CALLBACK(menu_write_fst_file_cleanup),
+                   G_CALLBACK(NULL),
+                   "*.fst",
+                   1);
+    } else {
+        status_text("No traces onscreen to save!\n");
+    }
+}
+
+/******************************************************************/
+
 void menu_unwarp_traces_all(gpointer null_data, guint callback_action, GtkWidget *widget)
 {
     (void)null_data;
@@ -4744,6 +4804,15 @@ void menu_show_base(gpointer null_data, guint callback_action, GtkWidget *widget
     DEBUG(printf("Show Base Symbols\n"));
 }
 
+void menu_show_stats(gpointer null_data, guint callback_action, GtkWidget *widget)
+{
+    (void)null_data;
+    (void)callback_action;
+    (void)widget;
+
+    stats_window();
+}
+
 /**/
 void menu_fullscreen(gpointer null_data, guint callback_action, GtkWidget *widget)
 {
@@ -4897,6 +4966,11 @@ static gtkwave_mlist_t menu_items[] = {
                 menu_write_tim_file,
                 WV_MENU_WRTIM,
                 "<Item>"),
+    WAVE_GTKIFE("/File/Export/Write FST File As",
+                NULL,
+                menu_write_fst_file,
+                WV_MENU_WRFST,
+                "<Item>"),
     WAVE_GTKIFE("/File/Close", "<Control>W", menu_quit_close, WV_MENU_WCLOSE, "<Item>"),
     WAVE_GTKIFE("/File/<separator>", NULL, NULL, WV_MENU_SEP2VCD, "<Separator>"),
     WAVE_GTKIFE("/File/Print To File", "<Control>P", menu_print, WV_MENU_FPTF, "<Item>"),
@@ -5407,6 +5481,7 @@ static gtkwave_mlist_t menu_items[] = {
                 "<ToggleItem>"),
     WAVE_GTKIFE("/View/<separator>", NULL, NULL, WV_MENU_SEP9A, "<Separator>"),
     WAVE_GTKIFE("/View/Show Base Symbols", "<Alt>F1", menu_show_base, WV_MENU_VSBS, "<ToggleItem>"),
+    WAVE_GTKIFE("/View/Show Statistics", NULL, menu_show_stats, WV_MENU_VSTATS, "<Item>"),
     WAVE_GTKIFE("/View/<separator>", NULL, NULL, WV_MENU_SEP10, "<Separator>"),
     /* 110 */
     WAVE_GTKIFE("/View/Dynamic Resize",
@@ -82,6 +82,7 @@ enum WV_MenuItems
     WV_MENU_FRW,
     WV_MENU_WRVCD,
     WV_MENU_WRTIM,
+    WV_MENU_WRFST,
     WV_MENU_WCLOSE,
     WV_MENU_SEP2VCD,
     WV_MENU_FPTF,
@@ -252,6 +253,7 @@ enum WV_MenuItems
     WV_MENU_VSMC,
     WV_MENU_SEP9A,
     WV_MENU_VSBS,
+    WV_MENU_VSTATS,
     WV_MENU_SEP10,
     WV_MENU_VDR,
     WV_MENU_SEP11,
@@ -373,6 +375,7 @@ void delete_unnamed_marker(gpointer null_data, guint callback_action, GtkWidget
 void wave_scrolling_on(gpointer null_data, guint callback_action, GtkWidget *widget);
 void menu_show_grid(gpointer null_data, guint callback_action, GtkWidget *widget);
 void menu_show_mouseover(gpointer null_data, guint callback_action, GtkWidget *widget);
+void menu_show_stats(gpointer null_data, guint callback_action, GtkWidget *widget);
 void menu_show_base(gpointer null_data, guint callback_action, GtkWidget *widget);
 void menu_enable_dynamic_resize(gpointer null_data, guint callback_action, GtkWidget *widget);
 void menu_center_zooms(gpointer null_data, guint callback_action, GtkWidget *widget);
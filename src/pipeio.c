@@ -11,6 +11,9 @@
 #include <config.h>
 #include "pipeio.h"
 
+static void pipeio_init(struct pipe_ctx *p);
+static void pipeio_shutdown(struct pipe_ctx *p);
+
 #if defined __MINGW32__
 
 static void cleanup_p(struct pipe_ctx *p)
@@ -94,22 +97,73 @@ struct pipe_ctx *pipeio_create(char *execappname, char *args)
         /* CloseHandle(p->piProcInfo.hThread); */
     }
 
+    pipeio_init(p);
     return (p);
 }
 
 void pipeio_destroy(struct pipe_ctx *p)
 {
+    /* a worker blocked on a hung filter sees the end of its output */
+    TerminateProcess(p->piProcInfo.hProcess, 0);
+    CloseHandle(p->g_hChildStd_OUT_Wr);
     CloseHandle(p->g_hChildStd_IN_Rd);
+
+    pipeio_shutdown(p);
+
     CloseHandle(p->g_hChildStd_IN_Wr);
     CloseHandle(p->g_hChildStd_OUT_Rd);
-    CloseHandle(p->g_hChildStd_OUT_Wr);
-    TerminateProcess(p->piProcInfo.hProcess, 0);
 
     free_2(p);
 }
 
+static void pipeio_write_line(struct pipe_ctx *p, const char *s)
+{
+    DWORD dwWritten;
+
+    WriteFile(p->g_hChildStd_IN_Wr, s, strlen(s), &dwWritten, NULL);
+    WriteFile(p->g_hChildStd_IN_Wr, "\n", 1, &dwWritten, NULL);
+}
+
+static void pipeio_flush(struct pipe_ctx *p)
+{
+    (void)p;
+}
+
+void pipeio_hangup(struct pipe_ctx *p)
+{
+    TerminateProcess(p->piProcInfo.hProcess, 0);
+}
+
+int pipeio_read_line(struct pipe_ctx *p, char *buf)
+{
+    BOOL bSuccess;
+    DWORD dwRead;
+    int n;
+
+    for (n = 0; n < 1024; n++) {
+        do {
+            bSuccess = ReadFile(p->g_hChildStd_OUT_Rd, buf + n, 1, &dwRead, NULL);
+            if (!bSuccess) {
+                if (!n) {
+                    return (-1);
+                }
+                goto ex;
+            }
+            if (buf[n] == '\n') {
+                goto ex;
+            }
+
+        } while (buf[n] == '\r');
+    }
+ex:
+    buf[n] = 0;
+
+    return (n);
+}
+
 #else
 #include <sys/wait.h>
+#include <pthread.h>
 
 struct pipe_ctx *pipeio_create(char *execappname, char *arg)
 {
@@ -140,7 +194,10 @@ struct pipe_ctx *pipeio_create(char *execappname, char *arg)
         fsin = fdopen(filedes_r[0], "rb");
         close(filedes_w[0]);
         close(filedes_r[1]);
+        setpgid(pid, pid); /* also done by the child, whichever runs first */
     } else {
+        setpgid(0, 0); /* the helper and its monitor are killed as one group */
+
         dup2(filedes_w[0], 0);
         dup2(filedes_r[1], 1);
 
@@ -186,20 +243,371 @@ struct pipe_ctx *pipeio_create(char *execappname, char *arg)
     p->fd0 = filedes_r[0]; /* for potential select() ops */
     p->fd1 = filedes_w[1]; /* ditto */
 
+    pipeio_init(p);
     return (p);
 }
 
 void pipeio_destroy(struct pipe_ctx *p)
 {
-    /* #ifdef _AIX */
     int mystat;
-    kill(p->pid, SIGKILL);
+
+    /* a worker blocked on a hung filter sees the end of its output */
+    pipeio_hangup(p);
+    pipeio_shutdown(p);
     waitpid(p->pid, &mystat, 0);
-    /* #endif */
 
     fclose(p->sout);
     fclose(p->sin);
     free_2(p);
 }
 
+static void pipeio_write_line(struct pipe_ctx *p, const char *s)
+{
+    fputs(s, p->sout);
+    fputc('\n', p->sout);
+}
+
+static void pipeio_flush(struct pipe_ctx *p)
+{
+    fflush(p->sout);
+}
+
+void pipeio_hangup(struct pipe_ctx *p)
+{
+    kill(-p->pid, SIGKILL); /* the monitor holds the pipes as well */
+}
+
+int pipeio_read_line(struct pipe_ctx *p, char *buf)
+{
+    buf[0] = 0;
+    if (!fgets(buf, 1024, p->sin)) {
+        return (-1);
+    }
+
+    return (strlen(buf));
+}
+
 #endif
+
+/*
+ * batched exchanges: filters still see one value per line and answer
+ * with one line each, but up to PIPEIO_WINDOW values are written before
+ * the replies are read.  the window is also limited to PIPEIO_WINDOW_BYTES
+ * so the replies in flight stay below the smallest pipe buffer (4 KiB on
+ * windows) and a filter can never block on its stdout.  replies are
+ * assumed to be no longer than the longest one seen so far.
+ */
+#define PIPEIO_WINDOW (32)
+#define PIPEIO_WINDOW_BYTES (2048)
+#define PIPEIO_CACHE_MAX (65536)
+
+struct pipe_cache_ent
+{
+    GList link; /* in cache_lru */
+    char *value;
+    char *reply;
+};
+
+struct pipe_worker
+{
+    struct pipe_ctx *p; /* cleared by pipeio_destroy(), main thread only */
+    GThread *thread;
+    GAsyncQueue *queue;
+    GPtrArray *deferred; /* values collected for the next batch */
+    GHashTable *pending; /* values queued or in flight */
+};
+
+struct pipe_batch
+{
+    struct pipe_worker *w;
+    GPtrArray *values;
+    char **replies;
+    void (*done)(gpointer data);
+    gpointer data;
+    GDestroyNotify data_free;
+};
+
+static void pipeio_exchange(struct pipe_ctx *p, char **values, char **replies, guint count)
+{
+    char buf[1025];
+    guint i, j, n;
+
+    g_mutex_lock(&p->io_lock);
+
+    for (i = 0; i < count; i += n) {
+        gsize bytes = 0;
+
+        for (n = 0; (i + n < count) && (n < PIPEIO_WINDOW); n++) {
+            gsize cost = MAX(strlen(values[i + n]), p->reply_max) + 1;
+
+            if (n && (bytes + cost > PIPEIO_WINDOW_BYTES)) {
+                break;
+            }
+            bytes += cost;
+        }
+
+        for (j = 0; j < n; j++) {
+            pipeio_write_line(p, values[i + j]);
+        }
+        pipeio_flush(p);
+
+        for (j = 0; j < n; j++) {
+            int len = pipeio_read_line(p, buf);
+
+            if (len < 0) {
+                len = 0;
+                buf[0] = 0;
+            }
+            if (len && buf[len - 1] == '\n') {
+                buf[--len] = 0;
+            }
+            if ((gsize)len > p->reply_max) {
+                p->reply_max = len;
+            }
+            replies[i + j] = g_strdup(buf);
+        }
+    }
+
+    g_mutex_unlock(&p->io_lock);
+}
+
+static void pipeio_cache_ent_free(gpointer data)
+{
+    struct pipe_cache_ent *e = data;
+
+    g_free(e->value);
+    g_free(e->reply);
+    g_free(e);
+}
+
+/* returns the cached reply for value and marks it as recently used */
+static const char *pipeio_cache_lookup(struct pipe_ctx *p, const char *value)
+{
+    struct pipe_cache_ent *e = g_hash_table_lookup(p->cache, value);
+
+    if (!e) {
+        return (NULL);
+    }
+
+    g_queue_unlink(&p->cache_lru, &e->link);
+    g_queue_push_head_link(&p->cache_lru, &e->link);
+
+    return (e->reply);
+}
+
+/* takes over reply, the least recently used entry makes room once the cache is full */
+static void pipeio_cache_insert(struct pipe_ctx *p, const char *value, char *reply)
+{
+    struct pipe_cache_ent *e = g_hash_table_lookup(p->cache, value);
+
+    if (e) {
+        g_free(e->reply);
+        e->reply = reply;
+        g_queue_unlink(&p->cache_lru, &e->link);
+        g_queue_push_head_link(&p->cache_lru, &e->link);
+        return;
+    }
+
+    if (g_hash_table_size(p->cache) >= PIPEIO_CACHE_MAX) {
+        GList *lru = g_queue_pop_tail_link(&p->cache_lru);
+
+        g_hash_table_remove(p->cache, ((struct pipe_cache_ent *)lru->data)->value);
+    }
+
+    e = g_new0(struct pipe_cache_ent, 1);
+    e->value = g_strdup(value);
+    e->reply = reply;
+    e->link.data = e;
+    g_queue_push_head_link(&p->cache_lru, &e->link);
+    g_hash_table_insert(p->cache, e->value, e);
+}
+
+static void pipeio_worker_clear(gpointer data)
+{
+    struct pipe_worker *w = data;
+
+    g_async_queue_unref(w->queue);
+    g_ptr_array_free(w->deferred, TRUE);
+    g_hash_table_destroy(w->pending);
+}
+
+static void pipeio_batch_free(struct pipe_batch *b)
+{
+    guint i;
+
+    for (i = 0; i < b->values->len; i++) {
+        g_free(b->replies[i]);
+    }
+    g_free(b->replies);
+    g_ptr_array_free(b->values, TRUE);
+    if (b->data_free) {
+        b->data_free(b->data);
+    }
+    g_atomic_rc_box_release_full(b->w, pipeio_worker_clear);
+    g_free(b);
+}
+
+static gboolean pipeio_batch_deliver(gpointer data)
+{
+    struct pipe_batch *b = data;
+    struct pipe_worker *w = b->w;
+    guint i;
+
+    if (w->p) {
+        for (i = 0; i < b->values->len; i++) {
+            char *value = g_ptr_array_index(b->values, i);
+
+            pipeio_cache_insert(w->p, value, b->replies[i]);
+            b->replies[i] = NULL;
+            g_hash_table_remove(w->pending, value);
+        }
+
+        if (b->done) {
+            b->done(b->data);
+        }
+    }
+
+    pipeio_batch_free(b);
+    return (G_SOURCE_REMOVE);
+}
+
+static gpointer pipeio_worker_thread(gpointer data)
+{
+    struct pipe_worker *w = data;
+    struct pipe_ctx *p = w->p; /* outlives the thread, see pipeio_shutdown() */
+
+#if !defined __MINGW32__
+    sigset_t set;
+
+    /* writes to a filter killed by pipeio_destroy() fail with EPIPE instead */
+    sigemptyset(&set);
+    sigaddset(&set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+#endif
+
+    for (;;) {
+        struct pipe_batch *b = g_async_queue_pop(w->queue);
+
+        if (b->values == NULL) { /* stop request */
+            g_free(b);
+            break;
+        }
+
+        pipeio_exchange(p, (char **)b->values->pdata, b->replies, b->values->len);
+        g_idle_add(pipeio_batch_deliver, b);
+    }
+
+    g_atomic_rc_box_release_full(w, pipeio_worker_clear);
+    return (NULL);
+}
+
+static void pipeio_init(struct pipe_ctx *p)
+{
+    g_mutex_init(&p->io_lock);
+    p->reply_max = 0;
+    p->cache = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, pipeio_cache_ent_free);
+    g_queue_init(&p->cache_lru);
+    p->worker = NULL;
+}
+
+static void pipeio_shutdown(struct pipe_ctx *p)
+{
+    struct pipe_worker *w = p->worker;
+
+    if (w) {
+        if (w->thread) {
+            /* the filter is gone by now, batches in flight get empty replies */
+            g_async_queue_push(w->queue, g_new0(struct pipe_batch, 1));
+            g_thread_join(w->thread);
+        }
+        w->p = NULL; /* batches waiting for delivery are dropped */
+        g_atomic_rc_box_release_full(w, pipeio_worker_clear);
+        p->worker = NULL;
+    }
+
+    g_hash_table_destroy(p->cache);
+    g_mutex_clear(&p->io_lock);
+}
+
+/*
+ * returns the reply of the filter for s or NULL if the filter did not
+ * answer.  with defer set, values missing from the cache are only
+ * collected for pipeio_flush_deferred() and NULL is returned.
+ */
+char *pipeio_translate(struct pipe_ctx *p, const char *s, gboolean defer)
+{
+    const char *cached = pipeio_cache_lookup(p, s);
+    char *reply;
+
+    if (cached) {
+        return (*cached ? strdup_2(cached) : NULL);
+    }
+
+    if (defer) {
+        struct pipe_worker *w = p->worker;
+
+        if (!w) {
+            w = p->worker = g_atomic_rc_box_new0(struct pipe_worker);
+            w->p = p;
+            w->queue = g_async_queue_new();
+            w->deferred = g_ptr_array_new();
+            w->pending = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+        }
+
+        if (!g_hash_table_contains(w->pending, s)) {
+            char *value = g_strdup(s);
+
+            g_hash_table_add(w->pending, value);
+            g_ptr_array_add(w->deferred, value);
+        }
+
+        return (NULL);
+    }
+
+    pipeio_exchange(p, (char **)&s, &reply, 1);
+    pipeio_cache_insert(p, s, reply);
+
+    return (*reply ? strdup_2(reply) : NULL);
+}
+
+/*
+ * sends the values collected by pipeio_translate() to the filter on a
+ * background thread, done(data) is called on the main thread once the
+ * replies are in the cache.  data_free(data) is called when the batch is
+ * released, whether or not done() was called.
+ */
+void pipeio_flush_deferred(struct pipe_ctx *p,
+                           void (*done)(gpointer data),
+                           gpointer data,
+                           GDestroyNotify data_free)
+{
+    struct pipe_worker *w = p->worker;
+    struct pipe_batch *b;
+    guint i;
+
+    if (!w || !w->deferred->len) {
+        if (data_free) {
+            data_free(data);
+        }
+        return;
+    }
+
+    if (!w->thread) {
+        w->thread = g_thread_new("pipeio", pipeio_worker_thread, g_atomic_rc_box_acquire(w));
+    }
+
+    b = g_new0(struct pipe_batch, 1);
+    b->w = g_atomic_rc_box_acquire(w);
+    b->values = g_ptr_array_new_full(w->deferred->len, g_free);
+    b->replies = g_new0(char *, w->deferred->len);
+    b->done = done;
+    b->data = data;
+    b->data_free = data_free;
+    for (i = 0; i < w->deferred->len; i++) {
+        /* the pending table owns its keys, the batch gets copies */
+        g_ptr_array_add(b->values, g_strdup(g_ptr_array_index(w->deferred, i)));
+    }
+    g_ptr_array_set_size(w->deferred, 0);
+
+    g_async_queue_push(w->queue, b);
+}
@@ -27,8 +27,16 @@
 #include <windows.h>
 #endif
 
+struct pipe_worker;
+
 struct pipe_ctx
 {
+    GMutex io_lock; /* serializes exchanges with the child */
+    gsize reply_max; /* longest reply seen, guarded by io_lock */
+    GHashTable *cache; /* value -> struct pipe_cache_ent, main thread only */
+    GQueue cache_lru; /* cache entries, most recently used first */
+    struct pipe_worker *worker; /* created on the first deferred value */
+
 #if defined __MINGW32__
 
     HANDLE g_hChildStd_IN_Rd;
@@ -49,4 +57,15 @@ struct pipe_ctx
 struct pipe_ctx *pipeio_create(char *execappname, char *arg);
 void pipeio_destroy(struct pipe_ctx *p);
 
+/* reads one line into buf (1025 bytes), returns its length or -1 at the end of the output */
+int pipeio_read_line(struct pipe_ctx *p, char *buf);
+/* terminates the filter so a thread blocked in pipeio_read_line() returns */
+void pipeio_hangup(struct pipe_ctx *p);
+
+char *pipeio_translate(struct pipe_ctx *p, const char *s, gboolean defer);
+void pipeio_flush_deferred(struct pipe_ctx *p,
+                           void (*done)(gpointer data),
+                           gpointer data,
+                           GDestroyNotify data_free);
+
 #endif
@@ -14,6 +14,7 @@
 #include "symbol.h"
 #include "ptranslate.h"
 #include "pipeio.h"
+#include "gw-wave-view.h"
 #include "debug.h"
 
 enum
@@ -92,6 +93,46 @@ void remove_all_proc_filters(void)
     }
 }
 
+/*
+ * while the waves are drawn, values missing from the filter caches are
+ * collected and sent to each filter as one batch when the draw is done.
+ * the waves are redrawn with the translated values once they arrive.
+ */
+static gboolean proc_filter_batch;
+
+static void proc_filter_batch_done(gpointer data)
+{
+    gw_wave_view_force_redraw(GW_WAVE_VIEW(data));
+}
+
+void begin_proc_filter_batch(void)
+{
+    proc_filter_batch = TRUE;
+}
+
+void end_proc_filter_batch(GwWaveView *view)
+{
+    int i;
+
+    proc_filter_batch = FALSE;
+
+    if (GLOBALS->proc_filter) {
+        for (i = 1; i < PROC_FILTER_MAX + 1; i++) {
+            if (GLOBALS->proc_filter[i]) {
+                pipeio_flush_deferred(GLOBALS->proc_filter[i],
+                                      proc_filter_batch_done,
+                                      g_object_ref(view),
+                                      g_object_unref);
+            }
+        }
+    }
+}
+
+gboolean proc_filter_batch_active(void)
+{
+    return proc_filter_batch;
+}
+
 /*
  * this is likely obsolete
  */
@@ -17,6 +17,7 @@
 #include <ctype.h>
 #include "fgetdynamic.h"
 #include "debug.h"
+#include "gw-wave-view.h"
 
 #define PROC_FILTER_MAX (128)
 
@@ -26,4 +27,9 @@ int install_proc_filter(int which);
 void set_current_translate_proc(char *name);
 void remove_all_proc_filters(void);
 
+void begin_proc_filter_batch(void);
+/* view is redrawn once the values collected while it was drawn are translated */
+void end_proc_filter_batch(GwWaveView *view);
+gboolean proc_filter_batch_active(void);
+
 #endif
@@ -234,6 +234,13 @@ int f_enable_horiz_grid(const char *str)
     return (0);
 }
 
+int f_enable_stats(const char *str)
+{
+    DEBUG(printf("f_enable_stats(\"%s\")\n", str));
+    gw_stats_set_enabled(atoi_64(str) ? TRUE : FALSE);
+    return (0);
+}
+
 int f_enable_vert_grid(const char *str)
 {
     DEBUG(printf("f_enable_vert_grid(\"%s\")\n", str));
@@ -608,6 +615,13 @@ int f_vcd_preserve_glitches_real(const char *str)
     return (0);
 }
 
+int f_vcd_saver_parallel_min(const char *str)
+{
+    DEBUG(printf("f_vcd_saver_parallel_min(\"%s\")\n", str));
+    GLOBALS->settings.vcd_saver_parallel_min = atoi_64(str);
+    return (0);
+}
+
 int f_vcd_warning_filesize(const char *str)
 {
     DEBUG(printf("f_vcd_warning_filesize(\"%s\")\n", str));
@@ -817,6 +831,7 @@ static struct rc_entry rcitems[] = {{"accel", f_accel},
                                     {"enable_fast_exit", f_enable_fast_exit},
                                     {"enable_ghost_marker", f_enable_ghost_marker},
                                     {"enable_horiz_grid", f_enable_horiz_grid},
+                                    {"enable_stats", f_enable_stats},
                                     {"enable_vert_grid", f_enable_vert_grid},
                                     {"fill_waveform", f_fill_waveform},
                                     {"fontname_logfile", f_fontname_logfile},
@@ -860,6 +875,7 @@ static struct rc_entry rcitems[] = {{"accel", f_accel},
                                     {"use_roundcaps", f_use_roundcaps},
                                     {"vcd_preserve_glitches", f_vcd_preserve_glitches},
                                     {"vcd_preserve_glitches_real", f_vcd_preserve_glitches_real},
+                                    {"vcd_saver_parallel_min", f_vcd_saver_parallel_min},
                                     {"vcd_warning_filesize", f_vcd_warning_filesize},
                                     {"vector_padding", f_vector_padding},
                                     {"vlist_compression", f_vlist_compression},
@@ -78,6 +78,7 @@ int f_dynamic_resizing(const char *str);
 int f_enable_fast_exit(const char *str);
 int f_enable_ghost_marker(const char *str);
 int f_enable_horiz_grid(const char *str);
+int f_enable_stats(const char *str);
 int f_enable_vert_grid(const char *str);
 int f_fill_waveform(const char *str);
 int f_fontname_logfile(const char *str);
@@ -106,6 +107,7 @@ int f_use_maxtime_display(const char *str);
 int f_use_nonprop_fonts(const char *str);
 int f_use_roundcaps(const char *str);
 int f_vcd_preserve_glitches(const char *str);
+int f_vcd_saver_parallel_min(const char *str);
 int f_vcd_warning_filesize(const char *str);
 int f_vector_padding(const char *str);
 int f_vlist_compression(const char *str);
@@ -0,0 +1,181 @@
+#include <config.h>
+#include <gtk/gtk.h>
+#include <math.h>
+#ifdef CAIRO_HAS_SVG_SURFACE
+#include <cairo-svg.h>
+#endif
+#include "globals.h"
+#include "analyzer.h"
+#include "currenttime.h"
+#include "gw-wave-view.h"
+#include "render_file.h"
+#include "signal_list.h"
+#include "wavewindow.h"
+
+/*
+ * Renders the signal names and waveforms to a PNG or SVG file without
+ * creating any widgets, enabled with --render. This works without a display,
+ * e.g. to compare the waveforms of a regression test in CI.
+ */
+
+#define RENDER_FILE_MIN_WAVE_WIDTH 16
+
+gboolean render_file_parse_size(const gchar *size, gint *width, gint *height)
+{
+    gint w = 0;
+    gint h = 0;
+    gchar c;
+
+    if (sscanf(size, "%dx%d%c", &w, &h, &c) != 2 || w <= 0 || h <= 0 || w > 32767 ||
+        h > 32767) {
+        return FALSE;
+    }
+
+    *width = w;
+    *height = h;
+
+    return TRUE;
+}
+
+static void render_file_set_zoom(GwTime start, GwTime end, gint wave_width)
+{
+    gdouble range = end - start + 1;
+    gdouble estimated = -log(range / wave_width * 200.0) / log(GLOBALS->zoombase);
+    if (estimated > ((gdouble)(0.0))) {
+        estimated = ((gdouble)(0.0));
+    }
+
+    calczoom(estimated);
+    GLOBALS->tims.zoom = estimated;
+}
+
+// Determines the start time and the zoom from the command line options and
+// the save file, in the same way the main window would.
+static gboolean render_file_set_time_window(const RenderFileOptions *options, gint wave_width)
+{
+    GwTime global_time_offset = gw_dump_file_get_global_time_offset(GLOBALS->dump_file);
+    GwTimeDimension time_dimension = gw_dump_file_get_time_dimension(GLOBALS->dump_file);
+
+    GwTime start = GLOBALS->tims.first;
+    GwTime end = GLOBALS->tims.last;
+    gboolean fit = FALSE;
+
+    if (options->start != NULL) {
+        start = unformat_time(options->start, time_dimension) - global_time_offset;
+    } else if (GLOBALS->timestart_from_savefile_valid) {
+        start = GLOBALS->timestart_from_savefile;
+    }
+
+    if (options->end != NULL) {
+        end = unformat_time(options->end, time_dimension) - global_time_offset;
+        if (end <= start) {
+            fprintf(stderr, "GTKWAVE | Render end time must be after the start time\n");
+            return FALSE;
+        }
+        fit = TRUE;
+    } else if (options->start == NULL && GLOBALS->do_initial_zoom_fit) {
+        start = GLOBALS->tims.first;
+        fit = TRUE;
+    }
+
+    if (start < GLOBALS->tims.first) {
+        start = GLOBALS->tims.first;
+    } else if (start > GLOBALS->tims.last) {
+        start = GLOBALS->tims.last;
+    }
+
+    if (fit) {
+        render_file_set_zoom(start, end, wave_width);
+    }
+
+    GLOBALS->tims.start = GLOBALS->tims.laststart = start;
+    GLOBALS->tims.timecache = start;
+
+    return TRUE;
+}
+
+static void render_file_draw(cairo_t *cr, gint names_width, gint width, gint height)
+{
+    GwSignalListColors *signal_list_colors =
+        gw_color_theme_get_signal_list_colors(GLOBALS->color_theme);
+    GwWaveformColors *waveform_colors = gw_color_theme_get_waveform_colors(GLOBALS->color_theme);
+    if (GLOBALS->black_and_white) {
+        signal_list_colors = gw_signal_list_colors_new_black_and_white();
+        waveform_colors = gw_waveform_colors_new_black_and_white();
+    }
+
+    gw_signal_list_render_offscreen(cr, signal_list_colors, names_width, height);
+
+    cairo_save(cr);
+    cairo_translate(cr, names_width, 0);
+    gw_wave_view_render_offscreen(cr, waveform_colors, width - names_width, height);
+    cairo_restore(cr);
+
+    if (GLOBALS->black_and_white) {
+        g_free(signal_list_colors);
+        g_free(waveform_colors);
+    }
+}
+
+gboolean render_to_file(const RenderFileOptions *options)
+{
+    g_return_val_if_fail(options != NULL, FALSE);
+    g_return_val_if_fail(options->filename != NULL, FALSE);
+
+    if (GLOBALS->dump_file == NULL) {
+        fprintf(stderr, "GTKWAVE | No dump file to render\n");
+        return FALSE;
+    }
+
+    load_all_fonts();
+
+    GLOBALS->signalwindow_width_dirty = 1;
+    MaxSignalLength();
+
+    gint names_width = MIN(GLOBALS->signal_pixmap_width, options->width / 2);
+    gint wave_width = options->width - names_width;
+    if (wave_width < RENDER_FILE_MIN_WAVE_WIDTH) {
+        fprintf(stderr, "GTKWAVE | Render size is too small\n");
+        return FALSE;
+    }
+
+    if (!render_file_set_time_window(options, wave_width)) {
+        return FALSE;
+    }
+
+    gboolean is_svg = g_str_has_suffix(options->filename, ".svg");
+    cairo_surface_t *surface;
+    if (is_svg) {
+#ifdef CAIRO_HAS_SVG_SURFACE
+        surface = cairo_svg_surface_create(options->filename, options->width, options->height);
+#else
+        fprintf(stderr, "GTKWAVE | SVG output is not supported by this cairo build\n");
+        return FALSE;
+#endif
+    } else {
+        surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, options->width, options->height);
+    }
+
+    cairo_t *cr = cairo_create(surface);
+    render_file_draw(cr, names_width, options->width, options->height);
+    cairo_destroy(cr);
+
+    cairo_status_t status;
+    if (is_svg) {
+        cairo_surface_finish(surface);
+        status = cairo_surface_status(surface);
+    } else {
+        status = cairo_surface_write_to_png(surface, options->filename);
+    }
+    cairo_surface_destroy(surface);
+
+    if (status != CAIRO_STATUS_SUCCESS) {
+        fprintf(stderr,
+                "GTKWAVE | Could not write '%s': %s\n",
+                options->filename,
+                cairo_status_to_string(status));
+        return FALSE;
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct
+{
+    const gchar *filename;
+    gint width;
+    gint height;
+    const gchar *start; // (nullable)
+    const gchar *end; // (nullable)
+} RenderFileOptions;
+
+gboolean render_file_parse_size(const gchar *size, gint *width, gint *height);
+gboolean render_to_file(const RenderFileOptions *options);
+
+G_END_DECLS
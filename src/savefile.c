@@ -623,6 +623,188 @@ bot:
     return (rp);
 }
 
+/*
+ * signal names of a save file which are resolved in one batch before it is
+ * restored, so that parsing the lines doesn't need a lookup per signal...
+ */
+static GHashTable *restore_symbols = NULL;
+static GPtrArray *restore_symbol_names = NULL;
+
+GwSymbol *savefile_lookup_symbol(const char *name)
+{
+    if (restore_symbols != NULL) {
+        GwSymbol *s = g_hash_table_lookup(restore_symbols, name);
+        if (s != NULL) {
+            return s;
+        }
+    }
+
+    return gw_dump_file_lookup_symbol(GLOBALS->dump_file, name);
+}
+
+static void restore_add_name(const char *name, size_t len)
+{
+    char *pnt;
+
+    if (name[0] == '(') /* bit extraction of a vector */
+    {
+        pnt = memchr(name, ')', len);
+        if (pnt == NULL) {
+            return;
+        }
+        len -= pnt + 1 - name;
+        name = pnt + 1;
+    }
+
+    if ((len == 0) || memchr(name, '*', len)) /* wildcards are matched later */
+        return;
+
+    pnt = g_strndup(name, len);
+    if (g_hash_table_contains(restore_symbols, pnt)) {
+        g_free(pnt);
+    } else {
+        g_hash_table_insert(restore_symbols, pnt, NULL);
+        g_ptr_array_add(restore_symbol_names, pnt);
+    }
+}
+
+/*
+ * collect the names of the signals a save file line refers to...
+ */
+static void restore_collect_names(const char *line)
+{
+    const char *pnt = line;
+    size_t len;
+
+    while (isspace((int)(unsigned char)*pnt))
+        pnt++;
+
+    if ((*pnt == '+') || (*pnt == '#')) /* alias or vector, skip the {name} */
+    {
+        int is_vector = (*pnt == '#');
+
+        pnt = strchr(pnt, '}');
+        if (pnt == NULL)
+            return;
+        pnt++;
+
+        if (is_vector) {
+            for (;;) {
+                while (isspace((int)(unsigned char)*pnt))
+                    pnt++;
+                if (!*pnt)
+                    break;
+
+                len = strcspn(pnt, " \t");
+                restore_add_name(pnt, len);
+                pnt += len;
+            }
+            return;
+        }
+
+        while (isspace((int)(unsigned char)*pnt))
+            pnt++;
+    }
+
+    if ((!*pnt) || strchr("[*->@+#:!?^", *pnt))
+        return;
+
+    len = strlen(pnt);
+    if (strcspn(pnt, " \t") == len) {
+        restore_add_name(pnt, len);
+    }
+}
+
+static void restore_resolve_symbols(GPtrArray *lines)
+{
+    GwSymbol **symbols;
+    guint i;
+
+    restore_symbols = g_hash_table_new(g_str_hash, g_str_equal);
+    restore_symbol_names = g_ptr_array_new_with_free_func(g_free);
+
+    for (i = 0; i < lines->len; i++) {
+        restore_collect_names(g_ptr_array_index(lines, i));
+    }
+
+    symbols = g_new(GwSymbol *, restore_symbol_names->len);
+    gw_dump_file_lookup_symbols(GLOBALS->dump_file,
+                                (const gchar *const *)restore_symbol_names->pdata,
+                                restore_symbol_names->len,
+                                symbols);
+
+    for (i = 0; i < restore_symbol_names->len; i++) {
+        g_hash_table_insert(restore_symbols,
+                            g_ptr_array_index(restore_symbol_names, i),
+                            symbols[i]);
+    }
+
+    g_free(symbols);
+}
+
+static void restore_free_symbols(void)
+{
+    g_clear_pointer(&restore_symbols, g_hash_table_destroy);
+    g_clear_pointer(&restore_symbol_names, g_ptr_array_unref);
+}
+
+static void free_save_line(gpointer line)
+{
+    free_2(line);
+}
+
+/*
+ * read all lines of a save file, so that the passes over it don't need to
+ * read (and possibly decompress) the file again...
+ */
+GPtrArray *read_save_lines(FILE *wave)
+{
+    GPtrArray *lines = g_ptr_array_new_with_free_func(free_save_line);
+    char *iline;
+
+    while ((iline = fgetmalloc(wave))) {
+        g_ptr_array_add(lines, iline);
+    }
+
+    return lines;
+}
+
+/*
+ * parse the lines of a save file: the signal names are resolved in one batch
+ * and the signals are imported before the traces are added...
+ */
+void parse_save_lines(GPtrArray *lines)
+{
+    guint i;
+
+    if (GLOBALS->dump_file) {
+        restore_resolve_symbols(lines);
+    }
+
+    if (GLOBALS->is_lx2) {
+        for (i = 0; i < lines->len; i++) {
+            parsewavline_lx2(g_ptr_array_index(lines, i), NULL, 0);
+        }
+
+        lx2_import_masked();
+    }
+
+    GLOBALS->default_flags = TR_RJUSTIFY;
+    GLOBALS->default_fpshift = 0;
+    GLOBALS->shift_timebase_default_for_add = GW_TIME_CONSTANT(0);
+    GLOBALS->strace_current_window = 0; /* in case there are shadow traces */
+
+    GLOBALS->which_t_color = 0;
+    for (i = 0; i < lines->len; i++) {
+        parsewavline(g_ptr_array_index(lines, i), NULL, 0);
+        GLOBALS->strace_ctx->shadow_encountered_parsewavline |=
+            GLOBALS->strace_ctx->shadow_active;
+    }
+    GLOBALS->which_t_color = 0;
+
+    restore_free_symbols();
+}
+
 int read_save_helper(char *wname,
                      char **dumpfile,
                      char **savefile,
@@ -657,6 +839,7 @@ int read_save_helper(char *wname,
         errno = 0;
     } else {
         char *iline;
+        GPtrArray *lines;
         int s_ctx_iter;
 
         if (extract_dumpfile_savefile_only) {
@@ -734,7 +917,14 @@ int read_save_helper(char *wname,
             return (rc);
         }
 
+        lines = read_save_lines(wave);
+        if (wave_is_compressed)
+            pclose(wave);
+        else
+            fclose(wave);
+
         read_save_helper_relative_init(wname);
+        redraw_batch_begin();
 
         WAVE_STRACE_ITERATOR(s_ctx_iter)
         {
@@ -748,45 +938,9 @@ int read_save_helper(char *wname,
             /*		 AddBlankTrace(NULL); in order to terminate any possible collapsed groups */
         }
 
-        if (GLOBALS->is_lx2) {
-            while ((iline = fgetmalloc(wave))) {
-                parsewavline_lx2(iline, NULL, 0);
-                free_2(iline);
-            }
-
-            lx2_import_masked();
-
-            if (wave_is_compressed) {
-                pclose(wave);
-                wave = popen(str, "r");
-            } else {
-                fclose(wave);
-                wave = fopen(wname, "rb");
-            }
-
-            if (!wave) {
-                fprintf(stderr, "Error opening save file '%s' for reading.\n", wname);
-                perror("Why");
-                errno = 0;
-                return (rc);
-            }
-        }
-
-        GLOBALS->default_flags = TR_RJUSTIFY;
-        GLOBALS->default_fpshift = 0;
-        GLOBALS->shift_timebase_default_for_add = GW_TIME_CONSTANT(0);
-        GLOBALS->strace_current_window = 0; /* in case there are shadow traces */
-
-        rc = 0;
-        GLOBALS->which_t_color = 0;
-        while ((iline = fgetmalloc(wave))) {
-            parsewavline(iline, NULL, 0);
-            GLOBALS->strace_ctx->shadow_encountered_parsewavline |=
-                GLOBALS->strace_ctx->shadow_active;
-            free_2(iline);
-            rc++;
-        }
-        GLOBALS->which_t_color = 0;
+        parse_save_lines(lines);
+        rc = lines->len;
+        g_ptr_array_free(lines, TRUE);
 
         WAVE_STRACE_ITERATOR(s_ctx_iter)
         {
@@ -812,10 +966,6 @@ int read_save_helper(char *wname,
         GLOBALS->default_fpshift = 0;
         GLOBALS->shift_timebase_default_for_add = GW_TIME_CONSTANT(0);
         update_time_box();
-        if (wave_is_compressed)
-            pclose(wave);
-        else
-            fclose(wave);
 
         if (traces_already_exist)
             GLOBALS->timestart_from_savefile_valid = 0;
@@ -824,6 +974,7 @@ int read_save_helper(char *wname,
 
         GLOBALS->signalwindow_width_dirty = 1;
         redraw_signals_and_waves();
+        redraw_batch_end();
 
 #ifdef MAC_INTEGRATION
         if (GLOBALS->num_notebook_pages > 1)
@@ -1077,7 +1228,7 @@ int parsewavline(char *w, char *alias, int depth)
                 }
             }
 
-            s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, suffix + i);
+            s = savefile_lookup_symbol(suffix + i);
             if (s) {
                 nexp = ExtractNodeSingleBit(s->n, atoi(suffix + 1));
                 if (nexp) {
@@ -1111,7 +1262,7 @@ int parsewavline(char *w, char *alias, int depth)
                     sprintf(ns, "%s[%d]", suffix + i, actual);
                     *lp = '[';
 
-                    s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, ns);
+                    s = savefile_lookup_symbol(ns);
                     free_2(ns);
                     if (s) {
                         AddNode(s->n, prefix + 1);
@@ -1627,13 +1778,13 @@ int maketraces_lx2(char *str, char *alias, int quick_return)
                 }
             }
 
-            if ((s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, str + i))) {
+            if ((s = savefile_lookup_symbol(str + i))) {
                 lx2_set_fac_process_mask(s->n);
                 made = ~0;
             }
             return (made);
         } else {
-            if ((s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, str))) {
+            if ((s = savefile_lookup_symbol(str))) {
                 lx2_set_fac_process_mask(s->n);
                 made = ~0;
             }
@@ -1727,7 +1878,7 @@ int makevec_lx2(char *str)
                             break;
                         if ((wild[i] == ')') && (wild[i + 1])) {
                             i++;
-                            s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, wild + i);
+                            s = savefile_lookup_symbol(wild + i);
                             if (s) {
                                 lx2_set_fac_process_mask(s->n);
                                 rc = 1;
@@ -1736,7 +1887,7 @@ int makevec_lx2(char *str)
                         }
                     }
                 } else {
-                    if ((s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, wild))) {
+                    if ((s = savefile_lookup_symbol(wild))) {
                         lx2_set_fac_process_mask(s->n);
                         rc = 1;
                     }
@@ -1861,7 +2012,7 @@ int parsewavline_lx2(char *w, char *alias, int depth)
                 }
             }
 
-            s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, suffix + i);
+            s = savefile_lookup_symbol(suffix + i);
             if (s) {
                 lx2_set_fac_process_mask(s->n);
                 made = ~0;
@@ -1890,7 +2041,7 @@ int parsewavline_lx2(char *w, char *alias, int depth)
                     sprintf(ns, "%s[%d]", suffix + i, actual);
                     *lp = '[';
 
-                    s = gw_dump_file_lookup_symbol(GLOBALS->dump_file, ns);
+                    s = savefile_lookup_symbol(ns);
                     free_2(ns);
                     if (s) {
                         lx2_set_fac_process_mask(s->n);
@@ -29,6 +29,9 @@ char *append_array_row(GwNode *n);
 
 int parsewavline(char *w, char *alias, int depth);
 int parsewavline_lx2(char *w, char *alias, int depth);
+GPtrArray *read_save_lines(FILE *wave);
+void parse_save_lines(GPtrArray *lines);
+GwSymbol *savefile_lookup_symbol(const char *name);
 
 char *find_dumpfile(char *orig_save, char *orig_dump, char *this_save);
 
@@ -77,6 +77,9 @@ static const char *regex_type[] = {"(?:\\[.*\\])*$",
                                    ""};
 static const char *regex_name[] = {"WRange", "WStrand", "Range", "Strand", "None"};
 
+static void search_start_pending(void);
+static void search_cancel_pending(void);
+
 static void on_changed(GtkComboBox *widget, gpointer user_data)
 {
     (void)user_data;
@@ -92,6 +95,10 @@ static void on_changed(GtkComboBox *widget, gpointer user_data)
     GLOBALS->regex_mutex_search_c_1[GLOBALS->regex_which_search_c_1] = 1; /* mark our choice */
 
     DEBUG(printf("picked: %s\n", regex_name[GLOBALS->regex_which_search_c_1]));
+
+    if (!GLOBALS->is_searching_running_search_c_1) {
+        search_start_pending();
+    }
 }
 
 /***************************************************************************/
@@ -125,6 +132,9 @@ void search_insert_callback(GtkWidget *widget, char is_prepend)
     wave_gtk_grab_add(widget);
     set_window_busy(widget);
 
+    /* the rows are walked below while the main loop runs */
+    search_cancel_pending();
+
     symc = NULL;
 
     memcpy(&tcache, &GLOBALS->traces, sizeof(Traces));
@@ -270,6 +280,9 @@ static void replace_callback(GtkWidget *widget, GtkWidget *nothing)
     wave_gtk_grab_add(widget);
     set_window_busy(widget);
 
+    /* the rows are walked below while the main loop runs */
+    search_cancel_pending();
+
     tfirst = NULL;
     tlast = NULL;
     symc = NULL;
@@ -462,6 +475,9 @@ static void ok_callback(GtkWidget *widget, GtkWidget *nothing)
     wave_gtk_grab_add(widget);
     set_window_busy(widget);
 
+    /* the rows are walked below while the main loop runs */
+    search_cancel_pending();
+
     symc = NULL;
 
     interval = (gfloat)(GLOBALS->num_rows_search_c_2 / 100.0);
@@ -569,63 +585,54 @@ static void ok_callback(GtkWidget *widget, GtkWidget *nothing)
     GLOBALS->is_append_running_search_c_1 = 0;
 }
 
-void search_enter_callback(GtkWidget *widget, GtkWidget *do_warning)
+/*
+ * Search as you type: every change of the search expression cancels the
+ * running search and starts a new one, which is run in steps from an idle
+ * callback so that the first matches are shown while the search continues.
+ */
+
+#define SEARCH_STEP_CANDIDATES 16384
+
+static GwSymbolSearch *pending_search = NULL;
+static guint pending_search_source = 0;
+static struct Global *pending_search_globals = NULL;
+static GString *pending_search_duplicate_row_buffer = NULL;
+
+static void search_cancel_pending(void)
 {
-    if (GLOBALS->is_searching_running_search_c_1) {
-        return;
+    g_clear_handle_id(&pending_search_source, g_source_remove);
+    g_clear_object(&pending_search);
+    pending_search_globals = NULL;
+
+    if (pending_search_duplicate_row_buffer != NULL) {
+        g_string_free(pending_search_duplicate_row_buffer, TRUE);
+        pending_search_duplicate_row_buffer = NULL;
     }
-    GLOBALS->is_searching_running_search_c_1 = ~0;
-    wave_gtk_grab_add(widget);
+}
 
+static gchar *search_build_regex(void)
+{
     const gchar *entry_text = gtk_entry_get_text(GTK_ENTRY(GLOBALS->entry_search_c_3));
     entry_text = entry_text ? entry_text : "";
     DEBUG(printf("Entry contents: %s\n", entry_text));
 
     free_2(GLOBALS->searchbox_text_search_c_1);
-
-    if (strlen(entry_text) > 0) {
-        GLOBALS->searchbox_text_search_c_1 = strdup_2(entry_text);
-    } else {
-        GLOBALS->searchbox_text_search_c_1 = strdup_2("");
-    }
-
-    GLOBALS->num_rows_search_c_2 = 0;
+    GLOBALS->searchbox_text_search_c_1 = strdup_2(entry_text);
 
     gboolean use_word_boundaries = GLOBALS->regex_which_search_c_1 < 2;
     const gchar *regex_suffix = regex_type[GLOBALS->regex_which_search_c_1];
 
-    gchar *regex;
     if (use_word_boundaries) {
-        regex = g_strconcat("\\b", GLOBALS->searchbox_text_search_c_1, regex_suffix, NULL);
+        return g_strconcat("\\b", GLOBALS->searchbox_text_search_c_1, regex_suffix, NULL);
     } else {
-        regex = g_strconcat(GLOBALS->searchbox_text_search_c_1, regex_suffix, NULL);
+        return g_strconcat(GLOBALS->searchbox_text_search_c_1, regex_suffix, NULL);
     }
+}
 
-    GPtrArray *symbols = gw_dump_file_find_symbols(GLOBALS->dump_file, regex, NULL);
-    if (symbols == NULL) {
-        // TODO: show in UI
-        g_warning("Invalid regex: %s", regex);
-        symbols = g_ptr_array_new();
-    }
-
-    // GLOBALS->pdata->oldvalue = -1.0;
-    // interval = (gfloat)(numfacs / 100.0);
-
-    gtk_list_store_clear(GTK_LIST_STORE(GLOBALS->sig_store_search));
-
-    GString *duplicate_row_buffer = g_string_new(NULL);
-
+/* returns FALSE when the maximum number of rows has been reached */
+static gboolean search_append_symbols(GPtrArray *symbols, GString *duplicate_row_buffer)
+{
     for (guint i = 0; i < symbols->len; i++) {
-        // TODO: update progress bar while `gw_dump_file_find_symbols` is searching for symbols
-        // GLOBALS->pdata->value = i;
-        // if (((int)(GLOBALS->pdata->value / interval)) !=
-        //     ((int)(GLOBALS->pdata->oldvalue / interval))) {
-        //     gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(GLOBALS->pdata->pbar),
-        //                                   i / (gfloat)((numfacs > 1) ? numfacs - 1 : 1));
-        //     gtkwave_main_iteration();
-        // }
-        // GLOBALS->pdata->oldvalue = i;
-
         GwSymbol *fac = g_ptr_array_index(symbols, i);
 
         if (strcmp(fac->name, duplicate_row_buffer->str) == 0) {
@@ -671,11 +678,111 @@ void search_enter_callback(GtkWidget *widget, GtkWidget *do_warning)
         GLOBALS->num_rows_search_c_2++;
         if (GLOBALS->num_rows_search_c_2 == WAVE_MAX_CLIST_LENGTH) {
             /* if(was_packed) { free_2(hfacname); } ...not needed with HIER_DEPACK_STATIC */
-            break;
+            return FALSE;
         }
     }
 
+    return TRUE;
+}
+
+static gboolean search_step_idle(gpointer user_data)
+{
+    (void)user_data;
+
+    /* the tab was switched or the dialog was closed */
+    if (GLOBALS != pending_search_globals || GLOBALS->sig_store_search == NULL) {
+        pending_search_source = 0;
+        search_cancel_pending();
+        return G_SOURCE_REMOVE;
+    }
+
+    GPtrArray *symbols = g_ptr_array_new();
+
+    gboolean more = gw_symbol_search_step(pending_search, SEARCH_STEP_CANDIDATES, symbols);
+    if (!search_append_symbols(symbols, pending_search_duplicate_row_buffer)) {
+        more = FALSE;
+    }
+
+    g_ptr_array_free(symbols, TRUE);
+
+    if (more) {
+        gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(GLOBALS->pdata->pbar),
+                                      gw_symbol_search_get_progress(pending_search));
+        return G_SOURCE_CONTINUE;
+    }
+
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(GLOBALS->pdata->pbar), 0.0);
+    pending_search_source = 0;
+    search_cancel_pending();
+
+    return G_SOURCE_REMOVE;
+}
+
+static void search_start_pending(void)
+{
+    search_cancel_pending();
+
+    gchar *regex = search_build_regex();
+    GwSymbolSearch *search = gw_dump_file_search_symbols(GLOBALS->dump_file, regex, NULL);
+    g_free(regex);
+
+    /* keep the previous matches while the expression is incomplete */
+    if (search == NULL) {
+        return;
+    }
+
+    gtk_list_store_clear(GTK_LIST_STORE(GLOBALS->sig_store_search));
+    GLOBALS->num_rows_search_c_2 = 0;
+
+    pending_search = search;
+    pending_search_globals = GLOBALS;
+    pending_search_duplicate_row_buffer = g_string_new(NULL);
+    pending_search_source = g_idle_add(search_step_idle, NULL);
+}
+
+static void search_changed_callback(GtkEditable *editable, gpointer user_data)
+{
+    (void)editable;
+    (void)user_data;
+
+    if (GLOBALS->is_searching_running_search_c_1 || GLOBALS->is_insert_running_search_c_1 ||
+        GLOBALS->is_replace_running_search_c_1 || GLOBALS->is_append_running_search_c_1) {
+        return;
+    }
+
+    search_start_pending();
+}
+
+void search_enter_callback(GtkWidget *widget, GtkWidget *do_warning)
+{
+    if (GLOBALS->is_searching_running_search_c_1) {
+        return;
+    }
+    GLOBALS->is_searching_running_search_c_1 = ~0;
+    wave_gtk_grab_add(widget);
+
+    search_cancel_pending();
+
+    GLOBALS->num_rows_search_c_2 = 0;
+
+    gchar *regex = search_build_regex();
+
+    GPtrArray *symbols = gw_dump_file_find_symbols(GLOBALS->dump_file, regex, NULL);
+    if (symbols == NULL) {
+        // TODO: show in UI
+        g_warning("Invalid regex: %s", regex);
+        symbols = g_ptr_array_new();
+    }
+    g_free(regex);
+
+    gtk_list_store_clear(GTK_LIST_STORE(GLOBALS->sig_store_search));
+
+    GString *duplicate_row_buffer = g_string_new(NULL);
+
+    search_append_symbols(symbols, duplicate_row_buffer);
+
     g_string_free(duplicate_row_buffer, TRUE);
+    g_ptr_array_free(symbols, TRUE);
 
     gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(GLOBALS->pdata->pbar), 0.0);
     GLOBALS->pdata->oldvalue = -1.0;
@@ -697,6 +804,7 @@ static void destroy_callback(GtkWidget *widget, GtkWidget *nothing)
 
     if ((!GLOBALS->is_insert_running_search_c_1) && (!GLOBALS->is_replace_running_search_c_1) &&
         (!GLOBALS->is_append_running_search_c_1) && (!GLOBALS->is_searching_running_search_c_1)) {
+        search_cancel_pending();
         GLOBALS->is_active_search_c_4 = 0;
         gtk_widget_destroy(GLOBALS->window_search_c_7);
         GLOBALS->window_search_c_7 = NULL;
@@ -778,6 +886,10 @@ void searchbox(const char *title, GCallback func)
     gtk_editable_select_region(GTK_EDITABLE(GLOBALS->entry_search_c_3),
                                0,
                                gtk_entry_get_text_length(GTK_ENTRY(GLOBALS->entry_search_c_3)));
+    g_signal_connect(GLOBALS->entry_search_c_3,
+                     "changed",
+                     G_CALLBACK(search_changed_callback),
+                     NULL);
     gtk_tooltips_set_tip_2(
         GLOBALS->entry_search_c_3,
         "Enter search expression here.  POSIX Wildcards are allowed.  Note that you may also "
@@ -67,6 +67,7 @@ struct _GwSignalList
     GtkDrawingArea parent_instance;
 
     cairo_surface_t *surface;
+    gint64 surface_bytes;
 
     // TRUE if the internal surface needs to be redrawn
     gboolean dirty;
@@ -196,8 +197,8 @@ static void render_signal(cairo_t *cr,
         if (((IsGroupBegin(t) || IsGroupEnd(t)) && !HasWave(t)) || GLOBALS->left_justify_sigs) {
             text_x = 3 + text_dx;
         } else {
-            text_x = 3 + GLOBALS->max_signal_name_pixel_width -
-                     font_engine_string_measure(GLOBALS->signalfont, buf) + text_dx;
+            text_x = 3 + GLOBALS->max_signal_name_pixel_width - measure_trace_name(t, buf) +
+                     text_dx;
         }
 
         XXX_font_engine_draw_string(cr, GLOBALS->signalfont, &text_color, text_x, text_y, buf);
@@ -216,32 +217,77 @@ static void render_signal(cairo_t *cr,
     }
 }
 
-// Render all signals
-static void render_signals(GwSignalList *signal_list, GwSignalListColors *colors)
+// Render up to num_traces signal rows starting with t
+static void render_signal_rows(cairo_t *cr,
+                               GwSignalListColors *colors,
+                               GwTrace *t,
+                               int num_traces,
+                               int width,
+                               int text_dx)
 {
-    cairo_t *cr = cairo_create(signal_list->surface);
-
     // Clear background
     cairo_set_source_rgba(cr, colors->white.r, colors->white.g, colors->white.b, colors->white.a);
     cairo_paint(cr);
 
+    cairo_save(cr);
+    for (int i = 0; i < num_traces && t; i++) {
+        render_signal(cr, colors, t, width, text_dx);
+
+        cairo_translate(cr, 0, GLOBALS->fontheight);
+
+        t = GiveNextTrace(t);
+    }
+    cairo_restore(cr);
+}
+
+// Render all signals
+static void render_signals(GwSignalList *signal_list, GwSignalListColors *colors)
+{
+    cairo_t *cr = cairo_create(signal_list->surface);
+
     int num_traces_displayable = gw_signal_list_get_num_traces_displayable(signal_list);
     int width = gtk_widget_get_allocated_width(GTK_WIDGET(signal_list));
     int text_dx = -gtk_adjustment_get_value(signal_list->hadjustment);
 
-    GwTrace *t = gw_signal_list_get_trace(signal_list, 0);
-    if (t) {
-        int i;
-        for (i = 0; i < num_traces_displayable && t; i++) {
-            render_signal(cr, colors, t, width, text_dx);
+    render_signal_rows(cr,
+                       colors,
+                       gw_signal_list_get_trace(signal_list, 0),
+                       num_traces_displayable,
+                       width,
+                       text_dx);
 
-            cairo_translate(cr, 0, GLOBALS->fontheight);
+    cairo_destroy(cr);
+}
 
-            t = GiveNextTrace(t);
-        }
+// Render the "Time" header above the signal rows
+static void render_header(cairo_t *cr, GwSignalListColors *colors, int width)
+{
+    if (GLOBALS->use_dark) {
+        return;
     }
 
-    cairo_destroy(cr);
+    cairo_set_source_rgba(cr,
+                          colors->mdgray.r,
+                          colors->mdgray.g,
+                          colors->mdgray.b,
+                          colors->mdgray.a);
+    cairo_rectangle(cr, 0, 0, width, GLOBALS->fontheight);
+    cairo_fill(cr);
+
+    XXX_font_engine_draw_string(cr,
+                                GLOBALS->signalfont,
+                                &colors->black,
+                                4,
+                                GLOBALS->fontheight - 4,
+                                "Time");
+}
+
+static void clear_surface(GwSignalList *signal_list)
+{
+    gw_stats_counter_add(GW_STATS_COUNTER_SURFACES, -signal_list->surface_bytes);
+    signal_list->surface_bytes = 0;
+
+    g_clear_pointer(&signal_list->surface, cairo_surface_destroy);
 }
 
 static gint configure_event(GtkWidget *widget, GdkEventConfigure *event)
@@ -250,9 +296,7 @@ static gint configure_event(GtkWidget *widget, GdkEventConfigure *event)
 
     GwSignalList *signal_list = GW_SIGNAL_LIST(widget);
 
-    if (signal_list->surface) {
-        cairo_surface_destroy(signal_list->surface);
-    }
+    clear_surface(signal_list);
 
     GtkAllocation allocation;
     gtk_widget_get_allocation(widget, &allocation);
@@ -261,6 +305,10 @@ static gint configure_event(GtkWidget *widget, GdkEventConfigure *event)
                                                              CAIRO_CONTENT_COLOR,
                                                              allocation.width,
                                                              allocation.height);
+    // The surface may not be an image surface, assume 32 bits per pixel.
+    signal_list->surface_bytes = (gint64)allocation.width * allocation.height * 4;
+    gw_stats_counter_add(GW_STATS_COUNTER_SURFACES, signal_list->surface_bytes);
+
     signal_list->dirty = TRUE;
 
     return GDK_EVENT_STOP;
@@ -317,22 +365,7 @@ static gboolean draw(GtkWidget *widget, cairo_t *cr)
     gtk_widget_get_allocation(widget, &allocation);
 
     // Draw the header
-    if (!GLOBALS->use_dark) {
-        cairo_set_source_rgba(cr,
-                              colors->mdgray.r,
-                              colors->mdgray.g,
-                              colors->mdgray.b,
-                              colors->mdgray.a);
-        cairo_rectangle(cr, 0, 0, allocation.width, GLOBALS->fontheight);
-        cairo_fill(cr);
-
-        XXX_font_engine_draw_string(cr,
-                                    GLOBALS->signalfont,
-                                    &colors->black,
-                                    4,
-                                    GLOBALS->fontheight - 4,
-                                    "Time");
-    }
+    render_header(cr, colors, allocation.width);
 
     // Draw focus rectangle
     if (gtk_widget_has_focus(widget)) {
@@ -937,6 +970,8 @@ static void drag_data_received(GtkWidget *widget,
     // recalculate the drop position (the highlight position has been cleared by drag_leave)
     int drop_position = y_to_drop_position(y);
 
+    redraw_batch_begin();
+
     switch (info) {
         case WAVE_DRAG_INFO_SIGNAL_LIST:
             if (drop_position == 0) {
@@ -1015,6 +1050,8 @@ static void drag_data_received(GtkWidget *widget,
 
     drop_reset(&signal_list->drop);
     redraw_signals_and_waves();
+
+    redraw_batch_end();
 }
 
 static void drag_data_get(GtkWidget *widget,
@@ -1102,6 +1139,8 @@ static void destroy(GtkWidget *widget)
 {
     GwSignalList *signal_list = GW_SIGNAL_LIST(widget);
 
+    clear_surface(signal_list);
+
     if (signal_list->hadjustment != NULL) {
         g_object_unref(signal_list->hadjustment);
         signal_list->hadjustment = NULL;
@@ -1209,3 +1248,27 @@ GtkWidget *gw_signal_list_new(void)
 {
     return GTK_WIDGET(g_object_new(GW_TYPE_SIGNAL_LIST, NULL));
 }
+
+// Render the signal list without a widget, starting with the first trace
+//
+// Used to render to a file when there is no display.
+void gw_signal_list_render_offscreen(cairo_t *cr,
+                                     GwSignalListColors *colors,
+                                     int width,
+                                     int height)
+{
+    int num_traces = height / GLOBALS->fontheight - 1;
+
+    cairo_save(cr);
+    cairo_rectangle(cr, 0, 0, width, height);
+    cairo_clip(cr);
+
+    cairo_save(cr);
+    cairo_translate(cr, 0, GLOBALS->fontheight);
+    render_signal_rows(cr, colors, GLOBALS->traces.first, num_traces, width, 0);
+    cairo_restore(cr);
+
+    render_header(cr, colors, width);
+
+    cairo_restore(cr);
+}
@@ -19,6 +19,10 @@ GwTrace *gw_signal_list_get_trace(GwSignalList *signal_list, guint i);
 void gw_signal_list_scroll(GwSignalList *signal_list, int index);
 void gw_signal_list_scroll_to_trace(GwSignalList *signal_list, GwTrace *trace);
 int gw_signal_list_get_num_traces_displayable(GwSignalList *signal_list);
+void gw_signal_list_render_offscreen(cairo_t *cr,
+                                     GwSignalListColors *colors,
+                                     int width,
+                                     int height);
 
 G_END_DECLS
 
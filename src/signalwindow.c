@@ -273,8 +273,47 @@ GtkWidget *create_signalwindow(void)
     return box;
 }
 
+/*
+ * Redraws which are requested while a batch of changes is applied (e.g. a
+ * list of dropped nets or a save file) are deferred and done once when the
+ * outermost batch ends.
+ */
+static guint redraw_batch_depth = 0;
+static gboolean redraw_batch_pending = FALSE;
+
+void redraw_batch_begin(void)
+{
+    redraw_batch_depth++;
+}
+
+void redraw_batch_end(void)
+{
+    g_return_if_fail(redraw_batch_depth > 0);
+
+    redraw_batch_depth--;
+    if (redraw_batch_depth == 0 && redraw_batch_pending) {
+        redraw_batch_pending = FALSE;
+        redraw_signals_and_waves();
+    }
+}
+
+/* returns TRUE if a redraw has to be deferred to the end of the current batch */
+gboolean redraw_batch_defer(void)
+{
+    if (redraw_batch_depth == 0) {
+        return FALSE;
+    }
+
+    redraw_batch_pending = TRUE;
+    return TRUE;
+}
+
 void redraw_signals_and_waves(void)
 {
+    if (redraw_batch_defer()) {
+        return;
+    }
+
     if (!GLOBALS->signalarea || !GLOBALS->wavewindow) {
         return;
     }
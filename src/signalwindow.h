@@ -26,5 +26,8 @@ gint install_keypress_handler(void);
 void remove_keypress_handler(gint id);
 
 void redraw_signals_and_waves(void);
+void redraw_batch_begin(void);
+void redraw_batch_end(void);
+gboolean redraw_batch_defer(void);
 
 #endif
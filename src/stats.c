@@ -0,0 +1,102 @@
+#include <config.h>
+#include <gtk/gtk.h>
+#include "globals.h"
+#include "stats.h"
+
+/*
+ * Report and live view of the libgtkwave instrumentation, which is enabled
+ * with --stats or the enable_stats rc variable. The statistics are process
+ * wide, so a single window is shared by all tabs.
+ */
+
+#define STATS_REFRESH_INTERVAL_MS 500
+
+static GtkWidget *stats_window_widget = NULL;
+static GtkWidget *stats_label = NULL;
+static guint stats_refresh_source = 0;
+
+static void stats_report_at_exit(void)
+{
+    gchar *report = gw_stats_to_string();
+
+    fprintf(stderr, "GTKWAVE | Statistics:\n%s", report);
+
+    g_free(report);
+}
+
+void stats_init(gboolean enable)
+{
+    static gboolean report_registered = FALSE;
+
+    if (enable) {
+        gw_stats_set_enabled(TRUE);
+    }
+
+    if (gw_stats_is_enabled() && !report_registered) {
+        atexit(stats_report_at_exit);
+        report_registered = TRUE;
+    }
+}
+
+static gboolean stats_refresh(gpointer user_data)
+{
+    (void)user_data;
+
+    gchar *report;
+
+    if (gw_stats_is_enabled()) {
+        GwStatsTimerValue render;
+        gw_stats_get_timer(GW_STATS_TIMER_RENDER, &render);
+
+        gchar *table = gw_stats_to_string();
+        report = g_strdup_printf("last redraw: %.3f ms\n\n%s", render.last_ns / 1e6, table);
+        g_free(table);
+    } else {
+        report = g_strdup(
+            "Statistics are disabled.\n"
+            "Start GTKWave with --stats or set enable_stats in the rc file.");
+    }
+
+    gchar *markup = g_markup_printf_escaped("<tt>%s</tt>", report);
+    gtk_label_set_markup(GTK_LABEL(stats_label), markup);
+
+    g_free(markup);
+    g_free(report);
+
+    return G_SOURCE_CONTINUE;
+}
+
+static void stats_window_destroyed(GtkWidget *widget, gpointer user_data)
+{
+    (void)widget;
+    (void)user_data;
+
+    g_clear_handle_id(&stats_refresh_source, g_source_remove);
+    stats_window_widget = NULL;
+    stats_label = NULL;
+}
+
+void stats_window(void)
+{
+    if (stats_window_widget != NULL) {
+        gtk_window_present(GTK_WINDOW(stats_window_widget));
+        return;
+    }
+
+    stats_window_widget = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    gtk_window_set_title(GTK_WINDOW(stats_window_widget), "Statistics");
+    gtk_window_set_transient_for(GTK_WINDOW(stats_window_widget),
+                                 GTK_WINDOW(GLOBALS->mainwindow));
+    g_signal_connect(stats_window_widget, "destroy", G_CALLBACK(stats_window_destroyed), NULL);
+
+    stats_label = gtk_label_new(NULL);
+    gtk_label_set_selectable(GTK_LABEL(stats_label), TRUE);
+    gtk_label_set_xalign(GTK_LABEL(stats_label), 0.0);
+    g_object_set(stats_label, "margin", 12, NULL);
+    gtk_container_add(GTK_CONTAINER(stats_window_widget), stats_label);
+
+    stats_refresh(NULL);
+    stats_refresh_source = g_timeout_add(STATS_REFRESH_INTERVAL_MS, stats_refresh, NULL);
+
+    gtk_widget_show_all(stats_window_widget);
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+void stats_init(gboolean enable);
+void stats_window(void);
+
+G_END_DECLS
@@ -983,342 +983,517 @@ void strace_search(int direction)
     int i;
     int i_high_cnt = ((GLOBALS->strace_repeat_count > 0) ? GLOBALS->strace_repeat_count : 1) - 1;
 
+    gint64 stats_begin = gw_stats_timer_begin();
+
     for (i = 0; i <= i_high_cnt; i++) {
         strace_search_2(direction, (i == i_high_cnt));
     }
+
+    gw_stats_timer_end(GW_STATS_TIMER_SEARCH, stats_begin);
 }
 
 /*********************************************/
 
 /*
- * strace forward to make the timetrace
+ * sweep engine to make the timetrace: the transition streams of all
+ * search traces are merged in a single forward pass and the pattern is
+ * only reevaluated for the traces which change at each time.
  */
-GwTime strace_timetrace(GwTime basetime, int notfirst)
+#define STRACE_SWEEP_MAX_THREADS (8)
+#define STRACE_SWEEP_PARALLEL_MIN (1 << 18) /* transitions before splitting the range */
+
+struct strace_cursor
 {
     struct strace *s;
-    GwTime maxbase, fintim;
     GwTrace *t;
-    int totaltraces, passcount;
-    int whichpass;
+    GwHistEnt *h; /* current entry for nodes */
+    GwVectorEnt *v; /* current entry for vectors */
+    GwTime time; /* shifted time of the current entry */
+    GwTime next_time; /* shifted time of the next entry */
+    char counts; /* not don't care */
+    char edge; /* only matches at a transition */
+    char scalar; /* matches[] is valid */
+    char result;
+    char matches[GW_BIT_COUNT];
+};
+
+struct strace_sweep_job
+{
+    struct strace_cursor *cursors;
+    int count;
+    const char *logical_mutex;
+    GwTime lo, hi;
+    GArray *times;
+};
+
+static gboolean strace_scalar_matches(struct strace *s, char ch)
+{
+    char str[2];
 
-    fintim = GLOBALS->tims.last;
+    switch (s->value) {
+        case ST_HIGH:
+        case ST_RISE:
+            return ch == '1' || ch == 'h' || ch == 'H';
 
-    for (whichpass = 0;; whichpass++) {
-        maxbase = MAX_HISTENT_TIME;
-        s = GLOBALS->strace_ctx->straces;
-        while (s) {
-            t = s->trace;
-            GLOBALS->shift_timebase = t->shift;
-            if (!(t->vector)) {
-                GwHistEnt *h;
-                GwUTime utt;
-                GwTime tt;
-
-                h = bsearch_node(t->n.nd, basetime - t->shift);
-                s->his.h = h;
-                while (h->time == h->next->time) {
-                    h = h->next;
-                }
-                if ((whichpass) || (notfirst)) {
-                    h = h->next;
-                }
-                if (h == NULL) {
-                    return MAX_HISTENT_TIME;
-                }
-                utt = strace_adjust(h->time, GLOBALS->shift_timebase);
-                tt = utt;
-                if (tt < maxbase)
-                    maxbase = tt;
-            } else {
-                GwVectorEnt *v;
-                GwUTime utt;
-                GwTime tt;
+        case ST_LOW:
+        case ST_FALL:
+            return ch == '0' || ch == 'l' || ch == 'L';
 
-                v = bsearch_vector(t->n.vec, basetime - t->shift);
-                if ((whichpass) || (notfirst)) {
-                    v = v->next;
-                }
-                if (v == NULL) {
-                    return MAX_HISTENT_TIME;
-                }
-                s->his.v = v;
-                utt = strace_adjust(v->time, GLOBALS->shift_timebase);
-                tt = utt;
-                if (tt < maxbase)
-                    maxbase = tt;
-            }
+        case ST_MID:
+            return ch == 'z' || ch == 'Z';
 
-            s = s->next;
+        case ST_X:
+            return ch == 'x' || ch == 'X';
+
+        case ST_ANY:
+            return TRUE;
+
+        case ST_STRING:
+            str[0] = ch;
+            str[1] = 0x00;
+            return s->string != NULL && strstr_i(s->string, str) != NULL;
+
+        default:
+            return FALSE;
+    }
+}
+
+static void strace_cursor_init(struct strace_cursor *c, struct strace *s)
+{
+    GwTrace *t = s->trace;
+    int i;
+
+    memset(c, 0, sizeof(struct strace_cursor));
+    c->s = s;
+    c->t = t;
+
+    switch (s->value) {
+        case ST_DC:
+            break;
+
+        case ST_HIGH:
+        case ST_LOW:
+        case ST_MID:
+        case ST_X:
+        case ST_STRING:
+            c->counts = 1;
+            break;
+
+        case ST_RISE:
+        case ST_FALL:
+        case ST_ANY:
+            c->counts = 1;
+            c->edge = 1;
+            break;
+
+        default:
+            fprintf(stderr, "Internal error: st_type of %d\n", s->value);
+            exit(255);
+    }
+
+    if (!t->vector && !t->n.nd->extvals) {
+        c->scalar = 1;
+        for (i = 0; i < GW_BIT_COUNT; i++) {
+            GwBit b = (t->flags & TR_INVERT) ? gw_bit_invert(i) : i;
+            c->matches[i] = strace_scalar_matches(s, gw_bit_to_char(b));
         }
+    }
+}
 
-        s = GLOBALS->strace_ctx->straces;
-        totaltraces = 0; /* increment when not don't care */
-        while (s) {
-            char str[2];
-            t = s->trace;
-            s->search_result = 0; /* explicitly must set this */
-            GLOBALS->shift_timebase = t->shift;
+/*
+ * reentrant equivalents of bsearch_node()/bsearch_vector() as those keep
+ * their state in GLOBALS
+ */
+static GwHistEnt *strace_find_histent(GwNode *n, GwTime key)
+{
+    int lo = 0, hi = n->numhist - 1;
+    GwHistEnt *h = NULL;
 
-            if ((!t->vector) && (!(t->n.nd->extvals))) {
-                if (strace_adjust(s->his.h->time, GLOBALS->shift_timebase) != maxbase) {
-                    s->his.h = bsearch_node(t->n.nd, maxbase - t->shift);
-                    while (s->his.h->next && s->his.h->time == s->his.h->next->time) {
-                        s->his.h = s->his.h->next;
-                    }
-                }
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
 
-                GwBit h_val = s->his.h->v.h_val;
-                if (t->flags & TR_INVERT) {
-                    h_val = gw_bit_invert(h_val);
-                }
+        if (n->harray[mid]->time <= key) {
+            h = n->harray[mid];
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
 
-                str[0] = gw_bit_to_char(s->his.h->v.h_val);
-                str[1] = 0x00;
+    if (!h || h->time < GW_TIME_CONSTANT(0)) {
+        h = n->harray[1];
+    }
 
-                switch (s->value) {
-                    case ST_DC:
-                        break;
+    while (h->next && h->time == h->next->time) {
+        h = h->next;
+    }
 
-                    case ST_HIGH:
-                        totaltraces++;
-                        if (str[0] == '1' || str[0] == 'h' || str[0] == 'H') {
-                            s->search_result = 1;
-                        }
-                        break;
+    return h;
+}
 
-                    case ST_RISE:
-                        totaltraces++;
-                        if ((str[0] == '1' || str[0] == 'h' || str[0] == 'H') &&
-                            strace_adjust(s->his.h->time, GLOBALS->shift_timebase) == maxbase) {
-                            s->search_result = 1;
-                        }
-                        break;
+static GwVectorEnt *strace_find_vectorent(GwBitVector *b, GwTime key)
+{
+    int lo = 0, hi = b->numregions - 1;
+    GwVectorEnt *v = NULL;
 
-                    case ST_LOW:
-                        totaltraces++;
-                        if (str[0] == '0' || str[0] == 'l' || str[0] == 'L') {
-                            s->search_result = 1;
-                        }
-                        break;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
 
-                    case ST_FALL:
-                        totaltraces++;
-                        if ((str[0] == '0' || str[0] == 'l' || str[0] == 'L') &&
-                            strace_adjust(s->his.h->time, GLOBALS->shift_timebase) == maxbase) {
-                            s->search_result = 1;
-                        }
-                        break;
+        if (b->vectors[mid]->time <= key) {
+            v = b->vectors[mid];
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
 
-                    case ST_MID:
-                        totaltraces++;
-                        if ((str[0] == 'z') || (str[0] == 'Z'))
-                            s->search_result = 1;
-                        break;
+    if (!v || v->time < GW_TIME_CONSTANT(0)) {
+        v = b->vectors[1];
+    }
 
-                    case ST_X:
-                        totaltraces++;
-                        if (str[0] == 'x' || str[0] == 'X') {
-                            s->search_result = 1;
-                        }
-                        break;
+    while (v->next && v->time == v->next->time) {
+        v = v->next;
+    }
 
-                    case ST_ANY:
-                        totaltraces++;
-                        if (strace_adjust(s->his.h->time, GLOBALS->shift_timebase) == maxbase) {
-                            s->search_result = 1;
-                        }
-                        break;
+    return v;
+}
 
-                    case ST_STRING:
-                        totaltraces++;
-                        if (s->string != NULL && strstr_i(s->string, str) != NULL) {
-                            s->search_result = 1;
-                        }
-                        break;
+static void strace_cursor_update_times(struct strace_cursor *c)
+{
+    GwTime shift = c->t->shift;
 
-                    default:
-                        fprintf(stderr, "Internal error: st_type of %d\n", s->value);
-                        exit(255);
-                }
+    GwTime time;
 
-            } else {
-                char *chval, *chval2;
-                char ch;
+    if (c->t->vector) {
+        time = c->v->time;
+        c->next_time = c->v->next ? strace_adjust(c->v->next->time, shift) : MAX_HISTENT_TIME;
+    } else {
+        time = c->h->time;
+        c->next_time = c->h->next ? strace_adjust(c->h->next->time, shift) : MAX_HISTENT_TIME;
+    }
 
-                if (t->vector) {
-                    if (strace_adjust(s->his.v->time, GLOBALS->shift_timebase) != maxbase) {
-                        s->his.v = bsearch_vector(t->n.vec, maxbase - t->shift);
-                        while (s->his.v->next && s->his.v->time == s->his.v->next->time) {
-                            s->his.v = s->his.v->next;
-                        }
-                    }
-                    chval = convert_ascii(t, s->his.v);
-                } else {
-                    if (strace_adjust(s->his.h->time, GLOBALS->shift_timebase) != maxbase) {
-                        s->his.h = bsearch_node(t->n.nd, maxbase - t->shift);
-                        while (s->his.h->next && s->his.h->time == s->his.h->next->time) {
-                            s->his.h = s->his.h->next;
-                        }
-                    }
-                    if (s->his.h->flags & GW_HIST_ENT_FLAG_REAL) {
-                        if (!(s->his.h->flags & GW_HIST_ENT_FLAG_STRING)) {
-                            chval = convert_ascii_real(t, &s->his.h->v.h_double);
-                        } else {
-                            chval = convert_ascii_string((char *)s->his.h->v.h_vector);
-                            chval2 = chval;
-                            while ((ch = *chval2)) { /* toupper() the string */
-                                if ((ch >= 'a') && (ch <= 'z')) {
-                                    *chval2 = ch - ('a' - 'A');
-                                }
-                                chval2++;
-                            }
-                        }
-                    } else {
-                        chval = convert_ascii_vec(t, s->his.h->v.h_vector);
-                    }
+    /* the leading sentinel entries are not transitions */
+    c->time = (time < GW_TIME_CONSTANT(0)) ? GW_TIME_CONSTANT(-1) : strace_adjust(time, shift);
+}
+
+static void strace_cursor_seek(struct strace_cursor *c, GwTime time)
+{
+    if (c->t->vector) {
+        c->v = strace_find_vectorent(c->t->n.vec, time - c->t->shift);
+    } else {
+        c->h = strace_find_histent(c->t->n.nd, time - c->t->shift);
+    }
+    strace_cursor_update_times(c);
+}
+
+static void strace_cursor_advance(struct strace_cursor *c)
+{
+    if (c->t->vector) {
+        c->v = c->v->next;
+        while (c->v->next && c->v->time == c->v->next->time) {
+            c->v = c->v->next;
+        }
+    } else {
+        c->h = c->h->next;
+        while (c->h->next && c->h->time == c->h->next->time) {
+            c->h = c->h->next;
+        }
+    }
+    strace_cursor_update_times(c);
+}
+
+/*
+ * evaluates a single trace at the cursor position, changed is set when the
+ * trace has a transition at the current sweep time
+ */
+static char strace_cursor_eval(struct strace_cursor *c, gboolean changed)
+{
+    struct strace *s = c->s;
+    GwTrace *t = c->t;
+    char *chval, *chval2;
+    char ch;
+    char result = 0;
+
+    if (!c->counts || (c->edge && !changed)) {
+        return 0;
+    }
+
+    if (c->scalar) {
+        return c->matches[c->h->v.h_val & GW_BIT_MASK];
+    }
+
+    switch (s->value) {
+        case ST_RISE:
+        case ST_FALL:
+            return 0;
+
+        case ST_ANY:
+            return 1;
+
+        default:
+            break;
+    }
+
+    GLOBALS->shift_timebase = t->shift;
+    if (t->vector) {
+        chval = convert_ascii(t, c->v);
+    } else if (c->h->flags & GW_HIST_ENT_FLAG_REAL) {
+        if (!(c->h->flags & GW_HIST_ENT_FLAG_STRING)) {
+            chval = convert_ascii_real(t, &c->h->v.h_double);
+        } else {
+            chval = convert_ascii_string((char *)c->h->v.h_vector);
+            chval2 = chval;
+            while ((ch = *chval2)) { /* toupper() the string */
+                if ((ch >= 'a') && (ch <= 'z')) {
+                    *chval2 = ch - ('a' - 'A');
                 }
+                chval2++;
+            }
+        }
+    } else {
+        chval = convert_ascii_vec(t, c->h->v.h_vector);
+    }
 
-                switch (s->value) {
-                    case ST_DC:
+    switch (s->value) {
+        case ST_HIGH:
+            if ((chval2 = chval)) {
+                while ((ch = *(chval2++))) {
+                    if ((ch >= '1' && ch <= '9') || ch == 'h' || ch == 'H' ||
+                        (ch >= 'A' && ch <= 'F')) {
+                        result = 1;
                         break;
+                    }
+                }
+            }
+            break;
 
-                    case ST_RISE:
-                    case ST_FALL:
-                        totaltraces++;
+        case ST_LOW:
+            if ((chval2 = chval)) {
+                result = 1;
+                while ((ch = *(chval2++))) {
+                    if (ch != '0' && ch != 'l' && ch != 'L') {
+                        result = 0;
                         break;
+                    }
+                }
+            }
+            break;
 
-                    case ST_HIGH:
-                        totaltraces++;
-                        if ((chval2 = chval)) {
-                            while ((ch = *(chval2++))) {
-                                if ((ch >= '1' && ch <= '9') || ch == 'h' || ch == 'H' ||
-                                    (ch >= 'A' && ch <= 'F')) {
-                                    s->search_result = 1;
-                                    break;
-                                }
-                            }
-                        }
+        case ST_MID:
+            if ((chval2 = chval)) {
+                result = 1;
+                while ((ch = *(chval2++))) {
+                    if (ch != 'z' && ch != 'Z') {
+                        result = 0;
                         break;
+                    }
+                }
+            }
+            break;
 
-                    case ST_LOW:
-                        totaltraces++;
-                        if ((chval2 = chval)) {
-                            s->search_result = 1;
-                            while ((ch = *(chval2++))) {
-                                if (ch != '0' && ch != 'l' && ch != 'L') {
-                                    s->search_result = 0;
-                                    break;
-                                }
-                            }
-                        }
+        case ST_X:
+            if ((chval2 = chval)) {
+                result = 1;
+                while ((ch = *(chval2++))) {
+                    if (ch != 'x' && ch != 'w' && ch != 'X' && ch != 'W') {
+                        result = 0;
                         break;
+                    }
+                }
+            }
+            break;
 
-                    case ST_MID:
-                        totaltraces++;
-                        if ((chval2 = chval)) {
-                            s->search_result = 1;
-                            while ((ch = *(chval2++))) {
-                                if (ch != 'z' && ch != 'Z') {
-                                    s->search_result = 0;
-                                    break;
-                                }
-                            }
-                        }
-                        break;
+        case ST_STRING:
+            if (s->string != NULL && strstr_i(chval, s->string) != NULL) {
+                result = 1;
+            }
+            break;
 
-                    case ST_X:
-                        totaltraces++;
-                        if ((chval2 = chval)) {
-                            s->search_result = 1;
-                            while ((ch = *(chval2++))) {
-                                if (ch != 'x' && ch != 'w' && ch != 'X' && ch != 'W') {
-                                    s->search_result = 0;
-                                    break;
-                                }
-                            }
-                        }
-                        break;
+        default:
+            break;
+    }
 
-                    case ST_ANY:
-                        totaltraces++;
-                        if (strace_adjust(s->his.v->time, GLOBALS->shift_timebase) == maxbase) {
-                            s->search_result = 1;
-                        }
-                        break;
+    free_2(chval);
+    return result;
+}
 
-                    case ST_STRING:
-                        totaltraces++;
-                        if (s->string != NULL && strstr_i(chval, s->string) != NULL) {
-                            s->search_result = 1;
-                        }
-                        break;
+static gboolean strace_sweep_matches(const char *logical_mutex, int totaltraces, int passcount)
+{
+    if (!totaltraces) {
+        return FALSE;
+    }
 
-                    default:
-                        fprintf(stderr, "Internal error: st_type of %d\n", s->value);
-                        exit(255);
-                }
+    if (logical_mutex[0]) { /* and */
+        return totaltraces == passcount;
+    } else if (logical_mutex[1]) { /* or */
+        return passcount != 0;
+    } else if (logical_mutex[2]) { /* xor */
+        return (passcount & 1) != 0;
+    } else if (logical_mutex[3]) { /* nand */
+        return totaltraces != passcount;
+    } else if (logical_mutex[4]) { /* nor */
+        return passcount == 0;
+    } else if (logical_mutex[5]) { /* xnor */
+        return (passcount & 1) == 0;
+    }
 
-                free_2(chval);
+    return FALSE;
+}
+
+/*
+ * appends every transition time in [lo, hi] at which the pattern matches
+ */
+static void strace_sweep_range(struct strace_sweep_job *job)
+{
+    struct strace_cursor *cursors = job->cursors;
+    int totaltraces = 0;
+    int passcount = 0;
+    gboolean changed_any = FALSE;
+    GwTime now = job->lo;
+    int i;
+
+    for (i = 0; i < job->count; i++) {
+        struct strace_cursor *c = &cursors[i];
+        gboolean changed;
+
+        strace_cursor_seek(c, now);
+        changed = c->time == now;
+        changed_any |= changed;
+
+        c->result = strace_cursor_eval(c, changed);
+        totaltraces += c->counts;
+        passcount += c->result;
+    }
+
+    if (changed_any && strace_sweep_matches(job->logical_mutex, totaltraces, passcount)) {
+        g_array_append_val(job->times, now);
+    }
+
+    for (;;) {
+        now = MAX_HISTENT_TIME;
+        for (i = 0; i < job->count; i++) {
+            if (cursors[i].next_time < now) {
+                now = cursors[i].next_time;
             }
-            s = s->next;
         }
 
-        if (maxbase > fintim)
-            return (MAX_HISTENT_TIME);
+        if (now > job->hi || now == MAX_HISTENT_TIME) {
+            break;
+        }
 
-        DEBUG(printf("Maxbase: %" GW_TIME_FORMAT ", total traces: %d\n", maxbase, totaltraces));
-        s = GLOBALS->strace_ctx->straces;
-        passcount = 0;
-        while (s) {
-            DEBUG(printf("\tPass: %d, Name: %s\n", s->search_result, s->trace->name));
-            if (s->search_result) {
-                passcount++;
+        for (i = 0; i < job->count; i++) {
+            struct strace_cursor *c = &cursors[i];
+            char result;
+
+            if (c->next_time == now) {
+                strace_cursor_advance(c);
+                result = strace_cursor_eval(c, TRUE);
+            } else if (c->edge && c->result) {
+                result = 0; /* edge no longer current */
+            } else {
+                continue;
             }
-            s = s->next;
+
+            passcount += result - c->result;
+            c->result = result;
         }
 
-        if (totaltraces) {
-            if (GLOBALS->strace_ctx->logical_mutex[0]) { /* and */
-                if (totaltraces == passcount) {
-                    break;
-                }
-            } else if (GLOBALS->strace_ctx->logical_mutex[1]) { /* or */
-                if (passcount) {
-                    break;
-                }
-            } else if (GLOBALS->strace_ctx->logical_mutex[2]) { /* xor */
-                if (passcount & 1) {
-                    break;
-                }
-            } else if (GLOBALS->strace_ctx->logical_mutex[3]) { /* nand */
-                if (totaltraces != passcount) {
-                    break;
-                }
-            } else if (GLOBALS->strace_ctx->logical_mutex[4]) { /* nor */
-                if (!passcount) {
-                    break;
-                }
-            } else if (GLOBALS->strace_ctx->logical_mutex[5]) { /* xnor */
-                if (!(passcount & 1)) {
-                    break;
-                }
-            }
+        if (strace_sweep_matches(job->logical_mutex, totaltraces, passcount)) {
+            g_array_append_val(job->times, now);
         }
+    }
+}
 
-        basetime = maxbase;
+static gpointer strace_sweep_thread(gpointer user_data)
+{
+    strace_sweep_range(user_data);
+
+    return NULL;
+}
+
+/*
+ * computes all matching times in [basetime, endtime], scalar only patterns
+ * are split across threads as they do not touch GLOBALS
+ */
+static GArray *strace_sweep(GwTime basetime, GwTime endtime)
+{
+    struct strace_sweep_job jobs[STRACE_SWEEP_MAX_THREADS];
+    GThread *threads[STRACE_SWEEP_MAX_THREADS];
+    struct strace_cursor *cursors;
+    struct strace *s;
+    GArray *times;
+    gboolean all_scalar = TRUE;
+    gint64 transitions = 0;
+    int count = 0;
+    int num_threads = 1;
+    int i, j;
+
+    for (s = GLOBALS->strace_ctx->straces; s; s = s->next) {
+        count++;
+    }
+
+    times = g_array_new(FALSE, FALSE, sizeof(GwTime));
+    if (!count || basetime > endtime) {
+        return times;
     }
 
-    return (maxbase);
+    cursors = g_new(struct strace_cursor, count);
+    for (i = 0, s = GLOBALS->strace_ctx->straces; s; s = s->next, i++) {
+        strace_cursor_init(&cursors[i], s);
+        if (cursors[i].scalar) {
+            transitions += s->trace->n.nd->numhist;
+        } else {
+            all_scalar = FALSE;
+        }
+    }
+
+    if (all_scalar && transitions >= STRACE_SWEEP_PARALLEL_MIN &&
+        endtime - basetime >= STRACE_SWEEP_MAX_THREADS) {
+        num_threads = MIN(g_get_num_processors(), STRACE_SWEEP_MAX_THREADS);
+    }
+
+    if (num_threads <= 1) {
+        jobs[0].cursors = cursors;
+        jobs[0].count = count;
+        jobs[0].logical_mutex = GLOBALS->strace_ctx->logical_mutex;
+        jobs[0].lo = basetime;
+        jobs[0].hi = endtime;
+        jobs[0].times = times;
+        strace_sweep_range(&jobs[0]);
+        g_free(cursors);
+        return times;
+    }
+
+    GwTime width = (endtime - basetime) / num_threads;
+    for (i = 0; i < num_threads; i++) {
+        jobs[i].cursors = g_new(struct strace_cursor, count);
+        memcpy(jobs[i].cursors, cursors, sizeof(struct strace_cursor) * count);
+        jobs[i].count = count;
+        jobs[i].logical_mutex = GLOBALS->strace_ctx->logical_mutex;
+        jobs[i].lo = basetime + width * i;
+        jobs[i].hi = (i == num_threads - 1) ? endtime : basetime + width * (i + 1) - 1;
+        jobs[i].times = g_array_new(FALSE, FALSE, sizeof(GwTime));
+        threads[i] = g_thread_new("strace", strace_sweep_thread, &jobs[i]);
+    }
+
+    for (i = 0; i < num_threads; i++) {
+        g_thread_join(threads[i]);
+        for (j = 0; j < (int)jobs[i].times->len; j++) {
+            g_array_append_val(times, g_array_index(jobs[i].times, GwTime, j));
+        }
+        g_array_free(jobs[i].times, TRUE);
+        g_free(jobs[i].cursors);
+    }
+
+    g_free(cursors);
+    return times;
 }
 
 void strace_maketimetrace(int mode)
 {
     GwTime basetime = GLOBALS->tims.first;
     GwTime endtime = MAX_HISTENT_TIME;
-    int notfirst = 0;
-    GwTime *t;
-    int t_allocated;
-    GwTime orig_basetime;
+    GArray *times;
 
     if (GLOBALS->strace_ctx->timearray) {
         free_2(GLOBALS->strace_ctx->timearray);
@@ -1366,40 +1541,18 @@ void strace_maketimetrace(int mode)
         endtime = tmp;
     }
 
-    t_allocated = 1;
-    t = malloc_2(sizeof(GwTime) * t_allocated);
-
-    orig_basetime = basetime;
-    while (1) {
-        basetime = strace_timetrace(basetime, notfirst);
-        notfirst = 1;
-
-        if (endtime == MAX_HISTENT_TIME) {
-            if (basetime == MAX_HISTENT_TIME)
-                break;
-        } else {
-            if (basetime > endtime)
-                break; /* formerly was >= which didn't mark the endpoint if true which is incorrect
-                        */
-        } /* i.e., if start is markable, end should be also */
-
-        if (basetime >= orig_basetime) {
-            t[GLOBALS->strace_ctx->timearray_size] = basetime;
-            GLOBALS->strace_ctx->timearray_size++;
-            if (GLOBALS->strace_ctx->timearray_size == t_allocated) {
-                t_allocated *= 2;
-                t = realloc_2(t, sizeof(GwTime) * t_allocated);
-            }
-        }
+    if (endtime > GLOBALS->tims.last) {
+        endtime = GLOBALS->tims.last;
     }
 
+    times = strace_sweep(basetime, endtime);
+
+    GLOBALS->strace_ctx->timearray_size = times->len;
     if (GLOBALS->strace_ctx->timearray_size) {
-        GLOBALS->strace_ctx->timearray =
-            realloc_2(t, sizeof(GwTime) * GLOBALS->strace_ctx->timearray_size);
-    } else {
-        free_2(t);
-        GLOBALS->strace_ctx->timearray = NULL;
+        GLOBALS->strace_ctx->timearray = malloc_2(sizeof(GwTime) * times->len);
+        memcpy(GLOBALS->strace_ctx->timearray, times->data, sizeof(GwTime) * times->len);
     }
+    g_array_free(times, TRUE);
 
     if (!GLOBALS->strace_ctx->shadow_active)
         update_mark_count_label();
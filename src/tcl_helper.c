@@ -901,10 +901,15 @@ int process_tcl_list(const char *sl, gboolean prepend)
     int c, i, ii;
     char **list;
     char **s_new_list;
+    char **unescaped_list;
     char **most_recent_lbrack_list;
     char **most_recent_colon_list;
-    int *match_idx_list;
+    GwSymbol **match_sym_list;
     int *match_type_list;
+    const char **net_names;
+    int *net_idx;
+    GwSymbol **net_symbols;
+    int n_nets = 0;
     GwTrace *t = NULL;
     int found = 0;
     int lbrack_adj;
@@ -926,7 +931,8 @@ int process_tcl_list(const char *sl, gboolean prepend)
                                              no need for relative processing */
 
     s_new_list = calloc_2(c, sizeof(char *));
-    match_idx_list = calloc_2(c, sizeof(int *));
+    unescaped_list = calloc_2(c, sizeof(char *));
+    match_sym_list = calloc_2(c, sizeof(GwSymbol *));
     match_type_list = calloc_2(c, sizeof(int *));
     most_recent_lbrack_list = calloc_2(c, sizeof(char *));
     most_recent_colon_list = calloc_2(c, sizeof(char *));
@@ -940,12 +946,58 @@ int process_tcl_list(const char *sl, gboolean prepend)
     GLOBALS->strace_current_window =
         0; /* in case there are shadow traces; in reality this should never happen */
 
+    redraw_batch_begin();
+
+    /* parse the nets once, nets turned off by a NET OFF directive are dropped here */
     for (ii = 0; ii < c; ii++) {
         s_new = make_net_name_from_tcl_list(list[ii], &unescaped_str);
         if (s_new) {
-            if (net_processing_is_off)
-                continue;
+            if (net_processing_is_off) {
+                if (s_new != unescaped_str) {
+                    free_2(unescaped_str);
+                }
+                free_2(s_new);
+            } else {
+                s_new_list[ii] = s_new;
+                unescaped_list[ii] = unescaped_str;
+            }
         } else {
+            int ngl;
+            char **gdirect = check_gtkwave_directive_from_tcl_list(list[ii], &ngl);
+            if (gdirect) {
+                if ((ngl == 3) && (!strcmp(gdirect[1], "NET"))) {
+                    net_processing_is_off = !strcmp(gdirect[2], "OFF");
+                }
+                free_2(gdirect);
+            }
+        }
+    }
+
+    /* resolve the exact names of all nets in one batch, the searches below are only needed
+     * for nets which aren't found that way.  escaped names can only be found by the searches. */
+    if (!gw_dump_file_has_escaped_names(GLOBALS->dump_file)) {
+        net_names = calloc_2(c, sizeof(char *));
+        net_idx = calloc_2(c, sizeof(int));
+        net_symbols = calloc_2(c, sizeof(GwSymbol *));
+        for (ii = 0; ii < c; ii++) {
+            if ((unescaped_list[ii]) && (*unescaped_list[ii])) {
+                net_names[n_nets] = unescaped_list[ii];
+                net_idx[n_nets++] = ii;
+            }
+        }
+        gw_dump_file_lookup_symbols(GLOBALS->dump_file, net_names, n_nets, net_symbols);
+        for (i = 0; i < n_nets; i++) {
+            match_sym_list[net_idx[i]] = net_symbols[i];
+        }
+        free_2(net_symbols);
+        free_2(net_idx);
+        free_2(net_names);
+    }
+
+    for (ii = 0; ii < c; ii++) {
+        s_new = s_new_list[ii];
+        unescaped_str = unescaped_list[ii];
+        if (!s_new) {
             int ngl;
             char **gdirect = check_gtkwave_directive_from_tcl_list(list[ii], &ngl);
             if (gdirect) {
@@ -958,8 +1010,6 @@ int process_tcl_list(const char *sl, gboolean prepend)
                                 free_2(gdirect);
                                 goto cleanup;
                             }
-                        } else if (!strcmp(gdirect[1], "NET")) {
-                            net_processing_is_off = !strcmp(gdirect[2], "OFF");
                         } else if (!strcmp(gdirect[1], "SAVELIST")) {
                             int is;
                             for (is = 0; is < 4; is++) {
@@ -1026,7 +1076,6 @@ int process_tcl_list(const char *sl, gboolean prepend)
 
             continue;
         }
-        s_new_list[ii] = s_new;
 
         lbrack_adj = 0;
         most_recent_lbrack_list[ii] = strrchr(s_new, '[');
@@ -1040,6 +1089,12 @@ int process_tcl_list(const char *sl, gboolean prepend)
             most_recent_colon_list[ii] = strchr(most_recent_lbrack_list[ii], ':');
         }
 
+        if (match_sym_list[ii]) {
+            found++;
+            match_type_list[ii] = 1; /* match was on normal search */
+            goto import;
+        }
+
         unesc_len = strlen(unescaped_str);
         for (i = 0; i < numfacs; i++) {
             char *hfacname = NULL;
@@ -1053,11 +1108,8 @@ int process_tcl_list(const char *sl, gboolean prepend)
                 if ((unesc_len == hfacname_len) ||
                     ((hfacname_len > unesc_len) && (hfacname[unesc_len] == '['))) {
                     found++;
-                    match_idx_list[ii] = curr_srch_idx;
+                    match_sym_list[ii] = fac;
                     match_type_list[ii] = 1; /* match was on normal search */
-                    if (s_new != unescaped_str) {
-                        free_2(unescaped_str);
-                    }
                     goto import;
                 }
             }
@@ -1067,10 +1119,6 @@ int process_tcl_list(const char *sl, gboolean prepend)
                 curr_srch_idx = 0; /* optimization for rtlbrowse as names should be in order */
         }
 
-        if (s_new != unescaped_str) {
-            free_2(unescaped_str);
-        }
-
         entry_suffixed = g_alloca(2 + strlen(s_new) + strlen(this_regex) + 1);
         *entry_suffixed = 0x00;
         strcpy(entry_suffixed, "\\<");
@@ -1087,7 +1135,7 @@ int process_tcl_list(const char *sl, gboolean prepend)
 
             if (wave_regex_match(hfacname, WAVE_REGEX_DND)) {
                 found++;
-                match_idx_list[ii] = i;
+                match_sym_list[ii] = fac;
                 match_type_list[ii] = 1; /* match was on normal search */
                 goto import;
             }
@@ -1112,14 +1160,14 @@ int process_tcl_list(const char *sl, gboolean prepend)
 
                 if (wave_regex_match(hfacname, WAVE_REGEX_DND)) {
                     found++;
-                    match_idx_list[ii] = i;
+                    match_sym_list[ii] = fac;
                     match_type_list[ii] = 2 + lbrack_adj; /* match was on lbrack removal */
                     goto import;
                 }
             }
         }
 
-        import : if (match_type_list[ii]) { GwSymbol *s = gw_facs_get(facs, match_idx_list[ii]);
+        import : if (match_type_list[ii]) { GwSymbol *s = match_sym_list[ii];
         GwSymbol *schain = s->vec_root;
 
         if (GLOBALS->is_lx2) {
@@ -1148,7 +1196,7 @@ GLOBALS->traces.first = GLOBALS->traces.last = NULL;
 
 for (ii = 0; ii < c; ii++) {
     if (match_type_list[ii]) {
-        GwSymbol *s = gw_facs_get(facs, match_idx_list[ii]);
+        GwSymbol *s = match_sym_list[ii];
 
         if ((match_type_list[ii] >= 2) && (s->n->extvals)) {
             GwNode *nexp;
@@ -1245,11 +1293,14 @@ GLOBALS->traces.bufferlast = GLOBALS->tcache_treesearch_gtk2_c_2.bufferlast;
 
 cleanup : for (ii = 0; ii < c; ii++)
 {
+    if (unescaped_list[ii] != s_new_list[ii])
+        free_2(unescaped_list[ii]);
     if (s_new_list[ii])
         free_2(s_new_list[ii]);
 }
+free_2(unescaped_list);
 free_2(s_new_list);
-free_2(match_idx_list);
+free_2(match_sym_list);
 free_2(match_type_list);
 free_2(most_recent_colon_list);
 free_2(most_recent_lbrack_list);
@@ -1257,6 +1308,8 @@ free_2(list);
 
 EnsureGroupsMatch();
 
+redraw_batch_end();
+
 return (found);
 }
 
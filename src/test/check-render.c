@@ -0,0 +1,121 @@
+/*
+ * check-render: checks an image written by gtkwave --render, it has to
+ * have the requested size and has to show more than a blank background.
+ *
+ * usage: check-render FILE WIDTH HEIGHT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <cairo.h>
+
+static gboolean check_png(const char *fname, int width, int height)
+{
+    cairo_surface_t *surface = cairo_image_surface_create_from_png(fname);
+    gboolean ok = FALSE;
+
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+        fprintf(stderr, "%s: not a PNG file\n", fname);
+    } else if ((cairo_image_surface_get_width(surface) != width) ||
+               (cairo_image_surface_get_height(surface) != height)) {
+        fprintf(stderr,
+                "%s: size is %dx%d, expected %dx%d\n",
+                fname,
+                cairo_image_surface_get_width(surface),
+                cairo_image_surface_get_height(surface),
+                width,
+                height);
+    } else {
+        const unsigned char *data;
+        int stride = cairo_image_surface_get_stride(surface);
+        int x, y;
+
+        cairo_surface_flush(surface);
+        data = cairo_image_surface_get_data(surface);
+
+        /* anything that differs from the first pixel was drawn */
+        for (y = 0; (y < height) && !ok; y++) {
+            const guint32 *row = (const guint32 *)(data + (gsize)y * stride);
+
+            for (x = 0; x < width; x++) {
+                if (row[x] != *(const guint32 *)data) {
+                    ok = TRUE;
+                    break;
+                }
+            }
+        }
+
+        if (!ok) {
+            fprintf(stderr, "%s: image is blank\n", fname);
+        }
+    }
+
+    cairo_surface_destroy(surface);
+    return (ok);
+}
+
+static gboolean svg_get_dimension(const char *svg, const char *name, double *value)
+{
+    char *pattern = g_strdup_printf("<svg[^>]*\\s%s=\"([0-9.]+)", name);
+    GRegex *regex = g_regex_new(pattern, 0, 0, NULL);
+    GMatchInfo *match = NULL;
+    gboolean found = g_regex_match(regex, svg, 0, &match);
+
+    if (found) {
+        char *str = g_match_info_fetch(match, 1);
+
+        *value = g_ascii_strtod(str, NULL);
+        g_free(str);
+    }
+
+    g_match_info_free(match);
+    g_regex_unref(regex);
+    g_free(pattern);
+    return (found);
+}
+
+static gboolean check_svg(const char *fname, int width, int height)
+{
+    char *svg = NULL;
+    double w = 0, h = 0;
+    gboolean ok = FALSE;
+
+    if (!g_file_get_contents(fname, &svg, NULL, NULL)) {
+        fprintf(stderr, "%s: cannot be read\n", fname);
+    } else if (!svg_get_dimension(svg, "width", &w) || !svg_get_dimension(svg, "height", &h)) {
+        fprintf(stderr, "%s: not an SVG file\n", fname);
+    } else if (((int)w != width) || ((int)h != height)) {
+        fprintf(stderr, "%s: size is %gx%g, expected %dx%d\n", fname, w, h, width, height);
+    } else if (!strstr(svg, "<path")) {
+        fprintf(stderr, "%s: image is blank\n", fname);
+    } else {
+        ok = TRUE;
+    }
+
+    g_free(svg);
+    return (ok);
+}
+
+int main(int argc, char **argv)
+{
+    int width, height;
+    gboolean ok;
+
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s FILE WIDTH HEIGHT\n", argv[0]);
+        return (EXIT_FAILURE);
+    }
+
+    width = atoi(argv[2]);
+    height = atoi(argv[3]);
+
+    if (g_str_has_suffix(argv[1], ".svg")) {
+        ok = check_svg(argv[1], width, height);
+    } else {
+        ok = check_png(argv[1], width, height);
+    }
+
+    return (ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -10,6 +10,7 @@
 #include <config.h>
 #include "globals.h"
 #include <gtk/gtk.h>
+#include <glib/gstdio.h>
 #include "gtk23compat.h"
 #include "symbol.h"
 #include "translate.h"
@@ -171,6 +172,121 @@ xl_Tree *xl_delete(char *i, xl_Tree *t)
 
 /************************ splay ************************/
 
+/************************ filter tables ************************/
+
+/*
+ * compiled filters never change once loaded, so tabs loading the same
+ * filter file or enums list share one table and lookups do not need any
+ * locking.  values match case insensitively and the first mapping given
+ * for a value wins.  a table is dropped from the cache once the last tab
+ * using it removes the filter or is closed.
+ */
+struct file_filter_source
+{
+    GHashTable *map;
+    gint64 mtime; /* of the filter file, 0 for enums lists */
+    goffset size;
+    guint users; /* filter slots of all tabs holding map */
+};
+
+static GHashTable *file_filter_sources; /* "file:name" or "enums:list" -> source */
+
+static guint xl_str_hash(gconstpointer v)
+{
+    const char *p;
+    guint32 h = 5381;
+
+    for (p = v; *p; p++) {
+        h = (h << 5) + h + g_ascii_tolower(*p);
+    }
+
+    return (h);
+}
+
+static gboolean xl_str_equal(gconstpointer v1, gconstpointer v2)
+{
+    return (g_ascii_strcasecmp(v1, v2) == 0);
+}
+
+static void file_filter_add(GHashTable *map, const char *lhs, const char *xlt)
+{
+    if (!g_hash_table_contains(map, lhs)) {
+        g_hash_table_insert(map, g_strdup(lhs), g_strdup(xlt));
+    }
+}
+
+static void file_filter_source_free(gpointer data)
+{
+    struct file_filter_source *src = data;
+
+    g_hash_table_unref(src->map);
+    g_free(src);
+}
+
+/* returns the table loaded earlier from key or NULL */
+static struct file_filter_source *file_filter_lookup_shared(const char *key,
+                                                            gint64 mtime,
+                                                            goffset size)
+{
+    struct file_filter_source *src;
+
+    if (!file_filter_sources) {
+        return (NULL);
+    }
+
+    src = g_hash_table_lookup(file_filter_sources, key);
+    if (!src || src->mtime != mtime || src->size != size) {
+        return (NULL);
+    }
+
+    return (src);
+}
+
+/* takes over map, empty tables are neither shared nor installed */
+static struct file_filter_source *file_filter_share(const char *key,
+                                                    GHashTable *map,
+                                                    gint64 mtime,
+                                                    goffset size)
+{
+    struct file_filter_source *src;
+
+    if (!g_hash_table_size(map)) {
+        g_hash_table_unref(map);
+        return (NULL);
+    }
+
+    if (!file_filter_sources) {
+        file_filter_sources =
+            g_hash_table_new_full(g_str_hash, g_str_equal, g_free, file_filter_source_free);
+    }
+
+    src = g_new0(struct file_filter_source, 1);
+    src->map = map;
+    src->mtime = mtime;
+    src->size = size;
+    g_hash_table_replace(file_filter_sources, g_strdup(key), src);
+
+    return (src);
+}
+
+static gboolean file_filter_source_release(gpointer key, gpointer value, gpointer map)
+{
+    struct file_filter_source *src = value;
+    (void)key;
+
+    return ((src->map == map) && (--src->users == 0));
+}
+
+/* drops map from the cache with its last user, unless a newer version of its file replaced it */
+static void file_filter_release(GHashTable *map)
+{
+    if (file_filter_sources) {
+        g_hash_table_foreach_remove(file_filter_sources, file_filter_source_release, map);
+    }
+}
+
+/************************ filter tables ************************/
+
 void init_filetrans_data(void)
 {
     int i;
@@ -179,7 +295,7 @@ void init_filetrans_data(void)
         GLOBALS->filesel_filter = calloc_2(FILE_FILTER_MAX + 1, sizeof(char *));
     }
     if (!GLOBALS->xl_file_filter) {
-        GLOBALS->xl_file_filter = calloc_2(FILE_FILTER_MAX + 1, sizeof(struct xl_tree_node *));
+        GLOBALS->xl_file_filter = calloc_2(FILE_FILTER_MAX + 1, sizeof(GHashTable *));
     }
 
     for (i = 0; i < FILE_FILTER_MAX + 1; i++) {
@@ -188,23 +304,11 @@ void init_filetrans_data(void)
     }
 }
 
-static void remove_file_filter_2(xl_Tree *t)
-{
-    if (t->left)
-        remove_file_filter_2(t->left);
-    if (t->right)
-        remove_file_filter_2(t->right);
-    if (t->item)
-        free_2(t->item);
-    if (t->trans)
-        free_2(t->trans);
-    free_2(t);
-}
-
 static void remove_file_filter(int which, int regen)
 {
     if (GLOBALS->xl_file_filter[which]) {
-        remove_file_filter_2(GLOBALS->xl_file_filter[which]);
+        file_filter_release(GLOBALS->xl_file_filter[which]);
+        g_hash_table_unref(GLOBALS->xl_file_filter[which]);
         GLOBALS->xl_file_filter[which] = NULL;
     }
 
@@ -214,8 +318,35 @@ static void remove_file_filter(int which, int regen)
     }
 }
 
+/* loading a filter again installs the same state as loading it the first time */
+static void install_file_filter_table(int which, struct file_filter_source *src)
+{
+    if (src) {
+        src->users++;
+        GLOBALS->xl_file_filter[which] = g_hash_table_ref(src->map);
+    }
+}
+
+/* releases the shared tables of the current tab when it is closed or reloaded */
+void remove_all_file_filters(void)
+{
+    int i;
+
+    if (!GLOBALS->xl_file_filter) {
+        return;
+    }
+
+    for (i = 0; i < FILE_FILTER_MAX + 1; i++) {
+        remove_file_filter(i, 0);
+    }
+}
+
 static void load_file_filter(int which, const char *name)
 {
+    GStatBuf sb;
+    struct file_filter_source *src;
+    GHashTable *map;
+    char *key;
     FILE *f = fopen(name, "rb");
     if (!f) {
         status_text("Could not open filter file!\n");
@@ -226,6 +357,21 @@ static void load_file_filter(int which, const char *name)
         which,
         0); /* should never happen from GUI, but possible from save files or other weirdness */
 
+    if (g_stat(name, &sb) != 0) {
+        memset(&sb, 0, sizeof(sb));
+    }
+
+    key = g_strconcat("file:", name, NULL);
+    src = file_filter_lookup_shared(key, sb.st_mtime, sb.st_size);
+    if (src) {
+        install_file_filter_table(which, src);
+        g_free(key);
+        fclose(f);
+        return;
+    }
+
+    map = g_hash_table_new_full(xl_str_hash, xl_str_equal, g_free, g_free);
+
     while (!feof(f)) {
         char *s = fgetmalloc(f);
         if (s) {
@@ -247,8 +393,7 @@ static void load_file_filter(int which, const char *name)
                         while (*xlt && isspace((int)(unsigned char)*xlt))
                             xlt++;
                         if (*xlt) {
-                            GLOBALS->xl_file_filter[which] =
-                                xl_insert(lhs, GLOBALS->xl_file_filter[which], xlt);
+                            file_filter_add(map, lhs, xlt);
                         }
                     }
                 }
@@ -259,16 +404,24 @@ static void load_file_filter(int which, const char *name)
     }
 
     fclose(f);
+
+    src = file_filter_share(key, map, sb.st_mtime, sb.st_size);
+    g_free(key);
+    install_file_filter_table(which, src);
 }
 
 static void load_enums_filter(int which, const char *name)
 {
     int argc;
     char **spl = zSplitTclList(name, &argc);
+    struct file_filter_source *src;
+    char *key;
     int i;
 
     if ((!spl) || (!argc) || (argc & 1)) {
         status_text("Malformed enums list!\n");
+        if (spl)
+            free_2(spl);
         return;
     }
 
@@ -276,13 +429,24 @@ static void load_enums_filter(int which, const char *name)
         which,
         0); /* should never happen from GUI, but possible from save files or other weirdness */
 
-    for (i = 0; i < argc; i += 2) {
-        char *lhs = spl[i];
-        char *xlt = spl[i + 1];
+    key = g_strconcat("enums:", name, NULL);
+    src = file_filter_lookup_shared(key, 0, 0);
+    if (!src) {
+        GHashTable *map = g_hash_table_new_full(xl_str_hash, xl_str_equal, g_free, g_free);
+
+        for (i = 0; i < argc; i += 2) {
+            char *lhs = spl[i];
+            char *xlt = spl[i + 1];
 
-        GLOBALS->xl_file_filter[which] = xl_insert(lhs, GLOBALS->xl_file_filter[which], xlt);
+            file_filter_add(map, lhs, xlt);
+        }
+
+        src = file_filter_share(key, map, 0, 0);
     }
     free_2(spl);
+    g_free(key);
+
+    install_file_filter_table(which, src);
 }
 
 int install_file_filter(int which)
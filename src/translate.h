@@ -37,6 +37,7 @@ xl_Tree *xl_delete(char *i, xl_Tree *t);
 
 void trans_searchbox(const char *title);
 void init_filetrans_data(void);
+void remove_all_file_filters(void);
 int install_file_filter(int which);
 
 void set_current_translate_enums(char *lst);
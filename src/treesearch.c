@@ -663,7 +663,10 @@ static gboolean filter_edit_cb(GtkWidget *widget, GdkEventKey *ev, gpointer *dat
                                    GLOBALS->filter_matlen_treesearch_gtk2_c_1,
                                WAVE_REGEX_TREE);
         }
+
+        gint64 stats_begin = gw_stats_timer_begin();
         fill_sig_store();
+        gw_stats_timer_end(GW_STATS_TIMER_FILTER, stats_begin);
     }
     return FALSE;
 }
@@ -14,6 +14,7 @@
 #include "symbol.h"
 #include "ttranslate.h"
 #include "pipeio.h"
+#include "gw-wave-view.h"
 #include "debug.h"
 
 enum
@@ -91,6 +92,8 @@ void remove_all_ttrans_filters(void)
     for (j = 0; j < GLOBALS->num_notebook_pages; j++) {
         GLOBALS = (*GLOBALS->contexts)[j];
 
+        ttrans_cancel_jobs();
+
         for (i = 1; i < TTRANS_FILTER_MAX + 1; i++) {
             if (GLOBALS->ttrans_filter[i]) {
                 pipeio_destroy(GLOBALS->ttrans_filter[i]);
@@ -210,6 +213,7 @@ int install_ttrans_filter(int which)
                 }
 
                 if ((t->vector) && (!(t->flags & (TR_BLANK | TR_ANALOG_BLANK_STRETCH)))) {
+                    ttrans_forget_trace(t);
                     t->t_filter = which;
                     t->t_filter_converted = 0;
 
@@ -545,300 +549,585 @@ void set_current_translate_ttrans(char *name)
     }
 }
 
-int traverse_vector_nodes(GwTrace *t)
+/*
+ * transaction filters run in the background: the trace is written to the
+ * filter on the main thread, a reader thread collects the lines the filter
+ * answers with and a timeout on the main thread appends them to the trace
+ * so partial results show up while the filter is still decoding.  jobs
+ * sharing a filter are run one after the other in the order they were
+ * requested.
+ */
+#define TTRANS_POLL_MS (50)
+#define TTRANS_POLL_BUDGET (65536) /* lines ingested per job and poll */
+#define TTRANS_QUEUE_MAX (4 * TTRANS_POLL_BUDGET) /* lines buffered before the reader waits */
+
+enum
+{
+    TTRANS_REDRAW_WAVES = 1,
+    TTRANS_REDRAW_ALL = 2
+};
+
+struct ttrans_job
+{
+    struct Global *globals; /* context of the trace */
+    GwTrace *t; /* NULL once the trace is gone, its output is then discarded */
+    int which; /* index of the filter in ttrans_filter[] */
+    struct pipe_ctx *p;
+    GThread *thread; /* NULL while the filter is busy with an earlier job */
+    GAsyncQueue *lines; /* filter output up to and including $finish */
+    GMutex lock; /* guards stopping, paired with space */
+    GCond space; /* signalled when lines were taken from the queue */
+    gboolean stopping; /* the reader no longer waits for space */
+
+    GwBitVector *bv; /* section being received */
+    GwBitVector *prev; /* section in front of it, NULL for the first one */
+    int capacity; /* slots in bv->vectors */
+    int regions; /* entries of the section including the four sentinels */
+    GwVectorEnt *vprev; /* entry in front of tail, for duplicate removal */
+    GwVectorEnt *tail; /* last entry in front of the end sentinels */
+    GwVectorEnt *end; /* MAX_HISTENT_TIME - 1 sentinel */
+    GwTime prev_tim;
+};
+
+static GList *ttrans_jobs;
+static guint ttrans_poll_id;
+
+static char *ttrans_skip_space(char *pnt)
+{
+    while (*pnt && isspace((int)(unsigned char)*pnt)) {
+        pnt++;
+    }
+
+    return (pnt);
+}
+
+static char *ttrans_skip_word(char *pnt)
+{
+    while (*pnt && !isspace((int)(unsigned char)*pnt)) {
+        pnt++;
+    }
+
+    return (pnt);
+}
+
+static char *ttrans_chomp(char *sp)
+{
+    int slen = strlen(sp);
+
+    while (slen && isspace((int)(unsigned char)sp[slen - 1])) {
+        sp[--slen] = 0;
+    }
+
+    return (sp);
+}
+
+static GwVectorEnt *ttrans_vector_ent_new(GwTime tim, const char *s)
+{
+    GwVectorEnt *vt = calloc_2(1, sizeof(GwVectorEnt) + strlen(s) + 1);
+
+    vt->time = tim;
+    strcpy((char *)vt->v, s);
+
+    return (vt);
+}
+
+/*
+ * starts an empty section and splices it into the trace: the first one
+ * replaces the vector of the trace, later ones ($next) are chained to it
+ */
+static void ttrans_section_begin(struct ttrans_job *job)
+{
+    GwTrace *t = job->t;
+    GwVectorEnt *head;
+    GwBitVector *bv;
+
+    head = ttrans_vector_ent_new(GW_TIME_CONSTANT(-2), "");
+    job->vprev = head;
+    job->tail = head->next = ttrans_vector_ent_new(GW_TIME_CONSTANT(-1), "");
+    job->end = job->tail->next = ttrans_vector_ent_new(MAX_HISTENT_TIME - 1, "");
+    job->end->next = ttrans_vector_ent_new(MAX_HISTENT_TIME, "");
+    job->prev_tim = GW_TIME_CONSTANT(-1);
+    job->regions = 4;
+    job->capacity = 64;
+
+    bv = calloc_2(1, sizeof(GwBitVector) + (sizeof(GwVectorEnt *) * job->capacity));
+    bv->bvname = strdup_2(t->n.vec->bvname);
+    bv->nbits = 1;
+    bv->bits = t->n.vec->bits;
+    bv->numregions = job->regions;
+    bv->vectors[0] = head;
+    bv->vectors[1] = head->next;
+    bv->vectors[2] = job->end;
+    bv->vectors[3] = job->end->next;
+
+    if (!job->bv) {
+        bv->transaction_cache = t->n.vec; /* for possible restore later */
+        t->n.vec = bv;
+        t->t_filter_converted = 1;
+    } else {
+        job->prev = job->bv;
+        job->prev->transaction_chain = bv;
+    }
+
+    job->bv = bv;
+}
+
+static void ttrans_section_append(struct ttrans_job *job, GwTime tim, const char *s)
 {
+    GwVectorEnt *vt;
+
+    if (tim > job->prev_tim) {
+        vt = ttrans_vector_ent_new(tim, s);
+        vt->next = job->end;
+        job->tail->next = vt;
+        job->vprev = job->tail;
+        job->tail = vt;
+        job->prev_tim = tim;
+        job->regions++;
+    } else if (tim == job->prev_tim) {
+        vt = ttrans_vector_ent_new(tim, s);
+        vt->next = job->end;
+        job->vprev->next = vt; /* replaces the previous entry */
+        free_2(job->tail);
+        job->tail = vt;
+    }
+    /* else throw it away */
+}
+
+/*
+ * makes the entries appended since the last call visible in bv->vectors,
+ * growing the section geometrically so a long stream is not copied over
+ * and over
+ */
+static void ttrans_section_publish(struct ttrans_job *job)
+{
+    GwBitVector *bv = job->bv;
+    GwVectorEnt *vt;
     int i;
-    int cvt_ok = 0;
 
+    if (job->regions > job->capacity) {
+        GwBitVector *grown;
+
+        job->capacity = MAX(job->regions, job->capacity * 2);
+        grown = calloc_2(1, sizeof(GwBitVector) + (sizeof(GwVectorEnt *) * job->capacity));
+        memcpy(grown, bv, sizeof(GwBitVector) + (sizeof(GwVectorEnt *) * bv->numregions));
+
+        if (job->prev) {
+            job->prev->transaction_chain = grown;
+        } else {
+            job->t->n.vec = grown;
+        }
+
+        free_2(bv);
+        job->bv = bv = grown;
+    }
+
+    /* only the last entry published can have been replaced since */
+    i = (bv->numregions > 4) ? bv->numregions - 4 : 0;
+    for (vt = bv->vectors[i]; vt; vt = vt->next) {
+        bv->vectors[i++] = vt;
+    }
+    bv->numregions = job->regions;
+
+    if (bv->edge_index) {
+        gw_edge_index_free(bv->edge_index);
+        bv->edge_index = NULL;
+    }
+}
+
+static void ttrans_set_marker(char *pnt, GwTime time_scale)
+{
+    int mlen = bijective_marker_id_string_len(pnt);
+
+    if (mlen) {
+        int which_marker = bijective_marker_id_string_hash(pnt);
+
+        GwNamedMarkers *markers = gw_project_get_named_markers(GLOBALS->project);
+        GwMarker *marker = gw_named_markers_get(markers, which_marker);
+
+        if (marker != NULL) {
+            GwTime tim = atoi_64(pnt + mlen) * time_scale;
+
+            if (tim < GW_TIME_CONSTANT(0))
+                tim = GW_TIME_CONSTANT(-1);
+
+            gw_marker_set_position(marker, tim);
+            gw_marker_set_enabled(marker, tim >= 0);
+            gw_marker_set_alias(marker, ttrans_chomp(ttrans_skip_space(ttrans_skip_word(pnt))));
+        }
+    }
+}
+
+/*
+ * appends one line of filter output to the trace, returns TRUE once the
+ * filter is done with it
+ */
+static gboolean ttrans_job_ingest(struct ttrans_job *job, char *pnt, int *redraw)
+{
     GwTime time_scale = gw_dump_file_get_time_scale(GLOBALS->dump_file);
+    GwTrace *t = job->t;
 
-    if ((t->t_filter) && (t->flags & TR_TTRANSLATED) && (t->vector) && (!t->t_filter_converted)) {
-#if !defined __MINGW32__
-        int rc = save_nodes_to_trans(GLOBALS->ttrans_filter[t->t_filter]->sout, t);
-#else
-        int rc =
-            save_nodes_to_trans((FILE *)(GLOBALS->ttrans_filter[t->t_filter]->g_hChildStd_IN_Wr),
-                                t);
-#endif
+    if (!strncmp(pnt, "$finish", 7)) {
+        return (TRUE);
+    }
+
+    if (!t) {
+        return (FALSE);
+    }
+
+    if (*pnt == '#') {
+        GwTime tim = atoi_64(pnt + 1) * time_scale;
+
+        ttrans_section_append(job, tim, ttrans_chomp(ttrans_skip_space(ttrans_skip_word(pnt))));
+        *redraw |= TTRANS_REDRAW_WAVES;
+    } else if ((*pnt == 'M') || (*pnt == 'm')) {
+        ttrans_set_marker(pnt + 1, time_scale);
+        *redraw |= TTRANS_REDRAW_WAVES;
+    } else if (*pnt == '$') {
+        if (!strncmp(pnt + 1, "next", 4)) {
+            ttrans_section_publish(job);
+            ttrans_section_begin(job);
+            *redraw |= TTRANS_REDRAW_ALL;
+        } else if (!strncmp(pnt + 1, "name", 4)) {
+            char *sp = ttrans_chomp(ttrans_skip_space(pnt + 5));
+
+            if (*sp) {
+                free_2(job->bv->bvname);
+                job->bv->bvname = strdup_2(sp);
+
+                if (!job->prev) {
+                    t->name = job->bv->bvname;
+                    if (GLOBALS->hier_max_level)
+                        t->name = hier_extract(t->name, GLOBALS->hier_max_level);
+                }
+
+                *redraw |= TTRANS_REDRAW_ALL;
+            }
+        }
+    }
+
+    return (FALSE);
+}
+
+/*
+ * a context that is not shown is not polled, so its queue is bounded here:
+ * the reader stops taking output and the filter of that tab blocks on its
+ * stdout until the tab is selected again
+ */
+static void ttrans_reader_wait_for_space(struct ttrans_job *job)
+{
+    g_mutex_lock(&job->lock);
+    while (!job->stopping && (g_async_queue_length(job->lines) >= TTRANS_QUEUE_MAX)) {
+        g_cond_wait(&job->space, &job->lock);
+    }
+    g_mutex_unlock(&job->lock);
+}
+
+static gpointer ttrans_reader_thread(gpointer data)
+{
+    struct ttrans_job *job = data;
+    char buf[1025];
+
+    while (pipeio_read_line(job->p, buf) >= 0) {
+        char *pnt = ttrans_skip_space(buf);
+
+        if ((*pnt == '#') || (*pnt == 'M') || (*pnt == 'm') || (*pnt == '$')) {
+            ttrans_reader_wait_for_space(job);
+            g_async_queue_push(job->lines, g_strdup(pnt));
+
+            if (!strncmp(pnt, "$finish", 7)) {
+                return (NULL);
+            }
+        }
+    }
 
-        if (rc == VCDSAV_OK) {
-            int is_finish = 0;
-            GwBitVector *prev_transaction_trace = NULL;
+    g_async_queue_push(job->lines, g_strdup("$finish")); /* filter went away */
+    return (NULL);
+}
 
-            while (!is_finish) {
-                GwVectorEnt *vt_head = NULL;
-                GwVectorEnt *vt_curr = NULL;
-                GwVectorEnt *vt;
-                GwVectorEnt *vprev;
-                GwBitVector *bv;
-                int regions = 2;
-                GwTime prev_tim = GW_TIME_CONSTANT(-1);
-                char *trace_name = NULL;
-                char *orig_name = t->n.vec->bvname;
+static gboolean ttrans_filter_busy(struct pipe_ctx *p)
+{
+    GList *iter;
+
+    for (iter = ttrans_jobs; iter; iter = iter->next) {
+        struct ttrans_job *job = iter->data;
 
-                cvt_ok = 1;
+        if ((job->p == p) && (job->thread)) {
+            return (TRUE);
+        }
+    }
 
-                vt_head = vt_curr = vt = calloc_2(1, sizeof(GwVectorEnt) + 1);
-                vt->time = GW_TIME_CONSTANT(-2);
-                vprev = vt; /* for duplicate removal */
+    return (FALSE);
+}
 
-                vt_curr = vt_curr->next = vt = calloc_2(1, sizeof(GwVectorEnt) + 1);
-                vt->time = GW_TIME_CONSTANT(-1);
+/* mirrors the VCDSAV_EMPTY check of the saver for a single trace */
+static gboolean ttrans_trace_has_nodes(GwTrace *t)
+{
+    GwBits *bt = t->n.vec ? t->n.vec->bits : NULL;
+    int i;
 
-                for (;;) {
-                    char buf[1025];
-                    char *pnt, *rtn;
+    if (!t->vector) {
+        return (t->n.nd != NULL);
+    }
+
+    if (bt) {
+        for (i = 0; i < bt->nnbits; i++) {
+            if (bt->nodes[i]) {
+                return (TRUE);
+            }
+        }
+    }
+
+    return (FALSE);
+}
+
+static void ttrans_job_stop_reader(struct ttrans_job *job)
+{
+    g_mutex_lock(&job->lock);
+    job->stopping = TRUE;
+    g_cond_signal(&job->space);
+    g_mutex_unlock(&job->lock);
+
+    g_thread_join(job->thread);
+    job->thread = NULL;
+}
+
+/*
+ * a filter that was fed part of a trace is left in the middle of a
+ * transaction, so it is replaced by a fresh process.  jobs of the same
+ * context waiting for it are moved over to the new one.
+ */
+static void ttrans_respawn_filter(struct ttrans_job *failed)
+{
+    struct pipe_ctx *old = failed->p;
+    struct pipe_ctx *p;
+    GList *iter;
+
+    pipeio_hangup(old); /* the reader runs into EOF */
+    ttrans_job_stop_reader(failed);
+
+    pipeio_destroy(old);
+    GLOBALS->ttrans_filter[failed->which] = NULL;
+    if (GLOBALS->ttranssel_filter[failed->which]) {
+        load_ttrans_filter(failed->which, GLOBALS->ttranssel_filter[failed->which]);
+    }
+    p = GLOBALS->ttrans_filter[failed->which];
+
+    failed->p = p;
+    for (iter = ttrans_jobs; iter; iter = iter->next) {
+        struct ttrans_job *job = iter->data;
+
+        if (job->p == old) {
+            job->p = p;
+        }
+    }
+}
+
+/*
+ * the reader is started before the trace is written: a filter that answers
+ * while it is still being fed would otherwise fill its stdout pipe and stop
+ * reading, leaving both sides blocked in write()
+ */
+static gboolean ttrans_job_start(struct ttrans_job *job)
+{
+    int rc;
+
+    if (!job->p || !ttrans_trace_has_nodes(job->t)) {
+        return (FALSE);
+    }
+
+    job->thread = g_thread_new("ttranslate", ttrans_reader_thread, job);
 
 #if !defined __MINGW32__
-                    if (feof(GLOBALS->ttrans_filter[t->t_filter]->sin))
-                        break; /* should never happen */
-
-                    buf[0] = 0;
-                    pnt = fgets(buf, 1024, GLOBALS->ttrans_filter[t->t_filter]->sin);
-                    if (!pnt)
-                        break;
-                    rtn = pnt;
-                    while (*rtn) {
-                        if ((*rtn == '\n') || (*rtn == '\r')) {
-                            *rtn = 0;
-                            break;
-                        }
-                        rtn++;
-                    }
+    rc = save_nodes_to_trans(job->p->sout, job->t);
 #else
-                    {
-                        BOOL bSuccess;
-                        DWORD dwRead;
-                        int n;
-
-                        for (n = 0; n < 1024; n++) {
-                            do {
-                                bSuccess = ReadFile(
-                                    GLOBALS->ttrans_filter[t->t_filter]->g_hChildStd_OUT_Rd,
-                                    buf + n,
-                                    1,
-                                    &dwRead,
-                                    NULL);
-                                if ((!bSuccess) || (buf[n] == '\n')) {
-                                    goto ex;
-                                }
-
-                            } while (buf[n] == '\r');
-                        }
-                    ex:
-                        buf[n] = 0;
-                        pnt = buf;
-                    }
+    rc = save_nodes_to_trans((FILE *)(job->p->g_hChildStd_IN_Wr), job->t);
 #endif
 
-                    while (*pnt) {
-                        if (isspace((int)(unsigned char)*pnt))
-                            pnt++;
-                        else
-                            break;
-                    }
+    if (rc != VCDSAV_OK) {
+        /* the filter never sees data_end, only this job fails */
+        ttrans_respawn_filter(job);
+        return (FALSE);
+    }
 
-                    if (*pnt == '#') {
-                        GwTime tim = atoi_64(pnt + 1) * time_scale;
-                        int slen;
-                        char *sp;
+    return (TRUE);
+}
 
-                        while (*pnt) {
-                            if (!isspace((int)(unsigned char)*pnt))
-                                pnt++;
-                            else
-                                break;
-                        }
-                        while (*pnt) {
-                            if (isspace((int)(unsigned char)*pnt))
-                                pnt++;
-                            else
-                                break;
-                        }
+static void ttrans_job_free(struct ttrans_job *job)
+{
+    if (job->thread) {
+        ttrans_job_stop_reader(job);
+    }
 
-                        sp = pnt;
-                        slen = strlen(sp);
-
-                        if (slen) {
-                            pnt = sp + slen - 1;
-                            do {
-                                if (isspace((int)(unsigned char)*pnt)) {
-                                    *pnt = 0;
-                                    pnt--;
-                                    slen--;
-                                } else {
-                                    break;
-                                }
-                            } while (pnt != (sp - 1));
-                        }
+    g_async_queue_unref(job->lines);
+    g_mutex_clear(&job->lock);
+    g_cond_clear(&job->space);
+    g_free(job);
+}
 
-                        vt = calloc_2(1, sizeof(GwVectorEnt) + slen + 1);
-                        if (sp)
-                            strcpy((char *)vt->v, sp);
-
-                        if (tim > prev_tim) {
-                            prev_tim = vt->time = tim;
-                            vt_curr->next = vt;
-                            vt_curr = vt;
-                            vprev = vprev->next; /* bump forward the -2 node pointer */
-                            regions++;
-                        } else if (tim == prev_tim) {
-                            vt->time = prev_tim;
-                            free_2(vt_curr);
-                            vt_curr = vprev->next = vt; /* splice new one in -1 node place */
-                        } else {
-                            free_2(vt); /* throw it away */
-                        }
+/* backs out the empty section of a job whose trace could not be written */
+static void ttrans_job_revert(struct ttrans_job *job)
+{
+    GwTrace *t = job->t;
+    GwBitVector *bv = t->n.vec;
+    int i;
 
-                        continue;
-                    } else if ((*pnt == 'M') || (*pnt == 'm')) {
-                        int mlen;
-                        pnt++;
-
-                        mlen = bijective_marker_id_string_len(pnt);
-                        if (mlen) {
-                            int which_marker = bijective_marker_id_string_hash(pnt);
-
-                            GwNamedMarkers *markers =
-                                gw_project_get_named_markers(GLOBALS->project);
-                            GwMarker *marker = gw_named_markers_get(markers, which_marker);
-
-                            if (marker != NULL) {
-                                GwTime tim = atoi_64(pnt + mlen) * time_scale;
-                                int slen;
-                                char *sp;
-
-                                if (tim < GW_TIME_CONSTANT(0))
-                                    tim = GW_TIME_CONSTANT(-1);
-
-                                gw_marker_set_position(marker, tim);
-                                gw_marker_set_enabled(marker, tim >= 0);
-
-                                while (*pnt) {
-                                    if (!isspace((int)(unsigned char)*pnt))
-                                        pnt++;
-                                    else
-                                        break;
-                                }
-                                while (*pnt) {
-                                    if (isspace((int)(unsigned char)*pnt))
-                                        pnt++;
-                                    else
-                                        break;
-                                }
-
-                                sp = pnt;
-                                slen = strlen(sp);
-
-                                if (slen) {
-                                    pnt = sp + slen - 1;
-                                    do {
-                                        if (isspace((int)(unsigned char)*pnt)) {
-                                            *pnt = 0;
-                                            pnt--;
-                                            slen--;
-                                        } else {
-                                            break;
-                                        }
-                                    } while (pnt != (sp - 1));
-                                }
-
-                                gw_marker_set_alias(marker, sp);
-                            }
-                        }
+    t->n.vec = bv->transaction_cache;
+    for (i = 0; i < bv->numregions; i++) {
+        free_2(bv->vectors[i]);
+    }
+    free_2(bv->bvname);
+    free_2(bv);
 
-                        continue;
-                    } else if (*pnt == '$') {
-                        if (!strncmp(pnt + 1, "finish", 6)) {
-                            is_finish = 1;
-                            break;
-                        } else if (!strncmp(pnt + 1, "next", 4)) {
-                            break;
-                        } else if (!strncmp(pnt + 1, "name", 4)) {
-                            int slen;
-                            char *sp;
-
-                            pnt += 5;
-                            while (*pnt) {
-                                if (isspace((int)(unsigned char)*pnt))
-                                    pnt++;
-                                else
-                                    break;
-                            }
+    t->t_filter_converted = 0;
+    t->flags &= ~(TR_TTRANSLATED | TR_ANALOGMASK);
+}
 
-                            sp = pnt;
-                            slen = strlen(sp);
-
-                            if (slen) {
-                                pnt = sp + slen - 1;
-                                do {
-                                    if (isspace((int)(unsigned char)*pnt)) {
-                                        *pnt = 0;
-                                        pnt--;
-                                        slen--;
-                                    } else {
-                                        break;
-                                    }
-                                } while (pnt != (sp - 1));
-                            }
+static gboolean ttrans_poll(gpointer data)
+{
+    GList *iter = ttrans_jobs;
+    int redraw = 0;
 
-                            if (sp && *sp) {
-                                if (trace_name)
-                                    free_2(trace_name);
-                                trace_name = strdup_2(sp);
-                            }
-                        }
-                    }
-                }
+    (void)data;
 
-                vt_curr = vt_curr->next = vt = calloc_2(1, sizeof(GwVectorEnt) + 1);
-                vt->time = MAX_HISTENT_TIME - 1;
-                regions++;
-
-                /* vt_curr = */ vt_curr->next = vt =
-                    calloc_2(1, sizeof(GwVectorEnt) + 1); /* scan-build */
-                vt->time = MAX_HISTENT_TIME;
-                regions++;
-
-                bv = calloc_2(1, sizeof(GwBitVector) + (sizeof(GwVectorEnt *) * (regions)));
-                bv->bvname = strdup_2(trace_name ? trace_name : orig_name);
-                bv->nbits = 1;
-                bv->numregions = regions;
-                bv->bits = t->n.vec->bits;
-
-                vt = vt_head;
-                for (i = 0; i < regions; i++) {
-                    bv->vectors[i] = vt;
-                    vt = vt->next;
-                }
+    while (iter) {
+        struct ttrans_job *job = iter->data;
+        GList *next = iter->next;
+        gboolean finished = FALSE;
 
-                if (!prev_transaction_trace) {
-                    prev_transaction_trace = bv;
-                    bv->transaction_cache = t->n.vec; /* for possible restore later */
-                    t->n.vec = bv;
+        /* markers and time scale belong to the context, wait until it is shown */
+        if (job->globals != GLOBALS) {
+            iter = next;
+            continue;
+        }
 
-                    t->t_filter_converted = 1;
+        if (!job->thread) {
+            if (!ttrans_filter_busy(job->p) && !ttrans_job_start(job)) {
+                ttrans_job_revert(job);
+                redraw |= TTRANS_REDRAW_ALL;
+                finished = TRUE;
+            }
+        } else {
+            int budget = TTRANS_POLL_BUDGET;
+            char *line;
 
-                    if (trace_name) /* if NULL, no need to regen display as trace name didn't change
-                                     */
-                    {
-                        t->name = t->n.vec->bvname;
-                        if (GLOBALS->hier_max_level)
-                            t->name = hier_extract(t->name, GLOBALS->hier_max_level);
+            while (!finished && budget-- && (line = g_async_queue_try_pop(job->lines))) {
+                finished = ttrans_job_ingest(job, line, &redraw);
+                g_free(line);
+            }
 
-                        GLOBALS->signalwindow_width_dirty = 1;
-                        redraw_signals_and_waves();
-                    }
-                } else {
-                    prev_transaction_trace->transaction_chain = bv;
-                    prev_transaction_trace = bv;
-                }
+            g_mutex_lock(&job->lock);
+            g_cond_signal(&job->space);
+            g_mutex_unlock(&job->lock);
+
+            if (job->t) {
+                ttrans_section_publish(job);
             }
-        } else {
-            /* failed */
-            t->flags &= ~(TR_TTRANSLATED | TR_ANALOGMASK);
         }
+
+        if (finished) {
+            ttrans_jobs = g_list_delete_link(ttrans_jobs, iter);
+            ttrans_job_free(job);
+        }
+
+        iter = next;
+    }
+
+    if (redraw & TTRANS_REDRAW_ALL) {
+        GLOBALS->signalwindow_width_dirty = 1;
+        redraw_signals_and_waves();
+    } else if (redraw && GLOBALS->wavearea) {
+        gw_wave_view_force_redraw(GW_WAVE_VIEW(GLOBALS->wavearea));
+    }
+
+    if (!ttrans_jobs) {
+        ttrans_poll_id = 0;
+        return (G_SOURCE_REMOVE);
+    }
+
+    return (G_SOURCE_CONTINUE);
+}
+
+/*
+ * called before a trace is freed or its transaction sections are backed
+ * out.  a running filter still has to be read up to $finish so its output
+ * is drained and dropped.
+ */
+void ttrans_forget_trace(GwTrace *t)
+{
+    GList *iter = ttrans_jobs;
+
+    while (iter) {
+        struct ttrans_job *job = iter->data;
+        GList *next = iter->next;
+
+        if (job->t == t) {
+            job->t = NULL;
+            if (!job->thread) {
+                ttrans_jobs = g_list_delete_link(ttrans_jobs, iter);
+                ttrans_job_free(job);
+            }
+        }
+
+        iter = next;
+    }
+}
+
+/*
+ * stops the jobs of the current context, the filters they run on are
+ * terminated
+ */
+void ttrans_cancel_jobs(void)
+{
+    GList *iter = ttrans_jobs;
+
+    while (iter) {
+        struct ttrans_job *job = iter->data;
+        GList *next = iter->next;
+
+        if (job->globals == GLOBALS) {
+            if (job->thread) {
+                pipeio_hangup(job->p);
+            }
+            ttrans_jobs = g_list_delete_link(ttrans_jobs, iter);
+            ttrans_job_free(job);
+        }
+
+        iter = next;
+    }
+}
+
+int traverse_vector_nodes(GwTrace *t)
+{
+    struct ttrans_job *job;
+
+    if (!((t->t_filter) && (t->flags & TR_TTRANSLATED) && (t->vector) &&
+          (!t->t_filter_converted))) {
+        return (0);
+    }
+
+    job = g_new0(struct ttrans_job, 1);
+    job->globals = GLOBALS;
+    job->t = t;
+    job->which = t->t_filter;
+    job->p = GLOBALS->ttrans_filter[t->t_filter];
+    job->lines = g_async_queue_new_full(g_free);
+    g_mutex_init(&job->lock);
+    g_cond_init(&job->space);
+
+    if (!ttrans_filter_busy(job->p) && !ttrans_job_start(job)) {
+        /* failed */
+        ttrans_job_free(job);
+        t->flags &= ~(TR_TTRANSLATED | TR_ANALOGMASK);
+        return (0);
+    }
+
+    ttrans_section_begin(job);
+    ttrans_jobs = g_list_append(ttrans_jobs, job);
+
+    if (!ttrans_poll_id) {
+        ttrans_poll_id = g_timeout_add(TTRANS_POLL_MS, ttrans_poll, NULL);
     }
 
-    return (cvt_ok);
+    return (1);
 }
@@ -25,5 +25,7 @@ void init_ttrans_data(void);
 int install_ttrans_filter(int which);
 void set_current_translate_ttrans(char *name);
 void remove_all_ttrans_filters(void);
+void ttrans_forget_trace(GwTrace *t);
+void ttrans_cancel_jobs(void);
 
 #endif
@@ -128,6 +128,7 @@ struct vcdsav_tree_node
     int val;
     GwHistEnt *hist;
     int len;
+    char id[16];
 
     union
     {
@@ -241,85 +242,576 @@ static vcdsav_Tree *vcdsav_insert(void *i,
     }
 }
 
-/************************ heap ************************/
+/************************ tournament tree ************************/
 
-static int hpcmp(vcdsav_Tree *hp1, vcdsav_Tree *hp2)
+#define VCDSAV_FLUSH_SIZE (1024 * 1024)
+#define VCDSAV_SLICES_PER_THREAD (4)
+#define VCDSAV_HISTOGRAM_BUCKETS (4096)
+
+/*
+ * winner tree over the history cursors of all exported nodes, the root holds
+ * the node with the earliest pending value change so finding the next one
+ * only replays the matches on the path of the previous winner
+ */
+typedef struct
 {
-    GwHistEnt *n1 = hp1->hist;
-    GwHistEnt *n2 = hp2->hist;
-    GwTime t1, t2;
-
-    if (n1)
-        t1 = n1->time;
-    else
-        t1 = MAX_HISTENT_TIME;
-    if (n2)
-        t2 = n2->time;
-    else
-        t2 = MAX_HISTENT_TIME;
-
-    if (t1 == t2) {
-        return (0);
-    } else if (t1 > t2) {
-        return (-1);
-    } else {
-        return (1);
+    int size; /* number of leaves rounded up to a power of two */
+    int *win;
+    GwTime *key; /* time of the pending value change, GW_TIME_MAX if done */
+    GwHistEnt **cur;
+    GwTime limit;
+} vcdsav_Tourney;
+
+static int vcdsav_tourney_match(vcdsav_Tourney *tt, int l, int r)
+{
+    /* on equal times the node that was added first wins */
+    return (tt->key[r] < tt->key[l]) ? r : l;
+}
+
+static void vcdsav_tourney_set_key(vcdsav_Tourney *tt, int i)
+{
+    GwHistEnt *h = tt->cur[i];
+
+    tt->key[i] = (h && (h->time < tt->limit)) ? h->time : GW_TIME_MAX;
+}
+
+static void vcdsav_tourney_init(vcdsav_Tourney *tt, GwHistEnt **cur, int nodecnt, GwTime limit)
+{
+    int i;
+
+    tt->size = 1;
+    while (tt->size < nodecnt) {
+        tt->size <<= 1;
+    }
+
+    tt->win = g_new(int, tt->size * 2);
+    tt->key = g_new(GwTime, tt->size);
+    tt->cur = cur;
+    tt->limit = limit;
+
+    for (i = 0; i < tt->size; i++) {
+        if (i < nodecnt) {
+            vcdsav_tourney_set_key(tt, i);
+        } else {
+            tt->key[i] = GW_TIME_MAX;
+        }
+        tt->win[tt->size + i] = i;
+    }
+
+    for (i = tt->size - 1; i > 0; i--) {
+        tt->win[i] = vcdsav_tourney_match(tt, tt->win[2 * i], tt->win[2 * i + 1]);
     }
 }
 
-static void recurse_build(vcdsav_Tree *vt, vcdsav_Tree ***hp)
+static void vcdsav_tourney_advance(vcdsav_Tourney *tt)
 {
-    if (vt->left)
-        recurse_build(vt->left, hp);
+    int i = tt->win[1];
+    int j;
 
-    **hp = vt;
-    *hp = (*hp) + 1;
+    tt->cur[i] = tt->cur[i]->next;
+    vcdsav_tourney_set_key(tt, i);
 
-    if (vt->right)
-        recurse_build(vt->right, hp);
+    for (j = (tt->size + i) >> 1; j > 0; j >>= 1) {
+        tt->win[j] = vcdsav_tourney_match(tt, tt->win[2 * j], tt->win[2 * j + 1]);
+    }
 }
 
+static void vcdsav_tourney_free(vcdsav_Tourney *tt)
+{
+    g_free(tt->win);
+    g_free(tt->key);
+}
+
+/************************ value changes ************************/
+
 /*
- * heapify algorithm...used to grab the next value change
+ * value changes of all nodes in [start of cur, limit), slices are formatted
+ * independently and written in time order
  */
-static void heapify(int i, int heap_size)
+typedef struct
 {
-    int l, r;
-    int largest;
-    vcdsav_Tree *t;
-    int maxele = heap_size / 2 - 1; /* points to where heapswaps don't matter anymore */
+    vcdsav_Tree **hp;
+    int nodecnt;
+    int max_len;
+    GwTime time_scale;
+    GwTime dumpvars_time; /* timestamp that is followed by $dumpvars */
+    GwTime dumpvars_end_time; /* timestamp that ends $dumpvars */
+
+    GwHistEnt **cur;
+    GwTime limit;
+    GwTime prevtime;
+
+    GString *out;
+    FILE *f; /* set if the output is written while it is formatted */
+    int is_trans;
+    void *fst;
+
+    gboolean done;
+} vcdsav_Slice;
+
+typedef struct
+{
+    GMutex lock;
+    GCond cond;
+} vcdsav_Sync;
 
-    for (;;) {
-        l = 2 * i + 1;
-        r = l + 1;
+static void w32redirect_fwrite(int is_trans, FILE *sfd, const char *buf, size_t len)
+{
+#if defined __MINGW32__
+    if (is_trans) {
+        DWORD dwWritten;
+
+        WriteFile((HANDLE)sfd, buf, len, &dwWritten, NULL);
+    } else
+#else
+    (void)is_trans;
+#endif
+    {
+        fwrite(buf, 1, len, sfd);
+    }
+}
+
+static void vcdsav_flush(vcdsav_Slice *sl)
+{
+    w32redirect_fwrite(sl->is_trans, sl->f, sl->out->str, sl->out->len);
+    g_string_truncate(sl->out, 0);
+}
+
+static void vcdsav_append_time(GString *s, GwTime t)
+{
+    char buf[24];
+    char *pnt = buf + sizeof(buf);
+    GwUTime u = (t < 0) ? -(GwUTime)t : (GwUTime)t;
+
+    do {
+        *(--pnt) = '0' + (u % 10);
+        u /= 10;
+    } while (u);
+
+    if (t < 0) {
+        *(--pnt) = '-';
+    }
+
+    g_string_append_len(s, pnt, buf + sizeof(buf) - pnt);
+}
+
+static void vcdsav_emit_time(vcdsav_Slice *sl, GwTime time)
+{
+    GwTime tnorm = time;
+
+    if (sl->time_scale != 1) {
+        tnorm /= sl->time_scale;
+    }
+
+    if (sl->fst) {
+        fstWriterEmitTimeChange(sl->fst, tnorm);
+        return;
+    }
+
+    if (time == sl->dumpvars_end_time) {
+        g_string_append(sl->out, "$end\n");
+    }
+    g_string_append_c(sl->out, '#');
+    vcdsav_append_time(sl->out, tnorm);
+    g_string_append_c(sl->out, '\n');
+    if (time == sl->dumpvars_time) {
+        g_string_append(sl->out, "$dumpvars\n");
+    }
+}
+
+static void vcdsav_emit_value(vcdsav_Slice *sl, vcdsav_Tree *vt, GwHistEnt *h, char *row_data)
+{
+    int i;
+
+    if (vt->flags & (GW_HIST_ENT_FLAG_REAL | GW_HIST_ENT_FLAG_STRING)) {
+        if (vt->flags & GW_HIST_ENT_FLAG_STRING) {
+            char *vec = h->v.h_vector ? h->v.h_vector : "UNDEF";
+            int vec_slen = strlen(vec);
+
+            if (sl->fst) {
+                fstWriterEmitVariableLengthValueChange(sl->fst, vt->handle.i, vec, vec_slen);
+                return;
+            }
+
+            char *vec_escaped = g_malloc(vec_slen * 4 + 1); /* worst case */
+            int vlen = fstUtilityBinToEsc((unsigned char *)vec_escaped,
+                                          (unsigned char *)vec,
+                                          vec_slen);
+
+            g_string_append_c(sl->out, 's');
+            if (vlen) {
+                g_string_append_len(sl->out, vec_escaped, vlen);
+            } else {
+                g_string_append(sl->out, "\\000");
+            }
+            g_free(vec_escaped);
+        } else {
+            char buf[32];
+
+            if (sl->fst) {
+                fstWriterEmitValueChange(sl->fst, vt->handle.i, &h->v.h_double);
+                return;
+            }
 
-        if ((l < heap_size) &&
-            (hpcmp(GLOBALS->hp_vcd_saver_c_1[l], GLOBALS->hp_vcd_saver_c_1[i]) > 0)) {
-            largest = l;
+            snprintf(buf, sizeof(buf), "r%.16g", h->v.h_double);
+            g_string_append(sl->out, buf);
+        }
+    } else if (vt->len) {
+        if (h->v.h_vector) {
+            for (i = 0; i < vt->len; i++) {
+                row_data[i] = analyzer_demang(0, h->v.h_vector[i]);
+            }
         } else {
-            largest = i;
+            memset(row_data, 'x', vt->len);
         }
-        if ((r < heap_size) &&
-            (hpcmp(GLOBALS->hp_vcd_saver_c_1[r], GLOBALS->hp_vcd_saver_c_1[largest]) > 0)) {
-            largest = r;
+        row_data[vt->len] = 0;
+
+        if (sl->fst) {
+            fstWriterEmitValueChange(sl->fst, vt->handle.i, row_data);
+            return;
         }
 
-        if (i != largest) {
-            t = GLOBALS->hp_vcd_saver_c_1[i];
-            GLOBALS->hp_vcd_saver_c_1[i] = GLOBALS->hp_vcd_saver_c_1[largest];
-            GLOBALS->hp_vcd_saver_c_1[largest] = t;
+        g_string_append_c(sl->out, 'b');
+        g_string_append(sl->out, vcd_truncate_bitvec(row_data));
+    } else {
+        char ch = analyzer_demang(0, h->v.h_val);
 
-            if (largest <= maxele) {
-                i = largest;
-            } else {
-                break;
+        if (sl->fst) {
+            fstWriterEmitValueChange(sl->fst, vt->handle.i, &ch);
+            return;
+        }
+
+        /* scalars are not separated from their identifier */
+        g_string_append_c(sl->out, ch);
+        g_string_append(sl->out, vt->id);
+        g_string_append_c(sl->out, '\n');
+        return;
+    }
+
+    g_string_append_c(sl->out, ' ');
+    g_string_append(sl->out, vt->id);
+    g_string_append_c(sl->out, '\n');
+}
+
+static void vcdsav_format_slice(vcdsav_Slice *sl)
+{
+    vcdsav_Tourney tt;
+    char *row_data = g_malloc(sl->max_len + 1);
+
+    vcdsav_tourney_init(&tt, sl->cur, sl->nodecnt, sl->limit);
+
+    while (tt.key[tt.win[1]] != GW_TIME_MAX) {
+        GwHistEnt *h = tt.cur[tt.win[1]];
+
+        if (h->time >= GW_TIME_CONSTANT(0)) {
+            if (h->time != sl->prevtime) {
+                vcdsav_emit_time(sl, h->time);
+                sl->prevtime = h->time;
+            }
+            vcdsav_emit_value(sl, sl->hp[tt.win[1]], h, row_data);
+        }
+
+        vcdsav_tourney_advance(&tt);
+
+        if (sl->f && (sl->out->len >= VCDSAV_FLUSH_SIZE)) {
+            vcdsav_flush(sl);
+        }
+    }
+
+    vcdsav_tourney_free(&tt);
+    g_free(row_data);
+}
+
+static void vcdsav_format_slice_func(gpointer data, gpointer user_data)
+{
+    vcdsav_Slice *sl = data;
+    vcdsav_Sync *sync = user_data;
+
+    vcdsav_format_slice(sl);
+
+    g_mutex_lock(&sync->lock);
+    sl->done = TRUE;
+    g_cond_broadcast(&sync->cond);
+    g_mutex_unlock(&sync->lock);
+}
+
+/*
+ * the value changes up to the second timestamp are enclosed in $dumpvars,
+ * find both timestamps up front so slices can be formatted independently
+ */
+static void vcdsav_find_dumpvars_times(vcdsav_Tree **hp,
+                                       int nodecnt,
+                                       GwTime end_time,
+                                       GwTime *first,
+                                       GwTime *second)
+{
+    int i;
+
+    *first = *second = GW_TIME_CONSTANT(-1);
+
+    for (i = 0; i < nodecnt; i++) {
+        GwHistEnt *h;
+        GwTime last = GW_TIME_CONSTANT(-1);
+        int seen = 0;
+
+        for (h = hp[i]->hist; h && (seen < 2) && (h->time <= end_time); h = h->next) {
+            GwTime t = h->time;
+
+            if ((t < GW_TIME_CONSTANT(0)) || (t == last)) {
+                continue;
+            }
+            last = t;
+            seen++;
+
+            if ((*first < GW_TIME_CONSTANT(0)) || (t < *first)) {
+                *second = *first;
+                *first = t;
+            } else if ((t > *first) && ((*second < GW_TIME_CONSTANT(0)) || (t < *second))) {
+                *second = t;
             }
-        } else {
-            break;
         }
     }
 }
 
+/*
+ * splits the exported time range into slices with about the same number of
+ * value changes, returns the number of slices along with their limits and the
+ * first value change of every node in each slice
+ */
+static int vcdsav_plan_slices(vcdsav_Tree **hp,
+                              int nodecnt,
+                              GwTime end_time,
+                              int max_slices,
+                              guint64 min_changes,
+                              GwTime **limits_out,
+                              GwHistEnt ***starts_out)
+{
+    guint64 *counts;
+    guint64 total = 0;
+    guint64 acc = 0;
+    GwTime width;
+    GwTime *limits;
+    GwHistEnt **starts;
+    int nslices = 0;
+    int i, s;
+
+    if ((end_time < GW_TIME_CONSTANT(0)) || (max_slices < 2)) {
+        return (1);
+    }
+
+    width = end_time / VCDSAV_HISTOGRAM_BUCKETS + 1;
+    counts = g_new0(guint64, VCDSAV_HISTOGRAM_BUCKETS);
+
+    for (i = 0; i < nodecnt; i++) {
+        GwHistEnt *h;
+
+        for (h = hp[i]->hist; h && (h->time <= end_time); h = h->next) {
+            if (h->time >= GW_TIME_CONSTANT(0)) {
+                counts[h->time / width]++;
+                total++;
+            }
+        }
+    }
+
+    if (total < min_changes) {
+        g_free(counts);
+        return (1);
+    }
+
+    limits = g_new(GwTime, max_slices);
+    for (i = 0; (i < VCDSAV_HISTOGRAM_BUCKETS - 1) && (nslices < max_slices - 1); i++) {
+        acc += counts[i];
+        if (acc * max_slices >= total * (nslices + 1)) {
+            limits[nslices++] = MIN((i + 1) * width, end_time + 1);
+        }
+    }
+    limits[nslices++] = end_time + 1;
+    g_free(counts);
+
+    starts = g_new(GwHistEnt *, nslices * nodecnt);
+    for (i = 0; i < nodecnt; i++) {
+        GwHistEnt *h = hp[i]->hist;
+
+        starts[i] = h;
+        for (s = 1; s < nslices; s++) {
+            while (h && (h->time < limits[s - 1])) {
+                h = h->next;
+            }
+            starts[s * nodecnt + i] = h;
+        }
+    }
+
+    *limits_out = limits;
+    *starts_out = starts;
+    return (nslices);
+}
+
+/*
+ * writes all value changes up to the limit of proto, returns the last
+ * timestamp that was written
+ */
+static GwTime vcdsav_write_value_changes(vcdsav_Slice *proto, int nthreads)
+{
+    GwTime *limits = NULL;
+    GwHistEnt **starts = NULL;
+    GwTime prevtime = GW_TIME_CONSTANT(-1);
+    int nslices = 1;
+    int i, s;
+
+    if (nthreads > 1) {
+        nslices = vcdsav_plan_slices(proto->hp,
+                                     proto->nodecnt,
+                                     proto->limit - 1,
+                                     nthreads * VCDSAV_SLICES_PER_THREAD,
+                                     GLOBALS->settings.vcd_saver_parallel_min,
+                                     &limits,
+                                     &starts);
+    }
+
+    if (nslices == 1) {
+        vcdsav_Slice sl = *proto;
+
+        sl.cur = g_new(GwHistEnt *, proto->nodecnt);
+        for (i = 0; i < proto->nodecnt; i++) {
+            sl.cur[i] = proto->hp[i]->hist;
+        }
+        sl.out = g_string_sized_new(VCDSAV_FLUSH_SIZE + 4096);
+
+        vcdsav_format_slice(&sl);
+        if (!sl.fst) {
+            vcdsav_flush(&sl);
+        }
+
+        g_string_free(sl.out, TRUE);
+        g_free(sl.cur);
+        return (sl.prevtime);
+    }
+
+    vcdsav_Slice *slices = g_new(vcdsav_Slice, nslices);
+    vcdsav_Sync sync;
+    GThreadPool *pool;
+    int in_flight = MIN(nslices, nthreads + 1);
+
+    g_mutex_init(&sync.lock);
+    g_cond_init(&sync.cond);
+    pool = g_thread_pool_new(vcdsav_format_slice_func, &sync, nthreads, FALSE, NULL);
+
+    for (s = 0; s < nslices; s++) {
+        slices[s] = *proto;
+        slices[s].cur = starts + s * proto->nodecnt;
+        slices[s].limit = limits[s];
+        slices[s].out = NULL;
+        slices[s].f = NULL;
+    }
+
+    /*
+     * slices are stitched together in time order as soon as they are done,
+     * only nthreads + 1 of them are formatted or waiting to be written at a
+     * time so the formatted output that is held in memory stays bounded
+     */
+    for (s = 0; s < in_flight; s++) {
+        slices[s].out = g_string_new(NULL);
+        g_thread_pool_push(pool, &slices[s], NULL);
+    }
+
+    for (s = 0; s < nslices; s++) {
+        g_mutex_lock(&sync.lock);
+        while (!slices[s].done) {
+            g_cond_wait(&sync.cond, &sync.lock);
+        }
+        g_mutex_unlock(&sync.lock);
+
+        w32redirect_fwrite(proto->is_trans, proto->f, slices[s].out->str, slices[s].out->len);
+        g_string_free(slices[s].out, TRUE);
+
+        if (s + in_flight < nslices) {
+            slices[s + in_flight].out = g_string_new(NULL);
+            g_thread_pool_push(pool, &slices[s + in_flight], NULL);
+        }
+
+        if (slices[s].prevtime > prevtime) {
+            prevtime = slices[s].prevtime;
+        }
+    }
+
+    g_thread_pool_free(pool, FALSE, TRUE);
+    g_mutex_clear(&sync.lock);
+    g_cond_clear(&sync.cond);
+
+    g_free(slices);
+    g_free(starts);
+    g_free(limits);
+
+    return (prevtime);
+}
+
+static enum fstVarType vcdsav_fst_var_type(GwVarType vartype)
+{
+    switch (vartype) {
+        case GW_VAR_TYPE_VCD_EVENT:
+            return FST_VT_VCD_EVENT;
+        case GW_VAR_TYPE_VCD_INTEGER:
+            return FST_VT_VCD_INTEGER;
+        case GW_VAR_TYPE_VCD_PARAMETER:
+            return FST_VT_VCD_PARAMETER;
+        case GW_VAR_TYPE_VCD_REG:
+            return FST_VT_VCD_REG;
+        case GW_VAR_TYPE_VCD_SUPPLY0:
+            return FST_VT_VCD_SUPPLY0;
+        case GW_VAR_TYPE_VCD_SUPPLY1:
+            return FST_VT_VCD_SUPPLY1;
+        case GW_VAR_TYPE_VCD_TIME:
+            return FST_VT_VCD_TIME;
+        case GW_VAR_TYPE_VCD_TRI:
+            return FST_VT_VCD_TRI;
+        case GW_VAR_TYPE_VCD_TRIAND:
+            return FST_VT_VCD_TRIAND;
+        case GW_VAR_TYPE_VCD_TRIOR:
+            return FST_VT_VCD_TRIOR;
+        case GW_VAR_TYPE_VCD_TRIREG:
+            return FST_VT_VCD_TRIREG;
+        case GW_VAR_TYPE_VCD_TRI0:
+            return FST_VT_VCD_TRI0;
+        case GW_VAR_TYPE_VCD_TRI1:
+            return FST_VT_VCD_TRI1;
+        case GW_VAR_TYPE_VCD_WAND:
+            return FST_VT_VCD_WAND;
+        case GW_VAR_TYPE_VCD_WOR:
+            return FST_VT_VCD_WOR;
+        case GW_VAR_TYPE_SV_BIT:
+            return FST_VT_SV_BIT;
+        case GW_VAR_TYPE_SV_LOGIC:
+            return FST_VT_SV_LOGIC;
+        case GW_VAR_TYPE_SV_INT:
+            return FST_VT_SV_INT;
+        case GW_VAR_TYPE_SV_SHORTINT:
+            return FST_VT_SV_SHORTINT;
+        case GW_VAR_TYPE_SV_LONGINT:
+            return FST_VT_SV_LONGINT;
+        case GW_VAR_TYPE_SV_BYTE:
+            return FST_VT_SV_BYTE;
+        case GW_VAR_TYPE_SV_ENUM:
+            return FST_VT_SV_ENUM;
+        case GW_VAR_TYPE_VCD_WIRE:
+        default:
+            return FST_VT_VCD_WIRE;
+    }
+}
+
+/*
+ * FST stores the bit range separated from the name
+ */
+static char *vcdsav_fst_var_name(const char *netname)
+{
+    const char *br = strrchr(netname, '[');
+
+    if (br && (br != netname) && (br[-1] != ' ')) {
+        return g_strdup_printf("%.*s %s", (int)(br - netname), netname, br);
+    }
+
+    return g_strdup(netname);
+}
+
 /*
  * mainline
  */
@@ -336,31 +828,20 @@ int save_nodes_to_export_generic(FILE *trans_file,
     /* ExtNode *e; */
     /* int msi, lsi; */
     int i;
-    GwTime prevtime = GW_TIME_CONSTANT(-1);
+    GwTime prevtime;
     time_t walltime;
     struct strace *st = NULL;
     int strace_append = 0;
     int max_len = 1;
-    char *row_data = NULL;
     int is_trans = (export_typ == WAVE_EXPORT_TRANS);
-    int dumpvars_state = 0;
+    void *fst = NULL;
 
     if (export_typ == WAVE_EXPORT_TIM) {
         return (do_timfile_save(fname));
     }
 
-    errno = 0;
-    if (export_typ != WAVE_EXPORT_TRANS) {
-        GLOBALS->f_vcd_saver_c_1 = fopen(fname, "wb");
-    } else {
-        if (!trans_head) /* scan-build : is programming error to get here */
-        {
-            return (VCDSAV_FILE_ERROR);
-        }
-        GLOBALS->f_vcd_saver_c_1 = trans_file;
-    }
-
-    if (!GLOBALS->f_vcd_saver_c_1) {
+    if ((export_typ == WAVE_EXPORT_TRANS) && (!trans_head)) /* scan-build : is programming error to get here */
+    {
         return (VCDSAV_FILE_ERROR);
     }
 
@@ -451,12 +932,40 @@ int save_nodes_to_export_generic(FILE *trans_file,
     if (!nodecnt)
         return (VCDSAV_EMPTY);
 
-    GwTime global_time_offset = gw_dump_file_get_global_time_offset(GLOBALS->dump_file);
+    errno = 0;
+    if (export_typ == WAVE_EXPORT_FST) {
+        fst = GLOBALS->fst_vcd_saver_c_1 = fstWriterCreate(fname, 1);
+        if (!fst) {
+            return (VCDSAV_FILE_ERROR);
+        }
+        fstWriterSetParallelMode(fst, 1);
+    } else {
+        if (export_typ != WAVE_EXPORT_TRANS) {
+            GLOBALS->f_vcd_saver_c_1 = fopen(fname, "wb");
+        } else {
+            GLOBALS->f_vcd_saver_c_1 = trans_file;
+        }
+
+        if (!GLOBALS->f_vcd_saver_c_1) {
+            return (VCDSAV_FILE_ERROR);
+        }
+    }
+
     GwTime time_scale = gw_dump_file_get_time_scale(GLOBALS->dump_file);
+    /* the offset is kept in time units, the headers are in timescale units */
+    GwTime global_time_offset =
+        gw_dump_file_get_global_time_offset(GLOBALS->dump_file) / time_scale;
     GwTimeDimension time_dimension = gw_dump_file_get_time_dimension(GLOBALS->dump_file);
 
     /* header */
-    if (export_typ != WAVE_EXPORT_TRANS) {
+    if (export_typ == WAVE_EXPORT_FST) {
+        fstWriterSetVersion(fst, WAVE_VERSION_INFO);
+        fstWriterSetTimescale(fst,
+                              gw_time_scale_and_dimension_to_exponent(time_scale, time_dimension));
+        if (global_time_offset != 0) {
+            fstWriterSetTimezero(fst, global_time_offset);
+        }
+    } else if (export_typ != WAVE_EXPORT_TRANS) {
         time(&walltime);
         w32redirect_fprintf(is_trans, GLOBALS->f_vcd_saver_c_1, "$date\n");
         w32redirect_fprintf(is_trans,
@@ -531,193 +1040,118 @@ int save_nodes_to_export_generic(FILE *trans_file,
     recurse_build(vt, &hp_clone);
 
     for (i = 0; i < nodecnt; i++) {
-        char *hname = GLOBALS->hp_vcd_saver_c_1[i]->item->nname;
+        vcdsav_Tree *v = GLOBALS->hp_vcd_saver_c_1[i];
+        char *hname = v->item->nname;
         char *netname = output_hier(is_trans, hname);
+        int len = 1;
+        const char *typ;
 
         if (export_typ == WAVE_EXPORT_TRANS) {
             w32redirect_fprintf(is_trans,
                                 GLOBALS->f_vcd_saver_c_1,
                                 "$comment seqn %d %s $end\n",
-                                GLOBALS->hp_vcd_saver_c_1[i]->val,
+                                v->val,
                                 hname);
         }
 
-        if (GLOBALS->hp_vcd_saver_c_1[i]->flags &
-            (GW_HIST_ENT_FLAG_REAL | GW_HIST_ENT_FLAG_STRING)) {
-            const char *typ =
-                (GLOBALS->hp_vcd_saver_c_1[i]->flags & GW_HIST_ENT_FLAG_STRING) ? "string" : "real";
-            int tlen = (GLOBALS->hp_vcd_saver_c_1[i]->flags & GW_HIST_ENT_FLAG_STRING) ? 0 : 1;
-            w32redirect_fprintf(is_trans,
-                                GLOBALS->f_vcd_saver_c_1,
-                                "$var %s %d %s %s $end\n",
-                                typ,
-                                tlen,
-                                vcdid(GLOBALS->hp_vcd_saver_c_1[i]->val, export_typ),
-                                netname);
+        if (v->flags & (GW_HIST_ENT_FLAG_REAL | GW_HIST_ENT_FLAG_STRING)) {
+            typ = (v->flags & GW_HIST_ENT_FLAG_STRING) ? "string" : "real";
+            len = (v->flags & GW_HIST_ENT_FLAG_STRING) ? 0 : 1;
         } else {
             int msi = -1, lsi = -1;
 
-            if (GLOBALS->hp_vcd_saver_c_1[i]->item->extvals) {
-                msi = GLOBALS->hp_vcd_saver_c_1[i]->item->msi;
-                lsi = GLOBALS->hp_vcd_saver_c_1[i]->item->lsi;
+            if (v->item->extvals) {
+                msi = v->item->msi;
+                lsi = v->item->lsi;
             }
 
-            if (msi == lsi) {
-                w32redirect_fprintf(
-                    is_trans,
-                    GLOBALS->f_vcd_saver_c_1,
-                    "$var %s 1 %s %s $end\n",
-                    gw_var_type_to_string(GLOBALS->hp_vcd_saver_c_1[i]->item->vartype),
-                    vcdid(GLOBALS->hp_vcd_saver_c_1[i]->val, export_typ),
-                    netname);
-            } else {
-                int len = (msi < lsi) ? (lsi - msi + 1) : (msi - lsi + 1);
-                w32redirect_fprintf(
-                    is_trans,
-                    GLOBALS->f_vcd_saver_c_1,
-                    "$var %s %d %s %s $end\n",
-                    gw_var_type_to_string(GLOBALS->hp_vcd_saver_c_1[i]->item->vartype),
-                    len,
-                    vcdid(GLOBALS->hp_vcd_saver_c_1[i]->val, export_typ),
-                    netname);
-                GLOBALS->hp_vcd_saver_c_1[i]->len = len;
+            typ = gw_var_type_to_string(v->item->vartype);
+            if (msi != lsi) {
+                len = (msi < lsi) ? (lsi - msi + 1) : (msi - lsi + 1);
+                v->len = len;
                 if (len > max_len)
                     max_len = len;
             }
         }
 
+        if (fst) {
+            char *fst_name = vcdsav_fst_var_name(netname);
+            enum fstVarType fst_typ;
+
+            if (v->flags & GW_HIST_ENT_FLAG_STRING) {
+                fst_typ = FST_VT_GEN_STRING;
+            } else if (v->flags & GW_HIST_ENT_FLAG_REAL) {
+                fst_typ = FST_VT_VCD_REAL;
+                len = 64;
+            } else {
+                fst_typ = vcdsav_fst_var_type(v->item->vartype);
+            }
+
+            v->handle.i = fstWriterCreateVar(fst, fst_typ, FST_VD_IMPLICIT, len, fst_name, 0);
+            g_free(fst_name);
+        } else {
+            /* identifiers are generated once instead of for every value change */
+            strcpy(v->id, vcdid(v->val, export_typ));
+
+            w32redirect_fprintf(is_trans,
+                                GLOBALS->f_vcd_saver_c_1,
+                                "$var %s %d %s %s $end\n",
+                                typ,
+                                len,
+                                v->id,
+                                netname);
+        }
+
         /* if(was_packed) { free_2(hname); } ...not needed for HIER_DEPACK_STATIC */
     }
 
-    row_data = malloc_2(max_len + 1);
-
     output_hier(is_trans, "");
     free_hier();
 
-    w32redirect_fprintf(is_trans, GLOBALS->f_vcd_saver_c_1, "$enddefinitions $end\n");
+    if (!fst) {
+        w32redirect_fprintf(is_trans, GLOBALS->f_vcd_saver_c_1, "$enddefinitions $end\n");
+    }
 
     /* value changes */
 
-    for (i = (nodecnt / 2 - 1); i > 0; i--) /* build nodes into having heap property */
-    {
-        heapify(i, nodecnt);
-    }
-
     GwTimeRange *time_range = gw_dump_file_get_time_range(GLOBALS->dump_file);
-
-    for (;;) {
-        heapify(0, nodecnt);
-
-        if (!GLOBALS->hp_vcd_saver_c_1[0]->hist)
-            break;
-        if (GLOBALS->hp_vcd_saver_c_1[0]->hist->time > gw_time_range_get_end(time_range))
-            break;
-
-        if ((GLOBALS->hp_vcd_saver_c_1[0]->hist->time != prevtime) &&
-            (GLOBALS->hp_vcd_saver_c_1[0]->hist->time >= GW_TIME_CONSTANT(0))) {
-            GwTime tnorm = GLOBALS->hp_vcd_saver_c_1[0]->hist->time;
-            if (time_scale != 1) {
-                tnorm /= time_scale;
-            }
-
-            if (dumpvars_state == 1) {
+    GwTime end_time = gw_time_range_get_end(time_range);
+    vcdsav_Slice proto = {0};
+
+    proto.hp = GLOBALS->hp_vcd_saver_c_1;
+    proto.nodecnt = nodecnt;
+    proto.max_len = max_len;
+    proto.time_scale = time_scale;
+    vcdsav_find_dumpvars_times(proto.hp,
+                               nodecnt,
+                               end_time,
+                               &proto.dumpvars_time,
+                               &proto.dumpvars_end_time);
+    proto.limit = (end_time < GW_TIME_MAX) ? (end_time + 1) : GW_TIME_MAX;
+    proto.prevtime = GW_TIME_CONSTANT(-1);
+    proto.f = GLOBALS->f_vcd_saver_c_1;
+    proto.is_trans = is_trans;
+    proto.fst = fst;
+
+    /* only plain VCD files are formatted in parallel, FST has its own writer threads */
+    prevtime = vcdsav_write_value_changes(&proto,
+                                          (export_typ == WAVE_EXPORT_VCD)
+                                              ? (int)g_get_num_processors()
+                                              : 1);
+
+    if (prevtime < end_time) {
+        if (fst) {
+            fstWriterEmitTimeChange(fst, end_time / time_scale);
+        } else {
+            if ((proto.dumpvars_time >= GW_TIME_CONSTANT(0)) &&
+                (proto.dumpvars_end_time < GW_TIME_CONSTANT(0))) {
                 w32redirect_fprintf(is_trans, GLOBALS->f_vcd_saver_c_1, "$end\n");
-                dumpvars_state = 2;
             }
             w32redirect_fprintf(is_trans,
                                 GLOBALS->f_vcd_saver_c_1,
                                 "#%" GW_TIME_FORMAT "\n",
-                                tnorm);
-            if (!dumpvars_state) {
-                w32redirect_fprintf(is_trans, GLOBALS->f_vcd_saver_c_1, "$dumpvars\n");
-                dumpvars_state = 1;
-            }
-            prevtime = GLOBALS->hp_vcd_saver_c_1[0]->hist->time;
+                                end_time / time_scale);
         }
-
-        if (GLOBALS->hp_vcd_saver_c_1[0]->hist->time >= GW_TIME_CONSTANT(0)) {
-            if (GLOBALS->hp_vcd_saver_c_1[0]->flags &
-                (GW_HIST_ENT_FLAG_REAL | GW_HIST_ENT_FLAG_STRING)) {
-                if (GLOBALS->hp_vcd_saver_c_1[0]->flags & GW_HIST_ENT_FLAG_STRING) {
-                    char *vec = GLOBALS->hp_vcd_saver_c_1[0]->hist->v.h_vector
-                                    ? GLOBALS->hp_vcd_saver_c_1[0]->hist->v.h_vector
-                                    : "UNDEF";
-
-                    int vec_slen = strlen(vec);
-                    char *vec_escaped = malloc_2(vec_slen * 4 + 1); /* worst case */
-                    int vlen = fstUtilityBinToEsc((unsigned char *)vec_escaped,
-                                                  (unsigned char *)vec,
-                                                  vec_slen);
-
-                    vec_escaped[vlen] = 0;
-                    if (vlen) {
-                        w32redirect_fprintf(is_trans,
-                                            GLOBALS->f_vcd_saver_c_1,
-                                            "s%s %s\n",
-                                            vec_escaped,
-                                            vcdid(GLOBALS->hp_vcd_saver_c_1[0]->val, export_typ));
-                    } else {
-                        w32redirect_fprintf(is_trans,
-                                            GLOBALS->f_vcd_saver_c_1,
-                                            "s\\000 %s\n",
-                                            vcdid(GLOBALS->hp_vcd_saver_c_1[0]->val, export_typ));
-                    }
-                    free_2(vec_escaped);
-                } else {
-                    double *d = &GLOBALS->hp_vcd_saver_c_1[0]->hist->v.h_double;
-                    double value;
-
-                    if (!d) {
-                        sscanf("NaN", "%lg", &value);
-                    } else {
-                        value = *d;
-                    }
-
-                    w32redirect_fprintf(is_trans,
-                                        GLOBALS->f_vcd_saver_c_1,
-                                        "r%.16g %s\n",
-                                        value,
-                                        vcdid(GLOBALS->hp_vcd_saver_c_1[0]->val, export_typ));
-                }
-            } else if (GLOBALS->hp_vcd_saver_c_1[0]->len) {
-                if (GLOBALS->hp_vcd_saver_c_1[0]->hist->v.h_vector) {
-                    for (i = 0; i < GLOBALS->hp_vcd_saver_c_1[0]->len; i++) {
-                        row_data[i] =
-                            analyzer_demang(0, GLOBALS->hp_vcd_saver_c_1[0]->hist->v.h_vector[i]);
-                    }
-                } else {
-                    for (i = 0; i < GLOBALS->hp_vcd_saver_c_1[0]->len; i++) {
-                        row_data[i] = 'x';
-                    }
-                }
-                row_data[i] = 0;
-
-                w32redirect_fprintf(is_trans,
-                                    GLOBALS->f_vcd_saver_c_1,
-                                    "b%s %s\n",
-                                    vcd_truncate_bitvec(row_data),
-                                    vcdid(GLOBALS->hp_vcd_saver_c_1[0]->val, export_typ));
-            } else {
-                w32redirect_fprintf(is_trans,
-                                    GLOBALS->f_vcd_saver_c_1,
-                                    "%c%s\n",
-                                    analyzer_demang(0, GLOBALS->hp_vcd_saver_c_1[0]->hist->v.h_val),
-                                    vcdid(GLOBALS->hp_vcd_saver_c_1[0]->val, export_typ));
-            }
-        }
-
-        GLOBALS->hp_vcd_saver_c_1[0]->hist = GLOBALS->hp_vcd_saver_c_1[0]->hist->next;
-    }
-
-    if (prevtime < gw_time_range_get_end(time_range)) {
-        if (dumpvars_state == 1) {
-            w32redirect_fprintf(is_trans, GLOBALS->f_vcd_saver_c_1, "$end\n");
-            dumpvars_state = 2;
-        }
-        w32redirect_fprintf(is_trans,
-                            GLOBALS->f_vcd_saver_c_1,
-                            "#%" GW_TIME_FORMAT "\n",
-                            gw_time_range_get_end(time_range) / time_scale);
     }
 
     for (i = 0; i < nodecnt; i++) {
@@ -726,10 +1160,11 @@ int save_nodes_to_export_generic(FILE *trans_file,
 
     free_2(GLOBALS->hp_vcd_saver_c_1);
     GLOBALS->hp_vcd_saver_c_1 = NULL;
-    free_2(row_data);
-    row_data = NULL;
 
-    if (export_typ != WAVE_EXPORT_TRANS) {
+    if (fst) {
+        fstWriterClose(fst);
+        GLOBALS->fst_vcd_saver_c_1 = NULL;
+    } else if (export_typ != WAVE_EXPORT_TRANS) {
         fclose(GLOBALS->f_vcd_saver_c_1);
     } else {
         w32redirect_fprintf(is_trans,
@@ -777,6 +1212,24 @@ void free_hier(void)
     }
 }
 
+static void vcdsav_scope(int is_trans, const char *name)
+{
+    if (GLOBALS->fst_vcd_saver_c_1) {
+        fstWriterSetScope(GLOBALS->fst_vcd_saver_c_1, FST_ST_VCD_MODULE, name, NULL);
+    } else {
+        w32redirect_fprintf(is_trans, GLOBALS->f_vcd_saver_c_1, "$scope module %s $end\n", name);
+    }
+}
+
+static void vcdsav_upscope(int is_trans)
+{
+    if (GLOBALS->fst_vcd_saver_c_1) {
+        fstWriterSetUpscope(GLOBALS->fst_vcd_saver_c_1);
+    } else {
+        w32redirect_fprintf(is_trans, GLOBALS->f_vcd_saver_c_1, "$upscope $end\n");
+    }
+}
+
 /*
  * navigate up and down the scope hierarchy and
  * emit the appropriate vcd scope primitives
@@ -787,10 +1240,7 @@ static void diff_hier(int is_trans, struct namehier *nh1, struct namehier *nh2)
 
     if (!nh2) {
         while ((nh1) && (nh1->not_final)) {
-            w32redirect_fprintf(is_trans,
-                                GLOBALS->f_vcd_saver_c_1,
-                                "$scope module %s $end\n",
-                                nh1->name);
+            vcdsav_scope(is_trans, nh1->name);
             nh1 = nh1->next;
         }
         return;
@@ -806,10 +1256,7 @@ static void diff_hier(int is_trans, struct namehier *nh1, struct namehier *nh2)
         {
             /* nhtemp=nh1; */ /* scan-build */
             while ((nh1) && (nh1->not_final)) {
-                w32redirect_fprintf(is_trans,
-                                    GLOBALS->f_vcd_saver_c_1,
-                                    "$scope module %s $end\n",
-                                    nh1->name);
+                vcdsav_scope(is_trans, nh1->name);
                 nh1 = nh1->next;
             }
             break;
@@ -819,7 +1266,7 @@ static void diff_hier(int is_trans, struct namehier *nh1, struct namehier *nh2)
         {
             /* nhtemp=nh2; */ /* scan-build */
             while ((nh2) && (nh2->not_final)) {
-                w32redirect_fprintf(is_trans, GLOBALS->f_vcd_saver_c_1, "$upscope $end\n");
+                vcdsav_upscope(is_trans);
                 nh2 = nh2->next;
             }
             break;
@@ -828,16 +1275,13 @@ static void diff_hier(int is_trans, struct namehier *nh1, struct namehier *nh2)
         if (strcmp(nh1->name, nh2->name)) {
             /* nhtemp=nh2; */ /* prune old hier */ /* scan-build */
             while ((nh2) && (nh2->not_final)) {
-                w32redirect_fprintf(is_trans, GLOBALS->f_vcd_saver_c_1, "$upscope $end\n");
+                vcdsav_upscope(is_trans);
                 nh2 = nh2->next;
             }
 
             /* nhtemp=nh1; */ /* add new hier */ /* scan-build */
             while ((nh1) && (nh1->not_final)) {
-                w32redirect_fprintf(is_trans,
-                                    GLOBALS->f_vcd_saver_c_1,
-                                    "$scope module %s $end\n",
-                                    nh1->name);
+                vcdsav_scope(is_trans, nh1->name);
                 nh1 = nh1->next;
             }
             break;
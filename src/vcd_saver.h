@@ -19,7 +19,8 @@ enum vcd_export_typ
 {
     WAVE_EXPORT_VCD,
     WAVE_EXPORT_TIM,
-    WAVE_EXPORT_TRANS
+    WAVE_EXPORT_TRANS,
+    WAVE_EXPORT_FST
 };
 enum vcd_saver_rc
 {
@@ -1835,10 +1835,75 @@ void populateBuffer(GwTrace *t, char *altname, char *buf)
 
 /***************************************************************************/
 
+/* a width of -1 stands for a trace whose name isn't measured */
+static void update_signal_name_max(int old_width, int new_width)
+{
+    if (old_width >= 0 && old_width == GLOBALS->signal_name_max_width) {
+        GLOBALS->signal_name_max_count--;
+    }
+
+    if (new_width > GLOBALS->signal_name_max_width) {
+        GLOBALS->signal_name_max_width = new_width;
+        GLOBALS->signal_name_max_count = 1;
+    } else if (new_width >= 0 && new_width == GLOBALS->signal_name_max_width) {
+        GLOBALS->signal_name_max_count++;
+    }
+}
+
+/* only needed once no trace has the maximum width anymore */
+static void rescan_signal_name_max(void)
+{
+    GLOBALS->signal_name_max_width = 0;
+    GLOBALS->signal_name_max_count = 0;
+
+    for (GwTrace *t = GLOBALS->traces.first; t != NULL; t = t->t_next) {
+        if (t->name_label != NULL) {
+            update_signal_name_max(-1, t->name_label_width);
+        }
+    }
+}
+
+/* width of the signal list name of t, buf is filled by populateBuffer() */
+int measure_trace_name(GwTrace *t, const char *buf)
+{
+    if (t->name_label == NULL || strcmp(t->name_label, buf) != 0) {
+        int old_width = (t->name_label != NULL) ? t->name_label_width : -1;
+
+        g_free(t->name_label);
+        t->name_label = g_strdup(buf);
+        t->name_label_width = font_engine_string_measure(GLOBALS->signalfont, buf);
+        update_signal_name_max(old_width, t->name_label_width);
+    }
+
+    return t->name_label_width;
+}
+
+/* the name of t no longer counts for the width of the signal list */
+void forget_trace_name(GwTrace *t)
+{
+    if (t->name_label != NULL) {
+        update_signal_name_max(t->name_label_width, -1);
+        g_free(t->name_label);
+        t->name_label = NULL;
+    }
+}
+
+/* the traces skipped by GiveNextTrace() are hidden in closed groups */
+static GwTrace *next_measured_trace(GwTrace *t)
+{
+    GwTrace *next = GiveNextTrace(t);
+
+    for (GwTrace *hidden = t->t_next; hidden != NULL && hidden != next; hidden = hidden->t_next) {
+        forget_trace_name(hidden);
+    }
+
+    return next;
+}
+
 void MaxSignalLength(void)
 {
     GwTrace *t;
-    int len = 0, maxlen = 0;
+    int maxlen;
     int vlen = 0, vmaxlen = 0;
     char buf[2048];
     char dirty_kick;
@@ -1850,6 +1915,9 @@ void MaxSignalLength(void)
     if ((!GLOBALS->signalwindow_width_dirty) && (GLOBALS->use_nonprop_fonts))
         return;
 
+    if (redraw_batch_defer()) /* recalculated once by the redraw at the end of the batch */
+        return;
+
     GwMarker *primary_marker = gw_project_get_primary_marker(GLOBALS->project);
 
     dirty_kick = GLOBALS->signalwindow_width_dirty;
@@ -1898,20 +1966,18 @@ void MaxSignalLength(void)
                     (TR_BLANK | TR_ANALOG_BLANK_STRETCH))) /* for "comment" style blank traces */
         {
             if (t->name || subname) {
-                len = font_engine_string_measure(GLOBALS->signalfont, buf);
-                if (len > maxlen)
-                    maxlen = len;
+                measure_trace_name(t, buf);
+            } else {
+                forget_trace_name(t);
             }
 
             if (t->asciivalue) {
                 free_2(t->asciivalue);
                 t->asciivalue = NULL;
             }
-            t = GiveNextTrace(t);
+            t = next_measured_trace(t);
         } else if (t->name || subname) {
-            len = font_engine_string_measure(GLOBALS->signalfont, buf);
-            if (len > maxlen)
-                maxlen = len;
+            measure_trace_name(t, buf);
 
             if (gw_marker_is_enabled(primary_marker) && (!(t->flags & TR_EXCLUDE))) {
                 t->asciitime = gw_marker_get_position(primary_marker);
@@ -2014,12 +2080,18 @@ void MaxSignalLength(void)
                 }
             }
 
-            t = GiveNextTrace(t);
+            t = next_measured_trace(t);
         } else {
-            t = GiveNextTrace(t);
+            forget_trace_name(t);
+            t = next_measured_trace(t);
         }
     }
 
+    if (GLOBALS->signal_name_max_count <= 0) {
+        rescan_signal_name_max();
+    }
+    maxlen = GLOBALS->signal_name_max_width;
+
     GLOBALS->max_signal_name_pixel_width = maxlen;
     GLOBALS->signal_pixmap_width = maxlen + 6; /* 2 * 3 pixel pad */
     if (gw_marker_is_enabled(primary_marker)) {
@@ -17,6 +17,8 @@ void MaxSignalLength_2(
     char dirty_kick); /* used to resize but not fully recalculate like MaxSignalLength() */
 
 void populateBuffer(GwTrace *t, char *altname, char *buf);
+int measure_trace_name(GwTrace *t, const char *buf);
+void forget_trace_name(GwTrace *t);
 void calczoom(double z0);
 void make_sigarea_gcs(GtkWidget *widget);
 